@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FLAT_INDEX_H
+#define FLAT_INDEX_H
+
+#include <QVector>
+
+namespace common {
+
+/**
+ * @brief Flat hash table of Key to T
+ *
+ * Keys & values are kept in dense arrays (cheap to iterate, no per entry node allocation),
+ * located through an open addressing (linear probing) table of indexes into the arrays.
+ * Removal moves the last entry into the hole, so iteration order is not stable.
+ *
+ * Traits provides the home slot hash of a key & key equality:
+ *   static uint hash(const Key &key);
+ *   static bool equal(const Key &lhs, const Key &rhs);
+ * and the minimum table size, a power of 2: enum { kMinTableSize = N };
+ */
+template<typename Key, typename T, typename Traits>
+class FlatIndex
+{
+public:
+    FlatIndex()
+        : m_table {}
+        , m_keys {}
+        , m_values {}
+        , m_mask {0}
+    {
+    }
+
+    inline int size() const
+    {
+        return m_keys.size();
+    }
+    inline bool isEmpty() const
+    {
+        return m_keys.isEmpty();
+    }
+
+    /**
+     * @brief Remove all entries, table capacity is kept for the next scan
+     */
+    void clear()
+    {
+        m_table.fill(kEmptySlot);
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    void reserve(int n)
+    {
+        m_keys.reserve(n);
+        m_values.reserve(n);
+        if (n * 2 > m_table.size())
+            rehash(n * 2);
+    }
+
+    inline bool contains(const Key &key) const
+    {
+        return indexOf(key) >= 0;
+    }
+
+    inline T *find(const Key &key)
+    {
+        int idx = indexOf(key);
+        return idx >= 0 ? &m_values[idx] : nullptr;
+    }
+    inline const T *find(const Key &key) const
+    {
+        int idx = indexOf(key);
+        return idx >= 0 ? &m_values.at(idx) : nullptr;
+    }
+
+    inline T value(const Key &key) const
+    {
+        int idx = indexOf(key);
+        return idx >= 0 ? m_values.at(idx) : T();
+    }
+    inline T value(const Key &key, const T &defaultValue) const
+    {
+        int idx = indexOf(key);
+        return idx >= 0 ? m_values.at(idx) : defaultValue;
+    }
+
+    /**
+     * @brief Value of key, a default constructed value is inserted if key is not found
+     */
+    T &operator[](const Key &key)
+    {
+        int idx = indexOf(key);
+        if (idx < 0)
+            idx = append(key, T());
+        return m_values[idx];
+    }
+
+    void insert(const Key &key, const T &value = T())
+    {
+        int idx = indexOf(key);
+        if (idx >= 0)
+            m_values[idx] = value;
+        else
+            append(key, value);
+    }
+
+    bool remove(const Key &key)
+    {
+        if (m_table.isEmpty())
+            return false;
+
+        int slot = slotOf(key);
+        int idx = m_table.at(slot);
+        if (idx == kEmptySlot)
+            return false;
+
+        eraseSlot(slot);
+
+        // move the last entry into the hole to keep the arrays dense
+        int last = m_keys.size() - 1;
+        if (idx != last) {
+            int lastSlot = slotOf(m_keys.at(last));
+            m_keys[idx] = m_keys.at(last);
+            m_values[idx] = m_values.at(last);
+            m_table[lastSlot] = idx;
+        }
+        m_keys.removeLast();
+        m_values.removeLast();
+        return true;
+    }
+
+    /**
+     * @brief Dense key array, in insertion order as long as nothing was removed
+     */
+    inline const QVector<Key> &keys() const
+    {
+        return m_keys;
+    }
+    inline const QVector<T> &values() const
+    {
+        return m_values;
+    }
+    inline const Key &keyAt(int i) const
+    {
+        return m_keys.at(i);
+    }
+    inline const T &valueAt(int i) const
+    {
+        return m_values.at(i);
+    }
+    inline T &valueAt(int i)
+    {
+        return m_values[i];
+    }
+
+private:
+    enum { kEmptySlot = -1 };
+
+    inline int homeOf(const Key &key) const
+    {
+        return int(Traits::hash(key)) & m_mask;
+    }
+
+    // slot holding key, or the empty slot ending its probe sequence
+    inline int slotOf(const Key &key) const
+    {
+        int slot = homeOf(key);
+        int idx;
+        while ((idx = m_table.at(slot)) != kEmptySlot && !Traits::equal(m_keys.at(idx), key))
+            slot = (slot + 1) & m_mask;
+        return slot;
+    }
+
+    inline int indexOf(const Key &key) const
+    {
+        if (m_table.isEmpty())
+            return -1;
+        return m_table.at(slotOf(key));
+    }
+
+    int append(const Key &key, const T &value)
+    {
+        // keep load factor below 1/2
+        if ((m_keys.size() + 1) * 2 > m_table.size())
+            rehash((m_keys.size() + 1) * 2);
+
+        int idx = m_keys.size();
+        m_keys.append(key);
+        m_values.append(value);
+        m_table[slotOf(key)] = idx;
+        return idx;
+    }
+
+    void rehash(int minSize)
+    {
+        int size = Traits::kMinTableSize;
+        while (size < minSize)
+            size <<= 1;
+        if (size <= m_table.size())
+            return;
+
+        m_table.fill(kEmptySlot, size);
+        m_mask = size - 1;
+        for (int i = 0; i < m_keys.size(); ++i)
+            m_table[slotOf(m_keys.at(i))] = i;
+    }
+
+    // backward shift deletion, keeps probe sequences intact without tombstones
+    void eraseSlot(int hole)
+    {
+        int slot = hole;
+        for (;;) {
+            slot = (slot + 1) & m_mask;
+            int idx = m_table.at(slot);
+            if (idx == kEmptySlot)
+                break;
+
+            int home = homeOf(m_keys.at(idx));
+            // entry can move back if its home slot is not within (hole, slot]
+            bool movable = (hole <= slot) ? (home <= hole || home > slot)
+                                          : (home <= hole && home > slot);
+            if (movable) {
+                m_table[hole] = idx;
+                hole = slot;
+            }
+        }
+        m_table[hole] = kEmptySlot;
+    }
+
+    QVector<int> m_table;
+    QVector<Key> m_keys;
+    QVector<T> m_values;
+    int m_mask;
+};
+
+} // namespace common
+
+#endif // FLAT_INDEX_H
@@ -6,6 +6,7 @@
 #include "han_latin.h"
 #include "ddlog.h"
 #include <QDebug>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 
@@ -47,42 +48,56 @@ static QString parseError(const QString &words, UErrorCode &ec, const UParseErro
     return errbuf;
 }
 
+// transliterators are created once, ICU rule compilation costs far more than a conversion
+struct HanLatinTransliterators {
+    HanLatinTransliterators()
+    {
+        UParseError pe {};
+        hanLatin.reset(Transliterator::createInstance(
+                TRANSLITERATION_HAN_LATIN, UTransDirection::UTRANS_FORWARD, pe, hanLatinEc));
+        if (U_FAILURE(hanLatinEc))
+            qCWarning(app) << "Failed to create Han to Latin transliterator:" << parseError(TRANSLITERATION_HAN_LATIN, hanLatinEc, pe);
+
+        pe = {};
+        latinAscii.reset(Transliterator::createInstance(
+                TRANSLITERATION_LATIN_ASCII, UTransDirection::UTRANS_FORWARD, pe, latinAsciiEc));
+        if (U_FAILURE(latinAsciiEc))
+            qCWarning(app) << "Failed to create Latin to ASCII transliterator:" << parseError(TRANSLITERATION_LATIN_ASCII, latinAsciiEc, pe);
+    }
+
+    UErrorCode hanLatinEc = U_ZERO_ERROR;
+    UErrorCode latinAsciiEc = U_ZERO_ERROR;
+    unique_ptr<Transliterator> hanLatin;
+    unique_ptr<Transliterator> latinAscii;
+    // transliterate() is not safe for concurrent use of the same instance
+    QMutex mutex;
+};
+
 QString convHanToLatin(const QString &words)
 {
     qCDebug(app) << "Converting Han characters to Latin:" << words;
-    QString result {};
-    UErrorCode ec = U_ZERO_ERROR;
-    UParseError pe {};
-    unique_ptr<Transliterator> tr(Transliterator::createInstance(
-            TRANSLITERATION_HAN_LATIN, UTransDirection::UTRANS_FORWARD, pe, ec));
+    static HanLatinTransliterators trs;
+
+    if (U_FAILURE(trs.hanLatinEc) || !trs.hanLatin) {
+        return words;
+    }
 
     UnicodeString ubuf = UnicodeString::fromUTF8(StringPiece(words.toStdString()));
+    QMutexLocker locker(&trs.mutex);
     // from hanzi to latin
-    tr->transliterate(ubuf);
-
-    if (U_FAILURE(ec)) {
-        qCWarning(app) << "Failed to transliterate Han to Latin:" << parseError(words, ec, pe);
-        result = words;
-    } else {
-        qCDebug(app) << "Han to Latin success";
-        ec = U_ZERO_ERROR;
-        pe = {};
-        unique_ptr<Transliterator> tr2(Transliterator::createInstance(
-                TRANSLITERATION_LATIN_ASCII, UTransDirection::UTRANS_FORWARD, pe, ec));
-        // from latin to ascii (pinyin)
-        tr2->transliterate(ubuf);
-
-        if (U_FAILURE(ec)) {
-            qCWarning(app) << "Failed to transliterate Latin to ASCII:" << parseError(words, ec, pe);
-            result = words;
-        } else {
-            qCDebug(app) << "Latin to ASCII success";
-            std::string buffer;
-            result = QString::fromStdString(ubuf.toUTF8String(buffer));
-            qCDebug(app) << "Successfully converted to ASCII:" << result;
-        }
+    trs.hanLatin->transliterate(ubuf);
+    qCDebug(app) << "Han to Latin success";
+
+    if (U_FAILURE(trs.latinAsciiEc) || !trs.latinAscii) {
+        return words;
     }
+    // from latin to ascii (pinyin)
+    trs.latinAscii->transliterate(ubuf);
+    locker.unlock();
 
+    std::string buffer;
+    QString result = QString::fromStdString(ubuf.toUTF8String(buffer));
+    qCDebug(app) << "Successfully converted to ASCII:" << result;
     return result;
 }
 
@@ -0,0 +1,339 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "perf_stats.h"
+
+#include <QStringList>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PROC_PATH_THREAD_IO "/proc/thread-self/io"
+
+#ifdef PERF_COUNT_ALLOCS
+// allocations of the calling thread, plain TLS so that it can be touched from inside malloc
+static __thread quint64 t_allocs = 0;
+
+extern "C" {
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+// counted & forwarded to glibc, the allocator itself is not replaced
+void *malloc(size_t size)
+{
+    ++t_allocs;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    ++t_allocs;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    ++t_allocs;
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+namespace common {
+namespace perf {
+
+// /proc/thread-self/io of the calling thread, kept open for the lifetime of the thread
+struct ThreadIoFile {
+    int fd = -2; // -2: not opened yet, -1: not available
+
+    ~ThreadIoFile()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+};
+static thread_local ThreadIoFile t_ioFile;
+
+static quint64 parseIoField(const char *buf, const char *key)
+{
+    const char *p = strstr(buf, key);
+    if (!p)
+        return 0;
+    return strtoull(p + strlen(key), nullptr, 10);
+}
+
+PerfHistogram::PerfHistogram()
+{
+    reset();
+}
+
+int PerfHistogram::bucketOf(quint64 value)
+{
+    if (value < quint64(kSubCount))
+        return int(value);
+    int msb = 63 - __builtin_clzll(value);
+    int sub = int((value >> (msb - kSubBits)) & (kSubCount - 1));
+    return (msb - kSubBits + 1) * kSubCount + sub;
+}
+
+quint64 PerfHistogram::bucketHighest(int bucket)
+{
+    if (bucket < kSubCount)
+        return quint64(bucket);
+    int msb = bucket / kSubCount + kSubBits - 1;
+    int sub = bucket % kSubCount;
+    int shift = msb - kSubBits;
+    quint64 lowest = quint64(kSubCount + sub) << shift;
+    return lowest + ((quint64(1) << shift) - 1);
+}
+
+void PerfHistogram::record(quint64 value)
+{
+    m_buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    quint64 max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void PerfHistogram::reset()
+{
+    for (auto &bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+quint64 PerfHistogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+quint64 PerfHistogram::sum() const
+{
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+quint64 PerfHistogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+quint64 PerfHistogram::percentile(double percentile) const
+{
+    // buckets may be updated while walked, count them instead of trusting m_count
+    quint64 counts[kBucketCount];
+    quint64 total = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0)
+        return 0;
+
+    quint64 rank = quint64(percentile / 100. * double(total) + 0.5);
+    if (rank < 1)
+        rank = 1;
+    if (rank > total)
+        rank = total;
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank)
+            return qMin(bucketHighest(i), max());
+    }
+    return max();
+}
+
+PerfStats::PerfStats()
+{
+    for (int i = 0; i < kStageCount; ++i) {
+        m_syscalls[i].store(0, std::memory_order_relaxed);
+        m_allocs[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+PerfStats *PerfStats::instance()
+{
+    static PerfStats stats;
+    return &stats;
+}
+
+void PerfStats::record(PerfStage stage, quint64 ns, quint64 syscalls, quint64 allocs)
+{
+    if (stage < 0 || stage >= kStageCount)
+        return;
+    m_latency[stage].record(ns);
+    m_syscalls[stage].fetch_add(syscalls, std::memory_order_relaxed);
+    m_allocs[stage].fetch_add(allocs, std::memory_order_relaxed);
+}
+
+void PerfStats::reset()
+{
+    for (int i = 0; i < kStageCount; ++i) {
+        m_latency[i].reset();
+        m_syscalls[i].store(0, std::memory_order_relaxed);
+        m_allocs[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+perf_stage_summary_t PerfStats::summary(PerfStage stage) const
+{
+    perf_stage_summary_t summary {};
+    if (stage < 0 || stage >= kStageCount)
+        return summary;
+    const PerfHistogram &latency = m_latency[stage];
+    summary.count = latency.count();
+    summary.sumNs = latency.sum();
+    summary.maxNs = latency.max();
+    summary.p50Ns = latency.percentile(50);
+    summary.p90Ns = latency.percentile(90);
+    summary.p99Ns = latency.percentile(99);
+    summary.syscalls = m_syscalls[stage].load(std::memory_order_relaxed);
+    summary.allocs = m_allocs[stage].load(std::memory_order_relaxed);
+    return summary;
+}
+
+const char *PerfStats::stageName(PerfStage stage)
+{
+    switch (stage) {
+    case kStageCpuStats:
+        return "cpu_stats";
+    case kStageBlockDevices:
+        return "block_devices";
+    case kStageNetifs:
+        return "netifs";
+    case kStageProcessScan:
+        return "process_scan";
+    case kStageDKapture:
+        return "dkapture";
+    case kStageSnapshot:
+        return "snapshot";
+    case kStageModelDiff:
+        return "model_diff";
+    case kStagePaint:
+        return "paint";
+    default:
+        return "unknown";
+    }
+}
+
+bool PerfStats::allocsCounted()
+{
+#ifdef PERF_COUNT_ALLOCS
+    return true;
+#else
+    return false;
+#endif
+}
+
+QString PerfStats::report() const
+{
+    // durations in microseconds, syscalls & allocations averaged per run
+    QStringList lines;
+    lines << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+                     .arg("stage", -14)
+                     .arg("runs", 8)
+                     .arg("mean_us", 10)
+                     .arg("p50_us", 10)
+                     .arg("p90_us", 10)
+                     .arg("p99_us", 10)
+                     .arg("max_us", 10)
+                     .arg("syscalls", 10)
+                     .arg("allocs", 10);
+    for (int i = 0; i < kStageCount; ++i) {
+        PerfStage stage = PerfStage(i);
+        perf_stage_summary_t s = summary(stage);
+        auto us = [](quint64 ns) { return QString::number(double(ns) / 1000., 'f', 1); };
+        auto perRun = [&s](quint64 total) { return s.count ? QString::number(double(total) / double(s.count), 'f', 1) : QString("0"); };
+        lines << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+                         .arg(stageName(stage), -14)
+                         .arg(s.count, 8)
+                         .arg(us(s.count ? s.sumNs / s.count : 0), 10)
+                         .arg(us(s.p50Ns), 10)
+                         .arg(us(s.p90Ns), 10)
+                         .arg(us(s.p99Ns), 10)
+                         .arg(us(s.maxNs), 10)
+                         .arg(perRun(s.syscalls), 10)
+                         .arg(allocsCounted() ? perRun(s.allocs) : QString("-"), 10);
+    }
+    return lines.join('\n') + '\n';
+}
+
+PerfScope::PerfScope(PerfStage stage)
+    : m_stage(stage)
+    , m_startNs(monotonicNs())
+    , m_startSyscalls(threadSyscalls())
+    , m_startAllocs(threadAllocs())
+    , m_syscalls(-1)
+{
+}
+
+PerfScope::~PerfScope()
+{
+    quint64 ns = monotonicNs() - m_startNs;
+    quint64 allocs = threadAllocs() - m_startAllocs;
+    quint64 syscalls = 0;
+    if (m_syscalls >= 0) {
+        syscalls = quint64(m_syscalls);
+    } else {
+        syscalls = threadSyscallsSince(m_startSyscalls);
+    }
+    PerfStats::instance()->record(m_stage, ns, syscalls, allocs);
+}
+
+void PerfScope::setSyscalls(quint64 syscalls)
+{
+    m_syscalls = qint64(syscalls);
+}
+
+quint64 PerfScope::monotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000000000ull + quint64(ts.tv_nsec);
+}
+
+quint64 PerfScope::threadSyscalls()
+{
+    if (t_ioFile.fd == -2)
+        t_ioFile.fd = open(PROC_PATH_THREAD_IO, O_RDONLY | O_CLOEXEC);
+    if (t_ioFile.fd < 0)
+        return 0;
+
+    char buf[512];
+    ssize_t n = pread(t_ioFile.fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0)
+        return 0;
+    buf[n] = '\0';
+    return parseIoField(buf, "syscr:") + parseIoField(buf, "syscw:");
+}
+
+quint64 PerfScope::threadSyscallsSince(quint64 start)
+{
+    // the pread of the starting sample is only accounted in /proc after it returned, so the next sample
+    // counts it as issued by the measured code
+    static const quint64 kSampleReadSyscalls = 1;
+
+    quint64 now = threadSyscalls();
+    return now > start ? now - start - kSampleReadSyscalls : 0;
+}
+
+quint64 PerfScope::threadAllocs()
+{
+#ifdef PERF_COUNT_ALLOCS
+    return t_allocs;
+#else
+    return 0;
+#endif
+}
+
+} // namespace perf
+} // namespace common
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <QString>
+
+#include <atomic>
+
+namespace common {
+namespace perf {
+
+/**
+ * @brief Stages of a refresh tick
+ */
+enum PerfStage {
+    kStageCpuStats = 0, // CPUSet::read_stats
+    kStageBlockDevices, // BlockDeviceInfoDB::update
+    kStageNetifs, // NetifInfoDB::update
+    kStageProcessScan, // ProcessSet::scanProcess
+    kStageDKapture, // DKapture batch fetch
+    kStageSnapshot, // SystemSnapshot::capture
+    kStageModelDiff, // ProcessTableModel delta apply
+    kStagePaint, // process table paint
+
+    kStageCount
+};
+
+/**
+ * @brief Summary of one stage, durations in nanoseconds
+ */
+struct perf_stage_summary_t {
+    quint64 count;
+    quint64 sumNs;
+    quint64 maxNs;
+    quint64 p50Ns;
+    quint64 p90Ns;
+    quint64 p99Ns;
+    quint64 syscalls; // total over all runs
+    quint64 allocs; // total over all runs, 0 if allocations are not counted
+};
+
+/**
+ * @brief Lock free log-linear latency histogram
+ *
+ * Values are bucketed by their highest set bit, each power of 2 split into 8 linear sub buckets, so a
+ * recorded value is known within 12.5% over the whole 64 bit range.
+ */
+class PerfHistogram
+{
+public:
+    // sub buckets per power of 2, as a bit count
+    static const int kSubBits = 3;
+    static const int kSubCount = 1 << kSubBits;
+    static const int kBucketCount = (64 - kSubBits + 1) * kSubCount;
+
+    PerfHistogram();
+
+    void record(quint64 value);
+    void reset();
+
+    quint64 count() const;
+    quint64 sum() const;
+    quint64 max() const;
+
+    /**
+     * @brief Highest value of the bucket holding the given percentile
+     * @param percentile 0 ~ 100
+     */
+    quint64 percentile(double percentile) const;
+
+    static int bucketOf(quint64 value);
+    static quint64 bucketHighest(int bucket);
+
+private:
+    std::atomic<quint64> m_buckets[kBucketCount];
+    std::atomic<quint64> m_count;
+    std::atomic<quint64> m_sum;
+    std::atomic<quint64> m_max;
+};
+
+/**
+ * @brief Per stage latency histograms & syscall/allocation counters of the refresh ticks
+ *
+ * Recording is lock free, stages can be timed from the monitor thread & the GUI thread at the same time.
+ */
+class PerfStats
+{
+public:
+    static PerfStats *instance();
+
+    void record(PerfStage stage, quint64 ns, quint64 syscalls, quint64 allocs);
+    void reset();
+
+    perf_stage_summary_t summary(PerfStage stage) const;
+
+    /**
+     * @brief Plain text table of all stages, as dumped by --perf-report
+     */
+    QString report() const;
+
+    static const char *stageName(PerfStage stage);
+
+    /**
+     * @brief Whether allocations are counted, see PERF_COUNT_ALLOCS
+     */
+    static bool allocsCounted();
+
+private:
+    PerfStats();
+
+    PerfHistogram m_latency[kStageCount];
+    std::atomic<quint64> m_syscalls[kStageCount];
+    std::atomic<quint64> m_allocs[kStageCount];
+};
+
+/**
+ * @brief Times the enclosing scope into a stage with CLOCK_MONOTONIC
+ *
+ * Syscalls are the read & write syscalls of the calling thread (syscr + syscw of /proc/thread-self/io),
+ * stages fanning out to worker threads report their own count with setSyscalls().
+ */
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfStage stage);
+    ~PerfScope();
+
+    PerfScope(const PerfScope &) = delete;
+    PerfScope &operator=(const PerfScope &) = delete;
+
+    void setSyscalls(quint64 syscalls);
+
+    static quint64 monotonicNs();
+    // read & write syscalls issued by the calling thread so far, 0 if io accounting is not available
+    static quint64 threadSyscalls();
+    // syscalls issued by the calling thread since a threadSyscalls() sample, the sample's own read excluded
+    static quint64 threadSyscallsSince(quint64 start);
+    // allocations made by the calling thread so far, 0 if not counted
+    static quint64 threadAllocs();
+
+private:
+    PerfStage m_stage;
+    quint64 m_startNs;
+    quint64 m_startSyscalls;
+    quint64 m_startAllocs;
+    qint64 m_syscalls; // explicit count, -1 if sampled
+};
+
+} // namespace perf
+} // namespace common
+
+#endif // PERF_STATS_H
@@ -9,8 +9,9 @@
 #include "time_period.h"
 #include "common/common.h"
 
+#include <algorithm>
 #include <memory>
-#include <list>
+#include <vector>
 
 #include <sys/time.h>
 
@@ -276,43 +277,58 @@ public:
     qulonglong data;
 };
 
+/**
+ * @brief Fixed capacity history of sample frames
+ *
+ * Frames are stored by value in a ring buffer sized to the ticks of the time period,
+ * adding a sample overwrites the oldest frame once the buffer is full, so no allocation
+ * happens after the buffer filled up.
+ */
 template<typename T>
 class Sample
 {
 public:
     explicit Sample()
-        : m_samples {}
+        : m_frames {}
+        , m_head {0}
         , m_period {}
         , m_maxSamples {}
     {
         m_maxSamples = m_period.ticks();
+        m_frames.reserve(m_maxSamples);
     }
     explicit Sample(const TimePeriod &period)
-        : m_samples {}
+        : m_frames {}
+        , m_head {0}
         , m_period {period}
         , m_maxSamples {}
     {
         m_maxSamples = m_period.ticks();
+        m_frames.reserve(m_maxSamples);
     }
     Sample(const Sample &other)
-        : m_period(other.m_period)
+        : m_frames {}
+        , m_head {0}
+        , m_period(other.m_period)
         , m_maxSamples(other.m_maxSamples)
     {
-        for (auto &item : other.m_samples) {
-            m_samples.push_back(std::make_shared<SampleFrame<T>>(*item));
+        m_frames.reserve(m_maxSamples);
+        for (int i = 0; i < other.count(); ++i) {
+            m_frames.push_back(*other.sample(i));
         }
-        m_maxSamples = m_period.ticks();
     }
 
-    inline void addSample(SampleFrame<T> *frame)
+    inline void addSample(const SampleFrame<T> &frame)
     {
-        if (frame) {
-            if (m_samples.size() >= m_maxSamples)
-                m_samples.pop_front();
+        if (m_maxSamples == 0)
+            return;
 
-            std::shared_ptr<SampleFrame<T>> framePtr;
-            framePtr.reset(frame);
-            m_samples.push_back(framePtr);
+        if (m_frames.size() < m_maxSamples) {
+            // not wrapped yet, m_head stays at 0
+            m_frames.push_back(frame);
+        } else {
+            m_frames[m_head] = frame;
+            m_head = (m_head + 1) % m_frames.size();
         }
     }
 
@@ -323,55 +339,64 @@ public:
 
     inline const SampleFrame<T> *recentSample() const
     {
-        if (m_samples.size() > 0)
-            return m_samples.last().get();
-        else
-            return nullptr;
+        return sample(count() - 1);
     }
 
     inline void updateTimePeriod(const TimePeriod &newPeriod)
     {
         auto ticks = newPeriod.ticks();
-        auto old = m_period.ticks();
 
         if (timercmp(&newPeriod.interval(), &m_period.interval(), !=)) {
-            m_samples.clear();
-        } else if (ticks < old) {
-            while (m_samples.size() > ticks) {
-                m_samples.pop_front();
-            }
+            m_frames.clear();
+        } else {
+            // oldest frame first, then drop what does not fit in the new period
+            std::rotate(m_frames.begin(), m_frames.begin() + m_head, m_frames.end());
+            if (m_frames.size() > ticks)
+                m_frames.erase(m_frames.begin(), m_frames.begin() + (m_frames.size() - ticks));
         }
+        m_head = 0;
+        m_frames.reserve(ticks);
         m_maxSamples = ticks;
         m_period = newPeriod;
     }
 
+    /**
+     * @brief The two most recent frames, previous one first
+     */
     inline const QPair<const SampleFrame<T> *, const SampleFrame<T> *> recentSamplePair() const
     {
         QPair<const SampleFrame<T> *, const SampleFrame<T> *> pair {};
-        if (m_samples.size() > 0)
-            pair.first = m_samples[0].get();
-        if (m_samples.size() > 1)
-            pair.second = m_samples[1].get();
+        int n = count();
+        if (n > 1) {
+            pair.first = sample(n - 2);
+            pair.second = sample(n - 1);
+        } else if (n > 0) {
+            pair.first = sample(0);
+        }
         return pair;
     }
 
     inline int count() const
     {
-        return m_samples.size();
+        return int(m_frames.size());
     }
 
+    /**
+     * @brief Frame at index, 0 being the oldest one
+     */
     inline const SampleFrame<T> *sample(int index) const
     {
-        if (index >= 0 && index < m_samples.size()) {
-            return m_samples[index].get();
+        if (index >= 0 && index < count()) {
+            return &m_frames[(m_head + size_t(index)) % m_frames.size()];
         }
 
         return nullptr;
     }
 
 private:
-    // TODO: replace with circular buffer impl. (ref: boost/circular_buffer)
-    QList<std::shared_ptr<SampleFrame<T>>> m_samples;
+    // ring buffer, m_head is the index of the oldest frame once the buffer is full
+    std::vector<SampleFrame<T>> m_frames;
+    size_t m_head;
     TimePeriod m_period;
     size_t m_maxSamples;
 };
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "source_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace common {
+namespace source {
+
+static SourceReader s_defaultReader;
+static SourceReader *s_reader = &s_defaultReader;
+
+SourceReader::~SourceReader()
+{
+}
+
+int SourceReader::open(const char *path)
+{
+    return ::open(path, O_RDONLY | O_CLOEXEC);
+}
+
+ssize_t SourceReader::pread(int handle, void *buf, size_t size, off_t offset)
+{
+    return ::pread(handle, buf, size, offset);
+}
+
+void SourceReader::close(int handle)
+{
+    // keep errno of a failed read for the caller
+    int err = errno;
+    ::close(handle);
+    errno = err;
+}
+
+void setReader(SourceReader *reader)
+{
+    s_reader = reader ? reader : &s_defaultReader;
+}
+
+SourceReader *reader()
+{
+    return s_reader;
+}
+
+} // namespace source
+} // namespace common
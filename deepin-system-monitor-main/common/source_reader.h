@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOURCE_READER_H
+#define SOURCE_READER_H
+
+#include <sys/types.h>
+
+namespace common {
+namespace source {
+
+/**
+ * @brief File access of the procfs & sysfs files collectors keep open & re-read on each update
+ *
+ * The default reader is plain open/pread/close. Another implementation (batched reads, a shared memory
+ * source, canned data for tests ...) can be installed with setReader() before the monitor threads start.
+ * Paths given to open() are already resolved under the configured roots.
+ */
+class SourceReader
+{
+public:
+    virtual ~SourceReader();
+
+    /**
+     * @return handle of the opened file, -1 with errno set on failure
+     */
+    virtual int open(const char *path);
+    /**
+     * @return same as pread(), errno set on failure
+     */
+    virtual ssize_t pread(int handle, void *buf, size_t size, off_t offset);
+    virtual void close(int handle);
+};
+
+/**
+ * @brief Install reader, nullptr restores the default one
+ *
+ * reader is not owned & must outlive all collectors. Handles are not portable between readers.
+ */
+void setReader(SourceReader *reader);
+
+SourceReader *reader();
+
+} // namespace source
+} // namespace common
+
+#endif // SOURCE_READER_H
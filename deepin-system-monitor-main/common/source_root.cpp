@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "source_root.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace common {
+namespace source {
+
+static QByteArray s_procRoot {SOURCE_PROC_ROOT};
+static QByteArray s_sysRoot {SOURCE_SYS_ROOT};
+static bool s_redirected {false};
+
+// length of the default root hostPath starts with, 0 if none
+static size_t hostPrefix(const char *hostPath, const QByteArray **root)
+{
+    static const size_t procLen = strlen(SOURCE_PROC_ROOT);
+    static const size_t sysLen = strlen(SOURCE_SYS_ROOT);
+
+    if (!strncmp(hostPath, SOURCE_PROC_ROOT, procLen) && (hostPath[procLen] == '/' || hostPath[procLen] == '\0')) {
+        *root = &s_procRoot;
+        return procLen;
+    }
+    if (!strncmp(hostPath, SOURCE_SYS_ROOT, sysLen) && (hostPath[sysLen] == '/' || hostPath[sysLen] == '\0')) {
+        *root = &s_sysRoot;
+        return sysLen;
+    }
+    return 0;
+}
+
+static QByteArray normalizedRoot(const QByteArray &root, const char *fallback)
+{
+    QByteArray normalized = root;
+    while (normalized.size() > 1 && normalized.endsWith('/'))
+        normalized.chop(1);
+    return normalized.isEmpty() ? QByteArray(fallback) : normalized;
+}
+
+void setProcRoot(const QByteArray &root)
+{
+    s_procRoot = normalizedRoot(root, SOURCE_PROC_ROOT);
+    s_redirected = s_procRoot != SOURCE_PROC_ROOT || s_sysRoot != SOURCE_SYS_ROOT;
+}
+
+void setSysRoot(const QByteArray &root)
+{
+    s_sysRoot = normalizedRoot(root, SOURCE_SYS_ROOT);
+    s_redirected = s_procRoot != SOURCE_PROC_ROOT || s_sysRoot != SOURCE_SYS_ROOT;
+}
+
+const QByteArray &procRoot()
+{
+    return s_procRoot;
+}
+
+const QByteArray &sysRoot()
+{
+    return s_sysRoot;
+}
+
+bool isRedirected()
+{
+    return s_redirected;
+}
+
+QByteArray path(const char *hostPath)
+{
+    const QByteArray *root = nullptr;
+    size_t prefix = s_redirected ? hostPrefix(hostPath, &root) : 0;
+    if (prefix == 0)
+        return QByteArray(hostPath);
+    return *root + (hostPath + prefix);
+}
+
+int formatPath(char *buf, size_t size, const char *fmt, ...)
+{
+    const QByteArray *root = nullptr;
+    size_t prefix = s_redirected ? hostPrefix(fmt, &root) : 0;
+
+    int len = 0;
+    if (prefix > 0) {
+        len = snprintf(buf, size, "%s", root->constData());
+        if (len < 0)
+            return len;
+        // root truncated, only the length of the rest is computed
+        size_t used = qMin(size_t(len), size);
+        buf = used < size ? buf + used : nullptr;
+        size = buf ? size - used : 0;
+    }
+
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, size, fmt + prefix, ap);
+    va_end(ap);
+    return n < 0 ? n : len + n;
+}
+
+} // namespace source
+} // namespace common
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOURCE_ROOT_H
+#define SOURCE_ROOT_H
+
+#include <QByteArray>
+
+#include <stddef.h>
+
+namespace common {
+
+/**
+ * @brief Root directories procfs & sysfs are read from
+ *
+ * Collectors name their files by host path ("/proc/stat", "/sys/block", ...) and resolve them here, so that
+ * the trees of a snapshot, a container or a chroot can be read in place of the host's. Roots must be set
+ * before the monitor threads start.
+ */
+namespace source {
+
+// default roots
+#define SOURCE_PROC_ROOT "/proc"
+#define SOURCE_SYS_ROOT "/sys"
+
+void setProcRoot(const QByteArray &root);
+void setSysRoot(const QByteArray &root);
+
+const QByteArray &procRoot();
+const QByteArray &sysRoot();
+
+/**
+ * @brief Whether either root differs from the host's
+ */
+bool isRedirected();
+
+/**
+ * @brief Resolve a host "/proc/..." or "/sys/..." path under the configured roots
+ */
+QByteArray path(const char *hostPath);
+
+/**
+ * @brief snprintf() of a host path format under the configured roots
+ * @return same as snprintf()
+ */
+int formatPath(char *buf, size_t size, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+} // namespace source
+} // namespace common
+
+#endif // SOURCE_ROOT_H
@@ -33,7 +33,8 @@ using namespace common::format;
 using namespace DDLog;
 
 const int gridSize = 10;
-const int pointsNumber = 30;
+// one point per tick over a minute
+const int pointsNumber = SystemMonitor::ticks(60);
 CompactDiskMonitor::CompactDiskMonitor(QWidget *parent)
     : QWidget(parent)
 {
@@ -34,7 +34,8 @@ using namespace common::format;
 using namespace DDLog;
 
 const int gridSize = 10;
-const int pointsNumber = 30;
+// one point per tick over a minute
+const int pointsNumber = SystemMonitor::ticks(60);
 CompactNetworkMonitor::CompactNetworkMonitor(QWidget *parent)
     : QWidget(parent)
 {
@@ -6,6 +6,7 @@
 #include "dbus_object.h"
 #include "gui/main_window.h"
 #include "application.h"
+#include "common/perf_stats.h"
 #include "ddlog.h"
 #include <QDBusConnection>
 #include <QDebug>
@@ -59,6 +60,27 @@ void DBusObject::unRegister()
     internalMutex.unlock();
 }
 
+bool DBusObject::queryPerfReport(QString &report)
+{
+    QDBusInterface iface(DBUS_SERVER, DBUS_SERVER_PATH, DBUS_SERVER, QDBusConnection::sessionBus());
+    if (!iface.isValid()) {
+        qCWarning(app) << "No running instance to query perf report from";
+        return false;
+    }
+    QDBusReply<QString> reply = iface.call(QDBus::Block, "perfReport");
+    if (!reply.isValid()) {
+        qCWarning(app) << "Failed to query perf report:" << reply.error().message();
+        return false;
+    }
+    report = reply.value();
+    return true;
+}
+
+QString DBusObject::perfReport()
+{
+    return common::perf::PerfStats::instance()->report();
+}
+
 void DBusObject::handleWindow()
 {
     internalMutex.lockForRead();
@@ -34,6 +34,13 @@ public:
      */
     void unRegister();
 
+    /**
+     * @brief queryPerfReport
+     * 从已经运行的实例获取刷新各阶段的性能统计
+     * @param report 统计报告
+     * @return 没有运行的实例或调用失败时返回false
+     */
+    bool queryPerfReport(QString &report);
 
 public slots:
     /**
@@ -42,6 +49,12 @@ public slots:
      */
     Q_SCRIPTABLE void handleWindow();
 
+    /**
+     * @brief perfReport
+     * DBus接口, 返回刷新各阶段的耗时分布及系统调用、内存分配次数
+     */
+    Q_SCRIPTABLE QString perfReport();
+
 private:
     DBusObject(QObject *parent = nullptr);
     ~DBusObject();
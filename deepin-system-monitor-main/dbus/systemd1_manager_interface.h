@@ -281,6 +281,28 @@ public Q_SLOTS:  // METHODS
         return {ec, state};
     }
 
+    /**
+     * @brief Subscribe Ask systemd to emit UnitNew/UnitRemoved & unit PropertiesChanged signals to this client
+     * @return Error context
+     */
+    inline ErrorContext Subscribe()
+    {
+        // error context
+        ErrorContext ec;
+
+        // dbus interface method call: Subscribe
+        QDBusMessage reply = callWithArgumentList(QDBus::Block, "Subscribe", {});
+        // check dbus reply
+        if (reply.type() == QDBusMessage::ErrorMessage) {
+            ec.setCode(ErrorContext::kErrorTypeDBus);
+            ec.setSubCode(lastError().type());
+            ec.setErrorName(reply.errorName());
+            ec.setErrorMessage(reply.errorMessage());
+        }
+
+        return ec;
+    }
+
     // =========================================================================
     // TODO: half baked!!
     // call callWithArgumentList directly without calling CheckAuthorization
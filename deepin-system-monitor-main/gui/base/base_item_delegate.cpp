@@ -224,29 +224,30 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
         // Qt的QIcon::pixmap()接口返回QPixmap对象的内存不会回收，此处使用QPixmapCache类来管理进程图标内存资源
         // 原有QPixmapCache::find接口返回的pixmap指针为空，改为返回pixmap引用对象，保证能根据进程名从缓存中获取到图标资源
         // https://pms.uniontech.com/bug-view-239575.html
-        const QString &procName = index.data(Qt::UserRole + 4).toString();
+        // 进程图标按内容共享, 同一程序的所有进程(如浏览器的各个子进程)使用同一个缓存的pixmap
+        const QString &iconKey = QString("%1_%2x%3").arg(icon.cacheKey()).arg(iconRect.width()).arg(iconRect.height());
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
         QPixmap iconPixmap;
-        core::process::ProcessIconCache::instance()->iconPixmapCache.find(procName, iconPixmap);
+        core::process::ProcessIconCache::instance()->iconPixmapCache.find(iconKey, iconPixmap);
         if (!iconPixmap.isNull()) {
-            // qCDebug(app) << "BaseItemDelegate paint: Drawing icon from cache for process" << procName;
+            // qCDebug(app) << "BaseItemDelegate paint: Drawing icon from cache for process" << iconKey;
             painter->drawPixmap(iconRect, iconPixmap);
         } else {
-            // qCDebug(app) << "BaseItemDelegate paint: Icon not in cache, generating and drawing for process" << procName;
+            // qCDebug(app) << "BaseItemDelegate paint: Icon not in cache, generating and drawing for process" << iconKey;
             const QPixmap &iconPix = icon.pixmap(iconRect.size());
-            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(procName, iconPix);
+            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(iconKey, iconPix);
             painter->drawPixmap(iconRect, iconPix);
         }
 #else
         QPixmap iconPixmap;
-        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(procName, &iconPixmap)) {
-            // qCDebug(app) << "BaseItemDelegate paint: Drawing icon from cache for process" << procName;
+        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(iconKey, &iconPixmap)) {
+            // qCDebug(app) << "BaseItemDelegate paint: Drawing icon from cache for process" << iconKey;
             painter->drawPixmap(iconRect, iconPixmap);
         } else {
-            // qCDebug(app) << "BaseItemDelegate paint: Icon not in cache, generating and drawing for process" << procName;
+            // qCDebug(app) << "BaseItemDelegate paint: Icon not in cache, generating and drawing for process" << iconKey;
             const QPixmap &iconPix = icon.pixmap(iconRect.size());
-            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(procName, iconPix);
+            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(iconKey, iconPix);
             painter->drawPixmap(iconRect, iconPix);
         }
 #endif
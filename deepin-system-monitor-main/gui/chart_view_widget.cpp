@@ -5,6 +5,7 @@
 
 #include "chart_view_widget.h"
 #include "common/common.h"
+#include "system/system_monitor.h"
 #include "ddlog.h"
 
 #include <QPainter>
@@ -16,11 +17,13 @@
 #include <DApplication>
 #include <DFontSizeManager>
 
+using namespace core::system;
 using namespace common::format;
 using namespace DDLog;
 
 DWIDGET_USE_NAMESPACE
-const int allDatacount = 30;
+// one point per tick over the 60 seconds shown
+const int allDatacount = SystemMonitor::ticks(60);
 ChartViewWidget::ChartViewWidget(ChartViewTypes types, QWidget *parent) : QWidget(parent), m_viewType(types)
 {
     qCDebug(app) << "ChartViewWidget constructor, type:" << m_viewType;
@@ -12,6 +12,7 @@
 #include "model/cpu_info_model.h"
 #include "model/cpu_list_model.h"
 #include "system/cpu_set.h"
+#include "system/system_monitor.h"
 #include "cpu_summary_view_widget.h"
 #include "ddlog.h"
 
@@ -42,6 +43,10 @@ DWIDGET_USE_NAMESPACE
 
 using namespace common;
 using namespace DDLog;
+using namespace core::system;
+
+// one point per tick over the 60 seconds shown
+const int historyCount = SystemMonitor::ticks(60);
 
 CPUDetailGrapTableItem::CPUDetailGrapTableItem(CPUInfoModel *model, int index, QWidget *parent): QWidget(parent), m_cpuInfomodel(model), m_index(index)
 {
@@ -99,7 +104,7 @@ void CPUDetailGrapTableItem::updateStat()
             m_cpuPercents.insert(0, m_cpuInfomodel->cpuAllPercent() / 100.0);
         }
     }
-    while (m_cpuPercents.count() > 31)
+    while (m_cpuPercents.count() > historyCount + 1)
         m_cpuPercents.pop_back();
 
     update();
@@ -180,9 +185,9 @@ void CPUDetailGrapTableItem::drawNormalMode(QPainter &painter)
         QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
         Painterpath.moveTo(sp);
 
-        for (int i = 0; i < 30; ++i) {
+        for (int i = 0; i < historyCount; ++i) {
             if (m_cpuPercents.count() > i) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
+                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (static_cast<double>(historyCount) / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
                 QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
                 QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
                 Painterpath.cubicTo(c1, c2, ep);
@@ -215,9 +220,9 @@ void CPUDetailGrapTableItem::drawSimpleMode(QPainter &painter)
         QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
         Painterpath.moveTo(sp);
 
-        for (int i = 0; i < 30; ++i) {
+        for (int i = 0; i < historyCount; ++i) {
             if (m_cpuPercents.count() > i) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
+                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (static_cast<double>(historyCount) / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
                 QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
                 QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
                 Painterpath.cubicTo(c1, c2, ep);
@@ -296,9 +301,9 @@ void CPUDetailGrapTableItem::drawSingleCoreMode(QPainter &painter)
         QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
         Painterpath.moveTo(sp);
 
-        for (int i = 0; i < 30; ++i) {
+        for (int i = 0; i < historyCount; ++i) {
             if (m_cpuPercents.count() > 0) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(1)) * graphicRect.height() + graphicRect.y());
+                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (static_cast<double>(historyCount) / static_cast<double>(1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(1)) * graphicRect.height() + graphicRect.y());
                 QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
                 QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
                 Painterpath.cubicTo(c1, c2, ep);
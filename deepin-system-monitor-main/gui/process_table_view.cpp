@@ -18,6 +18,7 @@
 #include "toolbar.h"
 #include "ui_common.h"
 #include "common/perf.h"
+#include "common/perf_stats.h"
 #include "common/common.h"
 #include "common/error_context.h"
 #include "model/process_sort_filter_proxy_model.h"
@@ -58,9 +59,10 @@
 
 using namespace DDLog;
 using namespace common::init;
+using namespace common::perf;
 
 // process table view backup setting key
-const QByteArray header_version = "_1.0.0";
+const QByteArray header_version = "_1.1.0";
 static const char *kSettingsOption_ProcessTableHeaderState = "process_table_header_state";
 static const char *kSettingsOption_ProcessTableHeaderStateOfUserMode = "process_table_header_state_user";
 /**
@@ -78,6 +80,9 @@ ProcessTableView::ProcessTableView(DWidget *parent, QString userName)
     m_model = new ProcessTableModel(this, userName);
     m_proxyModel = new ProcessSortFilterProxyModel(this);
     m_proxyModel->setSourceModel(m_model);
+    // sort once per scan instead of once per changed row, connected before any other modelUpdated handler
+    connect(m_model, &ProcessTableModel::modelAboutToBeUpdated, m_proxyModel, &ProcessSortFilterProxyModel::beginBatchUpdate);
+    connect(m_model, &ProcessTableModel::modelUpdated, m_proxyModel, &ProcessSortFilterProxyModel::endBatchUpdate);
     // setModel must be called before calling loadSettings();
     setModel(m_proxyModel);
     // load process table view backup settings
@@ -85,6 +90,8 @@ ProcessTableView::ProcessTableView(DWidget *parent, QString userName)
     // initialize ui components & connections
     initUI(settingsLoaded);
     initConnections(settingsLoaded);
+    updateNetworkStatsDemand();
+    updateGpuStatsDemand();
     // adjust search result tip label text color dynamically on theme type change
     onThemeTypeChanged();
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -110,6 +117,8 @@ ProcessTableView::~ProcessTableView()
     qCDebug(app) << "ProcessTableView destroyed";
     // backup table view settings
     saveSettings();
+    ProcessDB::instance()->processSet()->sockInodeScan().setWanted(this, false);
+    ProcessDB::instance()->processSet()->drmClientScan().setWanted(this, false);
 }
 
 void ProcessTableView::onThemeTypeChanged()
@@ -615,6 +624,14 @@ void ProcessTableView::initUI(bool settingsLoaded)
         setColumnWidth(ProcessTableModel::kProcessPriorityColumn, 100);
         setColumnHidden(ProcessTableModel::kProcessPriorityColumn, true);
 
+        // gpu
+        setColumnWidth(ProcessTableModel::kProcessGPUColumn, 70);
+        setColumnHidden(ProcessTableModel::kProcessGPUColumn, true);
+
+        // gpu memory
+        setColumnWidth(ProcessTableModel::kProcessGPUMemoryColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessGPUMemoryColumn, true);
+
         //sort
         sortByColumn(ProcessTableModel::kProcessCPUColumn, Qt::DescendingOrder);
     }
@@ -783,7 +800,11 @@ void ProcessTableView::initConnections(bool settingsLoaded)
     auto *h = header();
     connect(h, &QHeaderView::sectionResized, this, [=]() { saveSettings(); });
     connect(h, &QHeaderView::sectionMoved, this, [=]() { saveSettings(); });
-    connect(h, &QHeaderView::sortIndicatorChanged, this, [=]() { saveSettings(); });
+    connect(h, &QHeaderView::sortIndicatorChanged, this, [=]() {
+        saveSettings();
+        updateNetworkStatsDemand();
+        updateGpuStatsDemand();
+    });
     connect(h, &QHeaderView::customContextMenuRequested, this,
             &ProcessTableView::displayProcessTableHeaderContextMenu);
 
@@ -839,6 +860,7 @@ void ProcessTableView::initConnections(bool settingsLoaded)
     connect(uploadHeaderAction, &QAction::triggered, this, [this](bool b) {
         header()->setSectionHidden(ProcessTableModel::kProcessUploadColumn, !b);
         saveSettings();
+        updateNetworkStatsDemand();
         Q_EMIT signalHeadchanged();
     });
     // download rate action
@@ -848,6 +870,7 @@ void ProcessTableView::initConnections(bool settingsLoaded)
     connect(downloadHeaderAction, &QAction::triggered, this, [this](bool b) {
         header()->setSectionHidden(ProcessTableModel::kProcessDownloadColumn, !b);
         saveSettings();
+        updateNetworkStatsDemand();
         Q_EMIT signalHeadchanged();
     });
     // disk read rate action
@@ -892,6 +915,24 @@ void ProcessTableView::initConnections(bool settingsLoaded)
         header()->setSectionHidden(ProcessTableModel::kProcessPriorityColumn, !b);
         saveSettings();
     });
+    // gpu action
+    auto *gpuHeaderAction = m_headerContextMenu->addAction(
+            DApplication::translate("Process.Table.Header", kProcessGPU));
+    gpuHeaderAction->setCheckable(true);
+    connect(gpuHeaderAction, &QAction::triggered, this, [this](bool b) {
+        header()->setSectionHidden(ProcessTableModel::kProcessGPUColumn, !b);
+        saveSettings();
+        updateGpuStatsDemand();
+    });
+    // gpu memory action
+    auto *gpuMemHeaderAction = m_headerContextMenu->addAction(
+            DApplication::translate("Process.Table.Header", kProcessGPUMemory));
+    gpuMemHeaderAction->setCheckable(true);
+    connect(gpuMemHeaderAction, &QAction::triggered, this, [this](bool b) {
+        header()->setSectionHidden(ProcessTableModel::kProcessGPUMemoryColumn, !b);
+        saveSettings();
+        updateGpuStatsDemand();
+    });
 
     // set default header context menu checkable state when settings load without success
     if (!settingsLoaded) {
@@ -907,6 +948,8 @@ void ProcessTableView::initConnections(bool settingsLoaded)
         pidHeaderAction->setChecked(true);
         niceHeaderAction->setChecked(true);
         priorityHeaderAction->setChecked(true);
+        gpuHeaderAction->setChecked(false);
+        gpuMemHeaderAction->setChecked(false);
     }
     // set header context menu checkable state based on current header section's visible state before popup
     connect(m_headerContextMenu, &QMenu::aboutToShow, this, [=]() {
@@ -935,6 +978,10 @@ void ProcessTableView::initConnections(bool settingsLoaded)
         priorityHeaderAction->setChecked(!b);
         b = header()->isSectionHidden(ProcessTableModel::kProcessUserColumn);
         userHeaderAction->setChecked(!b);
+        b = header()->isSectionHidden(ProcessTableModel::kProcessGPUColumn);
+        gpuHeaderAction->setChecked(!b);
+        b = header()->isSectionHidden(ProcessTableModel::kProcessGPUMemoryColumn);
+        gpuMemHeaderAction->setChecked(!b);
     });
 
     // on each model update, we restore settings, adjust search result tip lable's visibility & positon, select the same process item before update if any
@@ -1029,6 +1076,13 @@ void ProcessTableView::resizeEvent(QResizeEvent *event)
     DTreeView::resizeEvent(event);
 }
 
+// paint event handler
+void ProcessTableView::paintEvent(QPaintEvent *event)
+{
+    PerfScope perfScope(kStagePaint);
+    BaseTableView::paintEvent(event);
+}
+
 // show event handler
 void ProcessTableView::showEvent(QShowEvent *)
 {
@@ -1037,6 +1091,15 @@ void ProcessTableView::showEvent(QShowEvent *)
     if (m_notFoundLabel) {
         m_notFoundLabel->hide();
     }
+    m_shown = true;
+    updateNetworkStatsDemand();
+}
+
+// hide event handler
+void ProcessTableView::hideEvent(QHideEvent *)
+{
+    m_shown = false;
+    updateNetworkStatsDemand();
 }
 
 // backup current selected item's pid when selection changed
@@ -1064,6 +1127,30 @@ int ProcessTableView::sizeHintForColumn(int column) const
                     DTreeView::sizeHintForColumn(column) + margin * 2);
 }
 
+// socket inodes are only discovered while some view needs per process network stats
+void ProcessTableView::updateNetworkStatsDemand()
+{
+    int sortColumn = header()->sortIndicatorSection();
+    // the user page summarizes upload & download of the user's processes whatever columns are shown, while on screen
+    bool wanted = (!m_useModeName.isNull() && m_shown)
+                  || !header()->isSectionHidden(ProcessTableModel::kProcessUploadColumn)
+                  || !header()->isSectionHidden(ProcessTableModel::kProcessDownloadColumn)
+                  || sortColumn == ProcessTableModel::kProcessUploadColumn
+                  || sortColumn == ProcessTableModel::kProcessDownloadColumn;
+    ProcessDB::instance()->processSet()->sockInodeScan().setWanted(this, wanted);
+}
+
+// DRM fds are only read while some view needs per process gpu stats
+void ProcessTableView::updateGpuStatsDemand()
+{
+    int sortColumn = header()->sortIndicatorSection();
+    bool wanted = !header()->isSectionHidden(ProcessTableModel::kProcessGPUColumn)
+                  || !header()->isSectionHidden(ProcessTableModel::kProcessGPUMemoryColumn)
+                  || sortColumn == ProcessTableModel::kProcessGPUColumn
+                  || sortColumn == ProcessTableModel::kProcessGPUMemoryColumn;
+    ProcessDB::instance()->processSet()->drmClientScan().setWanted(this, wanted);
+}
+
 // adjust search result tip label's visibility & position
 void ProcessTableView::adjustInfoLabelVisibility()
 {
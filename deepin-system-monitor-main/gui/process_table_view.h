@@ -152,11 +152,22 @@ protected:
      */
     void resizeEvent(QResizeEvent *event) override;
 
+    /**
+     * @brief paintEvent Paint event handler, timed as the paint stage of a refresh
+     * @param event Paint event
+     */
+    void paintEvent(QPaintEvent *event) override;
+
     /**
      * @brief Show event handler
      * @param event Show event
      */
     void showEvent(QShowEvent *event) override;
+    /**
+     * @brief Hide event handler
+     * @param event Hide event
+     */
+    void hideEvent(QHideEvent *event) override;
 
     /**
      * @brief selectionChanged Selection changed event handler
@@ -177,6 +188,14 @@ private:
      * @brief Adjust search result tip label's position & visibility
      */
     void adjustInfoLabelVisibility();
+    /**
+     * @brief Tell the process scan whether this view shows, sorts by or sums up (user mode, while shown) network stats
+     */
+    void updateNetworkStatsDemand();
+    /**
+     * @brief Tell the process scan whether this view shows or sorts by GPU columns
+     */
+    void updateGpuStatsDemand();
     /**
      * @brief Customize process priority handler
      */
@@ -220,6 +239,8 @@ private:
 
     //User mode User Name
     QString m_useModeName {};
+    // Shown on screen, between showEvent & hideEvent
+    bool m_shown {};
     qreal m_cpuUsage {};
     qreal m_memUsage {};
     qreal m_download {};
@@ -10,6 +10,7 @@
 #include "settings.h"
 #include "gui/main_window.h"
 #include "common/perf.h"
+#include "common/source_root.h"
 #include "dbus/dbus_object.h"
 #include "dbus/dbusalarmnotify.h"
 #include "3rdparty/dmidecode/dmidecode.h"
@@ -29,6 +30,8 @@
 #include <QAccessible>
 #include <QTimer>
 #include <signal.h>
+#include <stdio.h>
+#include <string.h>
 #include "logger.h"
 DWIDGET_USE_NAMESPACE
 DCORE_USE_NAMESPACE
@@ -45,6 +48,33 @@ void signalHandler(int signal)
     }
 }
 
+// --proc-root & --sys-root are applied before the application is created, the monitor thread opens its
+// sources on construction. The options are declared again on the parser so that they are accepted there.
+static void applySourceRoots(int argc, char *argv[])
+{
+    static const struct {
+        const char *option;
+        void (*apply)(const QByteArray &root);
+    } roots[] = {
+        {"--proc-root", common::source::setProcRoot},
+        {"--sys-root", common::source::setSysRoot},
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        for (const auto &root : roots) {
+            size_t len = strlen(root.option);
+            if (strncmp(argv[i], root.option, len))
+                continue;
+            if (argv[i][len] == '=')
+                root.apply(QByteArray(argv[i] + len + 1));
+            else if (argv[i][len] == '\0' && i + 1 < argc)
+                root.apply(QByteArray(argv[++i]));
+        }
+    }
+    if (common::source::isRedirected())
+        qCInfo(DDLog::app) << "Reading procfs from" << common::source::procRoot() << "and sysfs from" << common::source::sysRoot();
+}
+
 int main(int argc, char *argv[])
 {
     MLogger();   // 日志处理要放在app之前，否则QApplication
@@ -67,6 +97,7 @@ int main(int argc, char *argv[])
         setenv("XDG_CURRENT_DESKTOP", "Deepin", 1);
     }
 
+    applySourceRoots(argc, argv);
     Application::setAttribute(Qt::AA_UseHighDpiPixmaps, true);
     Application app(argc, argv);
     g_app = &app;
@@ -76,7 +107,23 @@ int main(int argc, char *argv[])
     
     qCDebug(DDLog::app) << "Application object created";
     QCommandLineParser parser;
+    QCommandLineOption perfReportOption("perf-report", "Print refresh stage timings of the running instance and exit.");
+    parser.addOption(perfReportOption);
+    QCommandLineOption procRootOption("proc-root", "Read procfs from <dir> instead of /proc, e.g. the /proc of a container.", "dir");
+    parser.addOption(procRootOption);
+    QCommandLineOption sysRootOption("sys-root", "Read sysfs from <dir> instead of /sys.", "dir");
+    parser.addOption(sysRootOption);
     parser.process(app);
+    if (parser.isSet(perfReportOption)) {
+        qCDebug(DDLog::app) << "Perf report requested, querying running instance.";
+        QString report;
+        if (!DBusObject::getInstance().queryPerfReport(report)) {
+            fputs("Failed to query the running deepin-system-monitor instance\n", stderr);
+            return 1;
+        }
+        fputs(qPrintable(report), stdout);
+        return 0;
+    }
     QStringList allArguments = parser.positionalArguments();
     if (allArguments.size() == 3 && allArguments.first().compare("alarm", Qt::CaseInsensitive) == 0) {
         qCDebug(DDLog::app) << "Alarm command detected, showing notification and exiting.";
@@ -41,7 +41,7 @@ QString CPUInfoModel::uptime() const
 {
     qCDebug(app) << "CPUInfoModel::uptime()";
     QString buffer;
-    time_t uptime = m_sysInfo->uptime().tv_sec;
+    time_t uptime = m_snapshot ? m_snapshot->uptime().tv_sec : m_sysInfo->uptime().tv_sec;
     long days = uptime / 86400;
     long hours = (uptime - days * 86400) / 3600;
     long mins = (uptime - days * 86400 - hours * 3600) / 60;
@@ -68,30 +68,30 @@ CPUSet *CPUInfoModel::cpuSet()
 void CPUInfoModel::updateModel()
 {
     qCDebug(app) << "CPUInfoModel::updateModel()";
-    m_overallStatSample->addSample(new CPUStatSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*m_cpuSet->stat())));
+    // all samples of an update come from the same tick
+    SystemSnapshotPtr snapshot = SystemMonitor::instance()->snapshot();
+    if (!snapshot) {
+        qCDebug(app) << "No snapshot published yet";
+        return;
+    }
+    m_snapshot = snapshot;
+    const timeval &uptime = snapshot->uptime();
+
+    m_overallStatSample->addSample(CPUStatSampleFrame(uptime, std::make_shared<struct cpu_stat_t>(snapshot->cpuStat())));
 
-    m_overallUsageSample->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usage())));
+    m_overallUsageSample->addSample(CPUUsageSampleFrame(uptime, std::make_shared<struct cpu_usage_t>(snapshot->cpuUsage())));
 
-    m_loadAvgSampleDB->addSample(new LoadAvgSampleFrame(m_sysInfo->uptime(), std::make_shared<struct load_avg_t>(*m_sysInfo->loadAvg())));
+    m_loadAvgSampleDB->addSample(LoadAvgSampleFrame(uptime, std::make_shared<struct load_avg_t>(snapshot->loadAvg())));
 
-    for (auto &cpuname : m_cpuSet->cpuLogicName()) {
-        if (m_singleUsageSample.contains(cpuname)) {
-            m_singleUsageSample[cpuname]->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
+    for (const cpu_usage_t &usage : snapshot->cpuUsages()) {
+        if (m_singleUsageSample.contains(usage.cpu)) {
+            m_singleUsageSample[usage.cpu]->addSample(CPUUsageSampleFrame(uptime, std::make_shared<struct cpu_usage_t>(usage)));
         } else {
-            // qCDebug(app) << "Creating new usage sample for cpu:" << cpuname;
+            // qCDebug(app) << "Creating new usage sample for cpu:" << usage.cpu;
             auto smaple = std::make_shared<Sample<cpu_usage_t>>(m_period);
-            smaple->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
-            m_singleUsageSample.insert(cpuname, smaple);
+            smaple->addSample(CPUUsageSampleFrame(uptime, std::make_shared<struct cpu_usage_t>(usage)));
+            m_singleUsageSample.insert(usage.cpu, smaple);
         }
-
-//        auto model = std::make_shared<CPUStatModel>(m_period, this);
-//        if (model && model->m_statSampleDB)
-//            model->m_statSampleDB->addSample(new CPUStatSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*m_cpuSet->statDB(cpuname))));
-
-//        if (model && model->m_usageSampleDB)
-//            model->m_usageSampleDB->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
-
-//        m_cpuListModel->m_statModelDB[info.logicalName()] = model;
     } // ::for
 
     emit modelUpdated();
@@ -120,26 +120,29 @@ QString CPUInfoModel::loadavg() const
 {
     // qCDebug(app) << "CPUInfoModel::loadavg()";
     QString buffer {};
-    buffer << *m_sysInfo->loadAvg();
+    if (m_snapshot)
+        buffer << m_snapshot->loadAvg();
+    else
+        buffer << *m_sysInfo->loadAvg();
     return buffer;
 }
 
 uint CPUInfoModel::nProcesses() const
 {
     // qCDebug(app) << "CPUInfoModel::nProcesses()";
-    return m_sysInfo->nprocesses();
+    return m_snapshot ? m_snapshot->nprocesses() : m_sysInfo->nprocesses();
 }
 
 uint CPUInfoModel::nThreads() const
 {
     // qCDebug(app) << "CPUInfoModel::nThreads()";
-    return m_sysInfo->nthreads();
+    return m_snapshot ? m_snapshot->nthreads() : m_sysInfo->nthreads();
 }
 
 uint CPUInfoModel::nFileDescriptors() const
 {
     // qCDebug(app) << "CPUInfoModel::nFileDescriptors()";
-    return m_sysInfo->nfds();
+    return m_snapshot ? m_snapshot->nfds() : m_sysInfo->nfds();
 }
 
 QString CPUInfoModel::hostname() const
@@ -9,6 +9,7 @@
 #include "common/sample.h"
 #include "common/common.h"
 #include "system/sys_info.h"
+#include "system/system_snapshot.h"
 #include "cpu_stat_model.h"
 
 #include <QObject>
@@ -91,6 +92,8 @@ private:
 
     SysInfo *m_sysInfo;
     CPUSet *m_cpuSet;
+    // tick the samples were last taken from, values shown between two ticks come from it too
+    SystemSnapshotPtr m_snapshot;
 };
 
 #endif // CPU_INFO_MODEL_H
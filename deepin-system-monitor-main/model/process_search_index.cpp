@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_search_index.h"
+#include "process/process.h"
+#include "common/han_latin.h"
+
+#include <QLocale>
+
+using namespace core::process;
+
+// converted names kept, the cache is dropped when it grows past this
+#define PINYIN_CACHE_MAX 4096
+
+static bool containsHan(const QString &text)
+{
+    for (const QChar &c : text) {
+        if (c.script() == QChar::Script_Han)
+            return true;
+    }
+    return false;
+}
+
+static QString removeSpaces(const QString &text)
+{
+    QString buf;
+    buf.reserve(text.size());
+    for (const QChar &c : text) {
+        if (!c.isSpace())
+            buf.append(c);
+    }
+    return buf;
+}
+
+ProcessSearchIndex::ProcessSearchIndex(bool pinyin)
+    : m_pinyin(pinyin)
+{
+}
+
+ProcessSearchIndex::ProcessSearchIndex()
+    : ProcessSearchIndex(QLocale::system().language() == QLocale::Chinese)
+{
+}
+
+QString ProcessSearchIndex::pinyinOf(const QString &text)
+{
+    if (!m_pinyin || !containsHan(text))
+        return {};
+
+    auto it = m_pinyinCache.constFind(text);
+    if (it != m_pinyinCache.cend())
+        return it.value();
+
+    if (m_pinyinCache.size() >= PINYIN_CACHE_MAX)
+        m_pinyinCache.clear();
+    QString pinyin = removeSpaces(util::common::convHanToLatin(text).toLower());
+    m_pinyinCache.insert(text, pinyin);
+    return pinyin;
+}
+
+ProcessSearchIndex::Query ProcessSearchIndex::makeQuery(const QString &search) const
+{
+    Query query;
+    query.text = search.toLower();
+    if (m_pinyin && containsHan(search)) {
+        query.pinyin = removeSpaces(util::common::convHanToLatin(search).toLower());
+        if (query.pinyin == query.text)
+            query.pinyin.clear();
+    }
+    return query;
+}
+
+void ProcessSearchIndex::update(const Process &proc)
+{
+    update(proc.pid(), proc.name(), proc.displayName(), proc.userName());
+}
+
+void ProcessSearchIndex::update(pid_t pid, const QString &name, const QString &displayName, const QString &user)
+{
+    auto it = m_entries.find(pid);
+    if (it != m_entries.end() && it->sourceName == name && it->sourceDisplayName == displayName && it->sourceUser == user)
+        return;
+
+    Entry entry;
+    entry.sourceName = name;
+    entry.sourceDisplayName = displayName;
+    entry.sourceUser = user;
+    entry.name = name.toLower();
+    entry.displayName = displayName.toLower();
+    entry.pinyin = pinyinOf(displayName);
+    entry.user = user.toLower();
+    entry.pid = QString::number(pid);
+
+    if (it != m_entries.end())
+        *it = entry;
+    else
+        m_entries.insert(pid, entry);
+}
+
+void ProcessSearchIndex::remove(pid_t pid)
+{
+    m_entries.remove(pid);
+}
+
+void ProcessSearchIndex::clear()
+{
+    m_entries.clear();
+}
+
+bool ProcessSearchIndex::matches(pid_t pid, const Query &query) const
+{
+    if (query.isEmpty())
+        return true;
+
+    auto it = m_entries.constFind(pid);
+    if (it == m_entries.cend())
+        return false;
+
+    const Entry &e = it.value();
+    // display name or name matches pattern
+    if (e.displayName.contains(query.text) || e.name.contains(query.text))
+        return true;
+    // pinyin of the name typed in latin letters
+    if (!e.pinyin.isEmpty() && e.pinyin.contains(query.text))
+        return true;
+    // hanzi typed, processes named in pinyin or with the same pinyin
+    if (!query.pinyin.isEmpty() && (e.name.contains(query.pinyin) || (!e.pinyin.isEmpty() && e.pinyin.contains(query.pinyin))))
+        return true;
+    // pid or user name matches pattern
+    return e.pid.contains(query.text) || e.user.contains(query.text);
+}
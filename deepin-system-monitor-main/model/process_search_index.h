@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_SEARCH_INDEX_H
+#define PROCESS_SEARCH_INDEX_H
+
+#include <QHash>
+#include <QString>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+class Process;
+}
+}
+
+/**
+ * @brief Search text of the processes in the table, lower-cased once per process
+ *
+ * Entries are refreshed only when the name of a pid changes, pinyin of hanzi names is
+ * converted once and shared by all processes with the same name.
+ */
+class ProcessSearchIndex
+{
+public:
+    /**
+     * @brief Search pattern, prepared once per keystroke
+     */
+    struct Query {
+        QString text; // lower-cased search text
+        QString pinyin; // search text converted to pinyin, empty if the same as text
+
+        inline bool isEmpty() const
+        {
+            return text.isEmpty();
+        }
+    };
+
+    /**
+     * @param pinyin Index pinyin of hanzi names, defaults to chinese system locale
+     */
+    explicit ProcessSearchIndex(bool pinyin);
+    ProcessSearchIndex();
+
+    Query makeQuery(const QString &search) const;
+
+    /**
+     * @brief Add or refresh the entry of proc, nothing is converted if its name did not change
+     */
+    void update(const core::process::Process &proc);
+    void update(pid_t pid, const QString &name, const QString &displayName, const QString &user);
+    void remove(pid_t pid);
+    void clear();
+
+    inline int size() const
+    {
+        return m_entries.size();
+    }
+
+    /**
+     * @brief Substring match of name, display name, pinyin, pid & user of process pid
+     */
+    bool matches(pid_t pid, const Query &query) const;
+
+private:
+    struct Entry {
+        // values the entry was built from
+        QString sourceName;
+        QString sourceDisplayName;
+        QString sourceUser;
+
+        // lower-cased search text
+        QString name;
+        QString displayName;
+        QString pinyin; // whitespace removed, empty if the name has no hanzi
+        QString user;
+        QString pid;
+    };
+
+    QString pinyinOf(const QString &text);
+
+    bool m_pinyin;
+    QHash<pid_t, Entry> m_entries;
+    // converted names, many processes share a name
+    QHash<QString, QString> m_pinyinCache;
+};
+
+#endif // PROCESS_SEARCH_INDEX_H
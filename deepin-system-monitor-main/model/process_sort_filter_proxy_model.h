@@ -6,6 +6,9 @@
 #ifndef PROCESS_SORT_FILTER_PROXY_MODEL_H
 #define PROCESS_SORT_FILTER_PROXY_MODEL_H
 
+#include "process_search_index.h"
+#include "process_sort_keys.h"
+
 #include <QSortFilterProxyModel>
 
 /**
@@ -30,6 +33,21 @@ public:
 
     void setFilterType(int type);
 
+    /**
+     * @brief Set source model, sort keys are dropped whenever its rows change
+     * @param sourceModel Process table model
+     */
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    /**
+     * @brief Suspend dynamic sorting while the source model applies a batch of row changes
+     */
+    void beginBatchUpdate();
+    /**
+     * @brief Resume dynamic sorting, rows changed by the batch are filtered & sorted once
+     */
+    void endBatchUpdate();
+
 protected:
     /**
      * @brief Filters the row of specified parent with given pattern
@@ -50,10 +68,14 @@ protected:
 private:
     // Search pattern
     QString m_search {};
-    // Pinyin represented as ascii string converted from chinese hanzi
-    QString m_hanwords {};
+    // Search pattern prepared for the search index of the source model
+    ProcessSearchIndex::Query m_query {};
 
     int m_fileterType = 0;
+
+    // typed sort keys of the source rows, built on the first comparison after a change
+    mutable ProcessSortKeys m_sortKeys;
+    QList<QMetaObject::Connection> m_sourceConnections;
 };
 
 #endif  // PROCESS_SORT_FILTER_PROXY_MODEL_H
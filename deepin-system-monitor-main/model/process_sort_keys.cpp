@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_sort_keys.h"
+#include "process_table_model.h"
+#include "common/common.h"
+
+#include <QAbstractItemModel>
+#include <QLocale>
+
+#include <algorithm>
+#include <numeric>
+
+ProcessSortKeys::ProcessSortKeys()
+    : m_collator(QLocale())
+{
+}
+
+void ProcessSortKeys::invalidate()
+{
+    m_built = 0;
+}
+
+void ProcessSortKeys::prepare(const QAbstractItemModel *model, int column)
+{
+    if (!model)
+        return;
+    if (model->rowCount() != m_rows) {
+        m_built = 0;
+        m_rows = model->rowCount();
+    }
+
+    switch (column) {
+    case ProcessTableModel::kProcessNameColumn:
+        build(model, kKeyName);
+        build(model, kKeyCPU);
+        break;
+    case ProcessTableModel::kProcessUserColumn:
+        build(model, kKeyUser);
+        break;
+    case ProcessTableModel::kProcessCPUColumn:
+        build(model, kKeyCPU);
+        build(model, kKeyMemory);
+        break;
+    case ProcessTableModel::kProcessMemoryColumn:
+        build(model, kKeyMemory);
+        build(model, kKeyCPU);
+        break;
+    case ProcessTableModel::kProcessShareMemoryColumn:
+        build(model, kKeyShareMemory);
+        build(model, kKeyCPU);
+        break;
+    case ProcessTableModel::kProcessVTRMemoryColumn:
+        build(model, kKeyVTRMemory);
+        build(model, kKeyCPU);
+        break;
+    case ProcessTableModel::kProcessUploadColumn:
+        build(model, kKeyUpload);
+        build(model, kKeyUploadTotal);
+        break;
+    case ProcessTableModel::kProcessDownloadColumn:
+        build(model, kKeyDownload);
+        build(model, kKeyDownloadTotal);
+        break;
+    case ProcessTableModel::kProcessDiskReadColumn:
+        build(model, kKeyDiskRead);
+        break;
+    case ProcessTableModel::kProcessDiskWriteColumn:
+        build(model, kKeyDiskWrite);
+        break;
+    case ProcessTableModel::kProcessPIDColumn:
+        build(model, kKeyPID);
+        break;
+    case ProcessTableModel::kProcessNiceColumn:
+    case ProcessTableModel::kProcessPriorityColumn:
+        build(model, kKeyNice);
+        break;
+    case ProcessTableModel::kProcessGPUColumn:
+        build(model, kKeyGPU);
+        build(model, kKeyGPUMemory);
+        break;
+    case ProcessTableModel::kProcessGPUMemoryColumn:
+        build(model, kKeyGPUMemory);
+        build(model, kKeyGPU);
+        break;
+    default:
+        break;
+    }
+}
+
+void ProcessSortKeys::build(const QAbstractItemModel *model, Key key)
+{
+    if (m_built & (1u << key))
+        return;
+    m_built |= (1u << key);
+
+    auto value = [model](int row, int column, int role) {
+        return model->index(row, column).data(role);
+    };
+
+    switch (key) {
+    case kKeyName:
+    case kKeyUser: {
+        std::vector<QCollatorSortKey> &keys = m_text[key == kKeyName ? 0 : 1];
+        int column = (key == kKeyName) ? ProcessTableModel::kProcessNameColumn : ProcessTableModel::kProcessUserColumn;
+        keys.clear();
+        keys.reserve(size_t(m_rows));
+        if (key == kKeyName)
+            m_nameHanzi.resize(m_rows);
+        for (int row = 0; row < m_rows; ++row) {
+            const QString text = value(row, column, Qt::DisplayRole).toString();
+            keys.push_back(m_collator.sortKey(text));
+            if (key == kKeyName)
+                m_nameHanzi[row] = common::startWithHanzi(text);
+        }
+        break;
+    }
+    case kKeyCPU:
+    case kKeyUpload:
+    case kKeyDownload:
+    case kKeyDiskRead:
+    case kKeyDiskWrite:
+    case kKeyGPU: {
+        int column = (key == kKeyCPU) ? ProcessTableModel::kProcessCPUColumn
+                   : (key == kKeyUpload) ? ProcessTableModel::kProcessUploadColumn
+                   : (key == kKeyDownload) ? ProcessTableModel::kProcessDownloadColumn
+                   : (key == kKeyDiskRead) ? ProcessTableModel::kProcessDiskReadColumn
+                   : (key == kKeyDiskWrite) ? ProcessTableModel::kProcessDiskWriteColumn
+                   : ProcessTableModel::kProcessGPUColumn;
+        QVector<qreal> &keys = m_real[key];
+        keys.resize(m_rows);
+        for (int row = 0; row < m_rows; ++row)
+            keys[row] = value(row, column, Qt::UserRole).toDouble();
+        break;
+    }
+    case kKeyMemory:
+    case kKeyShareMemory:
+    case kKeyVTRMemory:
+    case kKeyUploadTotal:
+    case kKeyDownloadTotal:
+    case kKeyGPUMemory: {
+        int column = (key == kKeyMemory) ? ProcessTableModel::kProcessMemoryColumn
+                   : (key == kKeyShareMemory) ? ProcessTableModel::kProcessShareMemoryColumn
+                   : (key == kKeyVTRMemory) ? ProcessTableModel::kProcessVTRMemoryColumn
+                   : (key == kKeyUploadTotal) ? ProcessTableModel::kProcessUploadColumn
+                   : (key == kKeyDownloadTotal) ? ProcessTableModel::kProcessDownloadColumn
+                   : ProcessTableModel::kProcessGPUMemoryColumn;
+        // totals of the network columns are kept in UserRole + 1
+        int role = (key == kKeyUploadTotal || key == kKeyDownloadTotal) ? Qt::UserRole + 1 : Qt::UserRole;
+        QVector<qulonglong> &keys = m_uint[key];
+        keys.resize(m_rows);
+        for (int row = 0; row < m_rows; ++row)
+            keys[row] = value(row, column, role).toULongLong();
+        break;
+    }
+    case kKeyPID:
+    case kKeyNice: {
+        int column = (key == kKeyPID) ? ProcessTableModel::kProcessPIDColumn : ProcessTableModel::kProcessNiceColumn;
+        QVector<int> &keys = m_int[key];
+        keys.resize(m_rows);
+        for (int row = 0; row < m_rows; ++row)
+            keys[row] = value(row, column, Qt::UserRole).toInt();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+bool ProcessSortKeys::compareCPU(int left, int right) const
+{
+    return m_real[kKeyCPU][left] < m_real[kKeyCPU][right];
+}
+
+bool ProcessSortKeys::lessThan(int column, int left, int right) const
+{
+    switch (column) {
+    case ProcessTableModel::kProcessNameColumn: {
+        // names starting with hanzi are placed after latin ones
+        bool lstartHz = m_nameHanzi[left];
+        bool rstartHz = m_nameHanzi[right];
+        if (lstartHz != rstartHz)
+            return rstartHz;
+
+        int rc = m_text[0][size_t(left)].compare(m_text[0][size_t(right)]);
+        return (rc == 0) ? compareCPU(left, right) : rc < 0;
+    }
+    case ProcessTableModel::kProcessUserColumn:
+        return m_text[1][size_t(left)].compare(m_text[1][size_t(right)]) < 0;
+    case ProcessTableModel::kProcessMemoryColumn:
+    case ProcessTableModel::kProcessShareMemoryColumn:
+    case ProcessTableModel::kProcessVTRMemoryColumn: {
+        Key key = (column == ProcessTableModel::kProcessMemoryColumn) ? kKeyMemory
+                : (column == ProcessTableModel::kProcessShareMemoryColumn) ? kKeyShareMemory
+                : kKeyVTRMemory;
+        const QVector<qulonglong> &mem = m_uint[key];
+        // compare memory usage first, then by cpu time
+        return (mem[left] == mem[right]) ? compareCPU(left, right) : mem[left] < mem[right];
+    }
+    case ProcessTableModel::kProcessCPUColumn: {
+        const QVector<qreal> &cpu = m_real[kKeyCPU];
+        const QVector<qulonglong> &mem = m_uint[kKeyMemory];
+        // compare cpu time first, then by memory usage
+        return qFuzzyCompare(cpu[left], cpu[right]) ? mem[left] < mem[right] : cpu[left] < cpu[right];
+    }
+    case ProcessTableModel::kProcessUploadColumn:
+    case ProcessTableModel::kProcessDownloadColumn: {
+        bool upload = (column == ProcessTableModel::kProcessUploadColumn);
+        const QVector<qreal> &kbs = m_real[upload ? kKeyUpload : kKeyDownload];
+        const QVector<qulonglong> &total = m_uint[upload ? kKeyUploadTotal : kKeyDownloadTotal];
+        // compare speed first, then by total bytes
+        return qFuzzyCompare(kbs[left], kbs[right]) ? total[left] < total[right] : kbs[left] < kbs[right];
+    }
+    case ProcessTableModel::kProcessDiskReadColumn:
+        return m_real[kKeyDiskRead][left] < m_real[kKeyDiskRead][right];
+    case ProcessTableModel::kProcessDiskWriteColumn:
+        return m_real[kKeyDiskWrite][left] < m_real[kKeyDiskWrite][right];
+    case ProcessTableModel::kProcessPIDColumn:
+        return m_int[kKeyPID][left] < m_int[kKeyPID][right];
+    case ProcessTableModel::kProcessNiceColumn:
+    case ProcessTableModel::kProcessPriorityColumn:
+        // higher priority has negative number, strict comparison keeps the ordering valid for std::stable_sort
+        return m_int[kKeyNice][left] > m_int[kKeyNice][right];
+    case ProcessTableModel::kProcessGPUColumn: {
+        const QVector<qreal> &gpu = m_real[kKeyGPU];
+        const QVector<qulonglong> &vram = m_uint[kKeyGPUMemory];
+        // compare gpu usage first, then by vram
+        return qFuzzyCompare(gpu[left], gpu[right]) ? vram[left] < vram[right] : gpu[left] < gpu[right];
+    }
+    case ProcessTableModel::kProcessGPUMemoryColumn: {
+        const QVector<qulonglong> &vram = m_uint[kKeyGPUMemory];
+        const QVector<qreal> &gpu = m_real[kKeyGPU];
+        // compare vram first, then by gpu usage
+        return (vram[left] == vram[right]) ? gpu[left] < gpu[right] : vram[left] < vram[right];
+    }
+    default:
+        break;
+    }
+
+    return left < right;
+}
+
+QVector<int> ProcessSortKeys::sortedRows(int column, Qt::SortOrder order) const
+{
+    QVector<int> rows(m_rows);
+    std::iota(rows.begin(), rows.end(), 0);
+    if (order == Qt::AscendingOrder) {
+        std::stable_sort(rows.begin(), rows.end(), [this, column](int l, int r) { return lessThan(column, l, r); });
+    } else {
+        std::stable_sort(rows.begin(), rows.end(), [this, column](int l, int r) { return lessThan(column, r, l); });
+    }
+    return rows;
+}
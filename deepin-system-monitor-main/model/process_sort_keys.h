@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_SORT_KEYS_H
+#define PROCESS_SORT_KEYS_H
+
+#include <QCollator>
+#include <QVector>
+
+#include <vector>
+
+class QAbstractItemModel;
+
+/**
+ * @brief Typed sort keys of the process table, one contiguous vector per sortable field, indexed by source row
+ *
+ * Keys are read from the model once per update through the same roles lessThan() used to query on every
+ * comparison, so ordering is unchanged. Only the fields needed by the sort column are built. The keys are
+ * a value snapshot of the model, sortedRows() may run on any thread.
+ */
+class ProcessSortKeys
+{
+public:
+    ProcessSortKeys();
+
+    /**
+     * @brief Drop all keys, the model changed
+     */
+    void invalidate();
+    /**
+     * @brief Build the keys needed to sort by column, if not built yet since the last invalidate()
+     * @param model Process table model (source model of the proxy)
+     * @param column Sort column
+     */
+    void prepare(const QAbstractItemModel *model, int column);
+
+    /**
+     * @brief Number of rows the keys were built for
+     */
+    inline int rows() const
+    {
+        return m_rows;
+    }
+
+    /**
+     * @brief Compare two source rows by column, prepare() must have been called for column
+     */
+    bool lessThan(int column, int left, int right) const;
+    /**
+     * @brief Source rows in sorted order
+     */
+    QVector<int> sortedRows(int column, Qt::SortOrder order) const;
+
+private:
+    // key fields, a sort column uses one or two of them
+    enum Key {
+        kKeyName = 0,
+        kKeyUser,
+        kKeyCPU,
+        kKeyMemory,
+        kKeyShareMemory,
+        kKeyVTRMemory,
+        kKeyUpload,
+        kKeyUploadTotal,
+        kKeyDownload,
+        kKeyDownloadTotal,
+        kKeyDiskRead,
+        kKeyDiskWrite,
+        kKeyPID,
+        kKeyNice,
+        kKeyGPU,
+        kKeyGPUMemory,
+
+        kKeyCount
+    };
+
+    void build(const QAbstractItemModel *model, Key key);
+    bool compareCPU(int left, int right) const;
+
+    quint32 m_built {0}; // Key mask
+    int m_rows {0};
+    QCollator m_collator;
+
+    std::vector<QCollatorSortKey> m_text[2]; // name, user
+    QVector<bool> m_nameHanzi;
+    QVector<qreal> m_real[kKeyCount]; // cpu, gpu & rates
+    QVector<qulonglong> m_uint[kKeyCount]; // memory & totals
+    QVector<int> m_int[kKeyCount]; // pid & nice
+};
+
+#endif // PROCESS_SORT_KEYS_H
@@ -5,16 +5,24 @@
 #include "ddlog.h"
 #include "process_table_model.h"
 #include "process/process_db.h"
+#include "process/process_icon.h"
+#include "system/system_monitor.h"
 #include "common/common.h"
+#include "common/perf_stats.h"
 
 #include <QDebug>
+#include <QSet>
 #include <QTimer>
+#include <QUrl>
 #include <DApplication>
 #include <DGuiApplicationHelper>
 #include <DPlatformTheme>
 #include <QPointer>
+
+#include <algorithm>
 using namespace common;
 using namespace common::format;
+using namespace common::perf;
 using namespace DDLog;
 DGUI_USE_NAMESPACE   // using namespace Dtk::Gui;
 
@@ -53,8 +61,9 @@ ProcessTableModel::ProcessTableModel(QObject *parent, const QString &username)
 char ProcessTableModel::getProcessState(pid_t pid) const
 {
     qCDebug(app) << "Getting process state for PID:" << pid;
-    if (m_procIdList.contains(pid)) {
-        return ProcessDB::instance()->processSet()->getProcessById(pid).state();
+    int entry = entryAt(m_rowIndex.value(pid, -1));
+    if (entry >= 0) {
+        return stateAt(entry);
     }
 
     qCDebug(app) << "Process with PID" << pid << "not in the list";
@@ -64,7 +73,7 @@ char ProcessTableModel::getProcessState(pid_t pid) const
 Process ProcessTableModel::getProcess(pid_t pid) const
 {
     qCDebug(app) << "Getting process for PID:" << pid;
-    if (m_procIdList.contains(pid)) {
+    if (m_rowIndex.contains(pid)) {
         return ProcessDB::instance()->processSet()->getProcessById(pid);
     }
 
@@ -88,25 +97,34 @@ void ProcessTableModel::updateProcessList()
 void ProcessTableModel::updateProcessListWithUserSpecified()
 {
     qCDebug(app) << "Updating process list for specified user:" << m_userModeName;
-    ProcessSet *processSet = ProcessDB::instance()->processSet();
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    beginRemoveRows({}, 0, m_procIdList.size());
-    endRemoveRows();
-    m_procIdList.clear();
-    m_processList.clear();
-    int raw;
-    for (const auto &pid : newpidlst) {
-        Process changedProc = processSet->getProcessById(pid);
-        // 确保进程有效且用户名匹配
-        if (changedProc.isValid() && changedProc.userName() == m_userModeName) {
-            // qCDebug(app) << "Adding process with PID:" << pid << "for user" << m_userModeName;
-            raw = m_procIdList.size();
-            beginInsertRows({}, raw, raw);
-            m_procIdList << pid;
-            m_processList << changedProc;
-            endInsertRows();
-        }
+    SystemSnapshotPtr snapshot = SystemMonitor::instance()->snapshot();
+    if (!snapshot) {
+        qCDebug(app) << "No snapshot published yet";
+        return;
     }
+    Q_EMIT modelAboutToBeUpdated();
+
+    setSnapshot(snapshot);
+    rebuildRowIndex();
+    QSet<pid_t> newpids;
+    newpids.reserve(snapshot->processCount());
+    QVector<pid_t> added, removed, changed;
+    for (int i = 0; i < snapshot->processCount(); ++i) {
+        // 确保用户名匹配
+        if (snapshot->processText(i).userName != m_userModeName)
+            continue;
+        pid_t pid = snapshot->process(i).pid;
+        newpids.insert(pid);
+        if (m_rowIndex.contains(pid))
+            changed << pid;
+        else
+            added << pid;
+    }
+    for (const auto &pid : m_procIdList) {
+        if (!newpids.contains(pid))
+            removed << pid;
+    }
+    applyProcessChanges(removed, changed, added);
 
     qCDebug(app) << "Process list updated for user" << m_userModeName;
     Q_EMIT modelUpdated();
@@ -115,51 +133,163 @@ void ProcessTableModel::updateProcessListWithUserSpecified()
 void ProcessTableModel::updateProcessListDelay()
 {
     qCDebug(app) << "Updating process list with delay";
-    ProcessSet *processSet = ProcessDB::instance()->processSet();
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    QList<pid_t> oldpidlst = m_procIdList;
-
-    for (const auto &pid : newpidlst) {
-        Process proc = processSet->getProcessById(pid);
-        // 只处理有效进程
-        if (!proc.isValid()) {
-            qCDebug(app) << "Skipping invalid process with PID:" << pid;
-            continue;
-        }
-        
-        int row = m_procIdList.indexOf(pid);
-        if (row >= 0) {
-            // qCDebug(app) << "Updating process at row:" << row;
-            // update
-            m_processList[row] = proc;
-            Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
-        } else {
-            // insert
-            // qCDebug(app) << "Inserting new process with PID:" << pid;
-            row = m_procIdList.size();
-            beginInsertRows({}, row, row);
-            m_procIdList << pid;
-            m_processList << proc;
-            endInsertRows();
-        }
+    SystemSnapshotPtr snapshot = SystemMonitor::instance()->snapshot();
+    if (!snapshot) {
+        qCDebug(app) << "No snapshot published yet";
+        return;
+    }
+    Q_EMIT modelAboutToBeUpdated();
+    PerfScope perfScope(kStageModelDiff);
+    setSnapshot(snapshot);
+
+    // no scan since the snapshot applied before, rows are repainted from the new one
+    const ProcessSetDelta &delta = snapshot->processDelta();
+    if (delta.seq == m_deltaSeq && !m_procIdList.isEmpty()) {
+        Q_EMIT dataChanged(index(0, 0), index(m_procIdList.size() - 1, columnCount() - 1));
+        Q_EMIT modelUpdated();
+        return;
     }
 
-    // remove
-    for (const auto &pid : oldpidlst) {
-        if (!newpidlst.contains(pid)) {
-            // qCDebug(app) << "Removing process with PID:" << pid;
-            int row = m_procIdList.indexOf(pid);
-            beginRemoveRows({}, row, row);
-            m_procIdList.removeAt(row);
-            m_processList.removeAt(row);
-            endRemoveRows();
-        }
+    // apply only what the last scan changed, if the model has seen the scan before it
+    if (delta.seq == m_deltaSeq + 1) {
+        m_deltaSeq = delta.seq;
+        applyProcessChanges(delta.removed, delta.changed, delta.added);
+
+        qCDebug(app) << "Process list delta applied, added:" << delta.added.size()
+                     << "removed:" << delta.removed.size() << "changed:" << delta.changed.size();
+        Q_EMIT modelUpdated();
+        return;
+    }
+    m_deltaSeq = delta.seq;
+
+    // full resync, diff the processes of the snapshot against the rows, it only holds valid ones
+    rebuildRowIndex();
+    QSet<pid_t> newpids;
+    newpids.reserve(snapshot->processCount());
+    QVector<pid_t> added, removed, changed;
+    for (const process_metrics_t &proc : snapshot->processes()) {
+        pid_t pid = proc.pid;
+        newpids.insert(pid);
+        if (m_rowIndex.contains(pid))
+            changed << pid;
+        else
+            added << pid;
+    }
+    for (const auto &pid : m_procIdList) {
+        if (!newpids.contains(pid))
+            removed << pid;
     }
+    applyProcessChanges(removed, changed, added);
 
     qCDebug(app) << "Delayed process list update finished";
     Q_EMIT modelUpdated();
 }
 
+void ProcessTableModel::applyProcessChanges(const QVector<pid_t> &removed,
+                                            const QVector<pid_t> &changed,
+                                            const QVector<pid_t> &added)
+{
+    // remove: adjacent rows form one range, ranges are removed from the bottom up so rows above stay valid
+    QVector<int> rows;
+    rows.reserve(removed.size());
+    for (const auto &pid : removed) {
+        auto it = m_rowIndex.constFind(pid);
+        if (it != m_rowIndex.cend())
+            rows << it.value();
+        m_searchIndex.remove(pid);
+    }
+    if (!rows.isEmpty()) {
+        std::sort(rows.begin(), rows.end());
+        int i = rows.size() - 1;
+        while (i >= 0) {
+            int last = rows[i];
+            int first = last;
+            while (i > 0 && rows[i - 1] == first - 1)
+                first = rows[--i];
+            --i;
+
+            beginRemoveRows({}, first, last);
+            m_procIdList.erase(m_procIdList.begin() + first, m_procIdList.begin() + last + 1);
+            m_rows.erase(m_rows.begin() + first, m_rows.begin() + last + 1);
+            endRemoveRows();
+        }
+        rebuildRowIndex();
+    }
+
+    // update: one dataChanged covering all rows touched
+    int top = -1, bottom = -1;
+    for (const auto &pid : changed) {
+        auto it = m_rowIndex.constFind(pid);
+        if (it == m_rowIndex.cend())
+            continue;
+        int row = it.value();
+        int entry = entryAt(row);
+        if (entry >= 0) {
+            const process_text_t &text = m_snapshot->processText(entry);
+            m_searchIndex.update(pid, text.name, text.displayName, text.userName);
+        }
+        top = (top < 0) ? row : qMin(top, row);
+        bottom = qMax(bottom, row);
+    }
+    if (top >= 0)
+        Q_EMIT dataChanged(index(top, 0), index(bottom, columnCount() - 1));
+
+    // insert: all new processes appended as one range, processes the snapshot does not have are skipped
+    QList<pid_t> pids;
+    QVector<int> entries;
+    int row = m_procIdList.size();
+    for (const auto &pid : added) {
+        int entry = m_snapshot ? m_snapshot->indexOf(pid) : -1;
+        if (entry < 0 || m_rowIndex.contains(pid))
+            continue;
+        m_rowIndex.insert(pid, row + pids.size());
+        pids << pid;
+        entries << entry;
+        const process_text_t &text = m_snapshot->processText(entry);
+        m_searchIndex.update(pid, text.name, text.displayName, text.userName);
+    }
+    if (!pids.isEmpty()) {
+        beginInsertRows({}, row, row + pids.size() - 1);
+        m_procIdList << pids;
+        m_rows << entries;
+        endInsertRows();
+    }
+}
+
+void ProcessTableModel::rebuildRowIndex()
+{
+    m_rowIndex.clear();
+    m_rowIndex.reserve(m_procIdList.size());
+    for (int row = 0; row < m_procIdList.size(); ++row)
+        m_rowIndex.insert(m_procIdList[row], row);
+}
+
+void ProcessTableModel::setSnapshot(const SystemSnapshotPtr &snapshot)
+{
+    m_snapshot = snapshot;
+    m_rows.resize(m_procIdList.size());
+    for (int row = 0; row < m_procIdList.size(); ++row)
+        m_rows[row] = snapshot ? snapshot->indexOf(m_procIdList[row]) : -1;
+
+    // the processes of the snapshot already show the effect of the actions
+    if (snapshot && snapshot->processCapturedNs() > m_overridesNs) {
+        m_stateOverrides.clear();
+        m_priorityOverrides.clear();
+    }
+}
+
+char ProcessTableModel::stateAt(int entry) const
+{
+    const process_metrics_t &proc = m_snapshot->process(entry);
+    return m_stateOverrides.isEmpty() ? proc.state : m_stateOverrides.value(proc.pid, proc.state);
+}
+
+int ProcessTableModel::priorityAt(int entry) const
+{
+    const process_metrics_t &proc = m_snapshot->process(entry);
+    return m_priorityOverrides.isEmpty() ? proc.priority : m_priorityOverrides.value(proc.pid, proc.priority);
+}
+
 // returns the number of rows under the given parent
 int ProcessTableModel::rowCount(const QModelIndex &) const
 {
@@ -221,6 +351,12 @@ QVariant ProcessTableModel::headerData(int section, Qt::Orientation orientation,
         case kProcessPriorityColumn:
             // priority column display text
             return QApplication::translate("Process.Table.Header", kProcessPriority);
+        case kProcessGPUColumn:
+            // gpu column display text
+            return QApplication::translate("Process.Table.Header", kProcessGPU);
+        case kProcessGPUMemoryColumn:
+            // gpu memory column display text
+            return QApplication::translate("Process.Table.Header", kProcessGPUMemory);
         default:
             break;
         }
@@ -245,17 +381,15 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
     }
 
     // validate index
-    if (index.row() < 0 || index.row() >= m_processList.size()) {
+    int row = index.row();
+    int entry = entryAt(row);
+    if (entry < 0) {
         qCDebug(app) << "Index out of bounds, returning empty QVariant";
         return {};
     }
 
-    int row = index.row();
-    const Process &proc = m_processList[row];
-    if (!proc.isValid()) {
-        qCDebug(app) << "Process at row" << row << "is invalid";
-        return {};
-    }
+    const process_metrics_t &proc = m_snapshot->process(entry);
+    const process_text_t &text = m_snapshot->processText(entry);
 
     // qCDebug(app) << "Getting data for row:" << row << "column:" << index.column() << "role:" << role;
     if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
@@ -263,8 +397,8 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         switch (index.column()) {
         case kProcessNameColumn: {
             // prepended tag based on process state
-            name = proc.displayName();
-            switch (proc.state()) {
+            name = text.displayName;
+            switch (stateAt(entry)) {
             case 'Z':
                 qCDebug(app) << "Process state is Zombie";
                 name = QString("(%1) %2")
@@ -282,43 +416,49 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         }
         case kProcessCPUColumn:
             // formated cpu percent utilization
-            return QString("%1%").arg(proc.cpu(), 0, 'f', 1);
+            return QString("%1%").arg(proc.cpu, 0, 'f', 1);
         case kProcessUserColumn:
             // process's user name
-            return proc.userName();
+            return text.userName;
         case kProcessMemoryColumn:
             // formatted memory usage
-            return formatUnit_memory_disk(proc.memory(), KB);
+            return formatUnit_memory_disk(proc.memory, KB);
         case kProcessShareMemoryColumn:
             // formatted memory usage
-            return formatUnit_memory_disk(proc.sharememory(), KB);
+            return formatUnit_memory_disk(proc.sharedMemory, KB);
         case kProcessVTRMemoryColumn:
             // formatted memory usage
-            return formatUnit_memory_disk(proc.vtrmemory(), KB);
+            return formatUnit_memory_disk(proc.virtualMemory, KB);
         case kProcessUploadColumn:
             // formatted upload speed text
-            return formatUnit_net(8 * proc.sentBps(), B, 1, true);
+            return formatUnit_net(8 * proc.sentBps, B, 1, true);
         case kProcessDownloadColumn:
             // formated download speed text
-            return formatUnit_net(8 * proc.recvBps(), B, 1, true);
+            return formatUnit_net(8 * proc.recvBps, B, 1, true);
         case kProcessDiskReadColumn:
             // formatted disk read speed text
-            return formatUnit_memory_disk(proc.readBps(), B, 1, true);
+            return formatUnit_memory_disk(proc.readBps, B, 1, true);
         case kProcessDiskWriteColumn:
             // formatted disk write speed text
-            return formatUnit_memory_disk(proc.writeBps(), B, 1, true);
+            return formatUnit_memory_disk(proc.writeBps, B, 1, true);
         case kProcessPIDColumn: {
             // process pid text
-            return QString("%1").arg(proc.pid());
+            return QString("%1").arg(proc.pid);
         }
         case kProcessNiceColumn: {
             // process priority text
-            return QString("%1").arg(proc.priority());
+            return QString("%1").arg(priorityAt(entry));
         }
         case kProcessPriorityColumn: {
             // process priority enum text representation
-            return getPriorityName(proc.priority());
+            return getPriorityName(priorityAt(entry));
         }
+        case kProcessGPUColumn:
+            // formated gpu percent utilization
+            return QString("%1%").arg(proc.gpu, 0, 'f', 1);
+        case kProcessGPUMemoryColumn:
+            // formatted vram usage
+            return formatUnit_memory_disk(proc.gpuMemory, B);
         default:
             break;
         }
@@ -326,8 +466,8 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         switch (index.column()) {
         case kProcessNameColumn:
             qCDebug(app) << "Returning decoration role for process name";
-            // process icon
-            return proc.icon();
+            // process icon, built from the icon data of the snapshot on first use
+            return ProcessIcon::iconOf(text.icon);
         default:
             return {};
         }
@@ -336,27 +476,31 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         // get process's raw data
         switch (index.column()) {
         case kProcessNameColumn:
-            return proc.name();
+            return text.name;
         case kProcessMemoryColumn:
-            return proc.memory();
+            return proc.memory;
         case kProcessShareMemoryColumn:
-            return proc.sharememory();
+            return proc.sharedMemory;
         case kProcessVTRMemoryColumn:
-            return proc.vtrmemory();
+            return proc.virtualMemory;
         case kProcessCPUColumn:
-            return proc.cpu();
+            return proc.cpu;
         case kProcessUploadColumn:
-            return proc.sentBps();
+            return proc.sentBps;
         case kProcessDownloadColumn:
-            return proc.recvBps();
+            return proc.recvBps;
         case kProcessPIDColumn:
-            return proc.pid();
+            return proc.pid;
         case kProcessDiskReadColumn:
-            return proc.readBps();
+            return proc.readBps;
         case kProcessDiskWriteColumn:
-            return proc.writeBps();
+            return proc.writeBps;
         case kProcessNiceColumn:
-            return proc.priority();
+            return priorityAt(entry);
+        case kProcessGPUColumn:
+            return proc.gpu;
+        case kProcessGPUMemoryColumn:
+            return proc.gpuMemory;
         default:
             return {};
         }
@@ -365,9 +509,9 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         // get process's extra data
         switch (index.column()) {
         case kProcessUploadColumn:
-            return proc.sentBps();
+            return proc.sentBps;
         case kProcessDownloadColumn:
-            return proc.recvBps();
+            return proc.recvBps;
         default:
             return {};
         }
@@ -379,7 +523,7 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         qCDebug(app) << "Returning user role + 2 data";
         // text color role based on process's state
         if (index.column() == kProcessNameColumn) {
-            char state = proc.state();
+            char state = stateAt(entry);
             if (state == 'Z' || state == 'T') {
                 qCDebug(app) << "Returning warning color for process state:" << state;
                 return QVariant(int(Dtk::Gui::DPalette::TextWarning));
@@ -388,14 +532,14 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         return {};
     } else if (role == Qt::UserRole + 3) {
         qCDebug(app) << "Returning app type";
-        return proc.appType();
+        return proc.appType;
     } else if (role == Qt::UserRole + 4) {
         qCDebug(app) << "Returning cmdline string";
-        QString cmdlineStr = proc.cmdlineString();
+        QString cmdlineStr = QUrl::fromPercentEncoding(text.cmdline.join(' '));
         if (!cmdlineStr.isEmpty())
             return cmdlineStr;
         else
-            return QString("%1").arg(proc.name());
+            return QString("%1").arg(text.name);
     }
     return {};
 }
@@ -416,9 +560,9 @@ Qt::ItemFlags ProcessTableModel::flags(const QModelIndex &index) const
 ProcessPriority ProcessTableModel::getProcessPriority(pid_t pid) const
 {
     qCDebug(app) << "Getting process priority for PID:" << pid;
-    int row = m_procIdList.indexOf(pid);
-    if (row >= 0) {
-        int prio = ProcessDB::instance()->processSet()->getProcessById(pid).priority();
+    int entry = entryAt(m_rowIndex.value(pid, -1));
+    if (entry >= 0) {
+        int prio = priorityAt(entry);
         qCDebug(app) << "Process found, priority value:" << prio;
         return getProcessPriorityStub(prio);
     }
@@ -430,8 +574,8 @@ ProcessPriority ProcessTableModel::getProcessPriority(pid_t pid) const
 int ProcessTableModel::getProcessPriorityValue(pid_t pid) const
 {
     qCDebug(app) << "Getting process priority value for PID:" << pid;
-    int row = m_procIdList.indexOf(pid);
-    int priority = row >= 0 ? ProcessDB::instance()->processSet()->getProcessById(pid).priority() : kNormalPriority;
+    int entry = entryAt(m_rowIndex.value(pid, -1));
+    int priority = entry >= 0 ? priorityAt(entry) : kNormalPriority;
     qCDebug(app) << "Priority value for PID" << pid << "is" << priority;
     return priority;
 }
@@ -440,13 +584,15 @@ int ProcessTableModel::getProcessPriorityValue(pid_t pid) const
 void ProcessTableModel::removeProcess(pid_t pid)
 {
     qCInfo(app) << "Removing process with PID:" << pid;
-    int row = m_procIdList.indexOf(pid);
+    int row = m_rowIndex.value(pid, -1);
     if (row >= 0) {
         qCDebug(app) << "Process with PID" << pid << "found at row" << row << ", removing";
         beginRemoveRows(QModelIndex(), row, row);
         m_procIdList.removeAt(row);
-        m_processList.removeAt(row);
+        m_rows.remove(row);
         endRemoveRows();
+        rebuildRowIndex();
+        m_searchIndex.remove(pid);
         qCInfo(app) << "Process removed successfully";
     } else {
         qCWarning(app) << "Failed to remove process: PID" << pid << "not found";
@@ -457,10 +603,11 @@ void ProcessTableModel::removeProcess(pid_t pid)
 void ProcessTableModel::updateProcessState(pid_t pid, char state)
 {
     qCInfo(app) << "Updating process state. PID:" << pid << "New state:" << state;
-    int row = m_procIdList.indexOf(pid);
+    int row = m_rowIndex.value(pid, -1);
     if (row >= 0) {
         qCDebug(app) << "Process with PID" << pid << "found at row" << row << ", updating state";
-        m_processList[row].setState(state);
+        m_stateOverrides.insert(pid, state);
+        m_overridesNs = PerfScope::monotonicNs();
         Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
         qCInfo(app) << "Process state updated successfully";
     } else {
@@ -472,10 +619,11 @@ void ProcessTableModel::updateProcessState(pid_t pid, char state)
 void ProcessTableModel::updateProcessPriority(pid_t pid, int priority)
 {
     qCInfo(app) << "Updating process priority. PID:" << pid << "New priority:" << priority;
-    int row = m_procIdList.indexOf(pid);
+    int row = m_rowIndex.value(pid, -1);
     if (row >= 0) {
         qCDebug(app) << "Process with PID" << pid << "found at row" << row << ", updating priority";
-        m_processList[row].setPriority(priority);
+        m_priorityOverrides.insert(pid, priority);
+        m_overridesNs = PerfScope::monotonicNs();
         Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
         qCInfo(app) << "Process priority updated successfully";
     } else {
@@ -497,8 +645,11 @@ qreal ProcessTableModel::getTotalCPUUsage()
 {
     qCDebug(app) << "Calculating total CPU usage";
     qreal cpuUsage = 0;
-    for (const auto &proc : m_processList) {
-        cpuUsage += proc.cpu();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        cpuUsage += proc.cpu;
     }
     return cpuUsage;
 }
@@ -506,8 +657,11 @@ qreal ProcessTableModel::getTotalMemoryUsage()
 {
     qCDebug(app) << "Calculating total memory usage";
     qreal memUsage = 0;
-    for (const auto &proc : m_processList) {
-        memUsage += proc.memory();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        memUsage += proc.memory;
     }
     return memUsage;
 }
@@ -515,8 +669,11 @@ qreal ProcessTableModel::getTotalDownload()
 {
     qCDebug(app) << "Calculating total download";
     qreal download = 0;
-    for (const auto &proc : m_processList) {
-        download += proc.recvBps();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        download += proc.recvBps;
     }
     return download;
 }
@@ -524,8 +681,11 @@ qreal ProcessTableModel::getTotalUpload()
 {
     qCDebug(app) << "Calculating total upload";
     qlonglong upload = 0;
-    for (const auto &proc : m_processList) {
-        upload += proc.sentBps();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        upload += proc.sentBps;
     }
     return upload;
 }
@@ -534,8 +694,11 @@ qreal ProcessTableModel::getTotalVirtualMemoryUsage()
 {
     qCDebug(app) << "Calculating total virtual memory usage";
     qlonglong vtmem = 0;
-    for (const auto &proc : m_processList) {
-        vtmem += proc.vtrmemory();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        vtmem += proc.virtualMemory;
     }
     return vtmem;
 }
@@ -543,8 +706,11 @@ qreal ProcessTableModel::getTotalSharedMemoryUsage()
 {
     qCDebug(app) << "Calculating total shared memory usage";
     qlonglong smem = 0;
-    for (const auto &proc : m_processList) {
-        smem += proc.sharememory();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        smem += proc.sharedMemory;
     }
     return smem;
 }
@@ -552,8 +718,11 @@ qreal ProcessTableModel::getTotalDiskRead()
 {
     qCDebug(app) << "Calculating total disk read";
     qlonglong diskread = 0;
-    for (const auto &proc : m_processList) {
-        diskread += proc.readBps();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        diskread += proc.readBps;
     }
     return diskread;
 }
@@ -561,8 +730,11 @@ qreal ProcessTableModel::getTotalDiskWrite()
 {
     qCDebug(app) << "Calculating total disk write";
     qlonglong diskwrite = 0;
-    for (const auto &proc : m_processList) {
-        diskwrite += proc.writeBps();
+    for (int entry : m_rows) {
+        if (entry < 0)
+            continue;
+        const process_metrics_t &proc = m_snapshot->process(entry);
+        diskwrite += proc.writeBps;
     }
     return diskwrite;
 }
@@ -7,10 +7,14 @@
 #define PROCESS_TABLE_MODEL_H
 
 #include "process/process_set.h"
+#include "process_search_index.h"
+#include "system/system_snapshot.h"
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QVector>
 
 // name column display
 constexpr const char *kProcessName = QT_TRANSLATE_NOOP("Process.Table.Header", "Name");
@@ -36,8 +40,13 @@ constexpr const char *kProcessPID = QT_TRANSLATE_NOOP("Process.Table.Header", "P
 constexpr const char *kProcessNice = QT_TRANSLATE_NOOP("Process.Table.Header", "Nice");
 // priority column display
 constexpr const char *kProcessPriority = QT_TRANSLATE_NOOP("Process.Table.Header", "Priority");
+// gpu column display
+constexpr const char *kProcessGPU = QT_TRANSLATE_NOOP("Process.Table.Header", "GPU");
+// gpu memory column display
+constexpr const char *kProcessGPUMemory = QT_TRANSLATE_NOOP("Process.Table.Header", "VRAM");
 
 using namespace core::process;
+using namespace core::system;
 
 /**
  * @brief Process table model class
@@ -64,6 +73,8 @@ public:
         kProcessPIDColumn, // pid column index
         kProcessNiceColumn, // nice column index
         kProcessPriorityColumn, // priority column index
+        kProcessGPUColumn, // gpu column index
+        kProcessGPUMemoryColumn, // gpu memory column index
 
         kProcessColumnCount // total number of columns
     };
@@ -137,10 +148,33 @@ public:
 
     /**
      * @brief Get process entry from list with specified pid
+     *
+     * The entry is the live process object of the monitor thread, rows are read from snapshot() instead.
      * @param pid Process id
      * @return Process entry item
      */
     Process getProcess(pid_t pid) const;
+    /**
+     * @brief Snapshot the rows currently show
+     */
+    inline const SystemSnapshotPtr &snapshot() const
+    {
+        return m_snapshot;
+    }
+    /**
+     * @brief Process id of row
+     */
+    inline pid_t pidAt(int row) const
+    {
+        return (row >= 0 && row < m_procIdList.size()) ? m_procIdList[row] : -1;
+    }
+    /**
+     * @brief Search text of the processes in the model
+     */
+    inline const ProcessSearchIndex &searchIndex() const
+    {
+        return m_searchIndex;
+    }
    void setUserModeName(const QString &userName);
     qreal getTotalCPUUsage();
     qreal getTotalMemoryUsage();
@@ -152,6 +186,10 @@ public:
     qreal getTotalDiskWrite();
 
 Q_SIGNALS:
+    /**
+     * @brief Emitted before the rows of a scan are applied, modelUpdated() follows once they are
+     */
+    void modelAboutToBeUpdated();
     /**
      * @brief Model updated signal
      */
@@ -180,8 +218,41 @@ private Q_SLOTS:
 
     void updateProcessListWithUserSpecified();
 private:
+    /**
+     * @brief Apply the processes removed, changed & added by a scan
+     *
+     * Adjacent removed rows are removed as one range, changed rows are reported by a single
+     * dataChanged over the rows touched, added processes are appended as one range.
+     */
+    void applyProcessChanges(const QVector<pid_t> &removed,
+                             const QVector<pid_t> &changed,
+                             const QVector<pid_t> &added);
+    void rebuildRowIndex();
+    /**
+     * @brief Read the rows from snapshot, processes it no longer has are dropped by the changes applied next
+     */
+    void setSnapshot(const SystemSnapshotPtr &snapshot);
+    /**
+     * @return index of the process of row in m_snapshot, -1 if it has none
+     */
+    inline int entryAt(int row) const
+    {
+        return (m_snapshot && row >= 0 && row < m_rows.size()) ? m_rows[row] : -1;
+    }
+    char stateAt(int entry) const;
+    int priorityAt(int entry) const;
+
     QList<pid_t> m_procIdList; // pid list
-    QList<Process> m_processList; // pid list
+    SystemSnapshotPtr m_snapshot; // replaced as a whole on each tick, never modified
+    QVector<int> m_rows; // row -> process index in m_snapshot
+    QHash<pid_t, int> m_rowIndex; // pid -> row
+    // state & priority set by process actions, shown until a snapshot captured after the action
+    QHash<pid_t, char> m_stateOverrides;
+    QHash<pid_t, int> m_priorityOverrides;
+    quint64 m_overridesNs {0}; // CLOCK_MONOTONIC time of the last action
+    ProcessSearchIndex m_searchIndex;
+    // sequence number of the last process set delta applied to the model
+    quint64 m_deltaSeq {0};
 
     QString m_userModeName {};
 };
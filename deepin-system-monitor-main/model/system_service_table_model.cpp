@@ -30,6 +30,7 @@ SystemServiceTableModel::SystemServiceTableModel(QObject *parent)
     // conenct service list & status update slots
     connect(mgr, &ServiceManager::serviceListUpdated, this, &SystemServiceTableModel::updateServiceList);
     connect(mgr, &ServiceManager::serviceStatusUpdated, this, &SystemServiceTableModel::updateServiceEntry);
+    connect(mgr, &ServiceManager::serviceRemoved, this, &SystemServiceTableModel::removeServiceEntry);
 }
 
 // update the model with the data provided by entry
@@ -66,6 +67,29 @@ void SystemServiceTableModel::updateServiceEntry(const SystemServiceEntry &entry
     }
 }
 
+// remove the entry of service sname from the model
+void SystemServiceTableModel::removeServiceEntry(const QString &sname)
+{
+    auto row = m_svcList.indexOf(sname);
+    if (row < 0) {
+        qCDebug(app) << "Service" << sname << "not in model, skipping removal";
+        return;
+    }
+
+    qCDebug(app) << "Removing service entry:" << sname;
+    if (row < m_nr) {
+        beginRemoveRows({}, row, row);
+        m_svcList.removeAt(row);
+        m_svcMap.remove(sname);
+        --m_nr;
+        endRemoveRows();
+    } else {
+        // not fetched into the view yet
+        m_svcList.removeAt(row);
+        m_svcMap.remove(sname);
+    }
+}
+
 // Returns the data stored under the given role for the item referred to by the index
 QVariant SystemServiceTableModel::data(const QModelIndex &index, int role) const
 {
@@ -73,6 +73,11 @@ public:
      * @param entry Model update source entry
      */
     void updateServiceEntry(const SystemServiceEntry &entry);
+    /**
+     * @brief Remove service from model
+     * @param sname Service name of the entry to be removed
+     */
+    void removeServiceEntry(const QString &sname);
 
     /**
      * @brief Get unit file's state
@@ -32,7 +32,8 @@ using namespace common;
 using namespace common::format;
 
 const int gridSize = 10;
-const int pointsNumber = 30;
+// one point per tick over a minute
+const int pointsNumber = SystemMonitor::ticks(60);
 NetworkMonitor::NetworkMonitor(QWidget *parent)
     : QWidget(parent)
 {
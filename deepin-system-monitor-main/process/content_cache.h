@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CONTENT_CACHE_H
+#define CONTENT_CACHE_H
+
+#include "ddlog.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+#include <memory>
+
+// lookups between two hit rate reports in the debug log
+#define CONTENT_CACHE_REPORT_LOOKUPS 16384
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Lookup counters & memory use of a ContentCache
+ */
+struct content_cache_stats_t {
+    quint64 hits {0};
+    quint64 misses {0};
+    int entries {0};
+    int cost {0}; // approximate bytes held by the entries
+    int maxCost {0};
+
+    inline qreal hitRate() const
+    {
+        quint64 lookups = hits + misses;
+        return lookups > 0 ? qreal(hits) / qreal(lookups) * 100. : 0.;
+    }
+};
+
+/**
+ * @brief Values resolved from what a process runs (executable, desktop file, window icon...), not from its pid
+ *
+ * A value is shared by every process resolving to the same key, e.g. all workers of a browser, and outlives
+ * the processes, so short lived processes of the same program are resolved once. The cost of an entry is its
+ * approximate size in bytes, least recently used entries are dropped once maxCost is exceeded.
+ *
+ * Thread safe.
+ */
+template <typename T>
+class ContentCache
+{
+public:
+    ContentCache(const char *name, int maxCost)
+        : m_name(name)
+        , m_cache(maxCost)
+    {
+    }
+
+    /**
+     * @brief Shared value of key, nullptr on miss; every call is counted in stats()
+     */
+    std::shared_ptr<T> find(const QString &key)
+    {
+        QMutexLocker locker(&m_lock);
+        std::shared_ptr<T> *value = m_cache.object(key);
+        if (value)
+            ++m_stats.hits;
+        else
+            ++m_stats.misses;
+        if ((m_stats.hits + m_stats.misses) % CONTENT_CACHE_REPORT_LOOKUPS == 0)
+            qCDebug(DDLog::app) << m_name << "cache hit rate" << m_stats.hitRate() << "%," << m_cache.count()
+                                << "entries," << m_cache.totalCost() << "of" << m_cache.maxCost() << "bytes";
+        return value ? *value : std::shared_ptr<T>();
+    }
+
+    /**
+     * @brief Insert value under key, cost is its approximate size in bytes
+     */
+    void insert(const QString &key, const std::shared_ptr<T> &value, int cost)
+    {
+        QMutexLocker locker(&m_lock);
+        // the key is held by the cache too
+        m_cache.insert(key, new std::shared_ptr<T>(value), qMax(1, cost + key.size() * int(sizeof(QChar))));
+    }
+
+    void remove(const QString &key)
+    {
+        QMutexLocker locker(&m_lock);
+        m_cache.remove(key);
+    }
+
+    bool contains(const QString &key) const
+    {
+        QMutexLocker locker(&m_lock);
+        return m_cache.contains(key);
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&m_lock);
+        m_cache.clear();
+    }
+
+    void setMaxCost(int cost)
+    {
+        QMutexLocker locker(&m_lock);
+        m_cache.setMaxCost(cost);
+    }
+
+    content_cache_stats_t stats() const
+    {
+        QMutexLocker locker(&m_lock);
+        content_cache_stats_t stats = m_stats;
+        stats.entries = m_cache.count();
+        stats.cost = m_cache.totalCost();
+        stats.maxCost = m_cache.maxCost();
+        return stats;
+    }
+
+private:
+    const char *m_name;
+    mutable QMutex m_lock;
+    QCache<QString, std::shared_ptr<T>> m_cache;
+    content_cache_stats_t m_stats;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // CONTENT_CACHE_H
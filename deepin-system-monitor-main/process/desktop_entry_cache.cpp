@@ -7,24 +7,59 @@
 #include "ddlog.h"
 
 #include "desktop_entry_cache_updater.h"
+#include "common/common.h"
 
 #include <QFileInfo>
 #include <QDir>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
 #include <DDesktopEntry>
 #include <QDebug>
 
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
 DCORE_USE_NAMESPACE
 using namespace DDLog;
+using namespace common::error;
 
 namespace core {
 namespace process {
 
 #define DESKTOP_ENTRY_PATH "/usr/share/applications"
 #define DESKTOP_ENTRY_SUFFIX ".desktop"
+// application dirs that can't be watched (not created yet, no inotify) are rescanned this often, in ms
+#define DESKTOP_ENTRY_RESCAN_INTERVAL (5 * 60 * 1000)
+// changes of the files of an application dir, and of the dir itself
+#define DESKTOP_ENTRY_WATCH_MASK (IN_CREATE | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO \
+                                  | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+// index file in the cache dir, the version is bumped whenever desktop_entry_t or its parsing change
+#define DESKTOP_ENTRY_INDEX_FILE "desktop_entries.cache"
+#define DESKTOP_ENTRY_INDEX_MAGIC 0x44534d45
+#define DESKTOP_ENTRY_INDEX_VERSION 1
 
 DesktopEntryCache::DesktopEntryCache()
+    : m_inotifyFd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    , m_loaded(false)
+    , m_indexDirty(false)
+    , m_updater(new DesktopEntryCacheUpdater())
 {
     qCDebug(app) << "DesktopEntryCache created";
+    if (m_inotifyFd < 0)
+        print_errno(errno, "inotify_init1 failed, desktop entries are rescanned periodically");
+
+    const QString &cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDir.isEmpty())
+        m_indexPath = cacheDir + "/" + DESKTOP_ENTRY_INDEX_FILE;
+}
+
+DesktopEntryCache::~DesktopEntryCache()
+{
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
 }
 
 const DesktopEntry DesktopEntryCache::entryWithDesktopFile(const QString &desktopFile)
@@ -36,9 +71,18 @@ const DesktopEntry DesktopEntryCache::entryWithDesktopFile(const QString &deskto
         return {};
     }
 
+    // files of the application dirs are parsed by the index already
+    auto dir = m_dirs.constFind(fileInfo.absolutePath());
+    if (dir != m_dirs.cend()) {
+        auto file = dir->constFind(fileInfo.fileName());
+        if (file != dir->cend() && file->mtime == fileInfo.lastModified().toMSecsSinceEpoch() && file->size == fileInfo.size())
+            return file->entry;
+    }
+
     auto entry = DesktopEntryCacheUpdater::createEntry(fileInfo);
     if (entry) {
         qCDebug(app) << "Entry created, updating cache for:" << fileInfo.fileName();
+        applyLinglongName(entry);
         m_cache[fileInfo.fileName()] = entry;
         m_cache[entry->name] = entry;
     }
@@ -51,11 +95,47 @@ QHash<QString, DesktopEntry> DesktopEntryCache::getCache()
     return m_cache;
 }
 
-void DesktopEntryCache::updateCache()
+bool DesktopEntryCache::updateCache()
 {
-    qCDebug(app) << "Updating cache";
-    m_cache.clear();
+    bool changed = false;
+    if (!m_loaded) {
+        m_loaded = true;
+        m_dirList = applicationDirs();
+        qCDebug(app) << "Application dirs:" << m_dirList;
+        // entries of the last run are usable right away, the scan below only parses what changed since
+        changed = loadIndex();
+    }
+
+    QStringList rescan;
+    changed = readEvents(rescan) || changed;
+
+    bool unwatched = m_watches.size() < m_dirList.size();
+    if (!m_lastScan.isValid() || (unwatched && m_lastScan.hasExpired(DESKTOP_ENTRY_RESCAN_INTERVAL))) {
+        // watched before the scan, so that changes made while scanning are not missed
+        watchDirs();
+        rescan = m_dirList;
+        m_lastScan.start();
+    }
+    rescan.removeDuplicates();
+    for (const QString &dir : rescan)
+        changed = scanDir(dir) || changed;
 
+    changed = applyLinglongNames() || changed;
+
+    if (changed) {
+        qCDebug(app) << "Desktop entries changed, updating cache";
+        rebuildCache();
+        m_indexDirty = true;
+    } else if (m_indexDirty) {
+        // saved once changes settled, e.g. after a package installed many files
+        saveIndex();
+        m_indexDirty = false;
+    }
+    return changed;
+}
+
+QStringList DesktopEntryCache::applicationDirs()
+{
     QString xdgDataDirPath(getenv("XDG_DATA_DIRS"));
     QString xdgDataHomePath(getenv("XDG_DATA_HOME"));
     // Add XDG_DATA_HOME to XDG_DATA_DIRS
@@ -68,26 +148,284 @@ void DesktopEntryCache::updateCache()
         qCDebug(app) << "XDG_DATA_DIRS:" << xdgDataDirPath;
     }
 
+    QStringList dirs;
     if (xdgDataDirPath.isEmpty()) {
         qCDebug(app) << "XDG_DATA_DIRS is empty, using default path";
-        auto fileInfoList = QDir(DESKTOP_ENTRY_PATH).entryInfoList(QDir::Files);
-        for (auto &fileInfo : fileInfoList) {
-            entryWithDesktopFile(fileInfo.filePath());
-        }
+        dirs << DESKTOP_ENTRY_PATH;
     } else {
-        qCDebug(app) << "XDG_DATA_DIRS is set, using it:" << xdgDataDirPath;
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
         QStringList xdgDataDirPaths = xdgDataDirPath.split(":", QString::SkipEmptyParts);
 #else
         QStringList xdgDataDirPaths = xdgDataDirPath.split(":", Qt::SkipEmptyParts);
 #endif
         for (auto path : xdgDataDirPaths) {
-            auto fileInfoList = QDir(path.trimmed() + "/applications").entryInfoList(QDir::Files);
-            for (auto &fileInfo : fileInfoList) {
-                entryWithDesktopFile(fileInfo.filePath());
+            dirs << QDir::cleanPath(path.trimmed() + "/applications");
+        }
+    }
+    dirs.removeDuplicates();
+    return dirs;
+}
+
+bool DesktopEntryCache::updateFile(const QString &dir, const QFileInfo &fileInfo)
+{
+    DesktopDir &files = m_dirs[dir];
+    // same files as QDir::Files lists
+    if (!fileInfo.isFile() || fileInfo.isHidden())
+        return files.remove(fileInfo.fileName()) > 0;
+
+    qint64 mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+    auto it = files.constFind(fileInfo.fileName());
+    if (it != files.cend() && it->mtime == mtime && it->size == fileInfo.size())
+        return false;
+
+    desktop_file_t file;
+    file.mtime = mtime;
+    file.size = fileInfo.size();
+    file.entry = DesktopEntryCacheUpdater::createEntry(fileInfo);
+    applyLinglongName(file.entry);
+    files.insert(fileInfo.fileName(), file);
+    return true;
+}
+
+bool DesktopEntryCache::scanDir(const QString &dir)
+{
+    bool changed = false;
+    QSet<QString> seen;
+    const QFileInfoList &fileInfoList = QDir(dir).entryInfoList(QDir::Files);
+    for (const QFileInfo &fileInfo : fileInfoList) {
+        seen.insert(fileInfo.fileName());
+        changed = updateFile(dir, fileInfo) || changed;
+    }
+
+    DesktopDir &files = m_dirs[dir];
+    for (auto it = files.begin(); it != files.end();) {
+        if (!seen.contains(it.key())) {
+            it = files.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+    return changed;
+}
+
+void DesktopEntryCache::watchDirs()
+{
+    if (m_inotifyFd < 0)
+        return;
+
+    const QList<QString> &watched = m_watches.values();
+    for (const QString &dir : m_dirList) {
+        if (watched.contains(dir))
+            continue;
+
+        int wd = inotify_add_watch(m_inotifyFd, dir.toLocal8Bit().constData(), DESKTOP_ENTRY_WATCH_MASK);
+        if (wd >= 0)
+            m_watches.insert(wd, dir);
+        else if (errno != ENOENT && errno != ENOTDIR)
+            print_errno(errno, QString("watch %1 failed").arg(dir));
+        // dirs that don't exist yet are picked up by the periodic rescan
+    }
+}
+
+bool DesktopEntryCache::readEvents(QStringList &rescan)
+{
+    if (m_inotifyFd < 0)
+        return false;
+
+    bool changed = false;
+    alignas(struct inotify_event) char buf[4096];
+    for (;;) {
+        ssize_t n = read(m_inotifyFd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && errno != EAGAIN)
+            print_errno(errno, "read inotify events failed");
+        if (n <= 0)
+            break;
+
+        for (char *ptr = buf; ptr < buf + n;) {
+            auto *event = reinterpret_cast<struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                qCWarning(app) << "Desktop entry events overflowed, rescanning application dirs";
+                rescan = m_dirList;
+                continue;
+            }
+
+            auto dir = m_watches.constFind(event->wd);
+            if (dir == m_watches.cend())
+                continue;
+
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                // dir went away, it is watched again by the periodic rescan once it is back
+                qCDebug(app) << "Application dir" << *dir << "went away";
+                if (event->mask & IN_MOVE_SELF)
+                    inotify_rm_watch(m_inotifyFd, event->wd);
+                rescan << *dir;
+                m_watches.erase(dir);
+                continue;
+            }
+
+            if (event->len > 0)
+                changed = updateFile(*dir, QFileInfo(*dir + "/" + QString::fromLocal8Bit(event->name))) || changed;
+        }
+    }
+    return changed;
+}
+
+bool DesktopEntryCache::applyLinglongName(DesktopEntry &entry)
+{
+    // name is only looked up with ll-cli if the file doesn't name the app (StartupWMClass...)
+    if (!entry || entry->linglong.isEmpty() || !entry->name.isEmpty())
+        return false;
+
+    auto name = m_linglongNames.constFind(entry->linglong);
+    if (name == m_linglongNames.cend()) {
+        m_updater->requestLinglongName(entry->linglong);
+        return false;
+    }
+
+    // entries handed out before are left as is
+    DesktopEntry named = std::make_shared<struct desktop_entry_t>(*entry);
+    named->name = *name;
+    entry = named;
+    return true;
+}
+
+bool DesktopEntryCache::applyLinglongNames()
+{
+    const QHash<QString, QString> &names = m_updater->takeLinglongNames();
+    bool found = false;
+    for (auto it = names.cbegin(); it != names.cend(); ++it) {
+        if (!it.value().isEmpty()) {
+            m_linglongNames.insert(it.key(), it.value());
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    bool changed = false;
+    for (DesktopDir &files : m_dirs) {
+        for (desktop_file_t &file : files)
+            changed = applyLinglongName(file.entry) || changed;
+    }
+    // names are saved with the index, so ll-cli is not run again on the next start
+    m_indexDirty = true;
+    return changed;
+}
+
+void DesktopEntryCache::rebuildCache()
+{
+    m_cache.clear();
+    // entries of later dirs override earlier ones
+    for (const QString &dir : m_dirList) {
+        const DesktopDir &files = m_dirs.value(dir);
+        for (auto it = files.cbegin(); it != files.cend(); ++it) {
+            if (!it->entry)
+                continue;
+            m_cache[it.key()] = it->entry;
+            m_cache[it->entry->name] = it->entry;
+        }
+    }
+}
+
+bool DesktopEntryCache::loadIndex()
+{
+    if (m_indexPath.isEmpty())
+        return false;
+
+    QFile file(m_indexPath);
+    // not saved yet
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QStringList dirs;
+    stream >> magic >> version;
+    if (magic != DESKTOP_ENTRY_INDEX_MAGIC || version != DESKTOP_ENTRY_INDEX_VERSION) {
+        qCInfo(app) << "Desktop entry index" << m_indexPath << "is outdated, rebuilding it";
+        return false;
+    }
+    stream >> dirs;
+    if (dirs != m_dirList) {
+        qCInfo(app) << "Application dirs changed, rebuilding desktop entry index";
+        return false;
+    }
+
+    QHash<QString, DesktopDir> index;
+    for (const QString &dir : dirs) {
+        qint32 count = 0;
+        stream >> count;
+        DesktopDir &files = index[dir];
+        for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+            QString name;
+            desktop_file_t desktopFile;
+            bool hasEntry = false;
+            stream >> name >> desktopFile.mtime >> desktopFile.size >> hasEntry;
+            if (hasEntry) {
+                desktopFile.entry = std::make_shared<struct desktop_entry_t>();
+                stream >> desktopFile.entry->name >> desktopFile.entry->displayName >> desktopFile.entry->exec
+                       >> desktopFile.entry->icon >> desktopFile.entry->startup_wm_class >> desktopFile.entry->linglong;
             }
+            files.insert(name, desktopFile);
         }
     }
+    QHash<QString, QString> linglongNames;
+    stream >> linglongNames;
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(app) << "Desktop entry index" << m_indexPath << "is corrupted, rebuilding it";
+        return false;
+    }
+
+    m_dirs = index;
+    m_linglongNames = linglongNames;
+    for (DesktopDir &files : m_dirs) {
+        for (desktop_file_t &desktopFile : files)
+            applyLinglongName(desktopFile.entry);
+    }
+    rebuildCache();
+    qCInfo(app) << "Loaded" << m_cache.size() << "desktop entries from" << m_indexPath;
+    return true;
+}
+
+void DesktopEntryCache::saveIndex() const
+{
+    if (m_indexPath.isEmpty())
+        return;
+
+    QDir().mkpath(QFileInfo(m_indexPath).absolutePath());
+    QSaveFile file(m_indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(app) << "Failed to write desktop entry index" << m_indexPath << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << quint32(DESKTOP_ENTRY_INDEX_MAGIC) << quint32(DESKTOP_ENTRY_INDEX_VERSION) << m_dirList;
+    for (const QString &dir : m_dirList) {
+        const DesktopDir &files = m_dirs.value(dir);
+        stream << qint32(files.size());
+        for (auto it = files.cbegin(); it != files.cend(); ++it) {
+            stream << it.key() << it->mtime << it->size << bool(it->entry);
+            if (it->entry) {
+                stream << it->entry->name << it->entry->displayName << it->entry->exec
+                       << it->entry->icon << it->entry->startup_wm_class << it->entry->linglong;
+            }
+        }
+    }
+    stream << m_linglongNames;
+
+    if (!file.commit())
+        qCWarning(app) << "Failed to write desktop entry index" << m_indexPath << file.errorString();
+    else
+        qCDebug(app) << "Saved desktop entry index" << m_indexPath;
 }
 
 } // namespace process
@@ -6,7 +6,11 @@
 #ifndef DESKTOP_ENTRY_CACHE_H
 #define DESKTOP_ENTRY_CACHE_H
 
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QHash>
+#include <QMap>
+#include <QStringList>
 
 #include <memory>
 
@@ -19,14 +23,25 @@ struct desktop_entry_t {
     QStringList exec;
     QString icon;
     QString startup_wm_class;
+    QString linglong; // X-linglong id of a linglong app, name is looked up with ll-cli
 };
 using DesktopEntry = std::shared_ptr<struct desktop_entry_t>;
 
+class DesktopEntryCacheUpdater;
+
+/**
+ * @brief Desktop entries of the application directories of XDG_DATA_DIRS & XDG_DATA_HOME
+ *
+ * The index is incremental: files are parsed once and only parsed again when inotify reports a change,
+ * or when their mtime or size changed if a directory can't be watched (rescanned every
+ * DESKTOP_ENTRY_RESCAN_INTERVAL). Parsed entries & linglong names are saved to an index file in the
+ * cache directory, so a cold start only stats the files.
+ */
 class DesktopEntryCache
 {
 public:
     explicit DesktopEntryCache();
-    virtual ~DesktopEntryCache() = default;
+    virtual ~DesktopEntryCache();
 
     bool contains(const QString &name) const;
     const DesktopEntry entry(const QString &name) const;
@@ -34,11 +49,63 @@ public:
     const DesktopEntry entryWithSubName(const QString &subName) const;
     QHash<QString, DesktopEntry> getCache();
 
-    void updateCache();
+    /**
+     * @brief Apply changes of the application directories & linglong names looked up since the last call
+     * @return true if entries changed
+     */
+    bool updateCache();
 
+    /**
+     * @brief Directories desktop files are read from, later ones override entries of earlier ones
+     */
+    static QStringList applicationDirs();
 
 private:
-    QHash<QString, DesktopEntry> m_cache;
+    struct desktop_file_t {
+        qint64 mtime {0};
+        qint64 size {0};
+        DesktopEntry entry; // nullptr if the file is not an app
+    };
+    // desktop files of an application directory, by file name
+    using DesktopDir = QMap<QString, desktop_file_t>;
+
+    /**
+     * @brief Parse fileInfo of dir again if it changed since it was parsed, drop it if it is gone
+     * @return true if the entry changed
+     */
+    bool updateFile(const QString &dir, const QFileInfo &fileInfo);
+    /**
+     * @brief Stat every file of dir, parse changed files & drop removed ones
+     */
+    bool scanDir(const QString &dir);
+    void watchDirs();
+    /**
+     * @brief Apply inotify events, dirs that can't be tracked by events are added to rescan
+     */
+    bool readEvents(QStringList &rescan);
+    /**
+     * @brief Set the name of linglong entries from names looked up so far, or queue their lookup
+     */
+    bool applyLinglongName(DesktopEntry &entry);
+    bool applyLinglongNames();
+    void rebuildCache();
+
+    bool loadIndex();
+    void saveIndex() const;
+
+    QHash<QString, DesktopEntry> m_cache; // by file name & entry name
+    QHash<QString, DesktopDir> m_dirs;
+    QStringList m_dirList; // application dirs the index was built from
+    QHash<QString, QString> m_linglongNames; // by X-linglong id
+
+    int m_inotifyFd;
+    QHash<int, QString> m_watches; // application dir by watch descriptor
+    QElapsedTimer m_lastScan;
+    bool m_loaded;
+    bool m_indexDirty;
+    QString m_indexPath;
+
+    std::unique_ptr<DesktopEntryCacheUpdater> m_updater;
 };
 
 inline bool DesktopEntryCache::contains(const QString &name) const
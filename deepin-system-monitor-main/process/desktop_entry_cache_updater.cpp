@@ -12,6 +12,12 @@
 #include <QProcess>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMutexLocker>
+
+// ll-cli of linglong apps
+#define LINGLONG_CLI_PATH "/usr/bin/ll-cli"
+// time a ll-cli info lookup is given
+#define LINGLONG_CLI_TIMEOUT 5000
 
 DCORE_USE_NAMESPACE
 using namespace DDLog;
@@ -21,7 +27,88 @@ namespace process {
 
 DesktopEntryCacheUpdater::DesktopEntryCacheUpdater(QObject *parent)
     : QObject(parent)
+    , m_quit(false)
+{
+}
+
+DesktopEntryCacheUpdater::~DesktopEntryCacheUpdater()
 {
+    if (m_thread) {
+        {
+            QMutexLocker locker(&m_lock);
+            m_quit = true;
+            m_wakeup.wakeAll();
+        }
+        m_thread->wait();
+    }
+}
+
+void DesktopEntryCacheUpdater::requestLinglongName(const QString &id)
+{
+    QMutexLocker locker(&m_lock);
+    if (m_requested.contains(id))
+        return;
+
+    m_requested.insert(id);
+    m_pending << id;
+    if (!m_thread) {
+        m_thread.reset(QThread::create([this]() { run(); }));
+        m_thread->start(QThread::LowPriority);
+    }
+    m_wakeup.wakeAll();
+}
+
+QHash<QString, QString> DesktopEntryCacheUpdater::takeLinglongNames()
+{
+    QMutexLocker locker(&m_lock);
+    QHash<QString, QString> names;
+    names.swap(m_names);
+    return names;
+}
+
+QString DesktopEntryCacheUpdater::parseLinglongInfo(const QByteArray &output)
+{
+    // Parse JSON output to get name field
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(output);
+    if (!jsonDoc.isNull() && jsonDoc.isObject()) {
+        qCDebug(app) << "Parsing linglong info json";
+        QJsonObject jsonObj = jsonDoc.object();
+        if (jsonObj.contains("name")) {
+            qCDebug(app) << "Found name in linglong json:" << jsonObj["name"].toString();
+            return jsonObj["name"].toString();
+        }
+    }
+    return {};
+}
+
+void DesktopEntryCacheUpdater::run()
+{
+    QMutexLocker locker(&m_lock);
+    while (!m_quit) {
+        if (m_pending.isEmpty()) {
+            m_wakeup.wait(&m_lock);
+            continue;
+        }
+
+        const QString id = m_pending.takeFirst();
+        locker.unlock();
+
+        qCDebug(app) << "Looking up linglong app" << id;
+        QProcess process;
+        process.start(LINGLONG_CLI_PATH, QStringList() << "info" << id);
+        QString name;
+        if (process.waitForFinished(LINGLONG_CLI_TIMEOUT))
+            name = parseLinglongInfo(process.readAllStandardOutput());
+        else
+            qCWarning(app) << "ll-cli info" << id << "did not finish:" << process.errorString();
+        if (process.state() != QProcess::NotRunning) {
+            process.kill();
+            process.waitForFinished();
+        }
+
+        locker.relock();
+        m_names.insert(id, name);
+    }
 }
 
 DesktopEntry DesktopEntryCacheUpdater::createEntry(const QFileInfo &fileInfo)
@@ -54,27 +141,13 @@ DesktopEntry DesktopEntryCacheUpdater::createEntry(const QFileInfo &fileInfo)
 #endif
     QString exec = execList.size() > 1 ? execList.last().trimmed() : execStr.trimmed();
     exec = exec.remove("\"");
-    if (tryExec == "/usr/bin/ll-cli") {
+    if (tryExec == LINGLONG_CLI_PATH) {
         qCDebug(app) << "Found linglong app";
         auto linglongStr = dde.stringValue("X-linglong");
         if (!linglongStr.isEmpty()) {
             qCDebug(app) << "linglong string:" << linglongStr;
-            // Use QProcess to get application info
-            QProcess process;
-            process.start("/usr/bin/ll-cli", QStringList() << "info" << linglongStr);
-            process.waitForFinished(5000);
-            QString output = QString::fromUtf8(process.readAllStandardOutput());
-
-            // Parse JSON output to get name field
-            QJsonDocument jsonDoc = QJsonDocument::fromJson(output.toUtf8());
-            if (!jsonDoc.isNull() && jsonDoc.isObject()) {
-                qCDebug(app) << "Parsing linglong info json";
-                QJsonObject jsonObj = jsonDoc.object();
-                if (jsonObj.contains("name")) {
-                    entry->name = jsonObj["name"].toString();
-                    qCDebug(app) << "Found name in linglong json:" << entry->name;
-                }
-            }
+            // name is looked up with ll-cli by DesktopEntryCache, off the thread parsing the file
+            entry->linglong = linglongStr;
 
             if (!exec.isEmpty()) {
                 qCDebug(app) << "Exec is not empty, use exec";
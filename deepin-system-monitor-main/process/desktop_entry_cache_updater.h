@@ -8,12 +8,26 @@
 
 #include <QObject>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
 
 #include "desktop_entry_cache.h"
 
+#include <memory>
+
 namespace core {
 namespace process {
 
+/**
+ * @brief Parses desktop files, and looks up names of linglong apps with ll-cli on its own thread
+ *
+ * ll-cli may take seconds to answer, lookups are queued with requestLinglongName() and picked up later
+ * with takeLinglongNames(), so the monitor thread never waits on it.
+ */
 class DesktopEntryCacheUpdater : public QObject
 {
     Q_OBJECT
@@ -21,9 +35,37 @@ class DesktopEntryCacheUpdater : public QObject
 
 public:
     explicit DesktopEntryCacheUpdater(QObject *parent = nullptr);
-    ~DesktopEntryCacheUpdater() override = default;
+    ~DesktopEntryCacheUpdater() override;
 
+    /**
+     * @brief Parse a desktop file; name of a linglong app is left empty, see desktop_entry_t::linglong
+     */
     static DesktopEntry createEntry(const QFileInfo &fileInfo);
+
+    /**
+     * @brief Queue the lookup of the name of linglong app id, each id is looked up once
+     */
+    void requestLinglongName(const QString &id);
+    /**
+     * @brief Names looked up since the last call, by id; empty if ll-cli failed
+     */
+    QHash<QString, QString> takeLinglongNames();
+
+    /**
+     * @brief Name field of the output of ll-cli info
+     */
+    static QString parseLinglongInfo(const QByteArray &output);
+
+private:
+    void run();
+
+    QMutex m_lock;
+    QWaitCondition m_wakeup;
+    QStringList m_pending;
+    QSet<QString> m_requested;
+    QHash<QString, QString> m_names;
+    bool m_quit;
+    std::unique_ptr<QThread> m_thread;
 };
 
 } // namespace process
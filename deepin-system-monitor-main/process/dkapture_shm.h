@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DKAPTURE_SHM_H
+#define DKAPTURE_SHM_H
+
+/**
+ * DKapture 进程数据共享内存布局, 由 system server (写) 与 system monitor (只读映射) 共用
+ *
+ * memfd 由一个段头和 DKAPTURE_SHM_SLOTS 个槽组成, 每个槽保存一批固定布局的进程记录.
+ * 每次批量读取写入下一个槽, D-Bus 只返回该批次的序号, 槽号为 seq % slotCount.
+ * 写入时槽序号先置 0, 写完后再发布批次序号, 读端在读取前后各检查一次序号.
+ */
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <fcntl.h>
+#include <stddef.h>
+
+#define DKAPTURE_SHM_MAGIC 0x444b5052 // "DKPR"
+#define DKAPTURE_SHM_VERSION 1
+#define DKAPTURE_SHM_SLOTS 4 // batches kept, a reader may lag this many batches - 1
+#define DKAPTURE_SHM_SLOT_RECORDS 16384 // processes per batch, pages are only touched as used
+#define DKAPTURE_SHM_ALIGN 64
+
+// Linux 5.1, only the mapping made before sealing stays writable
+#ifndef F_SEAL_FUTURE_WRITE
+#define F_SEAL_FUTURE_WRITE 0x0010
+#endif
+// seals the server applies and the client requires: fixed size, no write access besides the server's mapping
+#define DKAPTURE_SHM_SEALS (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_FUTURE_WRITE)
+
+// tables present in a record
+enum DKaptureShmField {
+    kDKFieldStat = 0x01,
+    kDKFieldIo = 0x02,
+    kDKFieldStatm = 0x04,
+    kDKFieldStatus = 0x08,
+    kDKFieldSchedstat = 0x10
+};
+
+/**
+ * @brief Process record of one batch, values are already converted as getProcessInfoBatch() returns them
+ */
+struct dk_proc_record_t {
+    qint32 pid;
+    qint32 tgid;
+    quint32 fields; // DKaptureShmField mask
+    qint32 ppid;
+
+    // stat
+    qint32 state; // DKapture state bits, highest bit set is the state
+    qint32 priority;
+    qint32 nice;
+    qint32 num_threads;
+    quint64 utime; // jiffies
+    quint64 stime;
+    quint64 cutime;
+    quint64 cstime;
+    quint64 cpu_time; // seconds
+    quint64 start_time;
+    quint64 vsize; // bytes
+    quint64 rss; // bytes
+
+    // io
+    quint64 rchar;
+    quint64 wchar;
+    quint64 syscr;
+    quint64 syscw;
+    quint64 read_bytes;
+    quint64 write_bytes;
+    quint64 cancelled_write_bytes;
+
+    // statm, pages
+    quint64 memory_size;
+    quint64 memory_resident;
+    quint64 memory_shared;
+    quint64 memory_text;
+    quint64 memory_data;
+
+    // status
+    quint32 uid[4]; // uid euid suid fsuid
+    quint32 gid[4]; // gid egid sgid fsgid
+    qint32 status_state;
+    qint32 tracer_pid;
+    qint32 umask;
+    qint32 reserved;
+
+    // schedstat
+    quint64 rq_wait_time; // ns
+
+    char comm[16];
+};
+
+struct dk_shm_header_t {
+    quint32 magic;
+    quint32 version;
+    quint32 recordSize;
+    quint32 slotCount;
+    quint32 slotRecords;
+    quint32 reserved;
+    quint64 size; // whole segment
+};
+
+struct alignas(DKAPTURE_SHM_ALIGN) dk_shm_slot_t {
+    std::atomic<quint64> seq; // batch sequence number, 0 while the slot is written
+    quint32 count; // records of the batch
+    quint32 dropped; // processes not stored because the slot was full
+    // dk_proc_record_t records[slotRecords] follow
+};
+
+static_assert(sizeof(dk_proc_record_t) % 8 == 0, "dk_proc_record_t must stay 8 bytes aligned");
+static_assert(sizeof(dk_shm_header_t) <= DKAPTURE_SHM_ALIGN, "dk_shm_header_t must fit its cache line");
+static_assert(sizeof(dk_shm_slot_t) == DKAPTURE_SHM_ALIGN, "dk_shm_slot_t must fill one cache line");
+static_assert(std::atomic<quint64>::is_always_lock_free, "shared sequence number must be lock free");
+
+inline size_t dkShmSlotSize(quint32 slotRecords)
+{
+    // every slot starts on its own cache line
+    size_t size = sizeof(dk_shm_slot_t) + size_t(slotRecords) * sizeof(dk_proc_record_t);
+    return (size + DKAPTURE_SHM_ALIGN - 1) & ~size_t(DKAPTURE_SHM_ALIGN - 1);
+}
+
+inline size_t dkShmSize(quint32 slotCount, quint32 slotRecords)
+{
+    return DKAPTURE_SHM_ALIGN + size_t(slotCount) * dkShmSlotSize(slotRecords);
+}
+
+inline dk_shm_slot_t *dkShmSlot(void *base, const dk_shm_header_t *hdr, quint64 seq)
+{
+    char *p = static_cast<char *>(base) + DKAPTURE_SHM_ALIGN;
+    return reinterpret_cast<dk_shm_slot_t *>(p + (seq % hdr->slotCount) * dkShmSlotSize(hdr->slotRecords));
+}
+
+inline dk_proc_record_t *dkShmRecords(dk_shm_slot_t *slot)
+{
+    return reinterpret_cast<dk_proc_record_t *>(slot + 1);
+}
+
+/**
+ * @brief Whether seals (F_GET_SEALS of the segment) protect it against resizing & writes by clients
+ */
+inline bool dkShmSealed(int seals)
+{
+    return seals >= 0 && (seals & DKAPTURE_SHM_SEALS) == DKAPTURE_SHM_SEALS;
+}
+
+/**
+ * @brief Check the segment header of a mapping of size bytes
+ * @return Header if the layout matches this build, otherwise nullptr
+ */
+inline const dk_shm_header_t *dkShmHeader(const void *base, size_t size)
+{
+    if (!base || size < DKAPTURE_SHM_ALIGN)
+        return nullptr;
+
+    const dk_shm_header_t *hdr = static_cast<const dk_shm_header_t *>(base);
+    if (hdr->magic != DKAPTURE_SHM_MAGIC || hdr->version != DKAPTURE_SHM_VERSION
+        || hdr->recordSize != sizeof(dk_proc_record_t) || hdr->slotCount == 0 || hdr->slotRecords == 0
+        || hdr->size != size || dkShmSize(hdr->slotCount, hdr->slotRecords) > size)
+        return nullptr;
+    return hdr;
+}
+
+/**
+ * @brief Records of batch seq in a read only mapping
+ *
+ * The slot is reused slotCount batches later, check isCurrent() after the records were consumed
+ */
+struct dk_shm_batch_t {
+    const dk_shm_slot_t *slot = nullptr;
+    const dk_proc_record_t *records = nullptr;
+    quint32 count = 0;
+    quint64 seq = 0;
+
+    inline bool isValid() const
+    {
+        return slot != nullptr;
+    }
+    inline bool isCurrent() const
+    {
+        // record reads must not move past the check
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot && slot->seq.load(std::memory_order_relaxed) == seq;
+    }
+};
+
+inline dk_shm_batch_t dkShmBatch(const void *base, size_t size, quint64 seq)
+{
+    dk_shm_batch_t batch;
+    const dk_shm_header_t *hdr = dkShmHeader(base, size);
+    if (!hdr || seq == 0)
+        return batch;
+
+    const dk_shm_slot_t *slot = dkShmSlot(const_cast<void *>(base), hdr, seq);
+    if (slot->seq.load(std::memory_order_acquire) != seq)
+        return batch;
+
+    batch.slot = slot;
+    batch.records = dkShmRecords(const_cast<dk_shm_slot_t *>(slot));
+    batch.count = qMin(slot->count, hdr->slotRecords);
+    batch.seq = seq;
+    return batch;
+}
+
+#endif // DKAPTURE_SHM_H
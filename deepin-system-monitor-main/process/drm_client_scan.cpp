@@ -0,0 +1,329 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "drm_client_scan.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "common/source_reader.h"
+#include "common/source_root.h"
+
+#include <QMutexLocker>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROC_FD_PATH "/proc/%d/fd"
+#define PROC_FDINFO_PATH "/proc/%d/fdinfo/%d"
+// device nodes of DRM render/primary nodes & compute accelerators
+#define DRM_DEV_PATH "/dev/dri/"
+#define ACCEL_DEV_PATH "/dev/accel/"
+// scans between two walks of a process whose cached fds are all still DRM clients
+#define DRM_FD_RESCAN_TICKS 5
+// fdinfo of a DRM fd is well below a page, even with many engines & regions
+#define DRM_FDINFO_BUF_SIZE 4096
+
+using namespace common::alloc;
+using namespace common::error;
+using namespace common::source;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+// value of a "key:\tvalue [unit]" fdinfo line, memory sizes are returned in bytes
+static quint64 parseValue(const char *value)
+{
+    char *end = nullptr;
+    quint64 v = strtoull(value, &end, 10);
+    while (end && (*end == ' ' || *end == '\t'))
+        ++end;
+    if (!end || *end == '\n' || *end == '\0')
+        return v;
+    if (!strncmp(end, "KiB", 3))
+        return v << 10;
+    if (!strncmp(end, "MiB", 3))
+        return v << 20;
+    if (!strncmp(end, "GiB", 3))
+        return v << 30;
+    return v;
+}
+
+static drm_engine_t &engineOf(drm_fdinfo_t &info, const char *name, int len)
+{
+    for (drm_engine_t &engine : info.engines) {
+        if (engine.name.size() == len && !memcmp(engine.name.constData(), name, size_t(len)))
+            return engine;
+    }
+    info.engines.append(drm_engine_t {});
+    info.engines.last().name = QByteArray(name, len);
+    return info.engines.last();
+}
+
+// vram of discrete devices is named vram (amdgpu, xe) or local (i915)
+static inline bool isVramRegion(const QByteArray &region)
+{
+    return region.startsWith("vram") || region.startsWith("local");
+}
+
+DrmClientScan::DrmClientScan()
+    : m_demand {false}
+    , m_wanted {false}
+    , m_tick {0}
+    , m_nowNs {0}
+    , m_epoch {1}
+    , m_walks {0}
+    , m_reads {0}
+    , m_lastWalks {0}
+    , m_lastReads {0}
+{
+}
+
+void DrmClientScan::setWanted(const void *client, bool wanted)
+{
+    QMutexLocker locker(&m_clientsLock);
+    if (wanted)
+        m_clients.insert(client);
+    else
+        m_clients.remove(client);
+    m_demand.store(!m_clients.isEmpty());
+}
+
+void DrmClientScan::beginScan(quint64 nowNs)
+{
+    bool wanted = m_demand.load();
+    if (wanted && !m_wanted) {
+        qCDebug(app) << "GPU columns shown, walking fds of all processes for DRM clients";
+        ++m_epoch;
+    }
+    m_wanted = wanted;
+    m_nowNs = nowNs;
+    ++m_tick;
+    m_walks = 0;
+    m_reads = 0;
+}
+
+void DrmClientScan::endScan()
+{
+    QVector<pid_t> gone;
+    for (int i = 0; i < m_pids.size(); ++i) {
+        if (m_pids.valueAt(i).tick != m_tick)
+            gone << m_pids.keyAt(i);
+    }
+    for (pid_t pid : gone)
+        m_pids.remove(pid);
+
+    for (auto it = m_drmClients.begin(); it != m_drmClients.end();) {
+        if (it->tick != m_tick)
+            it = m_drmClients.erase(it);
+        else
+            ++it;
+    }
+
+    m_lastWalks = m_walks;
+    m_lastReads = m_reads;
+}
+
+drm_usage_t DrmClientScan::scanProcess(pid_t pid)
+{
+    drm_usage_t usage;
+    if (!m_wanted)
+        return usage;
+
+    pid_state_t &state = m_pids[pid];
+    state.tick = m_tick;
+
+    // periodic walk, spread over pids so that not all processes are walked on the same scan
+    bool walk = (m_tick + quint64(pid)) % DRM_FD_RESCAN_TICKS == 0;
+    // fds of processes owned by other users are not readable, retried on periodic walks only
+    if (state.readable)
+        walk = walk || state.epoch != m_epoch || state.stale;
+    if (walk) {
+        state.readable = walkFds(pid, state.fds);
+        state.epoch = m_epoch;
+        state.stale = false;
+        ++m_walks;
+    }
+
+    // clients of this process, fds dup'ed from the same open share one
+    QVector<QByteArray> keys;
+    for (int fd : state.fds) {
+        drm_fdinfo_t info;
+        if (!readFdinfo(pid, fd, info)) {
+            // closed, or reused for something else
+            state.stale = true;
+            continue;
+        }
+
+        QByteArray key = info.pdev + '/' + QByteArray::number(info.clientId);
+        if (keys.contains(key))
+            continue;
+        keys << key;
+
+        client_state_t &client = m_drmClients[key];
+        // inherited client, already accounted to a process scanned before
+        if (client.tick == m_tick)
+            continue;
+
+        if (client.tick != 0 && m_nowNs > client.sampleNs)
+            usage.gpu += busyPercent(client, info, m_nowNs - client.sampleNs);
+        usage.memory += info.hasVram ? info.vram : info.memory;
+
+        client.engines.clear();
+        for (const drm_engine_t &engine : info.engines)
+            client.engines.insert(engine.name, engine);
+        client.sampleNs = m_nowNs;
+        client.tick = m_tick;
+    }
+    usage.gpu = qMin(usage.gpu, 100.);
+    return usage;
+}
+
+bool DrmClientScan::parseFdinfo(const char *buf, drm_fdinfo_t &info)
+{
+    // legacy drm-memory-<region> is the resident size, newer drivers only report drm-resident-<region>
+    QHash<QByteArray, quint64> memoryRegions;
+    QHash<QByteArray, quint64> residentRegions;
+    bool hasClientId = false;
+
+    const char *line = buf;
+    while (line && *line) {
+        const char *eol = strchr(line, '\n');
+        const char *colon = strchr(line, ':');
+        if (!colon || (eol && colon > eol) || strncmp(line, "drm-", 4)) {
+            line = eol ? eol + 1 : nullptr;
+            continue;
+        }
+
+        const char *key = line + 4;
+        int keyLen = int(colon - key);
+        const char *value = colon + 1;
+        while (*value == ' ' || *value == '\t')
+            ++value;
+
+        auto suffix = [&](const char *prefix, const char *&name, int &len) {
+            int n = int(strlen(prefix));
+            if (keyLen <= n || strncmp(key, prefix, size_t(n)))
+                return false;
+            name = key + n;
+            len = keyLen - n;
+            return true;
+        };
+        const char *name = nullptr;
+        int len = 0;
+
+        if (keyLen == 4 && !strncmp(key, "pdev", 4)) {
+            const char *end = eol ? eol : value + strlen(value);
+            info.pdev = QByteArray(value, int(end - value)).trimmed();
+        } else if (keyLen == 9 && !strncmp(key, "client-id", 9)) {
+            info.clientId = parseValue(value);
+            hasClientId = true;
+        } else if (suffix("engine-capacity-", name, len)) {
+            engineOf(info, name, len).capacity = quint32(qMax<quint64>(1, parseValue(value)));
+        } else if (suffix("engine-", name, len)) {
+            engineOf(info, name, len).busyNs = parseValue(value);
+        } else if (suffix("total-cycles-", name, len)) {
+            engineOf(info, name, len).totalCycles = parseValue(value);
+        } else if (suffix("cycles-", name, len)) {
+            engineOf(info, name, len).cycles = parseValue(value);
+        } else if (suffix("memory-", name, len)) {
+            memoryRegions.insert(QByteArray(name, len), parseValue(value));
+        } else if (suffix("resident-", name, len)) {
+            residentRegions.insert(QByteArray(name, len), parseValue(value));
+        }
+
+        line = eol ? eol + 1 : nullptr;
+    }
+
+    const QHash<QByteArray, quint64> &regions = memoryRegions.isEmpty() ? residentRegions : memoryRegions;
+    for (auto it = regions.cbegin(); it != regions.cend(); ++it) {
+        info.memory += it.value();
+        if (isVramRegion(it.key())) {
+            info.vram += it.value();
+            info.hasVram = true;
+        }
+    }
+    return hasClientId;
+}
+
+bool DrmClientScan::walkFds(pid_t pid, QVector<int> &fds)
+{
+    char path[PATH_MAX];
+    formatPath(path, sizeof(path), PROC_FD_PATH, pid);
+    fds.clear();
+
+    errno = 0;
+    uDir dir(opendir(path));
+    if (!dir) {
+        // fd dir of processes owned by other users is not readable, which is expected
+        if (errno != EACCES && errno != EPERM && errno != ENOENT)
+            print_errno(errno, QString("open %1 failed").arg(path));
+        return false;
+    }
+
+    static const size_t drmLen = strlen(DRM_DEV_PATH);
+    static const size_t accelLen = strlen(ACCEL_DEV_PATH);
+    int dfd = dirfd(dir.get());
+    struct dirent *dp;
+    // only the prefix of the link target matters, longer targets are truncated
+    char target[64];
+    while ((dp = readdir(dir.get()))) {
+        if (!isdigit(dp->d_name[0]))
+            continue;
+        ssize_t n = readlinkat(dfd, dp->d_name, target, sizeof(target) - 1);
+        if (n <= 0)
+            continue;
+        target[n] = '\0';
+        if (!strncmp(target, DRM_DEV_PATH, drmLen) || !strncmp(target, ACCEL_DEV_PATH, accelLen))
+            fds << atoi(dp->d_name);
+    }
+    return true;
+}
+
+bool DrmClientScan::readFdinfo(pid_t pid, int fd, drm_fdinfo_t &info)
+{
+    char path[PATH_MAX];
+    formatPath(path, sizeof(path), PROC_FDINFO_PATH, pid, fd);
+
+    ++m_reads;
+    int handle = reader()->open(path);
+    if (handle < 0)
+        return false;
+
+    char buf[DRM_FDINFO_BUF_SIZE];
+    ssize_t n = reader()->pread(handle, buf, sizeof(buf) - 1, 0);
+    reader()->close(handle);
+    if (n <= 0)
+        return false;
+
+    buf[n] = '\0';
+    return parseFdinfo(buf, info);
+}
+
+qreal DrmClientScan::busyPercent(const client_state_t &prev, const drm_fdinfo_t &info, quint64 elapsedNs)
+{
+    qreal busiest = 0.;
+    for (const drm_engine_t &engine : info.engines) {
+        auto it = prev.engines.constFind(engine.name);
+        if (it == prev.engines.cend())
+            continue;
+
+        qreal busy = 0.;
+        if (engine.totalCycles > it->totalCycles && engine.cycles >= it->cycles) {
+            // gpu cycles spent on the client over cycles elapsed on the engine
+            busy = qreal(engine.cycles - it->cycles) / qreal(engine.totalCycles - it->totalCycles) * 100.;
+        } else if (engine.busyNs >= it->busyNs && elapsedNs > 0) {
+            busy = qreal(engine.busyNs - it->busyNs) / (qreal(elapsedNs) * engine.capacity) * 100.;
+        }
+        busiest = qMax(busiest, busy);
+    }
+    return qMin(busiest, 100.);
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DRM_CLIENT_SCAN_H
+#define DRM_CLIENT_SCAN_H
+
+#include "pid_index.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QVector>
+
+#include <atomic>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Usage counters of one engine of a DRM client
+ */
+struct drm_engine_t {
+    QByteArray name;
+    quint64 busyNs {0}; // drm-engine-<name>
+    quint64 cycles {0}; // drm-cycles-<name>, drivers counting in gpu cycles instead of ns
+    quint64 totalCycles {0}; // drm-total-cycles-<name>
+    quint32 capacity {1}; // drm-engine-capacity-<name>, number of engines of that class
+};
+
+/**
+ * @brief Values of /proc/[pid]/fdinfo/[fd] of a DRM device fd
+ */
+struct drm_fdinfo_t {
+    QByteArray pdev; // drm-pdev, device the client is opened on
+    quint64 clientId {0}; // drm-client-id, unique per device
+    QVector<drm_engine_t> engines;
+    quint64 vram {0}; // bytes resident in the vram region
+    quint64 memory {0}; // bytes resident in all regions
+    bool hasVram {false};
+};
+
+/**
+ * @brief GPU usage of a process
+ */
+struct drm_usage_t {
+    qreal gpu {0}; // busy percent of the busiest engine, summed over the clients of the process
+    quint64 memory {0}; // vram bytes, memory of all regions on devices without vram
+};
+
+/**
+ * @brief Per process GPU usage, from the fdinfo of DRM fds
+ *
+ * Engine busy time of each DRM client (drm-pdev & drm-client-id) is compared with the previous scan. A
+ * client shared by several fds or processes (dup, fork) is accounted once, to the first process scanned.
+ * Only fds pointing to /dev/dri or /dev/accel are read; they are found by walking /proc/[pid]/fd when a
+ * process is first seen, when a cached fd went away, or once every DRM_FD_RESCAN_TICKS scans (spread
+ * over pids) to pick up fds opened later. Nothing is read while no view shows the GPU columns.
+ *
+ * setWanted() may be called from any thread, the other methods are called by the process scan.
+ */
+class DrmClientScan
+{
+public:
+    DrmClientScan();
+
+    /**
+     * @brief Register whether client (e.g. a process table view) shows GPU columns
+     */
+    void setWanted(const void *client, bool wanted);
+
+    /**
+     * @brief Start a scan, demand of the clients is sampled once per scan
+     * @param nowNs CLOCK_MONOTONIC time of the scan, engine busy time is divided by the time between scans
+     */
+    void beginScan(quint64 nowNs);
+    /**
+     * @brief Drop processes & clients not seen by the scan
+     */
+    void endScan();
+
+    inline bool isWanted() const
+    {
+        return m_wanted;
+    }
+
+    /**
+     * @brief Read the DRM fds of pid, called once per process between beginScan() & endScan()
+     */
+    drm_usage_t scanProcess(pid_t pid);
+
+    /**
+     * @brief Number of fd directory walks & fdinfo reads of the last finished scan
+     */
+    inline int lastWalks() const
+    {
+        return m_lastWalks;
+    }
+    inline int lastReads() const
+    {
+        return m_lastReads;
+    }
+
+    /**
+     * @brief Parse fdinfo content
+     * @return false if buf does not describe a DRM client
+     */
+    static bool parseFdinfo(const char *buf, drm_fdinfo_t &info);
+
+private:
+    struct pid_state_t {
+        QVector<int> fds; // DRM fds found by the last walk
+        quint64 tick {0}; // last scan that saw the process
+        quint64 epoch {0}; // demand epoch of the last walk, 0 if never walked
+        bool stale {false}; // a cached fd went away since the last walk
+        bool readable {true}; // fd directory could be opened at the last walk
+    };
+    struct client_state_t {
+        QHash<QByteArray, drm_engine_t> engines; // counters at the previous sample
+        quint64 sampleNs {0};
+        quint64 tick {0}; // last scan the client was accounted on
+    };
+
+    /**
+     * @brief Walk /proc/[pid]/fd for DRM device fds
+     * @return false if the fd directory is not readable
+     */
+    bool walkFds(pid_t pid, QVector<int> &fds);
+    /**
+     * @return false if fd is gone or no longer a DRM client
+     */
+    bool readFdinfo(pid_t pid, int fd, drm_fdinfo_t &info);
+    /**
+     * @brief Busy percent of the busiest engine of info since prev was sampled
+     */
+    static qreal busyPercent(const client_state_t &prev, const drm_fdinfo_t &info, quint64 elapsedNs);
+
+    QMutex m_clientsLock;
+    QSet<const void *> m_clients;
+    std::atomic_bool m_demand;
+
+    // sampled by beginScan()
+    bool m_wanted;
+    quint64 m_tick;
+    quint64 m_nowNs;
+    // increased each time demand turns on, so every process is walked again
+    quint64 m_epoch;
+
+    PidIndex<pid_state_t> m_pids;
+    QHash<QByteArray, client_state_t> m_drmClients; // keyed by drm-pdev & drm-client-id
+
+    int m_walks;
+    int m_reads;
+    int m_lastWalks;
+    int m_lastReads;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // DRM_CLIENT_SCAN_H
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PID_INDEX_H
+#define PID_INDEX_H
+
+#include "common/flat_index.h"
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+struct pid_index_traits_t {
+    enum { kMinTableSize = 64 };
+
+    static inline uint hash(pid_t pid)
+    {
+        // fibonacci hashing, pids are mostly sequential
+        return (uint(pid) * 2654435769u) >> 7;
+    }
+    static inline bool equal(pid_t lhs, pid_t rhs)
+    {
+        return lhs == rhs;
+    }
+};
+
+/**
+ * @brief Flat pid keyed hash table, see common::FlatIndex
+ */
+template<typename T>
+using PidIndex = ::common::FlatIndex<pid_t, T, pid_index_traits_t>;
+
+using PidSet = PidIndex<bool>;
+
+} // namespace process
+} // namespace core
+
+#endif // PID_INDEX_H
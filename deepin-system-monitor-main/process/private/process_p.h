@@ -9,6 +9,7 @@
 #include "common/sample.h"
 #include "process/process_icon.h"
 #include "process/process_name.h"
+#include "process/sock_inode_scan.h"
 
 #include <QSharedData>
 
@@ -79,6 +80,9 @@ public:
         , environ {}
         , uptime {timeval {0, 0}}
         , sockInodes {}
+        , sockScan {}
+        , gpu {0}
+        , gpuMemory {0}
         , cpuTimeSample(new CPUTimeSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
         , cpuUsageSample(new CPUUsageSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
         , networkIOSample(new IOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
@@ -131,6 +135,9 @@ public:
         , environ(other.environ)
         , uptime {other.uptime}
         , sockInodes(other.sockInodes)
+        , sockScan(other.sockScan)
+        , gpu(other.gpu)
+        , gpuMemory(other.gpuMemory)
         , cpuTimeSample(std::unique_ptr<CPUTimeSample>(new CPUTimeSample(*(other.cpuTimeSample))))
         , cpuUsageSample(std::unique_ptr<CPUUsageSample>(new CPUUsageSample(*(other.cpuUsageSample))))
         , networkIOSample(std::unique_ptr<IOSample>(new IOSample(*(other.networkIOSample))))
@@ -198,6 +205,10 @@ private:
     struct timeval uptime;
 
     QList<ino_t> sockInodes; // socket inodes opened by this process
+    SockInodeScanState sockScan; // last walk of /proc/[pid]/fd
+
+    qreal gpu; // gpu busy percent, from the fdinfo of DRM fds
+    qulonglong gpuMemory; // vram used by the DRM clients of this process, in bytes
 
     // only 2 samples are kept here for each process, to avoid too much memory
     // consumption if there're too many processes
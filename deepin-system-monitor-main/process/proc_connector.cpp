@@ -0,0 +1,322 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "proc_connector.h"
+#include "ddlog.h"
+#include "common/common.h"
+
+#include <QThread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+// short lived processes kept per take, a fork storm is counted but not recorded beyond this
+#define SHORT_LIVED_MAX 256
+// listener wakes up this often to check for quit requests
+#define PROC_CONNECTOR_POLL_MS 200
+// time to wait for the kernel to acknowledge the subscription
+#define PROC_CONNECTOR_ACK_MS 1000
+#define PROC_CONNECTOR_RCVBUF (4 * 1024 * 1024)
+
+// event types, compared as numbers since newer kernel headers moved the enum out of struct proc_event
+#define PROC_CONNECTOR_EVENT_NONE 0x00000000u
+#define PROC_CONNECTOR_EVENT_FORK 0x00000001u
+#define PROC_CONNECTOR_EVENT_EXEC 0x00000002u
+#define PROC_CONNECTOR_EVENT_EXIT 0x80000000u
+
+using namespace DDLog;
+using namespace common::error;
+
+namespace core {
+namespace process {
+
+// netlink message carrying a connector message with a mcast op
+#define PROC_CN_REQUEST_SIZE NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))
+
+// read /proc/[pid]/comm of a process that just exited, still readable until it is reaped
+static void readComm(pid_t pid, char *comm, size_t size)
+{
+    comm[0] = '\0';
+    char path[64];
+    sprintf(path, "/proc/%d/comm", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    ssize_t n = read(fd, comm, size - 1);
+    close(fd);
+    if (n <= 0) {
+        comm[0] = '\0';
+        return;
+    }
+    if (comm[n - 1] == '\n')
+        --n;
+    comm[n] = '\0';
+}
+
+ProcConnector::ProcConnector()
+    : m_fd(-1)
+    , m_thread {}
+    , m_quitRequested {false}
+    , m_running(false)
+    , m_born {}
+    , m_exited {}
+    , m_shortLived {}
+    , m_shortLivedDropped(0)
+    , m_overflowed(false)
+    , m_stats {}
+{
+}
+
+ProcConnector::~ProcConnector()
+{
+    stop();
+}
+
+bool ProcConnector::start()
+{
+    if (m_running)
+        return true;
+
+    m_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (m_fd < 0) {
+        print_errno(errno, "create NETLINK_CONNECTOR socket failed");
+        return false;
+    }
+
+    // fork storms come in bursts, leave room for them between two polls
+    int rcvbuf = PROC_CONNECTOR_RCVBUF;
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_nl addr {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = 0;
+    if (bind(m_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        print_errno(errno, "bind NETLINK_CONNECTOR socket failed");
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    if (!subscribe(true)) {
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_quitRequested.store(false);
+    m_thread.reset(QThread::create([this]() { listen(); }));
+    m_thread->start();
+    m_running = true;
+    qCInfo(app) << "Proc connector listener started";
+    return true;
+}
+
+void ProcConnector::stop()
+{
+    if (m_thread) {
+        m_quitRequested.store(true);
+        m_thread->wait();
+        m_thread.reset();
+    }
+    if (m_fd >= 0) {
+        if (m_running)
+            subscribe(false);
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_running = false;
+}
+
+bool ProcConnector::subscribe(bool enable)
+{
+    char req[PROC_CN_REQUEST_SIZE] __attribute__((aligned(NLMSG_ALIGNTO))) = {};
+    auto *nlh = reinterpret_cast<struct nlmsghdr *>(req);
+    auto *cn = reinterpret_cast<struct cn_msg *>(NLMSG_DATA(nlh));
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    nlh->nlmsg_type = NLMSG_DONE;
+    nlh->nlmsg_pid = 0;
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(enum proc_cn_mcast_op);
+    enum proc_cn_mcast_op op = enable ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    memcpy(cn->data, &op, sizeof(op));
+
+    if (send(m_fd, req, nlh->nlmsg_len, 0) < 0) {
+        print_errno(errno, "send proc connector subscription failed");
+        return false;
+    }
+    if (!enable)
+        return true;
+
+    // the kernel answers with an ack event, none is sent if nobody is subscribed
+    // (i.e. we lack CAP_NET_ADMIN and no other listener exists)
+    char buf[4096] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct pollfd pfd {m_fd, POLLIN, 0};
+    while (poll(&pfd, 1, PROC_CONNECTOR_ACK_MS) > 0) {
+        int remain = int(recv(m_fd, buf, sizeof(buf), 0));
+        if (remain <= 0)
+            break;
+        for (auto *nlh = reinterpret_cast<struct nlmsghdr *>(buf); NLMSG_OK(nlh, remain); nlh = NLMSG_NEXT(nlh, remain)) {
+            auto *cn = reinterpret_cast<struct cn_msg *>(NLMSG_DATA(nlh));
+            if (cn->id.idx != CN_IDX_PROC || cn->len < sizeof(struct proc_event))
+                continue;
+            auto *ev = reinterpret_cast<const struct proc_event *>(cn->data);
+            if (quint32(ev->what) != PROC_CONNECTOR_EVENT_NONE)
+                continue;
+            if (ev->event_data.ack.err != 0) {
+                qCWarning(app) << "Proc connector subscription refused, error:" << strerror(int(ev->event_data.ack.err));
+                return false;
+            }
+            return true;
+        }
+    }
+
+    qCInfo(app) << "Proc connector subscription not acknowledged, proc events unavailable (CAP_NET_ADMIN required)";
+    return false;
+}
+
+void ProcConnector::listen()
+{
+    char buf[64 * 1024] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct pollfd pfd {m_fd, POLLIN, 0};
+
+    while (!m_quitRequested.load()) {
+        int rc = poll(&pfd, 1, PROC_CONNECTOR_POLL_MS);
+        if (rc < 0 && errno != EINTR) {
+            print_errno(errno, "poll proc connector socket failed");
+            break;
+        }
+        if (rc <= 0)
+            continue;
+
+        // drain the socket before going back to poll
+        for (;;) {
+            ssize_t n = recv(m_fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n > 0) {
+                parseMessages(buf, size_t(n));
+                continue;
+            }
+            if (n < 0 && errno == ENOBUFS) {
+                // the kernel dropped events, pids are resynced from /proc on the next scan
+                markOverflow();
+                continue;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EINTR)
+                print_errno(errno, "receive proc connector events failed");
+            break;
+        }
+    }
+}
+
+void ProcConnector::parseMessages(const char *buf, size_t len)
+{
+    auto *nlh = reinterpret_cast<const struct nlmsghdr *>(buf);
+    // NLMSG_NEXT() takes a non const length
+    int remain = int(len);
+    for (; NLMSG_OK(nlh, remain); nlh = NLMSG_NEXT(nlh, remain)) {
+        if (nlh->nlmsg_type == NLMSG_ERROR || nlh->nlmsg_type == NLMSG_NOOP)
+            continue;
+        auto *cn = reinterpret_cast<const struct cn_msg *>(NLMSG_DATA(nlh));
+        if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC || cn->len < sizeof(struct proc_event))
+            continue;
+        handleEvent(*reinterpret_cast<const struct proc_event *>(cn->data));
+    }
+}
+
+void ProcConnector::handleEvent(const struct proc_event &ev)
+{
+    switch (quint32(ev.what)) {
+    case PROC_CONNECTOR_EVENT_FORK: {
+        // new threads are reported as forks as well
+        pid_t pid = pid_t(ev.event_data.fork.child_pid);
+        if (pid != pid_t(ev.event_data.fork.child_tgid))
+            return;
+        QMutexLocker locker(&m_lock);
+        ++m_stats.forks;
+        m_born.insert(pid, {pid_t(ev.event_data.fork.parent_tgid), ev.timestamp_ns});
+        break;
+    }
+    case PROC_CONNECTOR_EVENT_EXEC: {
+        QMutexLocker locker(&m_lock);
+        ++m_stats.execs;
+        break;
+    }
+    case PROC_CONNECTOR_EVENT_EXIT: {
+        pid_t pid = pid_t(ev.event_data.exit.process_pid);
+        if (pid != pid_t(ev.event_data.exit.process_tgid))
+            return;
+
+        short_lived_proc_t proc {};
+        QMutexLocker locker(&m_lock);
+        ++m_stats.exits;
+        const Birth *birth = m_born.find(pid);
+        if (!birth) {
+            // known to the last take
+            m_exited.insert(pid);
+            return;
+        }
+
+        ++m_stats.shortLived;
+        proc.pid = pid;
+        proc.ppid = birth->ppid;
+        proc.exitCode = int(ev.event_data.exit.exit_code);
+        proc.lifetimeNs = ev.timestamp_ns > birth->forkNs ? ev.timestamp_ns - birth->forkNs : 0;
+        m_born.remove(pid);
+        if (m_shortLived.size() >= SHORT_LIVED_MAX) {
+            ++m_shortLivedDropped;
+            return;
+        }
+        locker.unlock();
+        readComm(pid, proc.comm, sizeof(proc.comm));
+        locker.relock();
+        m_shortLived << proc;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void ProcConnector::markOverflow()
+{
+    QMutexLocker locker(&m_lock);
+    ++m_stats.overflows;
+    m_overflowed = true;
+}
+
+void ProcConnector::takeChanges(ProcChanges &changes)
+{
+    QMutexLocker locker(&m_lock);
+    changes.born = m_born.keys();
+    changes.exited = m_exited.keys();
+    changes.shortLived.swap(m_shortLived);
+    m_shortLived.clear();
+    changes.overflowed = m_overflowed;
+
+    if (m_shortLivedDropped > 0) {
+        qCInfo(app) << m_shortLivedDropped << "more short lived processes not recorded";
+        m_shortLivedDropped = 0;
+    }
+    m_born.clear();
+    m_exited.clear();
+    m_overflowed = false;
+}
+
+proc_connector_stats_t ProcConnector::stats() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_stats;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROC_CONNECTOR_H
+#define PROC_CONNECTOR_H
+
+#include "pid_index.h"
+
+#include <QMutex>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+#include <sys/types.h>
+
+class QThread;
+struct proc_event;
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Process that was forked & exited between two scans
+ */
+struct short_lived_proc_t {
+    pid_t pid;
+    pid_t ppid;
+    int exitCode; // wait status
+    quint64 lifetimeNs; // fork to exit
+    char comm[16]; // command name, empty if it could not be read
+};
+
+/**
+ * @brief Counters of the proc connector events, since the listener started
+ */
+struct proc_connector_stats_t {
+    quint64 forks;
+    quint64 execs;
+    quint64 exits;
+    quint64 shortLived;
+    quint64 overflows; // receive buffer overruns, events were lost
+};
+
+/**
+ * @brief Processes born & exited since the previous takeChanges()
+ */
+struct ProcChanges {
+    QVector<pid_t> born; // forked & still alive
+    QVector<pid_t> exited; // alive at the previous take, exited since
+    QVector<short_lived_proc_t> shortLived; // forked & exited, oldest first
+    bool overflowed = false; // events were lost, live pids must be resynced from /proc
+};
+
+/**
+ * @brief NETLINK_CONNECTOR proc event listener
+ *
+ * Fork, exec & exit events of processes (thread events are skipped) are received on a listener
+ * thread and folded into the changes since the previous takeChanges(), so the process scan can
+ * keep its live pid set up to date without walking /proc. Processes forked & exited between two
+ * takes are recorded as short lived, up to SHORT_LIVED_MAX of them per take.
+ *
+ * Subscribing to proc events needs CAP_NET_ADMIN, start() fails without it.
+ */
+class ProcConnector
+{
+public:
+    ProcConnector();
+    ~ProcConnector();
+
+    ProcConnector(const ProcConnector &) = delete;
+    ProcConnector &operator=(const ProcConnector &) = delete;
+
+    /**
+     * @brief Open the netlink socket, subscribe to proc events & start the listener thread
+     * @return false if proc events are not available
+     */
+    bool start();
+    void stop();
+
+    inline bool isRunning() const
+    {
+        return m_running;
+    }
+
+    /**
+     * @brief Move the changes gathered since the previous call into changes
+     */
+    void takeChanges(ProcChanges &changes);
+
+    proc_connector_stats_t stats() const;
+
+    /**
+     * @brief Apply a buffer of netlink messages carrying proc events
+     */
+    void parseMessages(const char *buf, size_t len);
+
+private:
+    bool subscribe(bool enable);
+    void listen();
+    void handleEvent(const struct proc_event &ev);
+    void markOverflow();
+
+    int m_fd;
+    std::unique_ptr<QThread> m_thread;
+    std::atomic_bool m_quitRequested;
+    bool m_running;
+
+    struct Birth {
+        pid_t ppid;
+        quint64 forkNs; // event timestamp
+    };
+
+    // changes since the previous take, guarded by m_lock
+    mutable QMutex m_lock;
+    PidIndex<Birth> m_born;
+    PidSet m_exited;
+    QVector<short_lived_proc_t> m_shortLived;
+    quint64 m_shortLivedDropped;
+    bool m_overflowed;
+    proc_connector_stats_t m_stats;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROC_CONNECTOR_H
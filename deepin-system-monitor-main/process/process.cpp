@@ -8,6 +8,11 @@
 #include "private/process_p.h"
 #include "system/device_db.h"
 #include "process/process_db.h"
+#include "process/process_fd_cache.h"
+#include "process/sock_inode_scan.h"
+#include "process/dkapture_shm.h"
+#include "common/source_reader.h"
+#include "common/source_root.h"
 #include "system/sys_info.h"
 #include "system/cpu_set.h"
 #include "system/netif_info_db.h"
@@ -27,6 +32,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
+#include <limits.h>
 
 #define PROC_PATH "/proc"
 #define PROC_STAT_PATH "/proc/%u/stat"
@@ -36,19 +42,37 @@
 #define PROC_ENVIRON_PATH "/proc/%u/environ"
 #define PROC_IO_PATH "/proc/%u/io"
 #define PROC_FD_PATH "/proc/%u/fd"
-#define PROC_FD_NAME_PATH "/proc/%u/fd/%s"
 #define PROC_SCHEDSTAT_PATH "/proc/%u/schedstat"
 
 using namespace common::alloc;
 using namespace common::init;
 using namespace common::core;
 using namespace common::error;
+using namespace common::source;
 using namespace core::system;
 using namespace DDLog;
 
 namespace core {
 namespace process {
 
+// read a small /proc/[pid] file from offset 0, through the persistent descriptor cache if any
+static ssize_t readProcFile(pid_t pid, ProcessFdCache::ProcFile file, const char *pathFmt,
+                            char *buf, size_t size, ProcessFdCache *fdCache)
+{
+    if (fdCache)
+        return fdCache->read(pid, file, buf, size);
+
+    char path[PATH_MAX];
+    formatPath(path, sizeof(path), pathFmt, pid);
+    int fd = reader()->open(path);
+    if (fd < 0)
+        return -1;
+
+    ssize_t sz = reader()->pread(fd, buf, size, 0);
+    reader()->close(fd);
+    return sz;
+}
+
 QString getPriorityName(int prio)
 {
     qCDebug(app) << "Getting priority name for value:" << prio;
@@ -132,26 +156,33 @@ timeval Process::procuptime() const
     return d->uptime;
 }
 
-void Process::readProcessVariableInfo()
+void Process::readProcessVariableInfo(ProcessFdCache *fdCache, const SockInodeScan *sockScan)
 {
     qCDebug(app) << "Reading variable info for pid" << d->pid;
-    d->valid = true;
+    readProcessVariableStats(fdCache, sockScan);
+    updateProcessVariableInfo();
+    qCDebug(app) << "Finished reading variable info for pid" << d->pid << "valid:" << d->valid;
+}
 
+void Process::readProcessVariableStats(ProcessFdCache *fdCache, const SockInodeScan *sockScan)
+{
     bool ok = true;
-    ok = ok && readStat();
-    readSchedStat();
-    ok = ok && readStatm();
+    ok = ok && readStat(fdCache);
+    readSchedStat(fdCache);
+    ok = ok && readStatm(fdCache);
 
-    readIO();
-    readSockInodes();
+    readIO(fdCache);
+    updateSockInodes(fdCache, sockScan);
 
+    d->valid = ok;
+}
+
+void Process::updateProcessVariableInfo()
+{
     d->proc_name.refreashProcessName(this);
     d->uptime = SysInfo::instance()->uptime();
 
     calculateProcessMetrics();
-
-    d->valid = d->valid && ok;
-    qCDebug(app) << "Finished reading variable info for pid" << d->pid << "valid:" << d->valid;
 }
 
 void Process::readProcessSimpleInfo(bool skipStatReading)
@@ -222,18 +253,18 @@ void Process::readProcessInfo()
         qCDebug(app) << "Found recent process stage for pid" << d->pid;
         timedelta = timedelta - validrecentPtr->ptime;
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
+        d->diskIOSample->addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
 
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        d->networkIOSample->addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
     }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+    d->cpuUsageSample->addSample(CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    d->diskIOSample->addSample(DISKIOSampleFrame(d->uptime, io));
 
     auto pair = d->diskIOSample->recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    d->diskIOSpeedSample->addSample(IOPSSampleFrame(iops));
 
     d->apptype = kNoFilter;
     const QVariant &euid = ProcessDB::instance()->processEuid();
@@ -260,64 +291,46 @@ void Process::readProcessInfo()
             sum_send += sockIOStat->tx_bytes;
         }
     }
-    d->networkIOSample->addSample(new IOSampleFrame(d->uptime, {sum_recv, sum_send}));
+    d->networkIOSample->addSample(IOSampleFrame(d->uptime, {sum_recv, sum_send}));
 
     auto netpair = d->networkIOSample->recentSamplePair();
     struct IOPS netiops = IOSampleFrame::iops(netpair.first, netpair.second);
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netiops));
+    d->networkBandwidthSample->addSample(IOPSSampleFrame(netiops));
 
     d->valid = d->valid && ok;
     qCDebug(app) << "Finished reading full info for pid" << d->pid << "valid:" << d->valid;
 }
 
 // read /proc/[pid]/stat
-bool Process::readStat()
+bool Process::readStat(ProcessFdCache *fdCache)
 {
     qCDebug(app) << "Reading stat for pid" << d->pid;
     bool ok {true};
-    char path[256];
-    QByteArray buf;
-    int fd, rc;
+    char buf[1025];
+    int rc;
     ssize_t sz;
     char *pos, *begin;
 
-    buf.reserve(1025);
-
     errno = 0;
-    sprintf(path, PROC_STAT_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access stat file for process" << d->pid;
-        return !ok;
-    }
-        
-    // open /proc/[pid]/stat
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        qCWarning(app) << "Failed to open stat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
-    }
-
-    // read data
-    sz = read(fd, buf.data(), 1024);
-    close(fd);
+    // read /proc/[pid]/stat
+    sz = readProcFile(d->pid, ProcessFdCache::kProcStat, PROC_STAT_PATH, buf, sizeof(buf) - 1, fdCache);
     if (sz < 0) {
         qCWarning(app) << "Failed to read stat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
+        print_errno(errno, QString("read /proc/%1/stat failed").arg(d->pid));
         return !ok;
     }
-    buf.data()[sz] = '\0';
+    buf[sz] = '\0';
 
     // get process name between (...)
-    begin = strchr(buf.data(), '(');
-    begin += 1;
-
-    pos = strrchr(buf.data(), ')');
-    if (!pos) {
+    begin = strchr(buf, '(');
+    pos = strrchr(buf, ')');
+    if (!begin || !pos) {
         qCWarning(app) << "Invalid stat file format for process" << d->pid;
         return !ok;
     }
 
     *pos = '\0';
+    begin += 1;
     // process name (may be truncated by kernel if it's too long)
     d->name = QByteArray(begin);
 
@@ -362,14 +375,14 @@ bool Process::readCmdline()
 {
     qCDebug(app) << "Reading cmdline for pid" << d->pid;
     bool ok = true;
-    char path[128] {};
+    char path[PATH_MAX];
     const size_t bsiz = 4096;
     QByteArray cmd;
     cmd.reserve(bsiz);
     size_t nb;
     char *begin, *cur, *end;
 
-    sprintf(path, PROC_CMDLINE_PATH, d->pid);
+    formatPath(path, sizeof(path), PROC_CMDLINE_PATH, d->pid);
     if(access(path, R_OK) != 0) {
         qCWarning(app) << "Cannot access cmdline file for process" << d->pid;
         return !ok;
@@ -418,13 +431,13 @@ void Process::readEnviron()
 {
     qCDebug(app) << "Reading environ for pid" << d->pid;
     const size_t sz = 1024;
-    char path[128] {};
+    char path[PATH_MAX];
     ssize_t nb;
     QByteArray sbuf {};
     char buf[sz + 1] {};
     int fd;
 
-    sprintf(path, PROC_ENVIRON_PATH, d->pid);
+    formatPath(path, sizeof(path), PROC_ENVIRON_PATH, d->pid);
     if(access(path, R_OK) != 0) {
         // qCWarning(app) << "Cannot access environment file for process" << d->pid;
         return;
@@ -466,42 +479,26 @@ void Process::readEnviron()
 }
 
 // read /proc/[pid]/schedstat
-void Process::readSchedStat()
+void Process::readSchedStat(ProcessFdCache *fdCache)
 {
     qCDebug(app) << "Reading schedstat for pid" << d->pid;
     const size_t bsiz = 1024;
-    QByteArray buf;
-    char path[128];
-    int fd, rc;
+    char buf[bsiz];
+    int rc;
     ssize_t n;
     unsigned long long wtime = 0;
 
-    buf.reserve(bsiz);
-    sprintf(path, PROC_SCHEDSTAT_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access schedstat file for process" << d->pid;
-        return;
-    }
-
     errno = 0;
-    // open /proc/[pid]/schedstat
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        qCWarning(app) << "Failed to open schedstat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return;
-    }
-
-    n = read(fd, buf.data(), bsiz - 1);
-    close(fd);
-
+    // read /proc/[pid]/schedstat
+    n = readProcFile(d->pid, ProcessFdCache::kProcSchedStat, PROC_SCHEDSTAT_PATH, buf, bsiz - 1, fdCache);
     if (n < 0) {
         qCWarning(app) << "Failed to read schedstat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
+        print_errno(errno, QString("read /proc/%1/schedstat failed").arg(d->pid));
         return;
     }
 
-    buf.data()[n] = '\0';
-    rc = sscanf(buf.data(), "%*u %llu %*d", &wtime);
+    buf[n] = '\0';
+    rc = sscanf(buf, "%*u %llu %*d", &wtime);
     if (rc == 1) {
         d->wtime = wtime * HZ / 1000000000;
         qCDebug(app) << "Successfully parsed schedstat for pid" << d->pid;
@@ -517,10 +514,10 @@ bool Process::readStatus()
     bool ok {true};
     const size_t bsiz = 256;
     QByteArray buf;
-    char path[128];
+    char path[PATH_MAX];
 
     buf.reserve(bsiz);
-    sprintf(path, PROC_STATUS_PATH, d->pid);
+    formatPath(path, sizeof(path), PROC_STATUS_PATH, d->pid);
     if(access(path, R_OK) != 0) {
         qCWarning(app) << "Cannot access status file for process" << d->pid;
         return !ok;
@@ -567,33 +564,19 @@ bool Process::readStatus()
 }
 
 // read /proc/[pid]/statm
-bool Process::readStatm()
+bool Process::readStatm(ProcessFdCache *fdCache)
 {
     bool ok {true};
-    int fd;
     const size_t bsiz = 1024;
-    char path[128] {}, buf[bsiz + 1] {};
+    char buf[bsiz + 1] {};
     ssize_t nr;
 
-    sprintf(path, PROC_STATM_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access statm file for process" << d->pid;
-        return !ok;
-    }
-
     errno = 0;
-    // open /proc/[pid]/statm
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        qCWarning(app) << "Failed to open statm file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
-    }
-
-    nr = read(fd, buf, bsiz);
-    close(fd);
+    // read /proc/[pid]/statm
+    nr = readProcFile(d->pid, ProcessFdCache::kProcStatm, PROC_STATM_PATH, buf, bsiz, fdCache);
     if (nr < 0) {
         qCWarning(app) << "Failed to read statm file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
+        print_errno(errno, QString("read /proc/%1/statm failed").arg(d->pid));
         return !ok;
     }
 
@@ -605,7 +588,6 @@ bool Process::readStatm()
         d->rss = 0;
         d->shm = 0;
         qCWarning(app) << "Failed to parse statm file for process" << d->pid;
-        print_errno(errno, QString("read %1 failed").arg(path));
     } else {
         // convert to kB
         d->vmsize <<= kb_shift;
@@ -616,87 +598,129 @@ bool Process::readStatm()
 }
 
 // read /proc/[pid]/io
-void Process::readIO()
+void Process::readIO(ProcessFdCache *fdCache)
 {
-    const size_t bsiz = 128;
-    char path[128], buf[bsiz];
-
-    sprintf(path, PROC_IO_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        // qCWarning(app) << "Cannot access IO file for process" << d->pid;
-        return;
-    }
+    const size_t bsiz = 512;
+    char buf[bsiz + 1];
+    ssize_t nr;
 
     errno = 0;
-    // open /proc/[pid]/io
-    uFile fp(fopen(path, "r"));
-    if (!fp) {
-        qCWarning(app) << "Failed to open IO file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
+    // read /proc/[pid]/io
+    nr = readProcFile(d->pid, ProcessFdCache::kProcIO, PROC_IO_PATH, buf, bsiz, fdCache);
+    if (nr < 0) {
+        // io of processes owned by other users is not readable, which is expected
+        if (errno != EACCES && errno != EPERM) {
+            qCWarning(app) << "Failed to read IO file for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("read /proc/%1/io failed").arg(d->pid));
+        }
         return;
     }
+    buf[nr] = '\0';
 
     // scan each line
-    while (fgets(buf, bsiz, fp.get())) {
-        if (!strncmp(buf, "read_bytes", 10)) {
-            sscanf(buf + 12, "%llu", &d->read_bytes);
-        } else if (!strncmp(buf, "write_bytes", 11)) {
-            sscanf(buf + 13, "%llu", &d->write_bytes);
-        } else if (!strncmp(buf, "cancelled_write_bytes", 21)) {
-            sscanf(buf + 23, "%llu", &d->cancelled_write_bytes);
+    char *line = buf;
+    while (line && *line) {
+        if (!strncmp(line, "read_bytes", 10)) {
+            sscanf(line + 12, "%llu", &d->read_bytes);
+        } else if (!strncmp(line, "write_bytes", 11)) {
+            sscanf(line + 13, "%llu", &d->write_bytes);
+        } else if (!strncmp(line, "cancelled_write_bytes", 21)) {
+            sscanf(line + 23, "%llu", &d->cancelled_write_bytes);
         }
-    }
-    if (ferror(fp.get())) {
-        qCWarning(app) << "Failed to read IO file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
+        line = strchr(line, '\n');
+        if (line)
+            ++line;
     }
 
     qCDebug(app) << "Finished reading IO for pid" << d->pid;
 }
 
+// read FDSize of /proc/[pid]/status
+int Process::readFdSize(ProcessFdCache *fdCache)
+{
+    // FDSize follows Name, Umask, State, ids & Uid/Gid lines, well within the first bytes
+    char buf[512];
+    ssize_t n = readProcFile(d->pid, ProcessFdCache::kProcStatus, PROC_STATUS_PATH, buf, sizeof(buf) - 1, fdCache);
+    if (n <= 0)
+        return -1;
+
+    buf[n] = '\0';
+    const char *p = strstr(buf, "\nFDSize:");
+    int fdSize = -1;
+    if (!p || sscanf(p + 8, "%d", &fdSize) != 1)
+        return -1;
+    return fdSize;
+}
+
 // read /proc/[pid]/fd
-void Process::readSockInodes()
+bool Process::readSockInodes(ProcessFdCache *fdCache)
 {
     struct dirent *dp;
-    char path[128], fdp[256 + 32];
+    char path[PATH_MAX];
     struct stat sbuf;
+    quint64 nsyscalls = 0;
 
-    sprintf(path, PROC_FD_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        // qCWarning(app) << "Cannot access fd directory for process" << d->pid;
-        return;
-    }
+    formatPath(path, sizeof(path), PROC_FD_PATH, d->pid);
 
     errno = 0;
     // open /proc/[pid]/fd dir
     uDir dir(opendir(path));
+    ++nsyscalls;
     if (!dir) {
-        qCWarning(app) << "Failed to open fd directory for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return;
+        if (fdCache)
+            fdCache->addSyscalls(nsyscalls);
+        // fd dir of processes owned by other users is not readable, which is expected
+        if (errno != EACCES && errno != EPERM) {
+            qCWarning(app) << "Failed to open fd directory for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("open %1 failed").arg(path));
+        }
+        return false;
     }
 
+    // sockets closed since the last walk are dropped instead of being looked up forever,
+    // only traffic after the previous refresh of a just closed socket goes uncounted
+    QList<ino_t> inodes;
+    inodes.reserve(d->sockInodes.size());
+    int dfd = dirfd(dir.get());
     // enumerate each entry
     while ((dp = readdir(dir.get()))) {
         // only if entry name starts with a digit
         if (isdigit(dp->d_name[0])) {
-            // open /proc/[pid]/fd/[fd]
-            sprintf(fdp, PROC_FD_NAME_PATH, d->pid, dp->d_name);
+            // stat /proc/[pid]/fd/[fd] relative to the opened dir, no path lookup from /proc
             memset(&sbuf, 0, sizeof(struct stat));
-            if (!stat(fdp, &sbuf)) {
-                // get inode if it's a socket descriptor
+            ++nsyscalls;
+            if (!fstatat(dfd, dp->d_name, &sbuf, 0)) {
+                // get inode if it's a socket descriptor, a descriptor is listed once
                 if (S_ISSOCK(sbuf.st_mode)) {
-                    // not append repeat data, may memory leak.
-                    if (!d->sockInodes.contains(sbuf.st_ino)) {
-                        d->sockInodes << sbuf.st_ino;
-                    }
+                    inodes << sbuf.st_ino;
                 }
             } // ::if(stat)
         } // ::if(isdigit)
     } // ::while(readdir)
-    // if (errno) {
-    //     print_errno(errno, QString("read %1 failed").arg(path));
-    // }
+    d->sockInodes.swap(inodes);
+
+    if (fdCache) {
+        // getdents + close
+        fdCache->addSyscalls(nsyscalls + 2);
+    }
+    return true;
+}
+
+void Process::updateSockInodes(ProcessFdCache *fdCache, const SockInodeScan *sockScan)
+{
+    if (!sockScan) {
+        readSockInodes(fdCache);
+        return;
+    }
+    if (!sockScan->isWanted()) {
+        // nobody shows network stats, traffic is not taken from NetifMonitor until shown again
+        d->sockInodes.clear();
+        return;
+    }
+
+    int fdSize = d->sockScan.readable ? readFdSize(fdCache) : -1;
+    if (sockScan->needsWalk(d->pid, d->sockScan, fdSize))
+        d->sockScan.readable = readSockInodes(fdCache);
 }
 
 bool Process::isValid() const
@@ -764,18 +788,18 @@ void Process::calculateProcessMetrics()
         }
         
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
+        d->diskIOSample->addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
 
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        d->networkIOSample->addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
     }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+    d->cpuUsageSample->addSample(CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    d->diskIOSample->addSample(DISKIOSampleFrame(d->uptime, io));
 
     auto pair = d->diskIOSample->recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    d->diskIOSpeedSample->addSample(IOPSSampleFrame(iops));
 
     qulonglong sum_recv = 0;
     qulonglong sum_send = 0;
@@ -788,11 +812,11 @@ void Process::calculateProcessMetrics()
             sum_send += sockIOStat->tx_bytes;
         }
     }
-    d->networkIOSample->addSample(new IOSampleFrame(d->uptime, {sum_recv, sum_send}));
+    d->networkIOSample->addSample(IOSampleFrame(d->uptime, {sum_recv, sum_send}));
 
     auto netpair = d->networkIOSample->recentSamplePair();
     struct IOPS netiops = IOSampleFrame::iops(netpair.first, netpair.second);
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netiops));
+    d->networkBandwidthSample->addSample(IOPSSampleFrame(netiops));
 }
 
 QIcon Process::icon() const
@@ -800,6 +824,11 @@ QIcon Process::icon() const
     return d->proc_icon.icon();
 }
 
+std::shared_ptr<const icon_data_t> Process::iconData() const
+{
+    return d->proc_icon.data();
+}
+
 qreal Process::cpu() const
 {
     auto *sample = d->cpuUsageSample->recentSample();
@@ -811,7 +840,7 @@ qreal Process::cpu() const
 
 void Process::setCpu(qreal cpu)
 {
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(cpu));
+    d->cpuUsageSample->addSample(CPUUsageSampleFrame(cpu));
 }
 
 qulonglong Process::memory() const
@@ -938,7 +967,23 @@ qreal Process::sentBps() const
 void Process::setNetIoBps(qreal recvBps, qreal sendBps)
 {
     struct IOPS netIo = {recvBps, sendBps};
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netIo));
+    d->networkBandwidthSample->addSample(IOPSSampleFrame(netIo));
+}
+
+qreal Process::gpu() const
+{
+    return d->gpu;
+}
+
+qulonglong Process::gpuMemory() const
+{
+    return d->gpuMemory;
+}
+
+void Process::setGpuUsage(qreal gpu, qulonglong gpuMemory)
+{
+    d->gpu = gpu;
+    d->gpuMemory = gpuMemory;
 }
 
 qulonglong Process::recvBytes() const
@@ -991,11 +1036,21 @@ void Process::setUserName(const QString &userName)
     d->usrerName = userName;
 }
 
-void Process::applyDKaptureData(const QVariantMap &data)
+// DKapture 未转换状态字符串, 最高置位对应状态
+static char dkaptureStateChar(quint32 state)
+{
+    static const char kStates[] = "RSDTtXZPI";
+    int bit = 0;
+    for (state &= 0xff; state; state >>= 1)
+        ++bit;
+    return kStates[bit];
+}
+
+void Process::applyDKaptureData(const QVariantMap &data, const SockInodeScan *sockScan)
 {
     // 设置基本状态信息
     if (data.contains("state")) {
-        setState(data["state"].toString().at(0).toLatin1());
+        setState(dkaptureStateChar(data["state"].toUInt()));
     }
     if (data.contains("priority")) {
         setPriority(data["priority"].toInt());
@@ -1104,6 +1159,62 @@ void Process::applyDKaptureData(const QVariantMap &data)
     //     network_tx = data["network_tx_bytes"].toULongLong();
     // }
     
+    finishDKaptureData(sockScan);
+}
+
+void Process::applyDKaptureRecord(const dk_proc_record_t &rec, const SockInodeScan *sockScan)
+{
+    if (rec.fields & kDKFieldStat) {
+        setState(dkaptureStateChar(quint32(rec.state)));
+        setPriority(rec.priority);
+
+        // CPU 时间已由后端换算为时钟滴答数
+        d->utime = rec.utime;
+        d->stime = rec.stime;
+        d->cutime = rec.cutime;
+        d->cstime = rec.cstime;
+
+        // STAT中的rss和vsize是字节数, 有STATM数据时以其为准
+        d->rss = rec.rss >> 10;
+        d->vmsize = rec.vsize >> 10;
+
+        d->ppid = rec.ppid;
+        d->nthreads = rec.num_threads;
+        d->nice = rec.nice;
+        d->start_time = rec.start_time;
+    }
+    setName(QString::fromUtf8(rec.comm, int(strnlen(rec.comm, sizeof(rec.comm)))));
+
+    // STATM中的数据是页数（与/proc/[pid]/statm一致）
+    if (rec.fields & kDKFieldStatm) {
+        d->rss = rec.memory_resident << kb_shift;
+        d->vmsize = rec.memory_size << kb_shift;
+        d->shm = rec.memory_shared << kb_shift;
+    }
+
+    if (rec.fields & kDKFieldIo) {
+        d->read_bytes = rec.read_bytes;
+        d->write_bytes = rec.write_bytes;
+        d->cancelled_write_bytes = rec.cancelled_write_bytes;
+    }
+
+    if (rec.fields & kDKFieldStatus) {
+        d->uid = rec.uid[0];
+        d->euid = rec.uid[1];
+        d->gid = rec.gid[0];
+        d->egid = rec.gid[1];
+    }
+
+    // 纳秒转时钟滴答数（与传统方式一致）
+    if (rec.fields & kDKFieldSchedstat) {
+        d->wtime = rec.rq_wait_time * HZ / 1000000000;
+    }
+
+    finishDKaptureData(sockScan);
+}
+
+void Process::finishDKaptureData(const SockInodeScan *sockScan)
+{
     // 标记进程为有效，但需要检查关键数据读取是否成功
     d->valid = true;
     bool ok = true;
@@ -1111,7 +1222,7 @@ void Process::applyDKaptureData(const QVariantMap &data)
     // 读取关键信息并检查成功性
     ok = ok && readCmdline();    // cmdline是必需的，失败则进程无效
     readEnviron();             // environ失败可以容忍
-    readSockInodes();          // sockInodes失败可以容忍
+    updateSockInodes(nullptr, sockScan); // sockInodes失败可以容忍
 
     // 只有关键操作都成功才保持进程有效
     d->valid = d->valid && ok;
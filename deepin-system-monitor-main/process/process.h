@@ -14,10 +14,14 @@
 #include <QSharedDataPointer>
 #include <QUrl>
 
+#include <memory>
+
 #include <sys/types.h>
 
 using namespace core::system;
 
+struct dk_proc_record_t;
+
 namespace core {
 namespace process {
 
@@ -47,6 +51,9 @@ ProcessPriority getProcessPriorityStub(int prio);
  * @brief The Process class
  */
 class ProcessPrivate;
+class ProcessFdCache;
+class SockInodeScan;
+struct icon_data_t;
 class Process
 {
 public:
@@ -71,7 +78,9 @@ public:
     void setName(const QString &name);
     QString displayName() const;
 
+    // GUI thread only, other threads hand iconData() over to ProcessIcon::iconOf()
     QIcon icon() const;
+    std::shared_ptr<const icon_data_t> iconData() const;
 
     qreal cpu() const;
     void setCpu(qreal cpu);
@@ -114,9 +123,22 @@ public:
     qulonglong recvBytes() const;
     qulonglong sentBytes() const;
 
+    qreal gpu() const;
+    qulonglong gpuMemory() const;
+    void setGpuUsage(qreal gpu, qulonglong gpuMemory);
+
     void readProcessInfo();
     void readProcessSimpleInfo(bool skipStatReading = false); // 统一方法，可选择跳过stat读取
-    void readProcessVariableInfo();
+    void readProcessVariableInfo(ProcessFdCache *fdCache = nullptr, const SockInodeScan *sockScan = nullptr);
+    /**
+     * @brief Read the per-refresh /proc files only, safe to run concurrently for different processes
+     * @param sockScan decides whether fds are walked for socket inodes, walked each time if null
+     */
+    void readProcessVariableStats(ProcessFdCache *fdCache = nullptr, const SockInodeScan *sockScan = nullptr);
+    /**
+     * @brief Refresh name and derived metrics after readProcessVariableStats(), monitor thread only
+     */
+    void updateProcessVariableInfo();
 
     void calculateProcessMetrics();
     
@@ -127,13 +149,22 @@ public:
     void setUserName(const QString &userName);
     
     // DKapture data application method
-    void applyDKaptureData(const QVariantMap &pidData);
+    void applyDKaptureData(const QVariantMap &pidData, const SockInodeScan *sockScan = nullptr);
+    /**
+     * @brief Apply a DKapture record of the shared memory transport, same values as applyDKaptureData()
+     */
+    void applyDKaptureRecord(const dk_proc_record_t &rec, const SockInodeScan *sockScan = nullptr);
 private:
+    /**
+     * @brief Read the values DKapture does not provide & update derived info
+     */
+    void finishDKaptureData(const SockInodeScan *sockScan);
     /**
      * @brief Read /proc/[pid]/stat
+     * @param fdCache persistent descriptors to pread from, open/read/close each time if null
      * @return true: success; false: failure
      */
-    bool readStat();
+    bool readStat(ProcessFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/cmdline
      * @return true: success; false: failure
@@ -146,7 +177,7 @@ private:
     /**
      * @brief Read /proc/[pid]/schedstat
      */
-    void readSchedStat();
+    void readSchedStat(ProcessFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/status
      * @return true: success; false: failure
@@ -156,17 +187,26 @@ private:
      * @brief Read /proc/[pid]/statm
      * @return true: success; false: failure
      */
-    bool readStatm();
+    bool readStatm(ProcessFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/io
      * @return true: success; false: failure
      */
-    void readIO();
+    void readIO(ProcessFdCache *fdCache = nullptr);
+    /**
+     * @brief Read FDSize of /proc/[pid]/status
+     * @return fd table size, -1 on failure
+     */
+    int readFdSize(ProcessFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/fd
-     * @return true: success; false: failure
+     * @return true: success; false: fd directory not readable
+     */
+    bool readSockInodes(ProcessFdCache *fdCache = nullptr);
+    /**
+     * @brief Walk /proc/[pid]/fd if sockScan asks for it, drop the socket inodes if network stats are not wanted
      */
-    void readSockInodes();
+    void updateSockInodes(ProcessFdCache *fdCache, const SockInodeScan *sockScan);
 
 private:
 //    QSharedDataPointer<ProcessPrivate> d;
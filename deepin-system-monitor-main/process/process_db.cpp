@@ -14,6 +14,7 @@
 #include "process_name_cache.h"
 #include "process_controller.h"
 #include "priority_controller.h"
+#include "system/collector.h"
 
 #include <QReadLocker>
 #include <QWriteLocker>
@@ -23,12 +24,15 @@
 #include <sys/resource.h>
 
 using namespace core::wm;
+using namespace core::system;
 using namespace DDLog;
 
 namespace core {
 namespace process {
 
-const int DesktopEntryTimeCount = 150; // 5 minutes interval
+// refresh intervals of the process collectors, in ms
+#define PROCESS_COLLECT_INTERVAL 2000
+
 ProcessDB::ProcessDB(QObject *parent)
     : QObject(parent)
 {
@@ -37,8 +41,6 @@ ProcessDB::ProcessDB(QObject *parent)
     m_windowList = new WMWindowList();
     m_desktopEntryCache = new DesktopEntryCache();
 
-    m_desktopEntryTimeCount = DesktopEntryTimeCount;
-
     m_euid = geteuid();
     connect(this, &ProcessDB::signalProcessPrioritysetChanged, this, &ProcessDB::onProcessPrioritysetChanged);
 }
@@ -127,16 +129,32 @@ void ProcessDB::killProcess(pid_t pid)
 void ProcessDB::update()
 {
     qCDebug(app) << "ProcessDB::update() called";
-    if (m_desktopEntryTimeCount++ && m_desktopEntryTimeCount >= DesktopEntryTimeCount) {
-        qCDebug(app) << "Updating desktop entry cache";
-        m_desktopEntryTimeCount = 0;
-        m_desktopEntryCache->updateCache();
-    }
-
+    updateDesktopEntries();
     m_windowList->updateWindowListCache();
     m_procSet->refresh();
 }
 
+void ProcessDB::updateDesktopEntries()
+{
+    // only applies the changes reported by inotify, nothing is read while desktop files don't change
+    if (!m_desktopEntryCache->updateCache())
+        return;
+
+    const content_cache_stats_t &icons = ProcessIconCache::instance()->stats();
+    const content_cache_stats_t &names = ProcessNameCache::instance()->stats();
+    qCInfo(app) << "Process icon cache hit rate" << icons.hitRate() << "%," << icons.cost << "bytes; display name cache hit rate"
+                << names.hitRate() << "%," << names.cost << "bytes";
+    ProcessIconCache::instance()->clear();
+    ProcessNameCache::instance()->clear();
+}
+
+void ProcessDB::addCollectors(CollectorSet &collectors)
+{
+    collectors.add("desktop_entries", PROCESS_COLLECT_INTERVAL, [this]() { updateDesktopEntries(); });
+    collectors.add("window_list", PROCESS_COLLECT_INTERVAL, [this]() { m_windowList->updateWindowListCache(); });
+    collectors.add("processes", PROCESS_COLLECT_INTERVAL, [this]() { m_procSet->refresh(); });
+}
+
 void ProcessDB::setProcessPriority(pid_t pid, int priority)
 {
     qCDebug(app) << "setProcessPriority called for pid" << pid << "with priority" << priority;
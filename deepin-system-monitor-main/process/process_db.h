@@ -24,6 +24,9 @@ namespace core {
 namespace wm {
 class WMWindowList;
 }
+namespace system {
+class CollectorSet;
+}
 } // namespace core
 
 using namespace core::wm;
@@ -74,9 +77,17 @@ Q_SIGNALS:
 
 public:
     void update();
+    /**
+     * @brief Register the process collectors on collectors, update() runs them all at once
+     */
+    void addCollectors(core::system::CollectorSet &collectors);
 
 private:
     void sendSignalToProcess(pid_t pid, int signal);
+    /**
+     * @brief Update desktop entries, icons & display names resolved from entries that changed are dropped
+     */
+    void updateDesktopEntries();
 
 private slots:
     void onProcessPrioritysetChanged(pid_t pid, int priority);
@@ -86,7 +97,6 @@ private:
     DesktopEntryCache *m_desktopEntryCache;
 
     ProcessSet *m_procSet;
-    int m_desktopEntryTimeCount;
 
     uid_t m_euid;
 };
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_fd_cache.h"
+#include "ddlog.h"
+#include "common/source_reader.h"
+#include "common/source_root.h"
+
+#include <QDebug>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#define PROC_PID_FILE_PATH "/proc/%u/%s"
+
+// descriptors kept free for the rest of the application (sockets, X11, pcap, ...)
+#define FD_RESERVED 512
+// do not raise RLIMIT_NOFILE beyond this, even if the hard limit allows it
+#define FD_LIMIT_MAX (1 << 20)
+
+// descriptor state, besides a valid descriptor
+#define FD_NOT_OPENED -1
+#define FD_OPEN_FAILED -2
+
+using namespace common::source;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+static const char *const kProcFileName[ProcessFdCache::kProcFileCount] = {
+    "stat",
+    "statm",
+    "io",
+    "schedstat",
+    "status"
+};
+
+ProcessFdCache::ProcessFdCache()
+    : m_stripes {}
+    , m_fdBudget {0}
+    , m_opened {0}
+    , m_syscalls {0}
+    , m_lastRefreshSyscalls {0}
+{
+    // each live process may hold up to kProcFileCount descriptors, which exceeds the
+    // default soft limit (1024) by far on busy hosts, raise it to the hard limit
+    struct rlimit rlim {};
+    if (getrlimit(RLIMIT_NOFILE, &rlim) == 0) {
+        rlim_t want = rlim.rlim_max == RLIM_INFINITY ? rlim_t(FD_LIMIT_MAX) : qMin(rlim.rlim_max, rlim_t(FD_LIMIT_MAX));
+        if (rlim.rlim_cur != RLIM_INFINITY && rlim.rlim_cur < want) {
+            struct rlimit nrlim = rlim;
+            nrlim.rlim_cur = want;
+            if (setrlimit(RLIMIT_NOFILE, &nrlim) == 0) {
+                rlim.rlim_cur = want;
+            } else {
+                qCWarning(app) << "Failed to raise RLIMIT_NOFILE to" << want << "Error:" << strerror(errno);
+            }
+        }
+        rlim_t cur = rlim.rlim_cur == RLIM_INFINITY ? rlim_t(FD_LIMIT_MAX) : rlim.rlim_cur;
+        m_fdBudget = cur > FD_RESERVED ? int(qMin(cur - FD_RESERVED, rlim_t(FD_LIMIT_MAX))) : 0;
+    }
+    qCDebug(app) << "ProcessFdCache created, descriptor budget:" << m_fdBudget;
+}
+
+ProcessFdCache::~ProcessFdCache()
+{
+    clear();
+}
+
+ssize_t ProcessFdCache::read(pid_t pid, ProcFile file, char *buf, size_t size)
+{
+    int fd = cachedFd(pid, file);
+    if (fd == FD_OPEN_FAILED) {
+        errno = EACCES;
+        return -1;
+    }
+
+    if (fd == FD_NOT_OPENED) {
+        // out of budget, fall back to open/read/close without caching
+        if (m_opened.load(std::memory_order_relaxed) >= m_fdBudget)
+            return readOnce(pid, file, buf, size);
+
+        fd = openProcFile(pid, file);
+        if (fd < 0) {
+            int err = errno;
+            // keep retrying on transient failures (e.g. EMFILE), remember permanent ones
+            if (err == EACCES || err == EPERM || err == ENOENT)
+                setCachedFd(pid, file, FD_OPEN_FAILED);
+            errno = err;
+            return -1;
+        }
+        m_opened.fetch_add(1, std::memory_order_relaxed);
+        setCachedFd(pid, file, fd);
+    }
+
+    addSyscalls(1);
+    ssize_t n = reader()->pread(fd, buf, size, 0);
+    if (n < 0 && errno == ESRCH) {
+        // the task behind the descriptor is gone while the pid got reused, reopen once
+        int err = errno;
+        reader()->close(fd);
+        addSyscalls(1);
+        m_opened.fetch_sub(1, std::memory_order_relaxed);
+        fd = openProcFile(pid, file);
+        if (fd < 0) {
+            setCachedFd(pid, file, FD_NOT_OPENED);
+            errno = err;
+            return -1;
+        }
+        m_opened.fetch_add(1, std::memory_order_relaxed);
+        setCachedFd(pid, file, fd);
+        addSyscalls(1);
+        n = reader()->pread(fd, buf, size, 0);
+    } else if (n < 0 && (errno == EACCES || errno == EPERM)) {
+        // permission is checked on read for some files (e.g. io), do not retry every tick
+        int err = errno;
+        reader()->close(fd);
+        addSyscalls(1);
+        m_opened.fetch_sub(1, std::memory_order_relaxed);
+        setCachedFd(pid, file, FD_OPEN_FAILED);
+        errno = err;
+    }
+    return n;
+}
+
+void ProcessFdCache::release(pid_t pid)
+{
+    Stripe &s = stripe(pid);
+    std::lock_guard<std::mutex> guard(s.lock);
+
+    auto it = s.fds.find(pid);
+    if (it == s.fds.end())
+        return;
+
+    for (int i = 0; i < kProcFileCount; ++i) {
+        if (it->fd[i] >= 0) {
+            reader()->close(it->fd[i]);
+            addSyscalls(1);
+            m_opened.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    s.fds.erase(it);
+}
+
+void ProcessFdCache::clear()
+{
+    for (auto &s : m_stripes) {
+        std::lock_guard<std::mutex> guard(s.lock);
+        for (auto it = s.fds.begin(); it != s.fds.end(); ++it) {
+            for (int i = 0; i < kProcFileCount; ++i) {
+                if (it->fd[i] >= 0)
+                    reader()->close(it->fd[i]);
+            }
+        }
+        s.fds.clear();
+    }
+    m_opened.store(0, std::memory_order_relaxed);
+}
+
+void ProcessFdCache::beginRefresh()
+{
+    m_syscalls.store(0, std::memory_order_relaxed);
+}
+
+void ProcessFdCache::endRefresh()
+{
+    m_lastRefreshSyscalls = m_syscalls.load(std::memory_order_relaxed);
+}
+
+int ProcessFdCache::cachedFd(pid_t pid, ProcFile file)
+{
+    Stripe &s = stripe(pid);
+    std::lock_guard<std::mutex> guard(s.lock);
+
+    auto it = s.fds.find(pid);
+    if (it == s.fds.end())
+        return FD_NOT_OPENED;
+    return it->fd[file];
+}
+
+void ProcessFdCache::setCachedFd(pid_t pid, ProcFile file, int fd)
+{
+    Stripe &s = stripe(pid);
+    std::lock_guard<std::mutex> guard(s.lock);
+
+    auto it = s.fds.find(pid);
+    if (it == s.fds.end()) {
+        PidFds fds;
+        for (int i = 0; i < kProcFileCount; ++i)
+            fds.fd[i] = FD_NOT_OPENED;
+        it = s.fds.insert(pid, fds);
+    }
+    it->fd[file] = fd;
+}
+
+int ProcessFdCache::openProcFile(pid_t pid, ProcFile file)
+{
+    char path[PATH_MAX];
+    formatPath(path, sizeof(path), PROC_PID_FILE_PATH, pid, kProcFileName[file]);
+    addSyscalls(1);
+    return reader()->open(path);
+}
+
+ssize_t ProcessFdCache::readOnce(pid_t pid, ProcFile file, char *buf, size_t size)
+{
+    int fd = openProcFile(pid, file);
+    if (fd < 0)
+        return -1;
+
+    addSyscalls(2);
+    ssize_t n = reader()->pread(fd, buf, size, 0);
+    reader()->close(fd);
+    return n;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_FD_CACHE_H
+#define PROCESS_FD_CACHE_H
+
+#include <QHash>
+
+#include <atomic>
+#include <mutex>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Persistent per-PID descriptors for the /proc files re-read on every refresh
+ *
+ * /proc/[pid]/{stat,statm,io,schedstat,status} are opened once while the process lives and
+ * re-read with pread(fd, buf, n, 0) on each tick; the descriptors are released when
+ * the pid disappears from /proc. Files that can not be opened (e.g. io of processes
+ * owned by other users) are remembered and not retried until the pid is released.
+ *
+ * read() may be called concurrently for different pids, release() and clear() must not
+ * run concurrently with read().
+ */
+class ProcessFdCache
+{
+public:
+    enum ProcFile {
+        kProcStat = 0,
+        kProcStatm,
+        kProcIO,
+        kProcSchedStat,
+        kProcStatus,
+
+        kProcFileCount
+    };
+
+    explicit ProcessFdCache();
+    ~ProcessFdCache();
+
+    ProcessFdCache(const ProcessFdCache &) = delete;
+    ProcessFdCache &operator=(const ProcessFdCache &) = delete;
+
+    /**
+     * @brief Read /proc/[pid]/<file> from offset 0
+     * @return number of bytes read, or -1 with errno set
+     */
+    ssize_t read(pid_t pid, ProcFile file, char *buf, size_t size);
+
+    /**
+     * @brief Close all cached descriptors of pid
+     */
+    void release(pid_t pid);
+    void clear();
+
+    /**
+     * @brief Reset the syscall counter, called at the beginning of each refresh
+     */
+    void beginRefresh();
+    /**
+     * @brief Publish the syscall counter of the current refresh, called when refresh finished
+     */
+    void endRefresh();
+    /**
+     * @brief Account syscalls issued by /proc readers outside of this cache (readdir, stat, ...)
+     */
+    inline void addSyscalls(quint64 n);
+
+    /**
+     * @brief Number of /proc related syscalls issued during the last finished refresh
+     */
+    inline quint64 lastRefreshSyscalls() const;
+    inline int openedCount() const;
+
+private:
+    struct PidFds {
+        int fd[kProcFileCount];
+    };
+    // pids are spread over several independently locked tables, so that refresh workers
+    // reading different processes rarely contend
+    enum { kStripeCount = 16 };
+    struct Stripe {
+        std::mutex lock;
+        QHash<pid_t, PidFds> fds;
+    };
+
+    inline Stripe &stripe(pid_t pid);
+    int cachedFd(pid_t pid, ProcFile file);
+    void setCachedFd(pid_t pid, ProcFile file, int fd);
+    int openProcFile(pid_t pid, ProcFile file);
+    ssize_t readOnce(pid_t pid, ProcFile file, char *buf, size_t size);
+
+    Stripe m_stripes[kStripeCount];
+    // number of descriptors we are allowed to keep opened at the same time
+    int m_fdBudget;
+    std::atomic<int> m_opened;
+
+    std::atomic<quint64> m_syscalls;
+    quint64 m_lastRefreshSyscalls;
+};
+
+inline void ProcessFdCache::addSyscalls(quint64 n)
+{
+    m_syscalls.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline quint64 ProcessFdCache::lastRefreshSyscalls() const
+{
+    return m_lastRefreshSyscalls;
+}
+
+inline int ProcessFdCache::openedCount() const
+{
+    return m_opened.load(std::memory_order_relaxed);
+}
+
+inline ProcessFdCache::Stripe &ProcessFdCache::stripe(pid_t pid)
+{
+    return m_stripes[uint(pid) % kStripeCount];
+}
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_FD_CACHE_H
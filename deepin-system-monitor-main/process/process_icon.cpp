@@ -13,10 +13,16 @@
 #include "system/system_monitor.h"
 #include "process/process_db.h"
 #include "wm/wm_window_list.h"
+#include "common/hash.h"
 
 #include <QFileInfo>
 #include <QImage>
 
+// window icons are scaled down to this size once, enough for the icon column on hidpi screens
+#define PROCESS_ICON_MAX_SIZE 64
+// cost of an icon from the theme, its pixmaps are kept by the icon engine
+#define PROCESS_ICON_THEME_COST 256
+
 using namespace common::init;
 using namespace common::core;
 using namespace core::system;
@@ -36,6 +42,8 @@ struct icon_data_t {
     char __pad__[4];
     QString proc_name;
     bool desktopentry = false;
+    bool tray = false; // from the desktop file of a tray app, preferred over the window icon
+    QString key; // key in ProcessIconCache, the QIcon is built from the data on the GUI thread
 
     virtual ~icon_data_t() {}
 };
@@ -61,27 +69,9 @@ void ProcessIcon::refreashProcessIcon(Process *proc)
 {
     if (proc) {
         qCDebug(app) << "Refreshing process icon for pid" << proc->pid();
-        ProcessIconCache *cache = ProcessIconCache::instance();
-        if (cache->contains(proc->pid())) {
-            auto *procIcon = cache->getProcessIcon(proc->pid());
-            if (proc->name().compare(procIcon->m_data->proc_name, Qt::CaseInsensitive) == 0) {
-                qCDebug(app) << "Icon cache hit for pid" << proc->pid();
-                m_data = procIcon->m_data;
-            } else {
-                qCDebug(app) << "Icon cache hit but name mismatch, regenerating icon for pid" << proc->pid();
-                m_data = getIcon(proc);
-                procIcon->m_data = m_data;
-            }
-
-            if (m_data->desktopentry)
-                ProcessDB::instance()->windowList()->addDesktopEntryApp(proc);
-        } else {
-            qCDebug(app) << "Icon cache miss for pid" << proc->pid();
-            auto *procIcon = new ProcessIcon();
-            m_data = getIcon(proc);
-            procIcon->m_data = m_data;
-            cache->addProcessIcon(proc->pid(), procIcon);
-        }
+        m_data = getIcon(proc);
+        if (m_data->desktopentry)
+            ProcessDB::instance()->windowList()->addDesktopEntryApp(proc);
     } else {
         qCWarning(app) << "proc is null in refreashProcessIcon";
     }
@@ -89,25 +79,26 @@ void ProcessIcon::refreashProcessIcon(Process *proc)
 
 QIcon ProcessIcon::icon() const
 {
+    return iconOf(m_data);
+}
+
+QIcon ProcessIcon::iconOf(const std::shared_ptr<const icon_data_t> &data)
+{
+    if (!data)
+        return QIcon();
+
+    // shared by all processes resolved to the same data
+    ProcessIconCache *cache = ProcessIconCache::instance();
     QIcon icon;
-    qCDebug(app) << "Getting icon from ProcessIcon object";
-
-    if (m_data) {
-        if (m_data->type == kIconDataNameType) {
-            auto *iconData = reinterpret_cast<struct icon_data_name_type *>(m_data.get());
-            if (iconData) {
-                qCDebug(app) << "Icon data is a name:" << iconData->icon_name;
-                icon = QIcon::fromTheme(iconData->icon_name);
-            }
-        } else if (m_data->type == kIconDataPixmapType) {
-            auto *iconData = reinterpret_cast<struct icon_data_pix_map_type *>(m_data.get());
-            if (iconData) {
-                qCDebug(app) << "Icon data is a pixmap";
-                icon.addPixmap(QPixmap::fromImage(iconData->image));
-            } // ::if(iconData)
-        }
-    } // ::if(m_data)
+    if (cache->findIcon(data->key, data, &icon))
+        return icon;
 
+    if (data->type == kIconDataNameType) {
+        icon = QIcon::fromTheme(static_cast<const struct icon_data_name_type *>(data.get())->icon_name);
+    } else if (data->type == kIconDataPixmapType) {
+        icon.addPixmap(QPixmap::fromImage(static_cast<const struct icon_data_pix_map_type *>(data.get())->image));
+    }
+    cache->insertIcon(data->key, data, icon);
     return icon;
 }
 
@@ -147,13 +138,120 @@ QString ProcessIcon::getFileManagerString()
 std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
 {
     qCDebug(app) << "Getting icon for process" << proc->pid() << proc->name();
-    std::shared_ptr<icon_data_t> iconDataPtr;
+    WMWindowList *windowList = ProcessDB::instance()->windowList();
+
+    bool tray = !proc->cmdline().isEmpty() && windowList->isTrayApp(proc->pid());
+    std::shared_ptr<icon_data_t> iconData = contentIcon(proc, tray);
+
+    // the desktop file of a tray app comes first, then the icon of the window
+    if (!iconData->tray && !proc->cmdline().isEmpty() && windowList->isGuiApp(proc->pid())) {
+        qCDebug(app) << "Process is a GUI app";
+        ProcessIconCache *cache = ProcessIconCache::instance();
+        cache->syncWindowKeys(windowList->generation());
+        WMWId winId = windowList->getWindowId(proc->pid());
+
+        // the icon of a window is fetched from the X server & hashed once, until the window list changes
+        QString key;
+        if (cache->findWindowKey(proc->pid(), winId, &key)) {
+            if (key.isEmpty())
+                return iconData;
+            std::shared_ptr<icon_data_t> windowData = cache->find(key);
+            if (windowData)
+                return windowData;
+        }
+
+        const QImage &image = windowList->getWindowIcon(proc->pid());
+        if (!image.isNull()) {
+            qCDebug(app) << "Found icon from window properties";
+            key = imageKey(image);
+            cache->setWindowKey(proc->pid(), winId, key);
+            return windowIcon(proc, key, image);
+        } else {
+            qCDebug(app) << "No icon found from window properties";
+            cache->setWindowKey(proc->pid(), winId, QString());
+        }
+    }
+    return iconData;
+}
+
+QString ProcessIcon::contentKey(Process *proc, bool tray)
+{
+    if (proc->cmdline().isEmpty())
+        return QStringLiteral("[::default::]");
+
+    // everything resolveIcon() looks at, but the pid
+    const QHash<QString, QString> &environ = proc->environ();
+    const QString &desktopFile = environ.value("GIO_LAUNCHED_DESKTOP_FILE");
+    bool launched = !desktopFile.isEmpty()
+            && (!environ.value("XDG_DATA_DIRS").isEmpty() || environ.value("GIO_LAUNCHED_DESKTOP_FILE_PID").toInt() == proc->pid());
+    return QStringList {proc->name(), QString(proc->cmdline().value(0)), desktopFile, QString::number(int(tray) | int(launched) << 1)}.join('\n');
+}
+
+std::shared_ptr<icon_data_t> ProcessIcon::contentIcon(Process *proc, bool tray)
+{
+    const QString &key = contentKey(proc, tray);
+    std::shared_ptr<icon_data_t> iconData = ProcessIconCache::instance()->find(key);
+    if (iconData) {
+        qCDebug(app) << "Icon cache hit for pid" << proc->pid();
+        return iconData;
+    }
+
+    qCDebug(app) << "Icon cache miss for pid" << proc->pid();
+    return shareIcon(key, resolveIcon(proc, tray));
+}
+
+QString ProcessIcon::imageKey(const QImage &image)
+{
+    // windows of the same program usually carry the same image, key it by content
+    uint64_t digest[2] {};
+    util::common::hash(image.constBits(), image.bytesPerLine() * image.height(), util::common::global_seed, digest);
+    return QString("[::window::]%1x%2:%3%4")
+        .arg(image.width())
+        .arg(image.height())
+        .arg(digest[0], 16, 16, QChar('0'))
+        .arg(digest[1], 16, 16, QChar('0'));
+}
+
+std::shared_ptr<icon_data_t> ProcessIcon::windowIcon(Process *proc, const QString &key, const QImage &image)
+{
+    std::shared_ptr<icon_data_t> iconData = ProcessIconCache::instance()->find(key);
+    if (iconData)
+        return iconData;
+
+    auto *pixmapData = new struct icon_data_pix_map_type();
+    pixmapData->type = kIconDataPixmapType;
+    pixmapData->proc_name = proc->name();
+    pixmapData->image = image;
+    return shareIcon(key, pixmapData);
+}
+
+std::shared_ptr<icon_data_t> ProcessIcon::shareIcon(const QString &key, icon_data_t *iconData)
+{
+    // QIcon & QPixmap are GUI thread only, the data is not changed once shared
+    int cost = PROCESS_ICON_THEME_COST;
+    iconData->key = key;
+    if (iconData->type == kIconDataPixmapType) {
+        // only the scaled image is kept
+        auto *pixmapData = static_cast<struct icon_data_pix_map_type *>(iconData);
+        QImage &image = pixmapData->image;
+        if (image.width() > PROCESS_ICON_MAX_SIZE || image.height() > PROCESS_ICON_MAX_SIZE)
+            image = image.scaled(PROCESS_ICON_MAX_SIZE, PROCESS_ICON_MAX_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        cost = image.bytesPerLine() * image.height();
+    }
+
+    std::shared_ptr<icon_data_t> iconDataPtr(iconData);
+    ProcessIconCache::instance()->insert(key, iconDataPtr, cost);
+    return iconDataPtr;
+}
+
+struct icon_data_t *ProcessIcon::resolveIcon(Process *proc, bool tray)
+{
+    qCDebug(app) << "Resolving icon for process" << proc->pid() << proc->name();
     auto processDB = ProcessDB::instance();
-    WMWindowList *windowList = processDB->windowList();
     DesktopEntryCache *desktopEntryCache = processDB->desktopEntryCache();
 
     if (!proc->cmdline().isEmpty()) {
-        if (windowList->isTrayApp(proc->pid())) {
+        if (tray) {
             qCDebug(app) << "Process is a tray app";
             if (proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE")) {
                 qCDebug(app) << "Found GIO_LAUNCHED_DESKTOP_FILE";
@@ -165,30 +263,14 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
                     iconData->type = kIconDataNameType;
                     iconData->proc_name = proc->name();
                     iconData->icon_name = entry->icon;
-                    iconDataPtr.reset(iconData);
-                    return iconDataPtr;
+                    iconData->tray = true;
+                    return iconData;
                 } else {
                     qCDebug(app) << "No icon found in desktop file entry";
                 }
             }
         }
 
-        if (windowList->isGuiApp(proc->pid())) {
-            qCDebug(app) << "Process is a GUI app";
-            const QImage &image = windowList->getWindowIcon(proc->pid());
-            if (!image.isNull()) {
-                qCDebug(app) << "Found icon from window properties";
-                auto *iconData = new struct icon_data_pix_map_type();
-                iconData->image = image;
-                iconData->proc_name = proc->name();
-                iconData->type = kIconDataPixmapType;
-                iconDataPtr.reset(iconData);
-                return iconDataPtr;
-            } else {
-                qCDebug(app) << "No icon found from window properties";
-            }
-        }
-
         if (desktopEntryCache->contains(proc->name())) {
             qCDebug(app) << "Found process name in desktop entry cache";
             DesktopEntry entry;
@@ -208,9 +290,7 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
                 } else {
                     iconData->icon_name = entry->icon;
                 }
-                iconDataPtr.reset(iconData);
-                windowList->addDesktopEntryApp(proc);
-                return iconDataPtr;
+                return iconData;
             } else {
                 qCDebug(app) << "No icon found in desktop entry";
             }
@@ -229,9 +309,7 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
                 iconData->type = kIconDataNameType;
                 iconData->proc_name = proc->name();
                 iconData->icon_name = entry->icon;
-                iconDataPtr.reset(iconData);
-                windowList->addDesktopEntryApp(proc);
-                return iconDataPtr;
+                return iconData;
             } else {
                 qCDebug(app) << "No icon found in desktop file from environment";
             }
@@ -239,8 +317,7 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
 
         if (shellList.contains(proc->name())) {
             qCDebug(app) << "Process is a shell, using terminal icon";
-            iconDataPtr.reset(terminalIconData(proc->name()));
-            return iconDataPtr;
+            return terminalIconData(proc->name());
         }
 
         if (!proc->cmdline().isEmpty() && proc->cmdline()[0].startsWith("/opt")) {
@@ -253,8 +330,7 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
                 iconData->type = kIconDataNameType;
                 iconData->proc_name = proc->name();
                 iconData->icon_name = entry->icon;
-                iconDataPtr.reset(iconData);
-                return iconDataPtr;
+                return iconData;
             } else {
                 qCDebug(app) << "No icon found from subname in desktop entry";
             }
@@ -265,8 +341,7 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
 
     // fallback to use default icon
     qCDebug(app) << "No icon found, falling back to default icon";
-    iconDataPtr.reset(defaultIconData(proc->name()));
-    return iconDataPtr;
+    return defaultIconData(proc->name());
 }
 
 } // namespace process
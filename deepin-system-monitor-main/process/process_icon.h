@@ -7,6 +7,7 @@
 #define PROCESS_ICON_H
 
 #include <QIcon>
+#include <QImage>
 
 #include <memory>
 
@@ -22,11 +23,34 @@ public:
     explicit ProcessIcon();
     ~ProcessIcon();
 
+    /**
+     * @brief Icon of the process, GUI thread only
+     */
     QIcon icon() const;
+    inline std::shared_ptr<const struct icon_data_t> data() const
+    {
+        return m_data;
+    }
     void refreashProcessIcon(Process *proc);
+    /**
+     * @brief QIcon built from data, cached by ProcessIconCache, GUI thread only
+     */
+    static QIcon iconOf(const std::shared_ptr<const struct icon_data_t> &data);
 
 private:
     std::shared_ptr<struct icon_data_t> getIcon(Process *proc);
+    /**
+     * @brief Icon resolved from the name, executable & desktop file of proc, shared through ProcessIconCache
+     */
+    std::shared_ptr<struct icon_data_t> contentIcon(Process *proc, bool tray);
+    struct icon_data_t *resolveIcon(Process *proc, bool tray);
+    /**
+     * @brief Icon of a window, shared by the processes whose window has the same image
+     */
+    std::shared_ptr<struct icon_data_t> windowIcon(Process *proc, const QString &key, const QImage &image);
+    static QString imageKey(const QImage &image);
+    static QString contentKey(Process *proc, bool tray);
+    static std::shared_ptr<struct icon_data_t> shareIcon(const QString &key, struct icon_data_t *iconData);
     struct icon_data_t *defaultIconData(const QString &procname) const;
     struct icon_data_t *terminalIconData(const QString &procname) const;
     QString getFileManagerString();
@@ -28,5 +28,46 @@ ProcessIconCache::ProcessIconCache(QObject *parent)
     });
 }
 
+bool ProcessIconCache::findWindowKey(pid_t pid, core::wm::WMWId winId, QString *key) const
+{
+    auto it = m_windowKeys.constFind(pid);
+    if (it == m_windowKeys.cend() || it->winId != winId)
+        return false;
+
+    *key = it->key;
+    return true;
+}
+
+void ProcessIconCache::setWindowKey(pid_t pid, core::wm::WMWId winId, const QString &key)
+{
+    m_windowKeys.insert(pid, window_key_t {winId, key});
+}
+
+void ProcessIconCache::syncWindowKeys(quint64 generation)
+{
+    if (generation == m_windowGeneration)
+        return;
+
+    qCDebug(app) << "Window list changed, forgetting" << m_windowKeys.size() << "window icon keys";
+    m_windowKeys.clear();
+    m_windowGeneration = generation;
+}
+
+bool ProcessIconCache::findIcon(const QString &key, const std::shared_ptr<const icon_data_t> &data, QIcon *icon) const
+{
+    // the data of a key is replaced once desktop entries change, the icon is built again from the new data
+    built_icon_t *built = m_icons.object(key);
+    if (!built || built->data != data)
+        return false;
+
+    *icon = built->icon;
+    return true;
+}
+
+void ProcessIconCache::insertIcon(const QString &key, const std::shared_ptr<const icon_data_t> &data, const QIcon &icon)
+{
+    m_icons.insert(key, new built_icon_t {data, icon});
+}
+
 } // namespace process
 } // namespace core
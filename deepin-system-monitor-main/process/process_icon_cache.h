@@ -7,13 +7,32 @@
 #define PROCESS_ICON_CACHE_H
 
 #include <QCache>
-#include <QThread>
+#include <QIcon>
+#include <QObject>
 #include <QPixmapCache>
 
+#include "content_cache.h"
 #include "process_icon.h"
+#include "wm/wm_info.h"
+
+#include <QHash>
+
+// bytes of resolved icons kept, a 64x64 window icon takes 16KiB
+#define PROCESS_ICON_CACHE_MAX_COST (4 << 20)
+// QIcons built on the GUI thread
+#define PROCESS_ICON_CACHE_MAX_ICONS 512
 
 namespace core {
 namespace process {
+
+/**
+ * @brief Resolved process icons, keyed by what they are resolved from (see ProcessIcon::getIcon)
+ *
+ * Processes of the same program share the icon data & the QIcon built from it, so the delegate paints all
+ * of them from a single pixmap of iconPixmapCache.
+ *
+ * The icon data is resolved on the SystemMonitor thread, QIcons are only built & looked up on the GUI thread.
+ */
 class ProcessIconCache : public QObject
 {
     Q_OBJECT
@@ -22,21 +41,58 @@ class ProcessIconCache : public QObject
 public:
     static ProcessIconCache *instance();
 
-    ProcessIcon *getProcessIcon(pid_t pid) const;
-    void addProcessIcon(pid_t pid, ProcessIcon *procIcon);
-    void removeProcessIcon(pid_t pid);
-    bool contains(pid_t pid) const;
+    std::shared_ptr<struct icon_data_t> find(const QString &key);
+    void insert(const QString &key, const std::shared_ptr<struct icon_data_t> &data, int cost);
+    void remove(const QString &key);
+    bool contains(const QString &key) const;
     void clear();
     void setMaxCost(int cost);
+    content_cache_stats_t stats() const;
+
+    /**
+     * @brief Key of the icon read from window winId of pid, saves reading & hashing the window icon again
+     * @param key set to the key, empty if the window has no icon
+     * @return false if the icon of this window was never read
+     */
+    bool findWindowKey(pid_t pid, core::wm::WMWId winId, QString *key) const;
+    void setWindowKey(pid_t pid, core::wm::WMWId winId, const QString &key);
+    /**
+     * @brief Forget the window keys if the window list changed since the last call
+     * @param generation WMWindowList::generation()
+     */
+    void syncWindowKeys(quint64 generation);
+
+    /**
+     * @brief QIcon built from data, GUI thread only
+     * @return false if no icon was built from data yet, or the data of its key was resolved again since
+     */
+    bool findIcon(const QString &key, const std::shared_ptr<const struct icon_data_t> &data, QIcon *icon) const;
+    void insertIcon(const QString &key, const std::shared_ptr<const struct icon_data_t> &data, const QIcon &icon);
 
 public:
+    // scaled pixmaps of the icons, keyed by QIcon::cacheKey() & size
     QPixmapCache iconPixmapCache;
 
 private:
     explicit ProcessIconCache(QObject *parent = nullptr);
 
 private:
-    QCache<pid_t, ProcessIcon> m_cache {200};
+    ContentCache<struct icon_data_t> m_cache {"Process icon", PROCESS_ICON_CACHE_MAX_COST};
+
+    struct window_key_t {
+        core::wm::WMWId winId;
+        QString key;
+    };
+    // pid -> icon key of its window
+    QHash<pid_t, window_key_t> m_windowKeys;
+    quint64 m_windowGeneration {0};
+
+    struct built_icon_t {
+        std::shared_ptr<const struct icon_data_t> data;
+        QIcon icon;
+    };
+    // icon data key -> QIcon built from it, GUI thread only
+    QCache<QString, built_icon_t> m_icons {PROCESS_ICON_CACHE_MAX_ICONS};
 
     static ProcessIconCache *m_instance;
 };
@@ -49,27 +105,24 @@ inline ProcessIconCache *ProcessIconCache::instance()
     return m_instance;
 }
 
-inline ProcessIcon *ProcessIconCache::getProcessIcon(pid_t pid) const
+inline std::shared_ptr<struct icon_data_t> ProcessIconCache::find(const QString &key)
 {
-    if (m_cache.contains(pid))
-        return m_cache[pid];
-
-    return nullptr;
+    return m_cache.find(key);
 }
 
-inline void ProcessIconCache::addProcessIcon(pid_t pid, ProcessIcon *procIcon)
+inline void ProcessIconCache::insert(const QString &key, const std::shared_ptr<struct icon_data_t> &data, int cost)
 {
-    m_cache.insert(pid, procIcon);
+    m_cache.insert(key, data, cost);
 }
 
-inline void ProcessIconCache::removeProcessIcon(pid_t pid)
+inline void ProcessIconCache::remove(const QString &key)
 {
-    m_cache.remove(pid);
+    m_cache.remove(key);
 }
 
-inline bool ProcessIconCache::contains(pid_t pid) const
+inline bool ProcessIconCache::contains(const QString &key) const
 {
-    return m_cache.contains(pid);
+    return m_cache.contains(key);
 }
 
 inline void ProcessIconCache::clear()
@@ -82,6 +135,11 @@ inline void ProcessIconCache::setMaxCost(int cost)
     m_cache.setMaxCost(cost);
 }
 
+inline content_cache_stats_t ProcessIconCache::stats() const
+{
+    return m_cache.stats();
+}
+
 } // namespace process
 } // namespace core
 
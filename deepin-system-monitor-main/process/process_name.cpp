@@ -71,38 +71,34 @@ QString ProcessName::normalizeProcessName(const QString &source, const QByteArra
 QString ProcessName::getDisplayName(Process *proc)
 {
     qCDebug(app) << "Getting display name for pid" << proc->pid() << "name" << proc->name();
-    auto processDB = ProcessDB::instance();
-
-    WMWindowList *windowList = processDB->windowList();
-    DesktopEntryCache *desktopEntryCache = processDB->desktopEntryCache();
+    WMWindowList *windowList = ProcessDB::instance()->windowList();
 
 #ifdef BUILD_WAYLAND
-    Q_UNUSED(desktopEntryCache);
+    Q_UNUSED(windowList);
 #else
     if (!proc->cmdline().isEmpty()) {
-        if (windowList->isTrayApp(proc->pid())) {
+        // window titles change, they are looked up on every refresh
+        bool tray = windowList->isTrayApp(proc->pid());
+        if (tray) {
             qCDebug(app) << "Process is a tray app";
             // process with tray window
             auto title = windowList->getWindowTitle(proc->pid());
-
             if (!title.isEmpty()) {
                 qCDebug(app) << "Found window title for tray app:" << title;
                 return QString("%1: %2").arg(QApplication::translate("Process.Table", "Tray")).arg(title);
-
-            } else if (proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE")) {
-                qCDebug(app) << "Found GIO_LAUNCHED_DESKTOP_FILE for tray app";
-                // can't grab window title, try use desktop file instead
-                auto desktopFile = proc->environ()["GIO_LAUNCHED_DESKTOP_FILE"];
-                auto entry = desktopEntryCache->entryWithDesktopFile(desktopFile);
-                if (entry && !entry->displayName.isEmpty()) {
-                    qCDebug(app) << "Found display name from desktop file:" << entry->displayName;
-                    return QString("%1: %2").arg(QApplication::translate("Process.Table", "Tray")).arg(entry->displayName);
-                }
-
-            } else {
+            } else if (!proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE")) {
                 qCDebug(app) << "Falling back to process name for tray app";
                 return QString("%1: %2").arg(QApplication::translate("Process.Table", "Tray")).arg(proc->name());
             }
+        }
+
+        // the rest only depends on what the process runs
+        std::shared_ptr<display_name_t> displayName = contentName(proc, tray);
+
+        if (tray && !displayName->trayName.isEmpty()) {
+            // can't grab window title, use desktop file instead
+            qCDebug(app) << "Found display name from desktop file:" << displayName->trayName;
+            return QString("%1: %2").arg(QApplication::translate("Process.Table", "Tray")).arg(displayName->trayName);
         } // ::if(traysAppsCache)
 
         if (windowList->isGuiApp(proc->pid())) {
@@ -134,55 +130,26 @@ QString ProcessName::getDisplayName(Process *proc)
             } // ::if(title)
         } // ::if(guiAppsCache)
 
-        if (desktopEntryCache->entry(proc->name())) {
-            qCDebug(app) << "Found desktop entry for process";
-            // found desktop entry
-            auto &entry = desktopEntryCache->entry(proc->name());
-            if (!entry->startup_wm_class.isEmpty()) {
-                qCDebug(app) << "Using StartupWMClass as display name:" << entry->startup_wm_class;
-                return entry->startup_wm_class;
-            }
-            if (!entry->displayName.isEmpty()) {
-                qCDebug(app) << "Using display name from desktop entry:" << entry->displayName;
-                if (proc->cmdline().size() > 1) {
-                    // check if last arg of cmdline is url, if so take it's filename
-                    auto url = QUrl(proc->cmdline()[proc->cmdline().size() - 1]);
-                    if (url.isValid() && (url.isLocalFile() || !url.host().isEmpty())) {
-                        qCDebug(app) << "Prepending filename from URL to display name:" << url.fileName();
-                        return QString("%1 - %2").arg(url.fileName()).arg(entry->displayName);
-                    }
+        switch (displayName->kind) {
+        case kDisplayNameEntry:
+            if (proc->cmdline().size() > 1) {
+                // check if last arg of cmdline is url, if so take it's filename
+                auto url = QUrl(proc->cmdline()[proc->cmdline().size() - 1]);
+                if (url.isValid() && (url.isLocalFile() || !url.host().isEmpty())) {
+                    qCDebug(app) << "Prepending filename from URL to display name:" << url.fileName();
+                    return QString("%1 - %2").arg(url.fileName()).arg(displayName->name);
                 }
-
-                return entry->displayName;
-            } // ::if(displayName)
-        } // ::if(desktopEntryCache)
-
-        // is shell?
-        if (shellList.contains(proc->name())) {
+            }
+            return displayName->name;
+        case kDisplayNameFixed:
+            return displayName->name;
+        case kDisplayNameShell: {
             auto joined = proc->cmdline().join(' ');
             qCDebug(app) << "Process is a shell, using cmdline as display name:" << joined;
             return QString(joined);
         }
-
-        if (proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE") && proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE_PID") && proc->environ()["GIO_LAUNCHED_DESKTOP_FILE_PID"].toInt() == proc->pid()) {
-            qCDebug(app) << "Found GIO_LAUNCHED_DESKTOP_FILE in environment";
-            // has gio info set in environment
-            auto desktopFile = proc->environ()["GIO_LAUNCHED_DESKTOP_FILE"];
-            auto entry = desktopEntryCache->entryWithDesktopFile(desktopFile);
-            if (entry && !entry->displayName.isEmpty()) {
-                qCDebug(app) << "Found display name from desktop file:" << entry->displayName;
-                return entry->displayName;
-            }
-        }
-
-        if (proc->cmdline()[0].startsWith("/opt")) {
-            qCDebug(app) << "Process path starts with /opt";
-            QString fname = QFileInfo(QString(proc->cmdline()[0]).split(' ')[0]).fileName();
-            auto entry = desktopEntryCache->entryWithSubName(fname);
-            if (entry && !entry->displayName.isEmpty()) {
-                qCDebug(app) << "Found display name from sub-name entry:" << entry->displayName;
-                return entry->displayName;
-            }
+        default:
+            break;
         }
     } // ::if(cmdline)
 #endif
@@ -191,5 +158,91 @@ QString ProcessName::getDisplayName(Process *proc)
     return proc->name();
 }
 
+QString ProcessName::contentKey(Process *proc, bool tray)
+{
+    // everything resolveName() looks at, but the pid
+    const QHash<QString, QString> &environ = proc->environ();
+    const QString &desktopFile = environ.value("GIO_LAUNCHED_DESKTOP_FILE");
+    bool launched = !desktopFile.isEmpty() && environ.value("GIO_LAUNCHED_DESKTOP_FILE_PID").toInt() == proc->pid();
+    return QStringList {proc->name(), QString(proc->cmdline().value(0)), desktopFile, QString::number(int(tray) | int(launched) << 1)}.join('\n');
+}
+
+std::shared_ptr<display_name_t> ProcessName::contentName(Process *proc, bool tray)
+{
+    const QString &key = contentKey(proc, tray);
+    ProcessNameCache *cache = ProcessNameCache::instance();
+    std::shared_ptr<display_name_t> displayName = cache->find(key);
+    if (!displayName) {
+        qCDebug(app) << "Display name cache miss for pid" << proc->pid();
+        displayName.reset(resolveName(proc, tray));
+        cache->insert(key, displayName);
+    }
+    return displayName;
+}
+
+display_name_t *ProcessName::resolveName(Process *proc, bool tray)
+{
+    qCDebug(app) << "Resolving display name for pid" << proc->pid() << "name" << proc->name();
+    DesktopEntryCache *desktopEntryCache = ProcessDB::instance()->desktopEntryCache();
+    auto *displayName = new display_name_t();
+
+    if (tray && proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE")) {
+        qCDebug(app) << "Found GIO_LAUNCHED_DESKTOP_FILE for tray app";
+        auto desktopFile = proc->environ()["GIO_LAUNCHED_DESKTOP_FILE"];
+        auto entry = desktopEntryCache->entryWithDesktopFile(desktopFile);
+        if (entry && !entry->displayName.isEmpty())
+            displayName->trayName = entry->displayName;
+    }
+
+    if (desktopEntryCache->entry(proc->name())) {
+        qCDebug(app) << "Found desktop entry for process";
+        // found desktop entry
+        auto &entry = desktopEntryCache->entry(proc->name());
+        if (!entry->startup_wm_class.isEmpty()) {
+            qCDebug(app) << "Using StartupWMClass as display name:" << entry->startup_wm_class;
+            displayName->kind = kDisplayNameFixed;
+            displayName->name = entry->startup_wm_class;
+            return displayName;
+        }
+        if (!entry->displayName.isEmpty()) {
+            qCDebug(app) << "Using display name from desktop entry:" << entry->displayName;
+            displayName->kind = kDisplayNameEntry;
+            displayName->name = entry->displayName;
+            return displayName;
+        } // ::if(displayName)
+    } // ::if(desktopEntryCache)
+
+    // is shell?
+    if (shellList.contains(proc->name())) {
+        displayName->kind = kDisplayNameShell;
+        return displayName;
+    }
+
+    if (proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE") && proc->environ().contains("GIO_LAUNCHED_DESKTOP_FILE_PID") && proc->environ()["GIO_LAUNCHED_DESKTOP_FILE_PID"].toInt() == proc->pid()) {
+        qCDebug(app) << "Found GIO_LAUNCHED_DESKTOP_FILE in environment";
+        // has gio info set in environment
+        auto desktopFile = proc->environ()["GIO_LAUNCHED_DESKTOP_FILE"];
+        auto entry = desktopEntryCache->entryWithDesktopFile(desktopFile);
+        if (entry && !entry->displayName.isEmpty()) {
+            qCDebug(app) << "Found display name from desktop file:" << entry->displayName;
+            displayName->kind = kDisplayNameFixed;
+            displayName->name = entry->displayName;
+            return displayName;
+        }
+    }
+
+    if (proc->cmdline().value(0).startsWith("/opt")) {
+        qCDebug(app) << "Process path starts with /opt";
+        QString fname = QFileInfo(QString(proc->cmdline()[0]).split(' ')[0]).fileName();
+        auto entry = desktopEntryCache->entryWithSubName(fname);
+        if (entry && !entry->displayName.isEmpty()) {
+            qCDebug(app) << "Found display name from sub-name entry:" << entry->displayName;
+            displayName->kind = kDisplayNameFixed;
+            displayName->name = entry->displayName;
+        }
+    }
+    return displayName;
+}
+
 } // namespace process
 } // namespace core
@@ -15,6 +15,7 @@ namespace core {
 namespace process {
 
 class Process;
+struct display_name_t;
 
 class ProcessName
 {
@@ -31,6 +32,12 @@ public:
 
 private:
     QString getDisplayName(Process *proc);
+    /**
+     * @brief Display name resolved from the name, executable & desktop file of proc, shared through ProcessNameCache
+     */
+    std::shared_ptr<display_name_t> contentName(Process *proc, bool tray);
+    display_name_t *resolveName(Process *proc, bool tray);
+    static QString contentKey(Process *proc, bool tray);
 
 private:
     QString m_name {};
@@ -6,16 +6,37 @@
 #ifndef PROCESS_NAME_CACHE_H
 #define PROCESS_NAME_CACHE_H
 
-#include "process_name.h"
+#include "content_cache.h"
 
-#include <QCache>
 #include <QObject>
+#include <QString>
+
+// bytes of resolved display names kept
+#define PROCESS_NAME_CACHE_MAX_COST (1 << 20)
 
 namespace core {
 namespace process {
 
+enum display_name_kind_t {
+    kDisplayNameProcess, // name of the process
+    kDisplayNameEntry, // display name of the desktop entry, prefixed with the file name the process opened
+    kDisplayNameFixed, // StartupWMClass or display name of the desktop file, used as is
+    kDisplayNameShell // cmdline of the shell
+};
+
+/**
+ * @brief Display name resolved from the desktop entries matching a process
+ */
+struct display_name_t {
+    QString trayName; // display name of the desktop file of a tray app, used while it has no window title
+    display_name_kind_t kind {kDisplayNameProcess};
+    QString name; // kDisplayNameEntry & kDisplayNameFixed
+};
+
 /**
- * @brief The ProcessNameCache class
+ * @brief Resolved display names, keyed by what they are resolved from (see ProcessName::getDisplayName)
+ *
+ * Names are refreshed on every scan, a hit saves the scans of the desktop entry cache for the process.
  */
 class ProcessNameCache : public QObject
 {
@@ -24,18 +45,19 @@ class ProcessNameCache : public QObject
 public:
     static ProcessNameCache *instance();
 
-    void insert(pid_t pid, ProcessName *name);
-    void remove(pid_t pid);
+    std::shared_ptr<display_name_t> find(const QString &key);
+    void insert(const QString &key, const std::shared_ptr<display_name_t> &name);
+    void remove(const QString &key);
     void clear();
 
-    const ProcessName *processName(pid_t pid) const;
-    bool contains(pid_t pid) const;
+    bool contains(const QString &key) const;
+    content_cache_stats_t stats() const;
 
 protected:
     explicit ProcessNameCache(QObject *parent = nullptr);
 
 private:
-    QCache<pid_t, ProcessName> m_cache;
+    ContentCache<display_name_t> m_cache {"Process name", PROCESS_NAME_CACHE_MAX_COST};
 
     static ProcessNameCache *m_instance;
 };
@@ -48,14 +70,20 @@ inline ProcessNameCache *ProcessNameCache::instance()
     return m_instance;
 }
 
-inline void ProcessNameCache::insert(pid_t pid, ProcessName *name)
+inline std::shared_ptr<display_name_t> ProcessNameCache::find(const QString &key)
+{
+    return m_cache.find(key);
+}
+
+inline void ProcessNameCache::insert(const QString &key, const std::shared_ptr<display_name_t> &name)
 {
-    m_cache.insert(pid, name);
+    int cost = int(sizeof(display_name_t)) + (name->trayName.size() + name->name.size()) * int(sizeof(QChar));
+    m_cache.insert(key, name, cost);
 }
 
-inline void ProcessNameCache::remove(pid_t pid)
+inline void ProcessNameCache::remove(const QString &key)
 {
-    m_cache.remove(pid);
+    m_cache.remove(key);
 }
 
 inline void ProcessNameCache::clear()
@@ -63,14 +91,14 @@ inline void ProcessNameCache::clear()
     m_cache.clear();
 }
 
-inline const ProcessName *ProcessNameCache::processName(pid_t pid) const
+inline bool ProcessNameCache::contains(const QString &key) const
 {
-    return m_cache[pid];
+    return m_cache.contains(key);
 }
 
-inline bool ProcessNameCache::contains(pid_t pid) const
+inline content_cache_stats_t ProcessNameCache::stats() const
 {
-    return m_cache.contains(pid);
+    return m_cache.stats();
 }
 
 } // namespace process
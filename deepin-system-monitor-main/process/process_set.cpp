@@ -7,31 +7,88 @@
 #include "ddlog.h"
 #include "process/process_db.h"
 #include "common/common.h"
+#include "common/perf_stats.h"
+#include "common/source_root.h"
 #include "wm/wm_window_list.h"
 #include "system_service_client.h"
 #include "process/private/process_p.h"
+#include "system/sys_info.h"
+#include "system/netif_monitor.h"
+#include "system/netif_monitor_thread.h"
 // #include "settings.h"
 
 #include <QDebug>
 #include <QFile>
 #include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
 #include <DConfig>
 
+#include <atomic>
+#include <utility>
+
 #include <errno.h>
+#include <string.h>
 
 #define PROC_PATH "/proc"
 
+// processes handed to a refresh worker at once
+#define REFRESH_SHARD_SIZE 64
+// below this number of processes sharding costs more than it saves
+#define REFRESH_SHARD_MIN_PROCS 512
+#define REFRESH_WORKERS_MAX 256
+// scans between two full /proc walks while proc events keep the pid list up to date
+#define PROC_RESYNC_TICKS 30
+
 using namespace common::error;
+using namespace common::perf;
 DCORE_USE_NAMESPACE
 
 namespace core {
 namespace process {
 
+static inline quint64 mixFingerprint(quint64 h, quint64 v)
+{
+    // FNV-1a step
+    return (h ^ v) * 1099511628211ull;
+}
+
+static inline quint64 realBits(qreal v)
+{
+    quint64 bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+// hash of the values shown in process table, tells processes that changed apart from idle ones
+static quint64 displayFingerprint(const Process &proc)
+{
+    quint64 h = 14695981039346656037ull;
+    h = mixFingerprint(h, realBits(proc.cpu()));
+    h = mixFingerprint(h, proc.memory());
+    h = mixFingerprint(h, proc.vtrmemory());
+    h = mixFingerprint(h, proc.sharememory());
+    h = mixFingerprint(h, realBits(proc.readBps()));
+    h = mixFingerprint(h, realBits(proc.writeBps()));
+    h = mixFingerprint(h, realBits(proc.recvBps()));
+    h = mixFingerprint(h, realBits(proc.sentBps()));
+    h = mixFingerprint(h, realBits(proc.gpu()));
+    h = mixFingerprint(h, proc.gpuMemory());
+    h = mixFingerprint(h, quint64(proc.priority()));
+    h = mixFingerprint(h, quint64(proc.state()));
+    h = mixFingerprint(h, quint64(proc.appType()));
+    h = mixFingerprint(h, qHash(proc.name()));
+    h = mixFingerprint(h, qHash(proc.displayName()));
+    return h;
+}
+
 ProcessSet::ProcessSet()
     : m_set {}
     , m_recentProcStage {}
     , m_pidCtoPMapping {}
     , m_pidPtoCMapping {}
+    , m_appCount(0)
+    , m_resyncCountdown(0)
     , m_systemServiceClient(nullptr)
     , m_useSystemService(false)
     , m_config(nullptr)
@@ -51,6 +108,33 @@ ProcessSet::ProcessSet()
         qCInfo(app) << "DKapture enabled in config:" << dkaptureEnabled;
     }
 
+    // 分片并行刷新: 0 - 在监视线程中顺序读取, -1 - 按CPU核数, N - N个工作线程
+    int refreshWorkers = 0;
+    if (m_config) {
+        refreshWorkers = m_config->value("process_refresh_workers", 0).toInt();
+        if (refreshWorkers < 0)
+            refreshWorkers = QThread::idealThreadCount();
+        refreshWorkers = qMin(refreshWorkers, REFRESH_WORKERS_MAX);
+    }
+    if (refreshWorkers > 1) {
+        qCInfo(app) << "Sharded process refresh enabled with" << refreshWorkers << "workers";
+        m_refreshPool.reset(new QThreadPool());
+        // the monitor thread takes shards as well
+        m_refreshPool->setMaxThreadCount(refreshWorkers - 1);
+    }
+
+    // 进程事件监听: 通过NETLINK_CONNECTOR跟踪进程创建及退出, 需要CAP_NET_ADMIN
+    // 进程事件及DKapture数据均来自本机, 读取其他/proc根目录时不使用
+    if (common::source::isRedirected())
+        dkaptureEnabled = false;
+    if (m_config && m_config->value("enable_proc_connector", false).toBool() && !common::source::isRedirected()) {
+        m_procConnector.reset(new ProcConnector());
+        if (!m_procConnector->start()) {
+            qCInfo(app) << "Proc events not available, walking /proc on each scan";
+            m_procConnector.reset();
+        }
+    }
+
     // 只有在配置启用时才初始化系统服务客户端
     if (dkaptureEnabled) {
         qCInfo(app) << "Initializing system service client (DKapture enabled in config)";
@@ -83,6 +167,8 @@ ProcessSet::ProcessSet(const ProcessSet &other)
     , m_recentProcStage(other.m_recentProcStage)
     , m_pidCtoPMapping(other.m_pidCtoPMapping)
     , m_pidPtoCMapping(other.m_pidPtoCMapping)
+    , m_appCount(other.m_appCount)
+    , m_resyncCountdown(0)
     , m_systemServiceClient(nullptr)
     , m_useSystemService(other.m_useSystemService)
     , m_config(nullptr)
@@ -114,28 +200,38 @@ ProcessSet::~ProcessSet()
 void ProcessSet::mergeSubProcNetIO(pid_t ppid, qreal &recvBps, qreal &sendBps)
 {
     qCDebug(app) << "Merging sub-process net IO for ppid" << ppid;
-    auto it = m_pidPtoCMapping.find(ppid);
-    while (it != m_pidPtoCMapping.end() && it.key() == ppid) {
-        mergeSubProcNetIO(it.value(), recvBps, sendBps);
-        ++it;
+    const ProcLink *link = m_pidPtoCMapping.find(ppid);
+    for (pid_t child = link ? link->firstChild : 0; child > 0; child = m_pidPtoCMapping.value(child).nextSibling) {
+        mergeSubProcNetIO(child, recvBps, sendBps);
     }
 
-    const Process &proc = m_set[ppid];
-    recvBps += proc.recvBps();
-    sendBps += proc.sentBps();
+    const Process *proc = m_set.find(ppid);
+    if (proc) {
+        recvBps += proc->recvBps();
+        sendBps += proc->sentBps();
+    }
 }
 
 void ProcessSet::mergeSubProcCpu(pid_t ppid, qreal &cpu)
 {
     qCDebug(app) << "Merging sub-process CPU for ppid" << ppid;
-    auto it = m_pidPtoCMapping.find(ppid);
-    while (it != m_pidPtoCMapping.end() && it.key() == ppid) {
-        mergeSubProcCpu(it.value(), cpu);
-        ++it;
+    const ProcLink *link = m_pidPtoCMapping.find(ppid);
+    for (pid_t child = link ? link->firstChild : 0; child > 0; child = m_pidPtoCMapping.value(child).nextSibling) {
+        mergeSubProcCpu(child, cpu);
     }
 
-    const Process &proc = m_set[ppid];
-    cpu += proc.cpu();
+    const Process *proc = m_set.find(ppid);
+    if (proc)
+        cpu += proc->cpu();
+}
+
+// nothing takes socket traffic while network stats are not wanted, drop it so the stat cache does not grow
+static void discardSockIOStats()
+{
+    auto *thread = ThreadManager::instance()->thread<NetifMonitorThread>(BaseThread::kNetifMonitorThread);
+    NetifMonitor *monitor = thread ? thread->netifJobInstance() : nullptr;
+    if (monitor)
+        monitor->clearSockIOStats();
 }
 
 void ProcessSet::refresh()
@@ -148,8 +244,13 @@ void ProcessSet::scanProcess()
 {
     QElapsedTimer timer;
     timer.start();
+    PerfScope perfScope(kStageProcessScan);
 
     qCInfo(app) << "Scanning processes";
+    m_fdCache.beginRefresh();
+    m_sockScan.beginScan();
+    if (!m_sockScan.isWanted())
+        discardSockIOStats();
 
     if (m_useSystemService) {
         qCInfo(app) << "Using DKapture enhanced scanning";
@@ -157,52 +258,40 @@ void ProcessSet::scanProcess()
         qCInfo(app) << "Using traditional /proc scanning";
     }
 
-    for (auto iter = m_set.begin(); iter != m_set.end(); iter++) {
-        qCDebug(app) << "Storing recent stage for pid" << iter->pid();
+    m_recentProcStage.reserve(m_set.size());
+    for (const Process &proc : m_set.values()) {
+        qCDebug(app) << "Storing recent stage for pid" << proc.pid();
         std::shared_ptr<RecentProcStage> procstage = std::make_shared<RecentProcStage>();
-        procstage->ptime = iter->utime() + iter->stime();
-        procstage->read_bytes = iter->readBytes();
-        procstage->write_bytes = iter->writeBytes();
-        procstage->cancelled_write_bytes = iter->cancelledWriteBytes();
-        procstage->uptime = iter->procuptime();
-        m_recentProcStage[iter->pid()] = procstage;
+        procstage->ptime = proc.utime() + proc.stime();
+        procstage->read_bytes = proc.readBytes();
+        procstage->write_bytes = proc.writeBytes();
+        procstage->cancelled_write_bytes = proc.cancelledWriteBytes();
+        procstage->uptime = proc.procuptime();
+        m_recentProcStage.insert(proc.pid(), procstage);
     }
-    m_curPid.clear();
     m_set.clear();
     m_pidPtoCMapping.clear();
     m_pidCtoPMapping.clear();
     WMWindowList *wmwindowList = ProcessDB::instance()->windowList();
 
-    Iterator iter;
-    QList<pid_t> appLst;
-    while (iter.hasNext()) {
-        Process proc = iter.next();
-
-        if(!m_curPid.contains(proc.pid())) {
-            qCDebug(app) << "Found process with pid" << proc.pid();
-            m_curPid.append(proc.pid());
-        }
-
-    }
+    bool pidReused = collectPids();
+    // 进程数由扫描结果提供, SysInfo 不再单独遍历 /proc
+    core::system::SysInfo::instance()->set_nprocesses(quint32(m_curPid.size()));
 
-    if(m_prePid != m_curPid) {
+    if (m_prePid != m_curPid || pidReused) {
         qCDebug(app) << "Process list changed";
-        for (auto it = m_prePid.begin(); it != m_prePid.end();) {
-            if (!m_curPid.contains(*it)) {
-                // qCDebug(app) << "Removing obsolete pid" << *it;
-                if (m_simpleSet.contains(*it))
-                    m_simpleSet.remove(*it);
-                if (m_pidMyApps.contains(*it))
-                    m_pidMyApps.removeOne(*it);
-                it = m_prePid.erase(it);
-            } else {
-                ++it;
+        for (const pid_t &pid : m_prePid) {
+            if (!m_curPidIndex.contains(pid)) {
+                // qCDebug(app) << "Removing obsolete pid" << pid;
+                m_simpleSet.remove(pid);
+                m_pidMyApps.remove(pid);
+                m_fdCache.release(pid);
             }
         }
 
         for (const pid_t &pid : m_curPid) {
             Process proc;
-            bool isNewProcess = !m_prePid.contains(pid);
+            bool isNewProcess = !m_prePidIndex.contains(pid);
 
             if (isNewProcess) {
                 proc = Process(pid);
@@ -227,7 +316,7 @@ void ProcessSet::scanProcess()
                 if (!isTrayApp) {
                     if (!m_pidMyApps.contains(proc.pid())) {
                         qCDebug(app) << "Adding" << (isNewProcess ? "new" : "existing") << "app process to list:" << proc.pid();
-                        m_pidMyApps << proc.pid();
+                        m_pidMyApps.insert(proc.pid());
                     }
                 } else {
                     qCDebug(app) << "Process" << proc.pid() << "is a tray app, not adding to applications list";
@@ -254,107 +343,163 @@ void ProcessSet::scanProcess()
                     if (isTrayApp) {
                         if (m_pidMyApps.contains(proc.pid())) {
                             qCInfo(app) << "Removing tray app process from list:" << proc.pid();
-                            m_pidMyApps.removeOne(proc.pid());
+                            m_pidMyApps.remove(proc.pid());
                         }
                     } else {
                         if (!m_pidMyApps.contains(proc.pid())) {
                             qCInfo(app) << "Adding reevaluated app process to list:" << proc.pid();
-                            m_pidMyApps << proc.pid();
+                            m_pidMyApps.insert(proc.pid());
                         }
                     }
                 } else {
                     if (m_pidMyApps.contains(proc.pid())) {
                         qCInfo(app) << "Removing non-window process from applications list:" << proc.pid();
-                        m_pidMyApps.removeOne(proc.pid());
+                        m_pidMyApps.remove(proc.pid());
                     }
                 }
             }
         }
         m_prePid = m_curPid;
+        std::swap(m_prePidIndex, m_curPidIndex);
     }
 
     // const QVariant &vindex = m_settings->getOption(kSettingKeyProcessTabIndex, kFilterApps);
     // int index = vindex.toInt();
 
-    // 尝试获取DKapture数据
+    // 尝试获取DKapture数据: 优先使用共享内存中的记录, 不可用时通过D-Bus批量获取
     QVariantMap dkaptureData;
-    
+    dk_shm_batch_t dkaptureBatch;
+    m_dkaptureRecords.clear();
+
     if (m_useSystemService) {
-        QVariantMap response = m_systemServiceClient->getProcessInfoBatch(m_prePid);
-        if (response["success"].toBool()) {
-            dkaptureData = response["data"].toMap();
-            qCInfo(app) << "Successfully got DKapture data for" << dkaptureData.size() << "processes";
+        PerfScope dkapturePerfScope(kStageDKapture);
+        dkaptureBatch = m_systemServiceClient->readProcessInfoShm();
+        if (dkaptureBatch.isValid()) {
+            // 槽在之后第 DKAPTURE_SHM_SLOTS 批才被复用, 记录先复制, 复制后槽仍属于该批才使用
+            m_dkaptureCopy.resize(int(dkaptureBatch.count));
+            memcpy(m_dkaptureCopy.data(), dkaptureBatch.records, dkaptureBatch.count * sizeof(dk_proc_record_t));
+            if (dkaptureBatch.isCurrent()) {
+                m_dkaptureRecords.reserve(m_dkaptureCopy.size());
+                for (const dk_proc_record_t &record : m_dkaptureCopy)
+                    m_dkaptureRecords.insert(record.pid, &record);
+                qCInfo(app) << "Successfully got DKapture batch" << dkaptureBatch.seq << "for" << dkaptureBatch.count << "processes";
+            } else {
+                qCWarning(app) << "DKapture batch" << dkaptureBatch.seq << "was overwritten while copied";
+                qCWarning(app) << "Falling back to traditional /proc scanning";
+            }
         } else {
-            qCWarning(app) << "Failed to get DKapture data:" << response["error"].toString();
-            qCWarning(app) << "Falling back to traditional /proc scanning";
+            QVariantMap response = m_systemServiceClient->getProcessInfoBatch(m_prePid);
+            if (response["success"].toBool()) {
+                dkaptureData = response["data"].toMap();
+                qCInfo(app) << "Successfully got DKapture data for" << dkaptureData.size() << "processes";
+            } else {
+                qCWarning(app) << "Failed to get DKapture data:" << response["error"].toString();
+                qCWarning(app) << "Falling back to traditional /proc scanning";
+            }
         }
     }
     
     // 统一处理所有进程
+    QVector<Process> procList;
+    QVector<Process> procReadList;
+    procList.reserve(m_prePid.size());
     for (const pid_t &pid : m_prePid) {
         Process proc = m_simpleSet[pid];
-        
-        if (dkaptureData.contains(QString::number(pid))) {
+        const dk_proc_record_t *const *record = m_dkaptureRecords.find(pid);
+
+        if (record) {
+            proc.applyDKaptureRecord(**record, &m_sockScan);
+        } else if (dkaptureData.contains(QString::number(pid))) {
             // 使用DKapture数据
             QVariantMap pidData = dkaptureData[QString::number(pid)].toMap();
             qCDebug(app) << "Applying DKapture data to process" << pid;
-            proc.applyDKaptureData(pidData);
+            proc.applyDKaptureData(pidData, &m_sockScan);
         } else {
             // 使用传统方式（包括DKapture获取失败或没有该进程数据的情况）
             qCDebug(app) << "Using traditional /proc reading for process" << pid;
-            proc.readProcessVariableInfo();
+            procReadList << proc;
         }
+        procList << proc;
+    }
+    m_dkaptureRecords.clear();
+
+    // /proc读取可分片并行, 名称及指标计算依赖全局状态, 仍在监视线程中完成
+    readProcessStats(procReadList);
+    for (Process &proc : procReadList) {
+        proc.updateProcessVariableInfo();
+    }
 
+    // 合并结果
+    m_set.reserve(procList.size());
+    for (const Process &proc : procList) {
         if (!proc.isValid()) {
-            qCWarning(app) << "Process" << pid << "invalid application, skipping";
+            qCWarning(app) << "Process" << proc.pid() << "invalid application, skipping";
             continue;
         }
 
         m_set.insert(proc.pid(), proc);
-        m_pidPtoCMapping.insert(proc.ppid(), proc.pid());
+        // prepend to the children chain of parent
+        ProcLink &parentLink = m_pidPtoCMapping[proc.ppid()];
+        pid_t sibling = parentLink.firstChild;
+        parentLink.firstChild = proc.pid();
+        m_pidPtoCMapping[proc.pid()].nextSibling = sibling;
         m_pidCtoPMapping.insert(proc.pid(), proc.ppid());
     }
 
+    // GPU usage is read from DRM fds only while some view shows the GPU columns, zero otherwise
+    m_drmScan.beginScan(PerfScope::monotonicNs());
+    for (int i = 0; i < m_set.size(); ++i) {
+        Process &proc = m_set.valueAt(i);
+        drm_usage_t usage = m_drmScan.scanProcess(proc.pid());
+        proc.setGpuUsage(usage.gpu, usage.memory);
+    }
+    m_drmScan.endScan();
+
     std::function<bool(pid_t ppid)> anyRootIsGuiProc;
     // find if any ancestor processes is gui application
     anyRootIsGuiProc = [&](pid_t ppid) -> bool {
         bool b;
         b = wmwindowList->isGuiApp(ppid);
-        if (!b && m_pidCtoPMapping.contains(ppid))
+        const pid_t *parent = m_pidCtoPMapping.find(ppid);
+        if (!b && parent)
         {
             qCDebug(app) << "Recursively checking for GUI ancestor for ppid" << ppid;
-            b = anyRootIsGuiProc(m_pidCtoPMapping[ppid]);
+            b = anyRootIsGuiProc(*parent);
         }
         return b;
     };
 
-    for (const pid_t &pid : m_pidMyApps) {
+    for (const pid_t &pid : m_pidMyApps.keys()) {
         // qCDebug(app) << "Merging stats for my app with pid" << pid;
+        Process *appProc = m_set.find(pid);
+        if (!appProc)
+            continue;
+
         qreal recvBps = 0;
         qreal sendBps = 0;
         mergeSubProcNetIO(pid, recvBps, sendBps);
-        m_set[pid].setNetIoBps(recvBps, sendBps);
+        appProc->setNetIoBps(recvBps, sendBps);
 
         // In DKapture mode, each subprocess is displayed separately, so no need to merge CPU
         if (!m_useSystemService) {
             qreal ptotalCpu = 0.;
             mergeSubProcCpu(pid, ptotalCpu);
-            m_set[pid].setCpu(ptotalCpu);
+            appProc->setCpu(ptotalCpu);
             qCDebug(app) << "Traditional mode: merged CPU for PID" << pid << "total:" << ptotalCpu;
         } else {
-            qCDebug(app) << "DKapture mode: skipping CPU merge for PID" << pid << "current CPU:" << m_set[pid].cpu();
+            qCDebug(app) << "DKapture mode: skipping CPU merge for PID" << pid << "current CPU:" << appProc->cpu();
         }
 
         if (!wmwindowList->isGuiApp(pid))
         {
             qCDebug(app) << "Process is not a GUI app, checking for GUI ancestor. Pid:" << pid;
             // only if no ancestor process is gui app we keep this process
-            if (m_pidCtoPMapping.contains(pid) &&
-                    anyRootIsGuiProc(m_pidCtoPMapping[pid])) {
+            const pid_t *ppid = m_pidCtoPMapping.find(pid);
+            if (ppid && anyRootIsGuiProc(*ppid)) {
                 qCDebug(app) << "Found GUI ancestor for pid" << pid;
 
                 // when we start app with deepin-terminal, we should skip setting apptype as CurrentUser
-                const Process parentProc = getProcessById(m_pidCtoPMapping[pid]);
+                const Process parentProc = getProcessById(*ppid);
                 QString parentCmdLineString = parentProc.cmdlineString();
 
                 /* 通过窗管接口获取到玲珑版本浏览器，wid 对应的 pid
@@ -372,25 +517,173 @@ void ProcessSet::scanProcess()
                   continue;
                 }
 
-                m_set[pid].setAppType(kFilterCurrentUser);
+                appProc->setAppType(kFilterCurrentUser);
                 wmwindowList->removeDesktopEntryApp(pid);
             }
         }
     }
 
+    updateDelta();
     m_recentProcStage.clear();
+    m_fdCache.endRefresh();
+    // /proc reads are spread over the refresh workers, counted by the fd cache
+    perfScope.setSyscalls(m_fdCache.lastRefreshSyscalls());
+
+    if (!m_shortLived.isEmpty()) {
+        qCInfo(app) << m_shortLived.size() << "processes started & exited since the previous scan";
+        for (const short_lived_proc_t &proc : m_shortLived) {
+            qCDebug(app) << "Short lived process" << proc.pid << proc.comm << "parent" << proc.ppid
+                         << "lived" << proc.lifetimeNs / 1000 << "us, exit status" << proc.exitCode;
+        }
+    }
 
     // 性能统计
     qint64 elapsed = timer.elapsed();
     QString mode = m_useSystemService ? "DKapture" : "Traditional";
-    qCInfo(app) << QString("OK! scanProcess completed in %1ms using %2 mode").arg(elapsed).arg(mode);
+    qCInfo(app) << QString("OK! scanProcess completed in %1ms using %2 mode, %3 /proc syscalls, %4 cached fds, +%5 -%6 ~%7 processes")
+                   .arg(elapsed).arg(mode).arg(m_fdCache.lastRefreshSyscalls()).arg(m_fdCache.openedCount())
+                   .arg(m_delta.added.size()).arg(m_delta.removed.size()).arg(m_delta.changed.size());
+}
+
+bool ProcessSet::collectPids()
+{
+    m_curPid.clear();
+    m_curPidIndex.clear();
+    m_shortLived.clear();
+
+    ProcChanges changes;
+    bool incremental = false;
+    if (m_procConnector) {
+        // taken on every scan, so a full walk starts from a clean slate as well
+        m_procConnector->takeChanges(changes);
+        m_shortLived.swap(changes.shortLived);
+        if (changes.overflowed)
+            qCWarning(app) << "Proc events lost, resyncing pids from /proc";
+        incremental = !changes.overflowed && m_resyncCountdown > 0;
+        m_resyncCountdown = incremental ? m_resyncCountdown - 1 : PROC_RESYNC_TICKS;
+    }
+
+    if (!incremental) {
+        // opendir + getdents + closedir of /proc
+        m_fdCache.addSyscalls(3);
+        Iterator iter;
+        while (iter.hasNext()) {
+            Process proc = iter.next();
+
+            if (!m_curPidIndex.contains(proc.pid())) {
+                qCDebug(app) << "Found process with pid" << proc.pid();
+                m_curPid.append(proc.pid());
+                m_curPidIndex.insert(proc.pid());
+            }
+        }
+        return false;
+    }
+
+    PidSet exited;
+    exited.reserve(changes.exited.size());
+    for (const pid_t &pid : changes.exited)
+        exited.insert(pid);
+    for (const pid_t &pid : m_prePid) {
+        if (!exited.contains(pid)) {
+            m_curPid.append(pid);
+            m_curPidIndex.insert(pid);
+        }
+    }
+
+    bool pidReused = false;
+    for (const pid_t &pid : changes.born) {
+        if (exited.contains(pid)) {
+            // the pid exited & was given to a new process, drop what was read about the old one
+            qCDebug(app) << "Pid" << pid << "reused by a new process";
+            m_prePidIndex.remove(pid);
+            m_simpleSet.remove(pid);
+            m_pidMyApps.remove(pid);
+            m_recentProcStage.remove(pid);
+            m_fdCache.release(pid);
+            pidReused = true;
+        }
+        if (!m_curPidIndex.contains(pid)) {
+            m_curPid.append(pid);
+            m_curPidIndex.insert(pid);
+        }
+    }
+    return pidReused;
+}
+
+void ProcessSet::updateDelta()
+{
+    m_delta.seq++;
+    m_delta.added.clear();
+    m_delta.removed.clear();
+    m_delta.changed.clear();
+    m_nextFingerprints.clear();
+    m_nextFingerprints.reserve(m_set.size());
+    m_appCount = 0;
+
+    for (int i = 0; i < m_set.size(); ++i) {
+        const pid_t pid = m_set.keyAt(i);
+        const Process &proc = m_set.valueAt(i);
+        if (proc.appType() == kFilterApps)
+            ++m_appCount;
+
+        quint64 fingerprint = displayFingerprint(proc);
+        const quint64 *prev = m_fingerprints.find(pid);
+        if (!prev)
+            m_delta.added << pid;
+        else if (*prev != fingerprint)
+            m_delta.changed << pid;
+        m_nextFingerprints.insert(pid, fingerprint);
+    }
+
+    for (const pid_t &pid : m_fingerprints.keys()) {
+        if (!m_set.contains(pid))
+            m_delta.removed << pid;
+    }
+    std::swap(m_fingerprints, m_nextFingerprints);
+}
+
+void ProcessSet::readProcessStats(QVector<Process> &procs)
+{
+    const int nprocs = procs.size();
+    if (!m_refreshPool || nprocs < REFRESH_SHARD_MIN_PROCS) {
+        for (Process &proc : procs) {
+            proc.readProcessVariableStats(&m_fdCache, &m_sockScan);
+        }
+        return;
+    }
+
+    // workers pull fixed size shards from a shared cursor, so faster workers take over
+    // the remaining shards of slower ones, each process is touched by one worker only
+    Process *data = procs.data();
+    const int nshards = (nprocs + REFRESH_SHARD_SIZE - 1) / REFRESH_SHARD_SIZE;
+    std::atomic<int> nextShard {0};
+    auto worker = [&]() {
+        int shard;
+        while ((shard = nextShard.fetch_add(1, std::memory_order_relaxed)) < nshards) {
+            const int end = qMin(nprocs, (shard + 1) * REFRESH_SHARD_SIZE);
+            for (int i = shard * REFRESH_SHARD_SIZE; i < end; ++i) {
+                data[i].readProcessVariableStats(&m_fdCache, &m_sockScan);
+            }
+        }
+    };
+
+    const int nworkers = qMin(m_refreshPool->maxThreadCount(), nshards - 1);
+    QList<QFuture<void>> futures;
+    for (int i = 0; i < nworkers; ++i) {
+        futures << QtConcurrent::run(m_refreshPool.get(), worker);
+    }
+    worker();
+    for (QFuture<void> &future : futures) {
+        future.waitForFinished();
+    }
+    qCDebug(app) << "Sharded refresh of" << nprocs << "processes in" << nshards << "shards on" << nworkers + 1 << "threads";
 }
 
 ProcessSet::Iterator::Iterator()
 {
     // qCDebug(app) << "ProcessSet::Iterator created";
     errno = 0;
-    auto *dp = opendir(PROC_PATH);
+    auto *dp = opendir(common::source::path(PROC_PATH).constData());
     if (!dp) {
         print_errno(errno, "open /proc failed");
         return;
@@ -437,28 +730,56 @@ void ProcessSet::Iterator::advance()
 
 std::weak_ptr<RecentProcStage> ProcessSet::getRecentProcStage(pid_t pid) const
 {
-    return m_recentProcStage[pid];
+    return m_recentProcStage.value(pid);
+}
+
+quint64 ProcessSet::lastRefreshSyscalls() const
+{
+    return m_fdCache.lastRefreshSyscalls();
+}
+
+const ProcessSetDelta &ProcessSet::lastDelta() const
+{
+    return m_delta;
+}
+
+const QVector<short_lived_proc_t> &ProcessSet::lastShortLived() const
+{
+    return m_shortLived;
+}
+
+int ProcessSet::processCount() const
+{
+    return m_set.size();
+}
+
+int ProcessSet::appCount() const
+{
+    return m_appCount;
+}
+
+SockInodeScan &ProcessSet::sockInodeScan()
+{
+    return m_sockScan;
+}
+
+DrmClientScan &ProcessSet::drmClientScan()
+{
+    return m_drmScan;
 }
 
 const Process ProcessSet::getProcessById(pid_t pid) const
 {
-    return m_set[pid];
+    return m_set.value(pid);
 }
 
 QList<pid_t> ProcessSet::getPIDList() const
 {
-    // 当系统读取到的m_set为空时,通过keys()函数返回会造成段错误 原因是keys函数效率低下,会造成大量的内存拷贝
-    // 替换方案是
     qCDebug(app) << "Getting PID list";
     QList<pid_t> pidList {};
-    pidList.clear();
-    int size = m_set.size();
-    QMap<pid_t, Process>::key_iterator iterBegin = m_set.keyBegin();
-    for (;iterBegin != m_set.keyEnd(); ++iterBegin) {
-        pid_t tmpKey = *iterBegin;
-        pidList.append(tmpKey);
-        if (size != m_set.size())
-            break;
+    pidList.reserve(m_set.size());
+    for (const pid_t &pid : m_set.keys()) {
+        pidList.append(pid);
     }
     return pidList;
 }
@@ -467,20 +788,24 @@ void ProcessSet::removeProcess(pid_t pid)
 {
     // qCDebug(app) << "Removing process with pid" << pid;
     m_set.remove(pid);
+    // reported as added again by the next scan if it is still alive
+    m_fingerprints.remove(pid);
 }
 
 void ProcessSet::updateProcessState(pid_t pid, char state)
 {
     qCDebug(app) << "Updating process state for pid" << pid << "to" << state;
-    if (m_set.contains(pid))
-        m_set[pid].setState(state);
+    Process *proc = m_set.find(pid);
+    if (proc)
+        proc->setState(state);
 }
 
 void ProcessSet::updateProcessPriority(pid_t pid, int priority)
 {
     qCDebug(app) << "Updating process priority for pid" << pid << "to" << priority;
-    if (m_set.contains(pid))
-        m_set[pid].setPriority(priority);
+    Process *proc = m_set.find(pid);
+    if (proc)
+        proc->setPriority(priority);
 }
 
 
@@ -7,9 +7,17 @@
 #define PROCESS_SET_H
 
 #include "process.h"
+#include "process_fd_cache.h"
+#include "sock_inode_scan.h"
+#include "drm_client_scan.h"
+#include "proc_connector.h"
+#include "pid_index.h"
+#include "dkapture_shm.h"
 #include "common/common.h"
 
 #include <QMap>
+#include <QVector>
+#include <QThreadPool>
 #include <DConfig>
 
 #include <dirent.h>
@@ -35,6 +43,16 @@ struct RecentProcStage {
     timeval uptime = {0, 0};
 };
 
+/**
+ * @brief Processes added, removed & changed by one scan
+ */
+struct ProcessSetDelta {
+    quint64 seq = 0; // scan sequence number, increased by one on each scan
+    QVector<pid_t> added;
+    QVector<pid_t> removed;
+    QVector<pid_t> changed; // processes whose displayed values changed since the previous scan
+};
+
 // Forward declaration
 class Process;
 
@@ -51,13 +69,51 @@ public:
     void updateProcessState(pid_t pid, char state);
     void updateProcessPriority(pid_t pid, int priority);
     std::weak_ptr<RecentProcStage> getRecentProcStage(pid_t pid) const;
+    /**
+     * @brief Number of /proc related syscalls issued by the last refresh
+     */
+    quint64 lastRefreshSyscalls() const;
+    /**
+     * @brief Difference between the last scan and the one before it
+     */
+    const ProcessSetDelta &lastDelta() const;
+    /**
+     * @brief Processes started & exited between the last two scans, only known with proc events enabled
+     */
+    const QVector<short_lived_proc_t> &lastShortLived() const;
+    /**
+     * @brief Number of processes & applications found by the last scan
+     */
+    int processCount() const;
+    int appCount() const;
+    /**
+     * @brief Demand & policy of socket inode discovery, views showing network columns register here
+     */
+    SockInodeScan &sockInodeScan();
+    /**
+     * @brief Demand of per process GPU usage, views showing GPU columns register here
+     */
+    DrmClientScan &drmClientScan();
 
     void refresh();
 
 private:
     void scanProcess();
+    /**
+     * @brief Fill m_curPid from proc events, or by walking /proc on resync
+     * @return true if a pid of the previous scan was reused by a new process
+     */
+    bool collectPids();
+    /**
+     * @brief Read per-refresh /proc files of procs, sharded over the refresh worker pool if enabled
+     */
+    void readProcessStats(QVector<Process> &procs);
     void mergeSubProcNetIO(pid_t ppid, qreal &recvBps, qreal &sendBps);
     void mergeSubProcCpu(pid_t ppid, qreal &cpu);
+    /**
+     * @brief Compare the processes of the finished scan with the previous one
+     */
+    void updateDelta();
 
     class Iterator
     {
@@ -76,19 +132,49 @@ private:
 
 private:
     // Settings *m_settings = nullptr;
-    QMap<pid_t, Process> m_simpleSet;
-    QMap<pid_t, Process> m_set;
-    QMap<pid_t, std::shared_ptr<RecentProcStage>> m_recentProcStage {};
-
-    QMap<pid_t, pid_t> m_pidCtoPMapping {}; // child to parent pid mapping
-    QMultiMap<pid_t, pid_t> m_pidPtoCMapping {}; // parent to child pid mapping
+    PidIndex<Process> m_simpleSet;
+    PidIndex<Process> m_set;
+    PidIndex<std::shared_ptr<RecentProcStage>> m_recentProcStage {};
+
+    // parent to child mapping, children of a process are chained through nextSibling
+    struct ProcLink {
+        pid_t firstChild = 0;
+        pid_t nextSibling = 0;
+    };
+    PidIndex<pid_t> m_pidCtoPMapping {}; // child to parent pid mapping
+    PidIndex<ProcLink> m_pidPtoCMapping {}; // parent to child pid mapping
     QList<pid_t> m_prePid;
     QList<pid_t> m_curPid;
-    QList<pid_t> m_pidMyApps;
+    PidSet m_prePidIndex;
+    PidSet m_curPidIndex;
+    PidSet m_pidMyApps;
+
+    // display fingerprints of the processes found by the last scan, see updateDelta()
+    PidIndex<quint64> m_fingerprints;
+    PidIndex<quint64> m_nextFingerprints;
+    ProcessSetDelta m_delta;
+    int m_appCount;
+
+    // persistent /proc/[pid]/{stat,statm,io,schedstat,status} descriptors of live processes
+    ProcessFdCache m_fdCache;
+    // decides which processes get their fds walked for socket inodes
+    SockInodeScan m_sockScan;
+    // per process GPU usage from the fdinfo of DRM fds
+    DrmClientScan m_drmScan;
+    // proc event listener keeping the pid list up to date between /proc walks, null if disabled
+    std::unique_ptr<ProcConnector> m_procConnector;
+    // incremental scans left until the next full /proc walk
+    int m_resyncCountdown;
+    QVector<short_lived_proc_t> m_shortLived;
+    // worker pool for sharded refresh, null if refresh runs on the monitor thread only
+    std::unique_ptr<QThreadPool> m_refreshPool;
     
     // System service client for DKapture data
     SystemServiceClient *m_systemServiceClient;
     bool m_useSystemService;
+    // records copied from the current DKapture shared memory batch & their index, rebuilt each scan
+    QVector<dk_proc_record_t> m_dkaptureCopy;
+    PidIndex<const dk_proc_record_t *> m_dkaptureRecords;
     
     // DConfig for configuration management
     DTK_CORE_NAMESPACE::DConfig *m_config;
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sock_inode_scan.h"
+#include "ddlog.h"
+
+#include <QMutexLocker>
+
+// scans between two walks of a process whose fd table size did not change
+#define SOCK_INODE_RESCAN_TICKS 5
+
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+SockInodeScan::SockInodeScan()
+    : m_demand {false}
+    , m_wanted {false}
+    , m_tick {0}
+    , m_epoch {1}
+{
+}
+
+void SockInodeScan::setWanted(const void *client, bool wanted)
+{
+    QMutexLocker locker(&m_clientsLock);
+    if (wanted)
+        m_clients.insert(client);
+    else
+        m_clients.remove(client);
+    m_demand.store(!m_clients.isEmpty());
+}
+
+void SockInodeScan::beginScan()
+{
+    bool wanted = m_demand.load();
+    if (wanted && !m_wanted) {
+        qCDebug(app) << "Network columns shown, walking fds of all processes";
+        ++m_epoch;
+    }
+    m_wanted = wanted;
+    ++m_tick;
+}
+
+bool SockInodeScan::needsWalk(pid_t pid, SockInodeScanState &state, int fdSize) const
+{
+    if (!m_wanted)
+        return false;
+
+    // periodic walk, spread over pids so that not all processes are walked on the same scan
+    bool walk = state.tick != m_tick && (m_tick + quint64(pid)) % SOCK_INODE_RESCAN_TICKS == 0;
+    // fds of processes owned by other users are not readable, retried on periodic walks only
+    if (state.readable) {
+        walk = walk || state.epoch != m_epoch
+               || (fdSize >= 0 && fdSize != state.fdSize);
+    }
+    if (walk) {
+        state.fdSize = fdSize;
+        state.tick = m_tick;
+        state.epoch = m_epoch;
+    }
+    return walk;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCK_INODE_SCAN_H
+#define SOCK_INODE_SCAN_H
+
+#include <QMutex>
+#include <QSet>
+
+#include <atomic>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Bookkeeping of the last /proc/[pid]/fd walk of a process
+ */
+struct SockInodeScanState {
+    int fdSize = -1; // FDSize of /proc/[pid]/status at the last walk
+    quint64 tick = 0; // scan tick of the last walk
+    quint64 epoch = 0; // demand epoch of the last walk, 0 if never walked
+    bool readable = true; // fd directory could be opened at the last walk
+};
+
+/**
+ * @brief Decides which processes get /proc/[pid]/fd walked for socket inodes on a scan
+ *
+ * Walking fds costs one stat() per open descriptor, so it is only done while some view shows
+ * or sorts by the network columns. Then a process is walked when first seen, when its fd table
+ * size (FDSize) changed, or once every SOCK_INODE_RESCAN_TICKS scans (spread over pids) to pick
+ * up sockets opened in place of closed ones. Traffic of sockets not found yet stays in the
+ * NetifMonitor stat cache and is accounted when the socket is found.
+ *
+ * setWanted() may be called from any thread, the other methods are called by the process scan;
+ * needsWalk() may run concurrently for different processes.
+ */
+class SockInodeScan
+{
+public:
+    SockInodeScan();
+
+    /**
+     * @brief Register whether client (e.g. a process table view) shows network columns
+     */
+    void setWanted(const void *client, bool wanted);
+
+    /**
+     * @brief Start a scan, demand of the clients is sampled once per scan
+     */
+    void beginScan();
+
+    inline bool isWanted() const
+    {
+        return m_wanted;
+    }
+    inline quint64 tick() const
+    {
+        return m_tick;
+    }
+
+    /**
+     * @brief Whether fds of pid need to be walked on this scan, updates state if so
+     * @param fdSize FDSize of /proc/[pid]/status, -1 if unknown
+     */
+    bool needsWalk(pid_t pid, SockInodeScanState &state, int fdSize) const;
+
+private:
+    QMutex m_clientsLock;
+    QSet<const void *> m_clients;
+    std::atomic_bool m_demand;
+
+    // sampled by beginScan()
+    bool m_wanted;
+    quint64 m_tick;
+    // increased each time demand turns on, so every process is walked again
+    quint64 m_epoch;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // SOCK_INODE_SCAN_H
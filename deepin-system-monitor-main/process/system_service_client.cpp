@@ -12,6 +12,14 @@
 #include <QProcess>
 #include <QStandardPaths>
 #include <QFileInfo>
+#include <QDBusUnixFileDescriptor>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace DDLog;
 
@@ -29,6 +37,9 @@ SystemServiceClient::SystemServiceClient(QObject *parent)
     , m_connectionTimer(nullptr)
     , m_serviceAvailable(false)
     , m_dkaptureAvailable(false)
+    , m_shmBase(nullptr)
+    , m_shmSize(0)
+    , m_shmUnsupported(false)
 {
     qCDebug(app) << "SystemServiceClient created";
     
@@ -142,6 +153,82 @@ QVariantMap SystemServiceClient::getProcessInfoBatch(const QList<int> &pids)
     return result;
 }
 
+dk_shm_batch_t SystemServiceClient::readProcessInfoShm()
+{
+    if (!isServiceAvailable() || m_shmUnsupported)
+        return {};
+    if (!m_shmBase && !attachProcessInfoShm())
+        return {};
+
+    // 只有批次序号经过总线, 记录由服务端直接写入共享内存
+    QDBusReply<qulonglong> reply = m_interface->call("updateProcessInfoShm");
+    if (!reply.isValid()) {
+        qCWarning(app) << "updateProcessInfoShm failed:" << reply.error().message();
+        return {};
+    }
+
+    dk_shm_batch_t batch = dkShmBatch(m_shmBase, m_shmSize, reply.value());
+    if (!batch.isValid()) {
+        // 服务端重启后是新的共享内存, 下次重新获取
+        qCInfo(app) << "DKapture batch" << reply.value() << "not found in shared memory, detaching";
+        detachProcessInfoShm();
+    }
+    return batch;
+}
+
+bool SystemServiceClient::attachProcessInfoShm()
+{
+    QDBusConnection bus = QDBusConnection::systemBus();
+    if (!(bus.connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing)) {
+        qCInfo(app) << "System bus can not pass file descriptors, DKapture shared memory disabled";
+        m_shmUnsupported = true;
+        return false;
+    }
+
+    QDBusReply<QDBusUnixFileDescriptor> reply = m_interface->call("getProcessInfoShm");
+    if (!reply.isValid() || !reply.value().isValid()) {
+        qCInfo(app) << "DKapture shared memory not available:" << reply.error().message();
+        m_shmUnsupported = true;
+        return false;
+    }
+
+    // 只映射已封印大小与写入的 memfd, 避免服务端截断后访问映射触发 SIGBUS, 也避免其他客户端改写记录
+    int fd = reply.value().fileDescriptor();
+    struct stat st {};
+    if (fstat(fd, &st) < 0 || !dkShmSealed(fcntl(fd, F_GET_SEALS))) {
+        qCWarning(app) << "DKapture shared memory is not a sealed memfd";
+        m_shmUnsupported = true;
+        return false;
+    }
+
+    size_t size = size_t(st.st_size);
+    void *base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        qCWarning(app) << "Failed to map DKapture shared memory:" << strerror(errno);
+        m_shmUnsupported = true;
+        return false;
+    }
+    if (!dkShmHeader(base, size)) {
+        qCWarning(app) << "DKapture shared memory layout mismatch";
+        munmap(base, size);
+        m_shmUnsupported = true;
+        return false;
+    }
+
+    m_shmBase = base;
+    m_shmSize = size;
+    qCInfo(app) << "Mapped DKapture shared memory," << size << "bytes";
+    return true;
+}
+
+void SystemServiceClient::detachProcessInfoShm()
+{
+    if (m_shmBase)
+        munmap(m_shmBase, m_shmSize);
+    m_shmBase = nullptr;
+    m_shmSize = 0;
+}
+
 
 
 bool SystemServiceClient::startSystemService()
@@ -222,6 +309,8 @@ void SystemServiceClient::connectToService()
         delete m_interface;
         m_interface = nullptr;
     }
+    detachProcessInfoShm();
+    m_shmUnsupported = false;
     
     QDBusConnection bus = QDBusConnection::systemBus();
     if (!bus.isConnected()) {
@@ -256,6 +345,7 @@ void SystemServiceClient::disconnectFromService()
         delete m_interface;
         m_interface = nullptr;
     }
+    detachProcessInfoShm();
     
     m_serviceAvailable = false;
     m_dkaptureAvailable = false;
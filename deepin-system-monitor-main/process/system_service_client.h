@@ -6,6 +6,8 @@
 #ifndef SYSTEM_SERVICE_CLIENT_H
 #define SYSTEM_SERVICE_CLIENT_H
 
+#include "dkapture_shm.h"
+
 #include <QObject>
 #include <QDBusInterface>
 #include <QDBusServiceWatcher>
@@ -31,6 +33,9 @@ public:
     
     // 批量获取进程信息
     QVariantMap getProcessInfoBatch(const QList<int> &pids);
+
+    // 通过共享内存获取一批进程记录, 不可用时返回无效批次, 调用方应回退到 getProcessInfoBatch
+    dk_shm_batch_t readProcessInfoShm();
     
     // 启动系统服务
     bool startSystemService();
@@ -47,12 +52,19 @@ private slots:
 private:
     void connectToService();
     void disconnectFromService();
+    bool attachProcessInfoShm();
+    void detachProcessInfoShm();
 
     QDBusInterface *m_interface;
     QDBusServiceWatcher *m_serviceWatcher;
     QTimer *m_connectionTimer;
     bool m_serviceAvailable;
     bool m_dkaptureAvailable;
+
+    // 只读映射的 DKapture 记录共享内存
+    void *m_shmBase;
+    size_t m_shmSize;
+    bool m_shmUnsupported; // 服务端或总线不支持, 重新连接前不再尝试
     
     static const QString SERVICE_NAME;
     static const QString SERVICE_PATH;
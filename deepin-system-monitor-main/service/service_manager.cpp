@@ -104,12 +104,16 @@ ServiceManager::ServiceManager(QObject *parent)
     EnvironmentFile::registerMetaType();
 
     qRegisterMetaType<QList<SystemServiceEntry>>("ServiceEntryList");
+    qRegisterMetaType<SystemServiceEntry>("SystemServiceEntry");
 
     m_worker = new ServiceManagerWorker();
     m_worker->moveToThread(&m_workerThread);
     connect(this, &ServiceManager::beginUpdateList, m_worker, &ServiceManagerWorker::startJob);
     connect(&m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
     connect(m_worker, &ServiceManagerWorker::resultReady, this, &ServiceManager::serviceListUpdated);
+    // incremental updates driven by systemd signals
+    connect(m_worker, &ServiceManagerWorker::entryUpdated, this, &ServiceManager::serviceStatusUpdated);
+    connect(m_worker, &ServiceManagerWorker::entryRemoved, this, &ServiceManager::serviceRemoved);
     qCDebug(app) << "Starting worker thread";
     m_workerThread.start();
 }
@@ -80,6 +80,7 @@ Q_SIGNALS:
     void beginUpdateList();
     void serviceListUpdated(const QList<SystemServiceEntry> &list);
     void serviceStatusUpdated(const SystemServiceEntry &entry);
+    void serviceRemoved(const QString &sname);
 
 public:
     SystemServiceEntry updateServiceEntry(const QString &opath);
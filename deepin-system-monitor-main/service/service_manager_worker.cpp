@@ -16,25 +16,128 @@
 #include "service_manager.h"
 
 #include <QDebug>
-#include <QtConcurrent>
+#include <QQueue>
+#include <QTimer>
 #include <QRegularExpression>
 
 using namespace DDLog;
 
+// escaped ".service" suffix of unit object paths
+static const char *kServiceObjectPathSuffix = "_2eservice";
+
 ServiceManagerWorker::ServiceManagerWorker(QObject *parent)
     : QObject(parent)
 {
     qCDebug(app) << "ServiceManagerWorker object created";
+    // child object, moved to the worker thread along with us
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(SERVICE_REFRESH_DELAY);
+    connect(m_refreshTimer, &QTimer::timeout, this, &ServiceManagerWorker::refreshChangedUnits);
 }
 
 void ServiceManagerWorker::startJob()
 {
     qCDebug(app) << "ServiceManagerWorker starting job";
-    QList<SystemServiceEntry> list;
-    // id hash, only keys are used here
-    QHash<QString, int> hash;
-    ErrorContext ec;
+    subscribe();
+
+    if (m_subscribed && m_loaded) {
+        // cached list is kept up to date by systemd signals, only apply what is still pending
+        qCDebug(app) << "Service list cached, flushing pending changes";
+        m_refreshTimer->stop();
+        refreshChangedUnits();
+
+        QList<SystemServiceEntry> list = m_entries.values();
+        list << m_templates;
+        qCDebug(app) << "Emitting resultReady with" << list.size() << "cached services";
+        Q_EMIT resultReady(list);
+        return;
+    }
+
+    QList<SystemServiceEntry> list = loadServiceList();
+    m_changedPaths.clear();
+    m_unitFilesChanged = false;
+    m_loaded = true;
+    qCDebug(app) << "Emitting resultReady with" << list.size() << "services";
+    Q_EMIT resultReady(list);
+}
+
+void ServiceManagerWorker::applyUnitProperties(SystemServiceEntry &entry, const QVariantMap &props)
+{
+    const QString id = props.value("Id").toString();
+    entry.setId(id);
+    if (entry.getSName().isEmpty())
+        entry.setSName(id.left(id.lastIndexOf('.')));
+    entry.setLoadState(props.value("LoadState").toString());
+    entry.setActiveState(props.value("ActiveState").toString());
+    entry.setSubState(props.value("SubState").toString());
+    entry.setDescription(props.value("Description").toString());
+    entry.setCanStart(props.value("CanStart").toBool());
+    entry.setCanStop(props.value("CanStop").toBool());
+    entry.setCanReload(props.value("CanReload").toBool());
+    // state from the unit file list takes precedence, it is what ListUnitFiles reports for aliases
+    if (entry.getState().isEmpty())
+        entry.setState(props.value("UnitFileState").toString());
+
+    entry.setStartupType(ServiceManager::getServiceStartupType(
+            entry.getSName(),
+            entry.getState()));
+}
+
+void ServiceManagerWorker::fetchUnitProperties(QList<SystemServiceEntry> &entries)
+{
+    struct PendingUnit {
+        int index;
+        QDBusPendingCall unit;
+        QDBusPendingCall service;
+    };
+    QQueue<PendingUnit> pending;
+    QDBusConnection bus = QDBusConnection::systemBus();
+
+    auto collect = [&entries](const PendingUnit &p) {
+        SystemServiceEntry &entry = entries[p.index];
 
+        QDBusPendingReply<QVariantMap> props = p.unit;
+        props.waitForFinished();
+        if (props.isError()) {
+            qCWarning(app) << "Failed to get properties of unit" << entry.getUnitObjectPath() << ":" << props.error().name() << props.error().message();
+            return;
+        }
+        applyUnitProperties(entry, props.value());
+
+        QDBusPendingReply<QDBusVariant> pid = p.service;
+        pid.waitForFinished();
+        if (pid.isError()) {
+            qCWarning(app) << "Failed to get main PID of unit" << entry.getId() << ":" << pid.error().name() << pid.error().message();
+        } else {
+            entry.setMainPID(pid.value().variant().toUInt());
+        }
+    };
+
+    // keep a window of requests in flight instead of one blocking round trip per property
+    for (int i = 0; i < entries.size(); ++i) {
+        const QString path = entries[i].getUnitObjectPath();
+        if (path.isEmpty())
+            continue;
+
+        QDBusMessage getAll = QDBusMessage::createMethodCall(DBUS_SYSTEMD1_SERVICE, path,
+                                                             DBusPropertiesInterface::staticInterfaceName(), "GetAll");
+        getAll << QString(Systemd1UnitInterface::staticInterfaceName());
+        QDBusMessage getPID = QDBusMessage::createMethodCall(DBUS_SYSTEMD1_SERVICE, path,
+                                                             DBusPropertiesInterface::staticInterfaceName(), "Get");
+        getPID << QString(Systemd1ServiceInterface::staticInterfaceName()) << QString("MainPID");
+
+        pending.enqueue({i, bus.asyncCall(getAll), bus.asyncCall(getPID)});
+        if (pending.size() >= SERVICE_PIPELINE_DEPTH)
+            collect(pending.dequeue());
+    }
+    while (!pending.isEmpty())
+        collect(pending.dequeue());
+}
+
+QList<SystemServiceEntry> ServiceManagerWorker::loadServiceList()
+{
+    ErrorContext ec;
     Systemd1ManagerInterface mgrIf(DBUS_SYSTEMD1_SERVICE,
                                    kSystemDObjectPath.path(),
                                    QDBusConnection::systemBus());
@@ -45,237 +148,274 @@ void ServiceManagerWorker::startJob()
     if (ec) {
         qCWarning(app) << "ListUnitFiles failed:" << ec.getErrorName() << ec.getErrorMessage();
     }
-    UnitFileInfoList unitFiles = unitFilesResult.second;
+    const UnitFileInfoList &unitFiles = unitFilesResult.second;
 
     auto unitsResult = mgrIf.ListUnits();
     ec = unitsResult.first;
     if (ec) {
         qCWarning(app) << "ListUnits failed:" << ec.getErrorName() << ec.getErrorMessage();
     }
-    UnitInfoList units = unitsResult.second;
-    for (auto u : units) {
-        if (u.getName().endsWith(UnitTypeServiceSuffix)) {
-            hash[u.getName()] = 0;
-        }
-    }
+    const UnitInfoList &units = unitsResult.second;
+
+    QList<SystemServiceEntry> list;
+    QSet<QString> ids;
+    for (const UnitInfo &unit : units) {
+        if (!unit.getName().endsWith(UnitTypeServiceSuffix))
+            continue;
 
-    // filter-out non service type units
-    std::function<bool(const UnitInfo &)> fltUnits;
-    fltUnits = [](const UnitInfo &unit) -> bool {
-        return unit.getName().endsWith(UnitTypeServiceSuffix);
-    };
-    std::function<SystemServiceEntry(const UnitInfo &)> mapUnit = [&mgrIf](const UnitInfo &unit) {
-        qCDebug(app) << "Mapping unit:" << unit.getName();
-        ErrorContext ec1 {};
         SystemServiceEntry entry {};
-        // SName
         entry.setSName(unit.getName().left(unit.getName().lastIndexOf('.')));
-        // LoadState
-        entry.setLoadState(unit.getLoadState());
-        // ActiveState
-        entry.setActiveState(unit.getActiveState());
-        // subState
-        entry.setSubState(unit.getSubState());
         entry.setUnitObjectPath(unit.getUnitObjectPath());
-        // Description
-        entry.setDescription(unit.getDescription());
-
-        Systemd1UnitInterface unitIf(DBUS_SYSTEMD1_SERVICE,
-                                     unit.getUnitObjectPath(),
-                                     QDBusConnection::systemBus());
-        // Id
-        auto id = unitIf.getId();
-        ec1 = id.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to get ID for unit" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully got ID for unit" << unit.getName() << ":" << id.second;
-            entry.setId(id.second);
-        }
-
-        auto bStart = unitIf.canStart();
-        ec1 = bStart.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to check if unit can start:" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully checked if unit can start for unit" << unit.getName() << ":" << bStart.second;
-            entry.setCanStart(bStart.second);
-        }
-
-        auto bStop = unitIf.canStop();
-        ec1 = bStop.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to check if unit can stop:" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully checked if unit can stop for unit" << unit.getName() << ":" << bStop.second;
-            entry.setCanStop(bStop.second);
-        }
-
-        auto bReload = unitIf.canReload();
-        ec1 = bReload.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to check if unit can reload:" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully checked if unit can reload for unit" << unit.getName() << ":" << bReload.second;
-            entry.setCanReload(bReload.second);
-        }
-
-        // mainPID
-        Systemd1ServiceInterface svcIf(DBUS_SYSTEMD1_SERVICE,
-                                       unit.getUnitObjectPath(),
-                                       QDBusConnection::systemBus());
-        auto pid = svcIf.getMainPID();
-        ec1 = pid.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to get main PID for unit" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully got main PID for unit" << unit.getName() << ":" << pid.second;
-            entry.setMainPID(pid.second);
-        }
+        ids << unit.getName();
+        list << entry;
+    }
+    const int nunits = list.size();
 
-        // unit state
-        auto state = mgrIf.GetUnitFileState(unit.getName());
-        ec1 = state.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to get unit file state for" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully got unit file state for unit" << unit.getName() << ":" << state.second;
-            entry.setState(state.second);
-        }
+    m_unitFileStates.clear();
+    m_templates.clear();
+    for (const UnitFileInfo &unf : unitFiles) {
+        auto id = unf.getName().mid(unf.getName().lastIndexOf('/') + 1);
+        if (!id.endsWith(UnitTypeServiceSuffix))
+            continue;
 
-        // startupType
-        entry.setStartupType(ServiceManager::getServiceStartupType(
-                entry.getSName(),
-                entry.getState()));
+        m_unitFileStates[id] = unf.getStatus();
+        if (ids.contains(id))
+            continue;
 
-        return entry;
-    };
-    std::function<void(QList<SystemServiceEntry> & elist, const SystemServiceEntry &entry)> addServiceEntryFromUnitInfo;
-    addServiceEntryFromUnitInfo = [](QList<SystemServiceEntry> &elist, const SystemServiceEntry &entry) {
-        elist << entry;
-    };
-    auto fltufe = QtConcurrent::filter(units, fltUnits);
-    fltufe.waitForFinished();
-    qCDebug(app) << "Finished filtering units";
-    auto ufe = QtConcurrent::mappedReduced<QList<SystemServiceEntry>>(units, mapUnit, addServiceEntryFromUnitInfo);
-
-    std::function<void(QList<SystemServiceEntry> & elist, const SystemServiceEntry &entry)> addServiceEntryFromUnitFileInfo;
-    addServiceEntryFromUnitFileInfo = [&hash](QList<SystemServiceEntry> &elist, const SystemServiceEntry &entry) {
-        if (!hash.contains(entry.getId())) {
-            elist << entry;
-        }
-    };
-    // filter-out non service type unit-files
-    std::function<bool(const UnitFileInfo &)> fltUnitFiles;
-    fltUnitFiles = [&hash](const UnitFileInfo &unitFile) -> bool {
-        auto id = unitFile.getName().mid(unitFile.getName().lastIndexOf('/') + 1);
-        if (hash.contains(id)) {
-            return false;
-        } else {
-            return unitFile.getName().endsWith(UnitTypeServiceSuffix);
-        }
-    };
-    std::function<SystemServiceEntry(const UnitFileInfo &)> mapUnitFiles;
-    mapUnitFiles = [](const UnitFileInfo &unf) {
-        qCDebug(app) << "Mapping unit file:" << unf.getName();
-        SystemServiceEntry entry {};
-        ErrorContext ec1 {};
-
-        auto id = unf.getName().mid(unf.getName().lastIndexOf('/') + 1);
         auto sname = id;
-        sname.chop(strlen(UnitTypeServiceSuffix));
+        sname.chop(int(strlen(UnitTypeServiceSuffix)));
 
+        SystemServiceEntry entry {};
         entry.setSName(sname);
         entry.setState(unf.getStatus());
-        entry.setStartupType(ServiceManager::getServiceStartupType(
-                entry.getSName(),
-                entry.getState()));
         if (sname.endsWith('@')) {
             qCDebug(app) << "Unit file is a template:" << unf.getName();
+            entry.setStartupType(ServiceManager::getServiceStartupType(
+                    entry.getSName(),
+                    entry.getState()));
             // read description from unit file
-            auto desc = readUnitDescriptionFromUnitFile(unf.getName());
-            entry.setDescription(desc);
+            entry.setDescription(readUnitDescriptionFromUnitFile(unf.getName()));
+            m_templates << entry;
         } else {
-            auto o = Systemd1UnitInterface::normalizeUnitPath(id);
-            Systemd1UnitInterface unitIf(DBUS_SYSTEMD1_SERVICE,
-                                         o.path(),
-                                         QDBusConnection::systemBus());
-            Systemd1ServiceInterface svcIf(DBUS_SYSTEMD1_SERVICE,
-                                           o.path(),
-                                           QDBusConnection::systemBus());
-
-            // Id
-            auto id1 = unitIf.getId();
-            ec1 = id1.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get ID for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got ID for unit file" << unf.getName() << ":" << id1.second;
-                entry.setId(id1.second);
-            }
+            entry.setUnitObjectPath(Systemd1UnitInterface::normalizeUnitPath(id).path());
+            list << entry;
+        }
+    }
+    // loaded units report their unit file state through GetAll (instances & transient units have no file entry)
+    for (int i = 0; i < nunits; ++i)
+        list[i].setState(m_unitFileStates.value(list[i].getSName() + UnitTypeServiceSuffix));
+
+    fetchUnitProperties(list);
+
+    // entries are keyed by the object path of the resolved unit id, aliases of listed units collapse into them
+    m_entries.clear();
+    for (int i = 0; i < list.size(); ++i) {
+        SystemServiceEntry &entry = list[i];
+        if (!entry.getId().isEmpty())
+            entry.setUnitObjectPath(Systemd1UnitInterface::normalizeUnitPath(entry.getId()).path());
+        if (i >= nunits && ids.contains(entry.getId()))
+            continue;
+        if (!m_entries.contains(entry.getUnitObjectPath()))
+            m_entries.insert(entry.getUnitObjectPath(), entry);
+    }
 
-            auto desc = unitIf.getDescription();
-            ec1 = desc.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get description for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got description for unit file" << unf.getName();
-                entry.setDescription(desc.second);
-            }
+    QList<SystemServiceEntry> result = m_entries.values();
+    result << m_templates;
+    return result;
+}
 
-            auto actState = unitIf.getActiveState();
-            ec1 = actState.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get active state for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got active state for unit file" << unf.getName() << ":" << actState.second;
-                entry.setActiveState(actState.second);
-            }
+bool ServiceManagerWorker::subscribe()
+{
+    if (m_subscribed)
+        return true;
 
-            auto loadState = unitIf.getLoadState();
-            ec1 = loadState.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get load state for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got load state for unit file" << unf.getName() << ":" << loadState.second;
-                entry.setLoadState(loadState.second);
-            }
+    Systemd1ManagerInterface mgrIf(DBUS_SYSTEMD1_SERVICE,
+                                   kSystemDObjectPath.path(),
+                                   QDBusConnection::systemBus());
+    ErrorContext ec = mgrIf.Subscribe();
+    if (ec) {
+        qCWarning(app) << "Subscribe to systemd failed, falling back to full reload:" << ec.getErrorName() << ec.getErrorMessage();
+        return false;
+    }
 
-            auto subState = unitIf.getSubState();
-            ec1 = subState.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get sub state for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got sub state for unit file" << unf.getName() << ":" << subState.second;
-                entry.setSubState(subState.second);
+    QDBusConnection bus = QDBusConnection::systemBus();
+    const char *mgrIface = Systemd1ManagerInterface::staticInterfaceName();
+    bool ok = bus.connect(DBUS_SYSTEMD1_SERVICE, kSystemDObjectPath.path(), mgrIface, "UnitNew",
+                          this, SLOT(onUnitNew(QString, QDBusObjectPath)));
+    ok = ok && bus.connect(DBUS_SYSTEMD1_SERVICE, kSystemDObjectPath.path(), mgrIface, "UnitRemoved",
+                           this, SLOT(onUnitRemoved(QString, QDBusObjectPath)));
+    ok = ok && bus.connect(DBUS_SYSTEMD1_SERVICE, kSystemDObjectPath.path(), mgrIface, "UnitFilesChanged",
+                           this, SLOT(onUnitFilesChanged()));
+    // arg0 is the changed interface: systemd emits org.freedesktop.systemd1.Service changes for service units
+    // only, so the bus daemon drops the signals of scopes, slices, mounts... before they wake us up
+    ok = ok && bus.connect(DBUS_SYSTEMD1_SERVICE, QString(), DBusPropertiesInterface::staticInterfaceName(), "PropertiesChanged",
+                           QStringList {Systemd1ServiceInterface::staticInterfaceName()}, QString(),
+                           this, SLOT(onPropertiesChanged(QDBusMessage)));
+    if (!ok) {
+        qCWarning(app) << "Failed to connect systemd signals:" << bus.lastError().message();
+        return false;
+    }
+
+    qCInfo(app) << "Subscribed to systemd unit signals";
+    m_subscribed = true;
+    return true;
+}
+
+void ServiceManagerWorker::scheduleRefresh()
+{
+    // not restarted by later signals, a busy systemd must not delay updates forever
+    if (m_loaded && !m_refreshTimer->isActive())
+        m_refreshTimer->start();
+}
+
+void ServiceManagerWorker::onUnitNew(const QString &id, const QDBusObjectPath &path)
+{
+    // our own GetAll calls load units too, known ones need no refresh
+    if (!id.endsWith(UnitTypeServiceSuffix) || m_entries.contains(path.path()))
+        return;
+
+    qCDebug(app) << "Unit loaded:" << id;
+    m_changedPaths << path.path();
+    scheduleRefresh();
+}
+
+void ServiceManagerWorker::onUnitRemoved(const QString &id, const QDBusObjectPath &path)
+{
+    auto it = m_entries.find(path.path());
+    if (it == m_entries.end())
+        return;
+
+    qCDebug(app) << "Unit unloaded:" << id;
+    // querying the unit would load it again, the state of an unloaded unit is known anyway
+    m_changedPaths.remove(path.path());
+    if (m_unitFileStates.contains(id)) {
+        SystemServiceEntry entry(it->getId(), it->getSName(), it->getLoadState(), "inactive", "dead",
+                                 it->getState(), it->getStartupType(), it->getUnitObjectPath(),
+                                 it->getDescription(), 0, it->getCanReload(), it->getCanStart(), it->getCanStop());
+        *it = entry;
+        Q_EMIT entryUpdated(entry);
+    } else {
+        const QString sname = it->getSName();
+        m_entries.erase(it);
+        Q_EMIT entryRemoved(sname);
+    }
+}
+
+void ServiceManagerWorker::onPropertiesChanged(const QDBusMessage &msg)
+{
+    if (!msg.path().endsWith(kServiceObjectPathSuffix))
+        return;
+
+    m_changedPaths << msg.path();
+    scheduleRefresh();
+}
+
+void ServiceManagerWorker::onUnitFilesChanged()
+{
+    qCDebug(app) << "Unit files changed";
+    m_unitFilesChanged = true;
+    scheduleRefresh();
+}
+
+void ServiceManagerWorker::refreshChangedUnits()
+{
+    if (m_unitFilesChanged) {
+        m_unitFilesChanged = false;
+
+        Systemd1ManagerInterface mgrIf(DBUS_SYSTEMD1_SERVICE,
+                                       kSystemDObjectPath.path(),
+                                       QDBusConnection::systemBus());
+        auto unitFilesResult = mgrIf.ListUnitFiles();
+        ErrorContext ec = unitFilesResult.first;
+        if (ec) {
+            qCWarning(app) << "ListUnitFiles failed:" << ec.getErrorName() << ec.getErrorMessage();
+        } else {
+            QHash<QString, QString> states;
+            QList<SystemServiceEntry> templates;
+            for (const UnitFileInfo &unf : unitFilesResult.second) {
+                auto id = unf.getName().mid(unf.getName().lastIndexOf('/') + 1);
+                if (!id.endsWith(UnitTypeServiceSuffix))
+                    continue;
+
+                states[id] = unf.getStatus();
+                auto sname = id;
+                sname.chop(int(strlen(UnitTypeServiceSuffix)));
+                if (sname.endsWith('@')) {
+                    SystemServiceEntry entry {};
+                    entry.setSName(sname);
+                    entry.setState(unf.getStatus());
+                    entry.setStartupType(ServiceManager::getServiceStartupType(
+                            entry.getSName(),
+                            entry.getState()));
+                    entry.setDescription(readUnitDescriptionFromUnitFile(unf.getName()));
+                    templates << entry;
+                    if (m_unitFileStates.value(id) != unf.getStatus())
+                        Q_EMIT entryUpdated(entry);
+                } else if (!m_unitFileStates.contains(id) || m_unitFileStates.value(id) != unf.getStatus()) {
+                    m_changedPaths << Systemd1UnitInterface::normalizeUnitPath(id).path();
+                }
+            }
+            // unit files gone
+            for (auto it = m_unitFileStates.cbegin(); it != m_unitFileStates.cend(); ++it) {
+                if (states.contains(it.key()))
+                    continue;
+                auto sname = it.key();
+                sname.chop(int(strlen(UnitTypeServiceSuffix)));
+                if (sname.endsWith('@'))
+                    Q_EMIT entryRemoved(sname);
+                else
+                    m_changedPaths << Systemd1UnitInterface::normalizeUnitPath(it.key()).path();
             }
+            m_unitFileStates = states;
+            m_templates = templates;
+        }
+    }
 
-            auto mainPID = svcIf.getMainPID();
-            ec1 = mainPID.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get main PID for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got main PID for unit file" << unf.getName() << ":" << mainPID.second;
-                entry.setMainPID(mainPID.second);
+    if (m_changedPaths.isEmpty())
+        return;
+
+    const QSet<QString> paths = m_changedPaths;
+    m_changedPaths.clear();
+
+    QList<SystemServiceEntry> list;
+    list.reserve(paths.size());
+    for (const QString &path : paths) {
+        // fresh entries, emitted ones share their data with the model
+        SystemServiceEntry entry {};
+        auto it = m_entries.constFind(path);
+        if (it != m_entries.cend()) {
+            entry.setSName(it->getSName());
+            entry.setState(m_unitFileStates.value(it->getSName() + UnitTypeServiceSuffix));
+        }
+        entry.setUnitObjectPath(path);
+        list << entry;
+    }
+    qCDebug(app) << "Refreshing" << list.size() << "changed units";
+
+    fetchUnitProperties(list);
+
+    for (SystemServiceEntry &entry : list) {
+        const QString path = entry.getUnitObjectPath();
+        const bool known = m_entries.contains(path);
+        // unit vanished, or a stale reference to a unit without unit file
+        const bool gone = entry.getId().isEmpty()
+                || (entry.getLoadState() == "not-found" && entry.getActiveState() == "inactive"
+                    && !m_unitFileStates.contains(entry.getId()));
+        if (gone) {
+            if (known) {
+                Q_EMIT entryRemoved(m_entries.value(path).getSName());
+                m_entries.remove(path);
             }
+            continue;
         }
+        // signals are emitted for every alias path, keep one entry per unit
+        const QString key = Systemd1UnitInterface::normalizeUnitPath(entry.getId()).path();
+        if (key != path && !known)
+            continue;
 
-        return entry;
-    };
-    auto fltuffe = QtConcurrent::filter(unitFiles, fltUnitFiles);
-    fltuffe.waitForFinished();
-    qCDebug(app) << "Finished filtering unit files";
-    auto uffe = QtConcurrent::mappedReduced<QList<SystemServiceEntry>>(unitFiles, mapUnitFiles, addServiceEntryFromUnitFileInfo);
-
-    ufe.waitForFinished();
-    qCDebug(app) << "Finished mapping units";
-    uffe.waitForFinished();
-    qCDebug(app) << "Finished mapping unit files";
-
-    list << ufe.result();
-    list << uffe.result();
-    qCDebug(app) << "Emitting resultReady with" << list.size() << "services";
-    Q_EMIT resultReady(list);
+        m_entries.insert(path, entry);
+        Q_EMIT entryUpdated(entry);
+    }
 }
 
 QString ServiceManagerWorker::readUnitDescriptionFromUnitFile(const QString &path)
@@ -6,10 +6,20 @@
 #ifndef SERVICE_MANAGER_WORKER_H
 #define SERVICE_MANAGER_WORKER_H
 
+#include "service/system_service_entry.h"
+
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QSet>
+#include <QVariantMap>
+
+#define SERVICE_PIPELINE_DEPTH 32 // units whose properties are requested at the same time
+#define SERVICE_REFRESH_DELAY 200 // ms, systemd change signals within this delay are handled at once
 
-class SystemServiceEntry;
+class QTimer;
+class QDBusMessage;
+class QDBusObjectPath;
 
 class ServiceManagerWorker : public QObject
 {
@@ -17,14 +27,58 @@ class ServiceManagerWorker : public QObject
 public:
     explicit ServiceManagerWorker(QObject *parent = nullptr);
 
+    /**
+     * @brief Fill entry with the org.freedesktop.systemd1.Unit properties returned by GetAll
+     */
+    static void applyUnitProperties(SystemServiceEntry &entry, const QVariantMap &props);
+
 Q_SIGNALS:
     void resultReady(const QList<SystemServiceEntry> list);
+    // incremental changes after the first list, driven by systemd signals
+    void entryUpdated(const SystemServiceEntry &entry);
+    void entryRemoved(const QString &sname);
 
 public Q_SLOTS:
     void startJob();
 
+private Q_SLOTS:
+    void onUnitNew(const QString &id, const QDBusObjectPath &path);
+    void onUnitRemoved(const QString &id, const QDBusObjectPath &path);
+    void onPropertiesChanged(const QDBusMessage &msg);
+    void onUnitFilesChanged();
+    void refreshChangedUnits();
+
 private:
+    /**
+     * @brief Subscribe to systemd unit signals, once
+     */
+    bool subscribe();
+    /**
+     * @brief Fetch the properties of entries with an object path, requests are pipelined
+     */
+    void fetchUnitProperties(QList<SystemServiceEntry> &entries);
+    /**
+     * @brief Full enumeration: ListUnits + ListUnitFiles, then unit properties
+     */
+    QList<SystemServiceEntry> loadServiceList();
+    void scheduleRefresh();
+
     inline static QString readUnitDescriptionFromUnitFile(const QString &path);
+
+    // services of the last list, object path -> entry, entries are replaced, never modified once emitted
+    QHash<QString, SystemServiceEntry> m_entries;
+    // template services (no unit object)
+    QList<SystemServiceEntry> m_templates;
+    // unit file state of installed service unit files, id -> state
+    QHash<QString, QString> m_unitFileStates;
+
+    // object paths changed since the last refresh
+    QSet<QString> m_changedPaths;
+    bool m_unitFilesChanged {false};
+    QTimer *m_refreshTimer {};
+
+    bool m_subscribed {false};
+    bool m_loaded {false};
 };
 
 #endif // SERVICE_MANAGER_WORKER_H
@@ -8,9 +8,9 @@
 #include <QDateTime>
 #include <QFile>
 #include <QSharedData>
-#include <QTextStream>
 #include "system/sys_info.h"
 #include "common/common.h"
+#include "common/source_root.h"
 namespace core {
 namespace system {
 
@@ -41,83 +41,77 @@ void BlockDevice::setDeviceName(const QByteArray &deviceName)
 {
     qCDebug(app) << "Setting device name to" << deviceName;
     d->name = deviceName;
-    readDeviceInfo();
 }
 
 void BlockDevice::readDeviceInfo()
 {
     qCDebug(app) << "Reading device info for" << d->name;
-    QFile file(PROC_PATH_DISK);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qCWarning(app) << "Failed to open" << PROC_PATH_DISK;
+    DiskStatsReader reader;
+    if (!reader.update())
         return;
+
+    readDeviceAttributes();
+    updateStats(reader, SysInfo::instance()->uptime());
+}
+
+bool BlockDevice::updateStats(const DiskStatsReader &reader, const timeval &uptime)
+{
+    const DiskStats *stats = reader.find(d->name.constData(), d->statsRow);
+    if (!stats)
+        return false;
+
+    const DiskStats &prev = d->stats;
+    auto delta = [&](DiskStats::Field field) -> qreal {
+        return (*stats)[field] > prev[field] ? qreal((*stats)[field] - prev[field]) : .0;
+    };
+
+    // rates need two samples
+    if (prev.isValid()) {
+        qreal interval = (uptime.tv_sec - d->uptime.tv_sec) + (uptime.tv_usec - d->uptime.tv_usec) / 1000000.;
+        if (interval <= 0)
+            interval = 1;
+
+        calcDiskIoStates(*stats, interval);
+        d->r_ps = delta(DiskStats::kReadsCompleted) / interval;
+        d->rsec_ps = delta(DiskStats::kSectorsRead) / interval;
+        d->rrqm_ps = delta(DiskStats::kReadsMerged) / interval;
+        d->w_ps = delta(DiskStats::kWritesCompleted) / interval;
+        d->wsec_ps = delta(DiskStats::kSectorsWritten) / interval;
+        d->wrqm_ps = delta(DiskStats::kWritesMerged) / interval;
+        // io_ticks: ms the device had requests in flight
+        d->p_util = qMin(delta(DiskStats::kIoTicks) / (interval * 1000.), 1.);
     }
-    QList<QStringList> strList;
-    QTextStream in(&file);
-
-    QString line;
-    do{
-        line = in.readLine();
-        if (!line.contains("loop")){
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            strList << line.split(" ", QString::SkipEmptyParts);
-#else
-            strList << line.split(" ", Qt::SkipEmptyParts);
-#endif
-        }
-    }while (!line.isNull());
-    file.close();
-    qCDebug(app) << "Read" << strList.size() << "lines from" << PROC_PATH_DISK;
-
-    for (int i = 0; i < strList.size(); ++i) {
-        QStringList deviceInfo = strList[i];
-        if (deviceInfo.size() > 16 && deviceInfo[2] == d->name) {
-            qCDebug(app) << "Found device" << d->name << "in disk stats";
-            m_time_sec = QDateTime::currentSecsSinceEpoch();
-            timevalList[0] = timevalList[1];
-            timevalList[1] = SysInfo::instance()->uptime();
-
-            qint64 interval = m_time_sec - d->_time_Sec > 0 ? m_time_sec - d->_time_Sec : 1;
-            calcDiskIoStates(deviceInfo);
-            readDeviceModel();
-            d->capacity = readDeviceSize(deviceInfo[2]);
-            if (d->read_iss != 0)
-                d->r_ps = (deviceInfo[3].toULongLong() - d->read_iss) / static_cast<quint64>(interval);
-            if (d->blk_read != 0)
-                d->rsec_ps = (deviceInfo[5].toULongLong() - d->blk_read) / static_cast<quint64>(interval);
-            if (d->blk_wrtn != 0)
-                d->wsec_ps = (deviceInfo[9].toULongLong() - d->blk_wrtn) / static_cast<quint64>(interval);
-            if (d->read_merged != 0)
-                d->rrqm_ps = (deviceInfo[4].toULongLong() - d->read_merged) / static_cast<quint64>(interval);
-            if (d->write_com != 0)
-                d->w_ps = (deviceInfo[7].toULongLong() - d->write_com) / static_cast<quint64>(interval);
-            if (d->write_merged != 0)
-                d->wrqm_ps = (deviceInfo[8].toULongLong() - d->write_merged) / static_cast<quint64>(interval);
-            d->blk_read = deviceInfo[5].toULongLong();
-            d->bytes_read = deviceInfo[5].toULongLong() * SECTOR_SIZE;
-            if (deviceInfo[3].toULongLong() != 0)
-                d->p_rrqm =  deviceInfo[4].toDouble() / deviceInfo[3].toDouble() * 100;
-            d->tps = deviceInfo[3].toULongLong() + deviceInfo[7].toULongLong();
-            d->blk_wrtn = deviceInfo[9].toULongLong();
-            d->bytes_wrtn = deviceInfo[9].toULongLong() * SECTOR_SIZE;
-            if (deviceInfo[7].toULongLong() != 0)
-                d->p_wrqm = deviceInfo[8].toULongLong() / deviceInfo[7].toULongLong() * 100;
-            d->read_iss = deviceInfo[3].toULongLong();
-            d->write_com = deviceInfo[7].toULongLong();
-            d->read_merged = deviceInfo[4].toULongLong();
-            d->write_merged = deviceInfo[8].toULongLong();
-            d->discard_sector = deviceInfo[16].toULongLong();
-            d->_time_Sec = QDateTime::currentSecsSinceEpoch();
-            qCDebug(app) << "Finished processing device info for" << d->name;
-            break;
-        }
-    }
 
+    d->read_iss = (*stats)[DiskStats::kReadsCompleted];
+    d->read_merged = (*stats)[DiskStats::kReadsMerged];
+    d->blk_read = (*stats)[DiskStats::kSectorsRead];
+    d->bytes_read = d->blk_read * SECTOR_SIZE;
+    d->write_com = (*stats)[DiskStats::kWritesCompleted];
+    d->write_merged = (*stats)[DiskStats::kWritesMerged];
+    d->blk_wrtn = (*stats)[DiskStats::kSectorsWritten];
+    d->bytes_wrtn = d->blk_wrtn * SECTOR_SIZE;
+    d->discard_sector = (*stats)[DiskStats::kSectorsDiscarded];
+    d->tps = d->read_iss + d->write_com;
+    if (d->read_iss != 0)
+        d->p_rrqm = qreal(d->read_merged) / d->read_iss * 100;
+    if (d->write_com != 0)
+        d->p_wrqm = qreal(d->write_merged) / d->write_com * 100;
+
+    d->stats = *stats;
+    d->uptime = uptime;
+    d->_time_Sec = QDateTime::currentSecsSinceEpoch();
+    return true;
+}
+
+void BlockDevice::readDeviceAttributes()
+{
+    readDeviceModel();
+    d->capacity = readDeviceSize(d->name);
 }
 
 void BlockDevice::readDeviceModel()
 {
-    QString Path = QString(SYSFS_PATH_MODEL).arg(d->name.data());
+    QString Path = QString(common::source::path(SYSFS_PATH_MODEL)).arg(d->name.data());
     qCDebug(app) << "Reading device model from" << Path;
     QFile file(Path);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -132,7 +126,7 @@ void BlockDevice::readDeviceModel()
 
 quint64 BlockDevice::readDeviceSize(const QString &deviceName)
 {
-    QString path = QString(SYSFS_PATH_SIZE).arg(deviceName);
+    QString path = QString(common::source::path(SYSFS_PATH_SIZE)).arg(deviceName);
     qCDebug(app) << "Reading device size from" << path;
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -145,31 +139,28 @@ quint64 BlockDevice::readDeviceSize(const QString &deviceName)
     return size;
 }
 
-void BlockDevice::calcDiskIoStates(const QStringList &diskInfo)
+void BlockDevice::calcDiskIoStates(const DiskStats &stats, qreal interval)
 {
     qCDebug(app) << "Calculating disk IO states for" << d->name;
-    quint64 curr_read_sector =  diskInfo[5].toULongLong();
-    quint64 curr_write_sector = diskInfo[9].toULongLong();
-    quint64 curr_discard_sector = diskInfo[16].toULongLong();
-    timeval cur_time = timevalList[1];
-    timeval prev_time = timevalList[0];
+    const DiskStats &prev = d->stats;
+    auto delta = [&](DiskStats::Field field) -> quint64 {
+        return stats[field] > prev[field] ? stats[field] - prev[field] : 0;
+    };
 
     // read increment between interval
-    auto rdiff = (curr_read_sector > d->blk_read) ? (curr_read_sector - d->blk_read) : 0;
+    auto rdiff = delta(DiskStats::kSectorsRead);
     // write increment between interval
-    auto wdiff = (curr_write_sector > d->blk_wrtn) ? (curr_write_sector - d->blk_wrtn) : 0;
+    auto wdiff = delta(DiskStats::kSectorsWritten);
     // discarded increment between interval
-    auto ddiff = (curr_discard_sector > d->discard_sector) ? (curr_discard_sector - d->discard_sector) : 0;
+    auto ddiff = delta(DiskStats::kSectorsDiscarded);
     // calculate actual size
     auto rsize = rdiff * SECTOR_SIZE;
     auto wsize = (wdiff + ddiff) * SECTOR_SIZE;
-    //  auto interval = (m_time_sec > d->_time_Sec) ? (m_time_sec - d->_time_Sec) : 1;
-    auto ltime = prev_time.tv_sec + prev_time.tv_usec * 1. / 1000000;
-    auto rtime = cur_time.tv_sec + cur_time.tv_usec * 1. / 1000000;
-    auto interval = (rtime > ltime) ? (rtime - ltime) : 1;
+    if (interval <= 0)
+        interval = 1;
 
-    d->read_speed = rsize / static_cast<quint64>(interval);
-    d->wirte_speed = wsize / static_cast<quint64>(interval);
+    d->read_speed = static_cast<quint64>(rsize / interval);
+    d->wirte_speed = static_cast<quint64>(wsize / interval);
     qCDebug(app) << d->name << "read speed:" << d->read_speed << "B/s, write speed:" << d->wirte_speed << "B/s";
 }
 
@@ -7,6 +7,7 @@
 #define BLOCK_DEVICE_H
 
 #include "private/block_device_p.h"
+#include "disk_stats.h"
 
 #include <QSharedDataPointer>
 #define MAX_NAME_LEN 128
@@ -51,18 +52,39 @@ public:
     quint64  readSpeed() const; // 获取读速度
     quint64  writeSpeed() const; // 获取写速度
 
+    /**
+     * @brief All diskstats counters of the last update, fields not reported by the kernel are 0
+     */
+    const DiskStats &diskStats() const;
+    quint64 inFlight() const; // 正在处理的请求数
+    quint64 ioTicks() const; // 处理I/O的时间(ms)
+    quint64 weightedIoTicks() const; // 加权的I/O时间(ms)
+    quint64 discardsCompleted() const; // discard 完成次数
+    quint64 sectorsDiscarded() const; // discard 扇区数
+    quint64 flushesCompleted() const; // flush 完成次数
+
     void setDeviceName(const QByteArray &deviceName);
 
 public:
+    /**
+     * @brief Read counters of this device only, BlockDeviceInfoDB updates all devices from one diskstats pass
+     */
     void readDeviceInfo();
+    /**
+     * @brief Update counters & rates from the diskstats row of this device
+     * @return false if the device is not listed in reader
+     */
+    bool updateStats(const DiskStatsReader &reader, const timeval &uptime);
+    /**
+     * @brief Read model & capacity from sysfs, they only change with udev events
+     */
+    void readDeviceAttributes();
     void readDeviceModel();
     quint64 readDeviceSize(const QString &deviceName);
-    void calcDiskIoStates(const QStringList &diskInfo);
+    void calcDiskIoStates(const DiskStats &stats, qreal interval);
 
 private:
     QSharedDataPointer<BlockDevicePrivate> d;
-    qint64 m_time_sec{0};
-    timeval timevalList[2] = {timeval{0, 0}, timeval{0, 0}};
 };
 
 inline QByteArray BlockDevice::deviceName() const
@@ -176,6 +198,35 @@ inline quint64  BlockDevice::writeSpeed() const
     return d->wirte_speed;
 }
 
+inline const DiskStats &BlockDevice::diskStats() const
+{
+    return d->stats;
+}
+inline quint64 BlockDevice::inFlight() const
+{
+    return d->stats[DiskStats::kInFlight];
+}
+inline quint64 BlockDevice::ioTicks() const
+{
+    return d->stats[DiskStats::kIoTicks];
+}
+inline quint64 BlockDevice::weightedIoTicks() const
+{
+    return d->stats[DiskStats::kWeightedIoTicks];
+}
+inline quint64 BlockDevice::discardsCompleted() const
+{
+    return d->stats[DiskStats::kDiscardsCompleted];
+}
+inline quint64 BlockDevice::sectorsDiscarded() const
+{
+    return d->stats[DiskStats::kSectorsDiscarded];
+}
+inline quint64 BlockDevice::flushesCompleted() const
+{
+    return d->stats[DiskStats::kFlushesCompleted];
+}
+
 
 
 } // namespace system
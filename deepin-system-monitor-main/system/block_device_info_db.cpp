@@ -12,7 +12,10 @@
 #include <QFile>
 #include "diskio_info.h"
 #include "common/common.h"
+#include "common/perf_stats.h"
+#include "common/source_root.h"
 #include "system/sys_info.h"
+#include "udev.h"
 #include <QDir>
 #include <ctype.h>
 #include <errno.h>
@@ -21,6 +24,7 @@
 #include <libudev.h>
 
 using namespace DDLog;
+using namespace common::perf;
 
 #define SYSFS_PATH_VIRTUAL_BLOCK "/sys/devices/virtual/block"
 
@@ -94,8 +98,13 @@ get_child(struct udev *udev, struct udev_device *parent, const char *subsystem)
 
 BlockDeviceInfoDB::BlockDeviceInfoDB()
     : m_deviceList {}
+    , m_diskStats {}
+    , m_udev(new UDev())
+    , m_blockMonitor {}
+    , m_devicesLoaded {false}
 {
     qCDebug(app) << "BlockDeviceInfoDB constructor";
+    m_blockMonitor.reset(new UDevMonitor(m_udev.get(), "block"));
 }
 
 BlockDeviceInfoDB::~BlockDeviceInfoDB()
@@ -106,7 +115,7 @@ BlockDeviceInfoDB::~BlockDeviceInfoDB()
 void BlockDeviceInfoDB::readDiskInfo()
 {
     qCDebug(app) << "Starting to read disk info";
-    QDir dir(SYSFS_PATH_BLOCK);
+    QDir dir(common::source::path(SYSFS_PATH_BLOCK));
     if (!dir.exists()) {
         qCWarning(app) << "Block device directory does not exist:" << SYSFS_PATH_BLOCK;
         return;
@@ -134,11 +143,12 @@ void BlockDeviceInfoDB::readDiskInfo()
                 BlockDevice bd;
                 if (bd.readDeviceSize(list[i].fileName()) > 0) {
                     bd.setDeviceName(list[i].fileName().toLocal8Bit());
+                    bd.readDeviceAttributes();
                     m_deviceList << bd;
                 }
             } else {
                 qCDebug(app) << "Updating existing physical disk:" << list[i].fileName();
-                m_deviceList[index].setDeviceName(list[i].fileName().toLocal8Bit());   // 更新disk数据
+                m_deviceList[index].readDeviceAttributes();   // 更新disk型号及容量
             }
         }
     }
@@ -164,16 +174,17 @@ void BlockDeviceInfoDB::readDiskInfo()
                 BlockDevice bd;
                 if (bd.readDeviceSize(list[i].fileName()) > 0) {
                     bd.setDeviceName(list[i].fileName().toLocal8Bit());
+                    bd.readDeviceAttributes();
                     m_deviceList << bd;
                 }
             } else {
                 qCDebug(app) << "Updating existing virtual disk:" << list[i].fileName();
-                m_deviceList[index].setDeviceName(list[i].fileName().toLocal8Bit());   // 更新disk数据
+                m_deviceList[index].readDeviceAttributes();   // 更新disk型号及容量
             }
         }
     }
 
-    for (int i = 0; i < m_deviceList.size(); ++i) {
+    for (int i = m_deviceList.size() - 1; i >= 0; --i) {
         bool isFind = false;
         for (int si = 0; si < list.size(); ++si) {
             if (list[si].fileName().toLocal8Bit() == m_deviceList[i].deviceName()) {
@@ -189,6 +200,18 @@ void BlockDeviceInfoDB::readDiskInfo()
     qCDebug(app) << "Finished reading disk info";
 }
 
+void BlockDeviceInfoDB::readDiskStats()
+{
+    if (!m_diskStats.update())
+        return;
+
+    const timeval uptime = SysInfo::instance()->uptime();
+    for (int i = 0; i < m_deviceList.size(); ++i) {
+        if (!m_deviceList[i].updateStats(m_diskStats, uptime))
+            qCDebug(app) << "Device" << m_deviceList[i].deviceName() << "not found in" << PROC_PATH_DISK;
+    }
+}
+
 //static void enum_block()
 //{
 //    struct udev *udev;
@@ -276,8 +299,16 @@ void BlockDeviceInfoDB::readDiskInfo()
 
 void BlockDeviceInfoDB::update()
 {
+    PerfScope perfScope(kStageBlockDevices);
     qCDebug(app) << "Updating BlockDeviceInfoDB";
-    readDiskInfo();
+    QWriteLocker lock(&m_rwlock);
+
+    // 设备列表、型号及容量只在 udev 上报块设备变化时重新读取, 没有 udev 时每次都读取
+    if (!m_devicesLoaded || !m_blockMonitor->isValid() || m_blockMonitor->pendingEvents() > 0) {
+        readDiskInfo();
+        m_devicesLoaded = true;
+    }
+    readDiskStats();
 
     // TODO: enum device in /sys/block => phy & virtual
 
@@ -7,15 +7,20 @@
 #define BLOCK_DEVICE_INFO_DB_H
 
 #include "block_device.h"
+#include "disk_stats.h"
 
 #include <QReadWriteLock>
 #include <QList>
 
+#include <memory>
+
 namespace core {
 namespace system {
 
 
 class DeviceDB;
+class UDev;
+class UDevMonitor;
 
 /**
  * @brief The BlockDeviceInfoDB class
@@ -31,11 +36,24 @@ public:
     void update();
 
 private:
+    /**
+     * @brief Enumerate block devices & read their model and capacity
+     */
     void readDiskInfo();
+    /**
+     * @brief Update counters of all devices from one /proc/diskstats pass
+     */
+    void readDiskStats();
 
 private:
     mutable QReadWriteLock m_rwlock;
     QList<BlockDevice> m_deviceList;
+
+    DiskStatsReader m_diskStats;
+    // block subsystem events, device list & attributes are only re-read after one
+    std::unique_ptr<UDev> m_udev;
+    std::unique_ptr<UDevMonitor> m_blockMonitor;
+    bool m_devicesLoaded;
 };
 
 inline QList<BlockDevice> BlockDeviceInfoDB::deviceList()
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "collector.h"
+#include "ddlog.h"
+
+#include <string.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+Collector::Collector(const char *name, int interval)
+    : m_name(name)
+    , m_interval(interval)
+{
+}
+
+Collector::~Collector()
+{
+}
+
+FunctionCollector::FunctionCollector(const char *name, int interval, std::function<void()> collect)
+    : Collector(name, interval)
+    , m_collect(std::move(collect))
+{
+}
+
+void FunctionCollector::collect()
+{
+    m_collect();
+}
+
+CollectorSet::CollectorSet(int tickInterval)
+    : m_tickInterval(qMax(1, tickInterval))
+{
+}
+
+CollectorSet::~CollectorSet()
+{
+    for (const entry_t &entry : m_entries)
+        delete entry.collector;
+}
+
+void CollectorSet::add(Collector *collector)
+{
+    int ticks = qMax(1, (collector->interval() + m_tickInterval - 1) / m_tickInterval);
+    qCDebug(app) << "Collector" << collector->name() << "runs every" << ticks * m_tickInterval << "ms";
+    m_entries << entry_t {collector, ticks, 1};
+}
+
+void CollectorSet::add(const char *name, int interval, std::function<void()> collect)
+{
+    add(new FunctionCollector(name, interval, std::move(collect)));
+}
+
+Collector *CollectorSet::collector(const char *name) const
+{
+    for (const entry_t &entry : m_entries) {
+        if (!strcmp(entry.collector->name(), name))
+            return entry.collector;
+    }
+    return nullptr;
+}
+
+int CollectorSet::tick()
+{
+    int n = 0;
+    for (entry_t &entry : m_entries) {
+        if (--entry.countdown > 0)
+            continue;
+        entry.countdown = entry.ticks;
+        entry.collector->collect();
+        n++;
+    }
+    return n;
+}
+
+void CollectorSet::collectAll()
+{
+    for (entry_t &entry : m_entries) {
+        entry.countdown = entry.ticks;
+        entry.collector->collect();
+    }
+}
+
+} // namespace system
+} // namespace core
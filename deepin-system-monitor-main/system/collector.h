@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COLLECTOR_H
+#define COLLECTOR_H
+
+#include <QVector>
+
+#include <functional>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Data source refreshed by SystemMonitor, at the cadence it declares
+ *
+ * Sources are read through common::source, so a collector follows the configured procfs & sysfs roots
+ * and the installed reader without changes of its own.
+ */
+class Collector
+{
+public:
+    /**
+     * @param name static string, used in logs & to look the collector up
+     * @param interval refresh interval in ms
+     */
+    Collector(const char *name, int interval);
+    virtual ~Collector();
+
+    Collector(const Collector &) = delete;
+    Collector &operator=(const Collector &) = delete;
+
+    inline const char *name() const
+    {
+        return m_name;
+    }
+    inline int interval() const
+    {
+        return m_interval;
+    }
+
+    virtual void collect() = 0;
+
+private:
+    const char *m_name;
+    int m_interval;
+};
+
+/**
+ * @brief Collector running a callable
+ */
+class FunctionCollector : public Collector
+{
+public:
+    FunctionCollector(const char *name, int interval, std::function<void()> collect);
+
+    void collect() override;
+
+private:
+    std::function<void()> m_collect;
+};
+
+/**
+ * @brief Collectors run in registration order, each one every interval() / tickInterval ticks
+ *
+ * Intervals are rounded up to a multiple of the tick interval.
+ */
+class CollectorSet
+{
+public:
+    explicit CollectorSet(int tickInterval);
+    ~CollectorSet();
+
+    CollectorSet(const CollectorSet &) = delete;
+    CollectorSet &operator=(const CollectorSet &) = delete;
+
+    /**
+     * @brief Add collector, owned by the set. It is first run on the next tick.
+     */
+    void add(Collector *collector);
+    void add(const char *name, int interval, std::function<void()> collect);
+
+    /**
+     * @return nullptr if no collector has name
+     */
+    Collector *collector(const char *name) const;
+
+    inline int tickInterval() const
+    {
+        return m_tickInterval;
+    }
+
+    /**
+     * @brief Run the collectors due on this tick
+     * @return number of collectors run
+     */
+    int tick();
+
+    /**
+     * @brief Run all collectors now, their cadence restarts from this tick
+     */
+    void collectAll();
+
+private:
+    struct entry_t {
+        Collector *collector;
+        int ticks; // ticks between two runs
+        int countdown; // ticks left before the next run
+    };
+
+    int m_tickInterval;
+    QVector<entry_t> m_entries;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // COLLECTOR_H
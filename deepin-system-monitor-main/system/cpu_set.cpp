@@ -7,10 +7,14 @@
 #include "private/cpu_set_p.h"
 
 #include "common/common.h"
+#include "common/perf_stats.h"
+#include "common/source_reader.h"
+#include "common/source_root.h"
 #include "common/thread_manager.h"
 #include "system_monitor_thread.h"
 #include "system_monitor.h"
 #include "sys_info.h"
+#include "udev.h"
 extern "C" {
 #include "../3rdparty/lscpu.h"
 #include "../3rdparty/include/path.h"
@@ -18,6 +22,7 @@ extern "C" {
 }
 
 #include <QMap>
+#include <QSet>
 #include <QByteArray>
 #include <QFile>
 #include <QTextStream>
@@ -28,14 +33,21 @@ DCORE_USE_NAMESPACE
 
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <sched.h>
+#include <unistd.h>
 
 #define PROC_PATH_STAT "/proc/stat"
 #define PROC_PATH_CPUINFO "/proc/cpuinfo"
+#define SYSFS_PATH_CPU_ONLINE "/sys/devices/system/cpu/online"
+#define SYSFS_PATH_CPU_CUR_FREQ "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq"
+#define SYSFS_PATH_CPU_CACHE_INDEX "/sys/devices/system/cpu/cpu%d/cache/index%d"
 
 using namespace common::error;
 using namespace common::alloc;
 using namespace common::init;
+using namespace common::perf;
 using namespace DDLog;
 
 static bool read_dmi_cache = false;
@@ -45,6 +57,124 @@ using namespace DDLog;
 namespace core {
 namespace system {
 
+/**
+ * @brief Current frequency of the online cpus, read from cpufreq scaling_cur_freq
+ *
+ * The sysfs files are opened once per topology load and re-read with pread on each update.
+ */
+class CPUFreqReader
+{
+public:
+    explicit CPUFreqReader(const QList<int> &cpus)
+    {
+        char path[PATH_MAX];
+        for (int cpu : cpus) {
+            common::source::formatPath(path, sizeof(path), SYSFS_PATH_CPU_CUR_FREQ, cpu);
+            int fd = common::source::reader()->open(path);
+            if (fd >= 0)
+                m_fds << fd;
+        }
+        qCDebug(app) << "Opened scaling_cur_freq of" << m_fds.size() << "cpus";
+    }
+    ~CPUFreqReader()
+    {
+        for (int fd : m_fds)
+            common::source::reader()->close(fd);
+    }
+
+    CPUFreqReader(const CPUFreqReader &) = delete;
+    CPUFreqReader &operator=(const CPUFreqReader &) = delete;
+
+    /**
+     * @brief Max & average current frequency in MHz of the cpus reporting one
+     * @return false if no cpu reported its frequency
+     */
+    bool read(float &maxMHz, float &avgMHz) const
+    {
+        char buf[32];
+        float sum = 0.0f;
+        int n = 0;
+
+        maxMHz = 0.0f;
+        for (int fd : m_fds) {
+            ssize_t len = common::source::reader()->pread(fd, buf, sizeof(buf) - 1, 0);
+            if (len <= 0)
+                continue;
+            buf[len] = '\0';
+
+            // kHz
+            float mhz = strtoul(buf, nullptr, 10) / 1000.0f;
+            if (mhz <= 0.0f)
+                continue;
+            maxMHz = qMax(maxMHz, mhz);
+            sum += mhz;
+            n++;
+        }
+        avgMHz = n > 0 ? sum / n : 0.0f;
+        return n > 0;
+    }
+
+private:
+    QVector<int> m_fds;
+};
+
+static QByteArray read_sysfs_value(const QByteArray &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll().trimmed();
+}
+
+// parse cpu list format, e.g. 0-3,5,7-8
+static QList<int> parse_cpu_list(const QByteArray &list)
+{
+    QList<int> cpus;
+    for (const QByteArray &range : list.split(',')) {
+        int sep = range.indexOf('-');
+        bool ok1 = false, ok2 = false;
+        int first = range.left(sep < 0 ? range.size() : sep).trimmed().toInt(&ok1);
+        int last = sep < 0 ? first : range.mid(sep + 1).trimmed().toInt(&ok2);
+        if (!ok1 || (sep >= 0 && !ok2))
+            continue;
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus << cpu;
+    }
+    return cpus;
+}
+
+static QList<int> read_online_cpus()
+{
+    return parse_cpu_list(read_sysfs_value(common::source::path(SYSFS_PATH_CPU_ONLINE)));
+}
+
+// cache size in sysfs format, e.g. 32K, 8M
+static qulonglong parse_cache_size(const QByteArray &size)
+{
+    if (size.isEmpty())
+        return 0;
+
+    qulonglong mult = 1;
+    QByteArray num = size;
+    switch (size.at(size.size() - 1)) {
+    case 'K':
+        mult = 1024;
+        num.chop(1);
+        break;
+    case 'M':
+        mult = 1024 * 1024;
+        num.chop(1);
+        break;
+    case 'G':
+        mult = 1024 * 1024 * 1024;
+        num.chop(1);
+        break;
+    default:
+        break;
+    }
+    return num.toULongLong() * mult;
+}
+
 /**
    @brief 获取首个有效CPU的当前频率，参考 util-linux 中 lscpu 读取 /proc/cpuinfo 的首个 cpu 的 mhz 信息。
    @note 1. 参考 lsblk_cputype_get_scalmhz 函数，过滤无效cpu
@@ -574,7 +704,10 @@ void CPUSet::update()
 {
     qCDebug(app) << "Updating CPUSet...";
     read_stats();
-    read_overall_info();
+    // 静态拓扑信息只在首次及CPU热插拔后重新加载, 每次刷新只读取当前频率
+    if (!d->m_topologyLoaded || topology_changed())
+        read_overall_info();
+    read_cur_freq();
 
     d->cpusageTotal[kLastStat] = d->cpusageTotal[kCurrentStat];
     d->cpusageTotal[kCurrentStat] = d->m_usage->total;
@@ -583,6 +716,7 @@ void CPUSet::update()
 
 void CPUSet::read_stats()
 {
+    PerfScope perfScope(kStageCpuStats);
     qCDebug(app) << "Reading CPU stats from" << PROC_PATH_STAT;
     FILE *fp;
     uFile fPtr;
@@ -590,7 +724,7 @@ void CPUSet::read_stats()
     int ncpu = 0;
     int nr;
 
-    if (!(fp = fopen(PROC_PATH_STAT, "r"))) {
+    if (!(fp = fopen(common::source::path(PROC_PATH_STAT).constData(), "r"))) {
         qCWarning(app) << "Failed to open" << PROC_PATH_STAT << ":" << strerror(errno);
         return;
     }
@@ -704,15 +838,52 @@ void CPUSet::read_stats()
     qCDebug(app) << "Finished reading CPU stats.";
 }
 
+bool CPUSet::topology_changed()
+{
+    if (!d->m_hotplugMonitor)
+        return false;
+
+    int events = d->m_hotplugMonitor->pendingEvents();
+    if (events > 0) {
+        qCInfo(app) << "CPU hotplug detected," << events << "udev events, reloading CPU topology";
+        return true;
+    }
+    return false;
+}
+
+void CPUSet::read_cur_freq()
+{
+    // 不支持调频时保留加载拓扑时读取的频率
+    if (!d->m_dynamicFreq || !d->m_freqReader)
+        return;
+
+    float maxMHz = 0.0f;
+    float avgMHz = 0.0f;
+    if (d->m_freqReader->read(maxMHz, avgMHz)) {
+        d->m_info.insert("CPU MHz", QString::number(static_cast<double>(maxMHz), 'f', 4));
+        d->m_info.insert("CPU avg MHz", QString::number(static_cast<double>(avgMHz), 'f', 4));
+    }
+}
+
 void CPUSet::read_overall_info()
 {
-    qCDebug(app) << "Reading overall CPU info from /proc/cpuinfo...";
+    qCDebug(app) << "Loading CPU topology from /proc/cpuinfo & sysfs...";
+    // listen before reading, so that hotplug during the load is not missed
+    if (!d->m_hotplugMonitor) {
+        d->m_udev = std::make_shared<UDev>();
+        d->m_hotplugMonitor = std::make_shared<UDevMonitor>(d->m_udev.get(), "cpu");
+    }
+
     //proc/cpuinfo
     QList<CPUInfo> infos;
-    QProcess process;
-    process.start("cat /proc/cpuinfo");
-    process.waitForFinished(3000);
-    QString cpuinfo = process.readAllStandardOutput();
+    QString cpuinfo;
+    QFile cpuinfoFile(common::source::path(PROC_PATH_CPUINFO));
+    if (cpuinfoFile.open(QIODevice::ReadOnly)) {
+        cpuinfo = QString::fromUtf8(cpuinfoFile.readAll());
+        cpuinfoFile.close();
+    } else {
+        qCWarning(app) << "Failed to open" << PROC_PATH_CPUINFO << ":" << cpuinfoFile.errorString();
+    }
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     QStringList processors = cpuinfo.split("\n\n", QString::SkipEmptyParts);
 #else
@@ -776,7 +947,10 @@ void CPUSet::read_overall_info()
     //    }
     read_lscpu();
     d->m_infos = infos;
-    qCDebug(app) << "Finished reading overall CPU info.";
+
+    d->m_freqReader = std::make_shared<CPUFreqReader>(read_online_cpus());
+    d->m_topologyLoaded = true;
+    qCDebug(app) << "Finished loading CPU topology.";
 }
 
 void CPUSet::read_dmi_cache_info()
@@ -907,29 +1081,57 @@ void CPUSet::read_dmi_cache_info()
     }
 }
 
-void CPUSet::read_cache_from_lscpu_cmd()
+void CPUSet::read_cache_from_sysfs()
 {
     if (read_dmi_cache)
         return;   // 不要覆盖 dmidecode 获取的缓存信息
 
-    QProcess process;
-    QString command = "lscpu | grep cache";
-    process.start("bash", QStringList() << "-c" << command);
-    process.waitForFinished(3000);
-    QString cache = process.readAllStandardOutput();
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    QStringList cacheList = cache.split("\n", QString::SkipEmptyParts);
-#else
-    QStringList cacheList = cache.split("\n", Qt::SkipEmptyParts);
-#endif
-    for (const QString &cacheLine : qAsConst(cacheList)) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QStringList keyValue = cacheLine.split(":", QString::SkipEmptyParts);
-#else
-        QStringList keyValue = cacheLine.split(":", Qt::SkipEmptyParts);
-#endif
-        if (keyValue.count() > 1)
-            d->m_info[keyValue.value(0).trimmed()] = keyValue.value(1).trimmed();
+    struct CacheSummary {
+        qulonglong size = 0;
+        int instances = 0;
+    };
+    QMap<QString, CacheSummary> caches;   // L1d/L1i/L2/L3 => total size & instances
+    QSet<QByteArray> counted;   // level/type/shared cpus of the counted cache instances
+    char path[PATH_MAX];
+
+    for (int cpu : read_online_cpus()) {
+        for (int index = 0;; ++index) {
+            common::source::formatPath(path, sizeof(path), SYSFS_PATH_CPU_CACHE_INDEX, cpu, index);
+            const QByteArray dir(path);
+            const QByteArray level = read_sysfs_value(dir + "/level");
+            if (level.isEmpty())
+                break;
+
+            const QByteArray type = read_sysfs_value(dir + "/type");
+            const QByteArray key = level + '/' + type + '/' + read_sysfs_value(dir + "/shared_cpu_list");
+            if (counted.contains(key))
+                continue;
+            counted.insert(key);
+
+            QString name = QString("L%1").arg(QString::fromLatin1(level));
+            if (type == "Data")
+                name += "d";
+            else if (type == "Instruction")
+                name += "i";
+
+            CacheSummary &summary = caches[name];
+            summary.size += parse_cache_size(read_sysfs_value(dir + "/size"));
+            summary.instances++;
+        }
+    }
+
+    // 与 lscpu 输出格式一致，如 "256 KiB (8 instances)"
+    for (auto it = caches.cbegin(); it != caches.cend(); ++it) {
+        if (it->size == 0)
+            continue;
+        char *tmp = size_to_human_string(SIZE_SUFFIX_3LETTER | SIZE_SUFFIX_SPACE, it->size);
+        if (!tmp)
+            continue;
+        d->m_info[it.key() + " cache"] = QString("%1 (%2 %3)")
+                                           .arg(tmp)
+                                           .arg(it->instances)
+                                           .arg(it->instances == 1 ? "instance" : "instances");
+        free(tmp);
     }
 }
 
@@ -950,7 +1152,7 @@ void CPUSet::read_lscpu()
         cxt->show_offline = cxt->mode == LSCPU_OUTPUT_READABLE ? 1 : 0;
     }
 
-    cxt->syscpu = ul_new_path(_PATH_SYS_CPU);
+    cxt->syscpu = ul_new_path("%s", common::source::path(_PATH_SYS_CPU).constData());
     if (!cxt->syscpu) {
         qCWarning(app) << "Failed to initialize CPUs sysfs handler";
         lscpu_free_context(cxt);
@@ -959,7 +1161,7 @@ void CPUSet::read_lscpu()
 
     if (cxt->prefix)
         ul_path_set_prefix(cxt->syscpu, cxt->prefix);
-    cxt->procfs = ul_new_path("/proc");
+    cxt->procfs = ul_new_path("%s", common::source::procRoot().constData());
     if (!cxt->procfs) {
         qCWarning(app) << "Failed to initialize procfs handler";
         lscpu_free_context(cxt);
@@ -986,6 +1188,7 @@ void CPUSet::read_lscpu()
     cxt->virt = lscpu_read_virtualization(cxt);   // 获取CPU的虚拟化信息
     qCDebug(app) << "Read virtualization info:" << (cxt->virt && cxt->virt->hypervisor ? cxt->virt->hypervisor : "N/A");
     struct lscpu_cputype *ct;
+    d->m_dynamicFreq = false;
     ct = lscpu_cputype_get_default(cxt);   // 获取CPU类型信息
     if (ct) {
         qCDebug(app) << "Default CPU type found. Populating info map.";
@@ -1141,6 +1344,7 @@ void CPUSet::read_lscpu()
                 nowMHz = "-";
                 avgMHz = "-";
             }
+            d->m_dynamicFreq = scal != 0.0f;
             d->m_info.insert("CPU MHz", nowMHz);
             d->m_info.insert("CPU avg MHz", avgMHz);
             qCDebug(app) << "Populated frequency: Min=" << minMHz << "Max=" << maxMHz << "Current=" << nowMHz << "Average=" << avgMHz;
@@ -1214,9 +1418,9 @@ void CPUSet::read_lscpu()
     }
 #endif
 
-    // 直接通过 lscpu 命令获取缓存信息，保持与 lscpu 命令一致；
-    // 部分厂商的设备会通过 dmidecode 覆盖 lscpu 命令获取的缓存信息，这里不会影响这类设备上的表现；
-    read_cache_from_lscpu_cmd();
+    // 直接从 sysfs 读取缓存信息，保持与 lscpu 命令一致；
+    // 部分厂商的设备会通过 dmidecode 覆盖 sysfs 获取的缓存信息，这里不会影响这类设备上的表现；
+    read_cache_from_sysfs();
     read_dmi_cache_info();
     // 某些CPU不带有缓存用‘-’替代
     if (!d->m_info.contains("L1d cache")) {
@@ -1269,7 +1473,7 @@ QPair<float, float> CPUSet::read_cpu_freq_range_by_cpu7()
     float maxFreq = 0.0f;
 
     // 读取最小频率
-    QFile minFile("/sys/devices/system/cpu/cpu7/cpufreq/scaling_min_freq");
+    QFile minFile(common::source::path("/sys/devices/system/cpu/cpu7/cpufreq/scaling_min_freq"));
     if (minFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QTextStream in(&minFile);
         QString content = in.readLine().trimmed();
@@ -1283,7 +1487,7 @@ QPair<float, float> CPUSet::read_cpu_freq_range_by_cpu7()
     }
 
     // 读取最大频率
-    QFile maxFile("/sys/devices/system/cpu/cpu7/cpufreq/scaling_max_freq");
+    QFile maxFile(common::source::path("/sys/devices/system/cpu/cpu7/cpufreq/scaling_max_freq"));
     if (maxFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QTextStream in(&maxFile);
         QString content = in.readLine().trimmed();
@@ -83,10 +83,24 @@ private:
      * @brief read_lscpu 通过lscpu读取CPU信息
      */
     void read_lscpu();
+    /**
+     * @brief read_overall_info 加载CPU静态拓扑信息(型号、缓存、插槽/核心)，仅在首次及CPU热插拔时调用
+     */
     void read_overall_info();
+    /**
+     * @brief read_cur_freq 从 scaling_cur_freq 读取在线CPU的当前频率
+     */
+    void read_cur_freq();
+    /**
+     * @brief topology_changed 是否收到CPU热插拔事件
+     */
+    bool topology_changed();
     QPair<float, float> read_cpu_freq_range_by_cpu7();
 
-    void read_cache_from_lscpu_cmd();
+    /**
+     * @brief read_cache_from_sysfs 从 sysfs 读取缓存信息，与 lscpu 输出保持一致
+     */
+    void read_cache_from_sysfs();
 
 private:
     QSharedDataPointer<CPUSetPrivate> d;
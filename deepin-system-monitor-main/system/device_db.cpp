@@ -13,6 +13,7 @@
 #include "diskio_info.h"
 #include "net_info.h"
 #include "gpu_info.h"
+#include "collector.h"
 #include "common/thread_manager.h"
 #include "system/system_monitor.h"
 #include "system/system_monitor_thread.h"
@@ -23,6 +24,11 @@
 
 using namespace DDLog;
 
+// refresh interval of the cpu, memory & network counters, in ms
+#define COUNTER_COLLECT_INTERVAL 1000
+// refresh interval of the block device & gpu collectors, slower to read, in ms
+#define DEVICE_COLLECT_INTERVAL 2000
+
 namespace core {
 namespace system {
 
@@ -92,6 +98,17 @@ void DeviceDB::update()
     qCDebug(app) << "DeviceDB update finished.";
 }
 
+void DeviceDB::addCollectors(CollectorSet &collectors)
+{
+    collectors.add("cpu", COUNTER_COLLECT_INTERVAL, [this]() { m_cpuSet->update(); });
+    collectors.add("memory", COUNTER_COLLECT_INTERVAL, [this]() { m_memInfo->readMemInfo(); });
+    collectors.add("netifs", COUNTER_COLLECT_INTERVAL, [this]() { m_netifInfoDB->update(); });
+    collectors.add("block_devices", DEVICE_COLLECT_INTERVAL, [this]() { m_blkDevInfoDB->update(); });
+    collectors.add("disk_io", DEVICE_COLLECT_INTERVAL, [this]() { m_diskIoInfo->update(); });
+    collectors.add("net_io", COUNTER_COLLECT_INTERVAL, [this]() { m_netInfo->resdNetInfo(); });
+    collectors.add("gpu", DEVICE_COLLECT_INTERVAL, [this]() { m_gpuInfoSet->update(); });
+}
+
 DeviceDB *DeviceDB::instance()
 {
     // qCDebug(app) << "DeviceDB instance: Getting instance...";
@@ -17,6 +17,7 @@ class SystemMonitor;
 class DiskIOInfo;
 class NetInfo;
 class GPUInfoSet;
+class CollectorSet;
 
 /**
  * @brief The DeviceDB class
@@ -38,6 +39,10 @@ public:
     GPUInfoSet *gpuInfoSet();
 
     void update();
+    /**
+     * @brief Register the device collectors on collectors, update() runs them all at once
+     */
+    void addCollectors(CollectorSet &collectors);
 
 private:
     CPUSet *m_cpuSet;
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "disk_stats.h"
+#include "block_device.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "common/source_reader.h"
+#include "common/source_root.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::error;
+
+// minimal fields of a row: reads, merges, sectors, ticks for both directions, in flight & io ticks
+#define DISK_STATS_MIN_FIELDS 11
+
+namespace core {
+namespace system {
+
+DiskStatsReader::DiskStatsReader(const char *path)
+    : m_fd(-1)
+    , m_buf(4096)
+    , m_rows {}
+{
+    const QByteArray sourcePath = common::source::path(path ? path : PROC_PATH_DISK);
+    m_fd = common::source::reader()->open(sourcePath.constData());
+    if (m_fd < 0)
+        print_errno(errno, QString("open %1 failed").arg(QString(sourcePath)));
+}
+
+DiskStatsReader::~DiskStatsReader()
+{
+    if (m_fd >= 0)
+        common::source::reader()->close(m_fd);
+}
+
+bool DiskStatsReader::update()
+{
+    m_rows.clear();
+    if (m_fd < 0)
+        return false;
+
+    size_t len = 0;
+    for (;;) {
+        if (len == size_t(m_buf.size()))
+            m_buf.resize(m_buf.size() * 2);
+
+        ssize_t n = common::source::reader()->pread(m_fd, m_buf.data() + len, size_t(m_buf.size()) - len, off_t(len));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            print_errno(errno, QString("read %1 failed").arg(PROC_PATH_DISK));
+            return false;
+        }
+        if (n == 0)
+            break;
+        len += size_t(n);
+    }
+    // terminate the last number for strtoull
+    if (len == size_t(m_buf.size()))
+        m_buf.resize(m_buf.size() + 1);
+    m_buf[int(len)] = '\0';
+
+    parse(m_buf.constData(), len, m_rows);
+    return true;
+}
+
+const DiskStats *DiskStatsReader::find(const char *name, int &hint) const
+{
+    // rows keep their order between updates unless devices come & go
+    if (hint >= 0 && hint < m_rows.size() && strcmp(m_rows.at(hint).name, name) == 0)
+        return &m_rows.at(hint);
+
+    for (int i = 0; i < m_rows.size(); ++i) {
+        if (strcmp(m_rows.at(i).name, name) == 0) {
+            hint = i;
+            return &m_rows.at(i);
+        }
+    }
+    hint = -1;
+    return nullptr;
+}
+
+void DiskStatsReader::parse(const char *buf, size_t len, QVector<DiskStats> &rows)
+{
+    rows.clear();
+
+    const char *p = buf;
+    const char *end = buf + len;
+    while (p < end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', size_t(end - p)));
+        if (!eol)
+            eol = end;
+
+        DiskStats stats;
+        char *next = nullptr;
+        stats.major = unsigned(strtoul(p, &next, 10));
+        stats.minor = unsigned(strtoul(next, &next, 10));
+
+        // device name
+        const char *s = next;
+        while (s < eol && *s == ' ')
+            ++s;
+        const char *e = s;
+        while (e < eol && *e != ' ')
+            ++e;
+        size_t nlen = qMin(size_t(e - s), size_t(DISK_STATS_NAME_LEN - 1));
+        memcpy(stats.name, s, nlen);
+        stats.name[nlen] = '\0';
+
+        // counters, up to the number of fields known to us
+        const char *q = e;
+        while (stats.nfields < DiskStats::kFieldCount) {
+            while (q < eol && *q == ' ')
+                ++q;
+            if (q >= eol || *q < '0' || *q > '9')
+                break;
+            stats.fields[stats.nfields++] = strtoull(q, &next, 10);
+            q = next;
+        }
+
+        if (nlen > 0 && stats.nfields >= DISK_STATS_MIN_FIELDS)
+            rows << stats;
+
+        p = eol + 1;
+    }
+}
+
+} // namespace system
+} // namespace core
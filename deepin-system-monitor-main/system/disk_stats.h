@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DISK_STATS_H
+#define DISK_STATS_H
+
+#include <QVector>
+
+#include <string.h>
+
+#define DISK_STATS_NAME_LEN 64
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Counters of one /proc/diskstats row, field order of Documentation/admin-guide/iostats.rst
+ */
+struct DiskStats {
+    enum Field {
+        kReadsCompleted,
+        kReadsMerged,
+        kSectorsRead,
+        kReadTicks, // ms
+        kWritesCompleted,
+        kWritesMerged,
+        kSectorsWritten,
+        kWriteTicks, // ms
+        kInFlight, // requests currently in flight, not a counter
+        kIoTicks, // ms spent doing I/O
+        kWeightedIoTicks, // ms, weighted by in flight requests
+        kDiscardsCompleted, // kernel 4.18+
+        kDiscardsMerged,
+        kSectorsDiscarded,
+        kDiscardTicks,
+        kFlushesCompleted, // kernel 5.5+
+        kFlushTicks,
+
+        kFieldCount
+    };
+
+    unsigned int major = 0;
+    unsigned int minor = 0;
+    char name[DISK_STATS_NAME_LEN] = {};
+    int nfields = 0; // number of fields reported by the running kernel
+    unsigned long long fields[kFieldCount] = {};
+
+    inline unsigned long long operator[](Field field) const
+    {
+        return fields[field];
+    }
+    inline bool isValid() const
+    {
+        return nfields > 0;
+    }
+};
+
+/**
+ * @brief Single pass /proc/diskstats reader
+ *
+ * The file is kept open and re-read on each update() into a row array reused between updates,
+ * rows are parsed in place without any per line allocation.
+ */
+class DiskStatsReader
+{
+public:
+    explicit DiskStatsReader(const char *path = nullptr);
+    ~DiskStatsReader();
+
+    DiskStatsReader(const DiskStatsReader &) = delete;
+    DiskStatsReader &operator=(const DiskStatsReader &) = delete;
+
+    /**
+     * @brief Re-read all rows
+     * @return false if the file could not be read, rows are cleared in that case
+     */
+    bool update();
+
+    inline const QVector<DiskStats> &rows() const
+    {
+        return m_rows;
+    }
+
+    /**
+     * @brief Row of device name
+     * @param hint row index of the device in the previous update, updated to the index found
+     * @return nullptr if the device is not listed
+     */
+    const DiskStats *find(const char *name, int &hint) const;
+
+    /**
+     * @brief Parse diskstats content into rows, lines with too few fields are skipped
+     * @param buf content, followed by a newline or a null character
+     */
+    static void parse(const char *buf, size_t len, QVector<DiskStats> &rows);
+
+private:
+    int m_fd;
+    QVector<char> m_buf;
+    QVector<DiskStats> m_rows;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // DISK_STATS_H
@@ -6,6 +6,7 @@
 #include "diskio_info.h"
 #include "ddlog.h"
 #include "common/common.h"
+#include "common/source_root.h"
 #include "system/sys_info.h"
 
 #include <ctype.h>
@@ -66,11 +67,11 @@ void DiskIOInfo::readDiskIOStats()
             *slash = '!';
         }
 
-        snprintf(syspath, sizeof(syspath), "%s/%s", SYSFS_PATH_BLOCK, dev_name);
+        common::source::formatPath(syspath, sizeof(syspath), SYSFS_PATH_BLOCK "/%s", dev_name);
         return (!access(syspath, F_OK));
     };
 
-    if ((fp = fopen(PROC_PATH_DISK, "r")) == nullptr) {
+    if ((fp = fopen(common::source::path(PROC_PATH_DISK).constData(), "r")) == nullptr) {
         qCWarning(app) << "Failed to open" << PROC_PATH_DISK << ":" << strerror(errno);
         return;
     }
@@ -5,6 +5,8 @@
 
 #include "ddlog.h"
 #include "gpu_info.h"
+#include "nvidia_smi_stream.h"
+#include "common/source_root.h"
 
 #include <QSharedData>
 #include <QFile>
@@ -17,6 +19,14 @@
 
 using namespace DDLog;
 
+#define SYSFS_PATH_DRM "/sys/class/drm"
+#define SYSFS_PATH_DEVFREQ "/sys/class/devfreq"
+#define SYSFS_PATH_MISC "/sys/class/misc"
+
+#define NVIDIA_SMI_PROGRAM "nvidia-smi"
+// sample interval of the NVIDIA telemetry stream, matches the gpu collector cadence
+#define NVIDIA_SMI_SAMPLE_INTERVAL 2000
+
 namespace core {
 namespace system {
 
@@ -29,6 +39,8 @@ public:
     bool m_hasIntel {false};
     bool m_hasNpu {false};
     bool m_detected {false};
+    // started on the first update, shared by the copies of the set
+    std::shared_ptr<NvidiaSmiStream> m_nvidiaStream;
 };
 
 static float readPercentFromFile(const QString &path)
@@ -384,21 +396,18 @@ void GPUInfoSet::detectGPUs()
     qCDebug(app) << "Detecting GPUs...";
     
     // Check for NVIDIA GPUs
-    QProcess nvidiaSmi;
-    nvidiaSmi.start("which", QStringList() << "nvidia-smi");
-    nvidiaSmi.waitForFinished();
-    if (nvidiaSmi.exitCode() == 0) {
+    if (!QStandardPaths::findExecutable(NVIDIA_SMI_PROGRAM).isEmpty()) {
         d->m_hasNvidia = true;
         qCDebug(app) << "NVIDIA GPU detected";
     }
     
     // Check for AMD/Intel GPUs via sysfs
-    QDir drmDir("/sys/class/drm");
+    QDir drmDir(QString(common::source::path(SYSFS_PATH_DRM)));
     if (drmDir.exists()) {
         QStringList entries = drmDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
         for (const QString &entry : entries) {
             if (entry.startsWith("card")) {
-                QString devicePath = QString("/sys/class/drm/%1/device").arg(entry);
+                QString devicePath = QString(common::source::path(SYSFS_PATH_DRM "/%1/device")).arg(entry);
                 QFile vendorFile(devicePath + "/vendor");
                 if (vendorFile.open(QIODevice::ReadOnly)) {
                     QString vendor = vendorFile.readAll().trimmed();
@@ -419,7 +428,7 @@ void GPUInfoSet::detectGPUs()
     }
 
     // Check for NPU via devfreq naming convention
-    QDir devfreqDir("/sys/class/devfreq");
+    QDir devfreqDir(QString(common::source::path(SYSFS_PATH_DEVFREQ)));
     if (devfreqDir.exists()) {
         const QStringList entries = devfreqDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
         for (const QString &entry : entries) {
@@ -442,12 +451,12 @@ void GPUInfoSet::detectGPUs()
         }
     }
 
-    if (QFileInfo::exists("/sys/class/misc/apex_0")) {
+    if (QFileInfo::exists(QString(common::source::path(SYSFS_PATH_MISC "/apex_0")))) {
         d->m_hasNpu = true;
         qCDebug(app) << "Edge TPU (apex) detected";
     }
 
-    QDir miscDir("/sys/class/misc");
+    QDir miscDir(QString(common::source::path(SYSFS_PATH_MISC)));
     if (!d->m_hasNpu && miscDir.exists()) {
         const QStringList entries = miscDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
         for (const QString &entry : entries) {
@@ -466,59 +475,27 @@ void GPUInfoSet::readNvidiaInfo()
 {
     if (!d->m_hasNvidia)
         return;
-    
-    QProcess nvidiaSmi;
-    // Query: index, name, utilization.gpu, utilization.memory, memory.total, memory.used, memory.free, temperature.gpu, clocks.current.graphics
-    nvidiaSmi.start("nvidia-smi", QStringList() 
-        << "--query-gpu=index,name,utilization.gpu,utilization.memory,memory.total,memory.used,memory.free,temperature.gpu,clocks.current.graphics,pci.bus_id"
-        << "--format=csv,noheader,nounits");
-    
-    if (!nvidiaSmi.waitForFinished(5000)) {
-        qCWarning(app) << "nvidia-smi command timed out";
-        return;
-    }
-    
-    if (nvidiaSmi.exitCode() != 0) {
-        qCWarning(app) << "nvidia-smi command failed:" << nvidiaSmi.readAllStandardError();
-        return;
+
+    if (!d->m_nvidiaStream) {
+        d->m_nvidiaStream = std::make_shared<NvidiaSmiStream>(NVIDIA_SMI_PROGRAM, NVIDIA_SMI_SAMPLE_INTERVAL);
+        if (!d->m_nvidiaStream->start())
+            qCWarning(app) << "NVIDIA telemetry stream could not be started";
     }
-    
-    QString output = nvidiaSmi.readAllStandardOutput();
-    QStringList lines = output.split('\n', Qt::SkipEmptyParts);
-    
-    for (const QString &line : lines) {
-        QStringList parts = line.split(", ");
-        if (parts.size() >= 10) {
-            GPUInfo gpu(new gpu_info_t());
-            gpu->index = parts[0].toInt();
-            gpu->name = parts[1].trimmed();
-            gpu->vendor = "NVIDIA";
-            gpu->isIntegrated = false;
-            gpu->gpuUtilization = parts[2].toFloat();
-            gpu->memoryUtilization = parts[3].toFloat();
-            // Memory values are in MiB, convert to bytes
-            gpu->totalMemory = static_cast<quint64>(parts[4].toDouble() * 1024 * 1024);
-            gpu->usedMemory = static_cast<quint64>(parts[5].toDouble() * 1024 * 1024);
-            gpu->freeMemory = static_cast<quint64>(parts[6].toDouble() * 1024 * 1024);
-            gpu->temperature = parts[7].toFloat();
-            gpu->clockSpeed = parts[8].toULongLong();
-            gpu->busInfo = QString("PCIe %1").arg(parts[9].trimmed());
-            gpu->engineNames.append("Graphics");
-            gpu->engineLoads.append(gpu->gpuUtilization);
-            gpu->isAvailable = true;
-            
-            d->m_gpuList.append(gpu);
-            qCDebug(app) << "NVIDIA GPU" << gpu->index << ":" << gpu->name 
-                         << "Utilization:" << gpu->gpuUtilization << "%"
-                         << "Memory:" << gpu->usedMemory / (1024*1024) << "/" << gpu->totalMemory / (1024*1024) << "MiB";
-        }
+
+    // latest record of each GPU streamed in so far, nothing is waited for
+    const QList<GPUInfo> gpus = d->m_nvidiaStream->latest();
+    for (const GPUInfo &gpu : gpus) {
+        d->m_gpuList.append(gpu);
+        qCDebug(app) << "NVIDIA GPU" << gpu->index << ":" << gpu->name
+                     << "Utilization:" << gpu->gpuUtilization << "%"
+                     << "Memory:" << gpu->usedMemory / (1024*1024) << "/" << gpu->totalMemory / (1024*1024) << "MiB";
     }
 }
 
 void GPUInfoSet::readAmdInfo()
 {
     // For AMD GPUs using open source drivers, we can read from sysfs
-    QDir drmDir("/sys/class/drm");
+    QDir drmDir(QString(common::source::path(SYSFS_PATH_DRM)));
     if (!drmDir.exists())
         return;
     
@@ -529,7 +506,7 @@ void GPUInfoSet::readAmdInfo()
         if (!entry.startsWith("card"))
             continue;
             
-        QString devicePath = QString("/sys/class/drm/%1/device").arg(entry);
+        QString devicePath = QString(common::source::path(SYSFS_PATH_DRM "/%1/device")).arg(entry);
         QFile vendorFile(devicePath + "/vendor");
         if (!vendorFile.open(QIODevice::ReadOnly))
             continue;
@@ -590,7 +567,7 @@ void GPUInfoSet::readAmdInfo()
 void GPUInfoSet::readIntelInfo()
 {
     // For Intel GPUs, read from sysfs
-    QDir drmDir("/sys/class/drm");
+    QDir drmDir(QString(common::source::path(SYSFS_PATH_DRM)));
     if (!drmDir.exists())
         return;
     
@@ -601,7 +578,7 @@ void GPUInfoSet::readIntelInfo()
         if (!entry.startsWith("card"))
             continue;
             
-        QString devicePath = QString("/sys/class/drm/%1/device").arg(entry);
+        QString devicePath = QString(common::source::path(SYSFS_PATH_DRM "/%1/device")).arg(entry);
         QFile vendorFile(devicePath + "/vendor");
         if (!vendorFile.open(QIODevice::ReadOnly))
             continue;
@@ -660,7 +637,7 @@ void GPUInfoSet::readNpuInfo()
     if (!d->m_hasNpu)
         return;
 
-    QDir devfreqDir("/sys/class/devfreq");
+    QDir devfreqDir(QString(common::source::path(SYSFS_PATH_DEVFREQ)));
     int npuIndex {0};
     if (devfreqDir.exists()) {
         const QStringList entries = devfreqDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
@@ -712,7 +689,7 @@ void GPUInfoSet::readNpuInfo()
         }
     }
 
-    if (QFileInfo::exists("/sys/class/misc/apex_0")) {
+    if (QFileInfo::exists(QString(common::source::path(SYSFS_PATH_MISC "/apex_0")))) {
         GPUInfo npu(new gpu_info_t());
         npu->index = npuIndex;
         npu->isNpu = true;
@@ -731,7 +708,7 @@ void GPUInfoSet::readNpuInfo()
 void GPUInfoSet::readSysfsInfo()
 {
     // General sysfs reading for any DRM device
-    QDir drmDir("/sys/class/drm");
+    QDir drmDir(QString(common::source::path(SYSFS_PATH_DRM)));
     if (!drmDir.exists())
         return;
 }
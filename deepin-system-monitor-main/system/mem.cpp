@@ -6,6 +6,7 @@
 #include "mem.h"
 #include "private/mem_p.h"
 #include "common/common.h"
+#include "common/source_root.h"
 #include "ddlog.h"
 
 #include <stdio.h>
@@ -119,7 +120,7 @@ void MemInfo::readMemInfo()
     const size_t BUFLEN = 512;
     QByteArray line(BUFLEN, '\0');
 
-    if ((fp = fopen(PROC_PATH_MEM, "r"))) {
+    if ((fp = fopen(common::source::path(PROC_PATH_MEM).constData(), "r"))) {
         ufp.reset(fp);
 
         int nr = 0;
@@ -5,6 +5,7 @@
 
 #include "net_info.h"
 #include "common/common.h"
+#include "common/source_root.h"
 #include "system/sys_info.h"
 #include "ddlog.h"
 
@@ -66,7 +67,7 @@ void NetInfo::resdNetInfo()
     QScopedArrayPointer<char> line(new char[bsiz] {});
     int rc;
 
-    if ((fp = fopen(PROC_PATH_NET, "r")) == nullptr) {
+    if ((fp = fopen(common::source::path(PROC_PATH_NET).constData(), "r")) == nullptr) {
         qCWarning(app) << "Failed to open" << PROC_PATH_NET << ":" << strerror(errno);
         return;
     }
@@ -15,10 +15,12 @@
 #include "common/thread_manager.h"
 #include "netif_monitor_thread.h"
 #include "system/sys_info.h"
+#include "common/perf_stats.h"
 
 #include <memory>
 using namespace common::core;
 using namespace DDLog;
+using namespace common::perf;
 
 namespace core {
 namespace system {
@@ -108,6 +110,7 @@ void NetifInfoDB::update_netif_info()
 }
 void NetifInfoDB::update()
 {
+    PerfScope perfScope(kStageNetifs);
     qCDebug(app) << "Updating NetifInfoDB...";
     this->update_addr();
     this->update_netif_info();
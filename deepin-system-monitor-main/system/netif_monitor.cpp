@@ -11,6 +11,11 @@
 #include <QTimerEvent>
 #include <QDebug>
 
+#include <sys/time.h>
+
+#define PACKET_QUEUE_WAIT_TIMEOUT 500 // ms, quit flag check interval when idle
+#define PACKET_QUEUE_REPORT_INTERVAL 10000 // ms
+
 using namespace DDLog;
 
 namespace core {
@@ -52,65 +57,120 @@ void NetifMonitor::startNetmonitorJob()
 void NetifMonitor::handleNetData()
 {
     qCDebug(app) << "handleNetData loop started";
+    QVector<struct packet_payload_t> batch(PACKET_QUEUE_BATCH_SIZE);
+    QVector<struct sock_io_stat_t> stats;
+    QElapsedTimer reportTimer;
+    reportTimer.start();
+
     while (!m_quitRequested.load()) {
-        m_pktqLock.lock();      // +++m_pktqLock+++
-        // packets available for processing when pending queue mutex unlocked
-        // qCDebug(app) << "Waiting for packets...";
-        m_pktqWatcher.wait(&m_pktqLock);
-        // qCDebug(app) << "Woke up from wait";
-
-        // check if quit requested again after wakeup by another thread, break the loop if need
-        if (m_quitRequested.load()) {
-            // qCDebug(app) << "Quit requested, breaking handleNetData loop";
-            m_pktqLock.unlock();
-            break;
+        int n = m_packetQueue.pop(batch.data(), batch.size());
+        if (n == 0) {
+            // sleep until the capture thread queues packets
+            m_packetQueue.wait(PACKET_QUEUE_WAIT_TIMEOUT);
+            continue;
         }
 
-        // qCDebug(app) << "Moving" << m_pendingPackets.size() << "packets from pending queue";
-        // append pending queue packets to local queue, so we dont lock the mutex for too long
-        m_localPendingPackets.append(m_pendingPackets);
-        m_pendingPackets.clear();
-        m_pktqLock.unlock();    // ---m_pktqLock---
-
-        // process payload queue
-        while (!m_localPendingPackets.isEmpty()) {
-            auto payload = m_localPendingPackets.dequeue();
-            // qCDebug(app) << "Processing packet for inode" << payload->ino << "direction" << payload->direction << "size" << payload->payload;
-
-            // lock sockiostatmap
-            m_sockIOStatMapLock.lock();     // +++m_sockIOStatMapLock+++
-
-            // sum up sock io stat by inode
-            auto ino = payload->ino;
-            if (m_sockIOStatMap.contains(ino)) {
-                // sum up sock io stat if already exists with same inode stat
-                auto &hist = m_sockIOStatMap[ino];
-                if (payload->direction == kInboundPacket) {
-                    hist->rx_bytes += payload->payload;
-                    hist->rx_packets++;
-                } else if (payload->direction == kOutboundPacket) {
-                    hist->tx_bytes += (payload->payload * 2);
-                    hist->tx_packets++;
-                }
-                // qCDebug(app) << "Updated existing stat for inode" << ino << ": rx_bytes=" << hist->rx_bytes << "tx_bytes=" << hist->tx_bytes;
-            } else {
-                // add new sock io stat if sock ino no exists in cache before
-                auto stat = QSharedPointer<struct sock_io_stat_t>::create();
-                stat->ino = payload->ino;
-                if (payload->direction == kInboundPacket) {
-                    stat->rx_bytes = payload->payload;
-                    stat->rx_packets++;
-                } else if (payload->direction == kOutboundPacket) {
-                    stat->tx_bytes = payload->payload;
-                    stat->tx_packets++;
+        aggregatePackets(batch.constData(), n, stats);
+        mergeSockIOStats(stats);
+
+        // capture to accounting latency of the oldest packet in this batch
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        const struct timeval &ts = batch.at(0).ts;
+        qint64 latencyUs = (now.tv_sec - ts.tv_sec) * 1000000 + (now.tv_usec - ts.tv_usec);
+        m_packetQueue.recordBatch(qMax(latencyUs, qint64(0)));
+
+        if (reportTimer.elapsed() >= PACKET_QUEUE_REPORT_INTERVAL) {
+            reportPacketQueue();
+            reportTimer.restart();
+        }
+    }
+    qCDebug(app) << "handleNetData loop finished";
+}
+
+void NetifMonitor::aggregatePackets(const struct packet_payload_t *packets, int n, QVector<struct sock_io_stat_t> &stats)
+{
+    stats.clear();
+    // few sockets carry the traffic of a batch, a linear search with the last hit is enough
+    int hint = -1;
+    for (int i = 0; i < n; ++i) {
+        const struct packet_payload_t &payload = packets[i];
+        if (hint < 0 || stats.at(hint).ino != payload.ino) {
+            hint = -1;
+            for (int j = 0; j < stats.size(); ++j) {
+                if (stats.at(j).ino == payload.ino) {
+                    hint = j;
+                    break;
                 }
-                m_sockIOStatMap[stat->ino] = stat;
-                // qCDebug(app) << "Created new stat for inode" << stat->ino << ": rx_bytes=" << stat->rx_bytes << "tx_bytes=" << stat->tx_bytes;
             }
-            m_sockIOStatMapLock.unlock();   // ---m_sockIOStatMapLock---
+            if (hint < 0) {
+                struct sock_io_stat_t stat {};
+                stat.ino = payload.ino;
+                stats << stat;
+                hint = stats.size() - 1;
+            }
+        }
+
+        struct sock_io_stat_t &stat = stats[hint];
+        if (payload.direction == kInboundPacket) {
+            stat.rx_bytes += payload.payload;
+            stat.rx_packets++;
+        } else if (payload.direction == kOutboundPacket) {
+            stat.tx_bytes += payload.payload;
+            stat.tx_packets++;
         }
     }
-    qCDebug(app) << "handleNetData loop finished";
+}
+
+void NetifMonitor::mergeSockIOStats(const QVector<struct sock_io_stat_t> &stats)
+{
+    QMutexLocker locker(&m_sockIOStatMapLock);
+    for (const struct sock_io_stat_t &batchStat : stats) {
+        auto &stat = m_sockIOStatMap[batchStat.ino];
+        if (stat) {
+            // sum up sock io stat if already exists with same inode stat
+            stat->rx_bytes += batchStat.rx_bytes;
+            stat->rx_packets += batchStat.rx_packets;
+            stat->tx_bytes += (batchStat.tx_bytes * 2);
+            stat->tx_packets += batchStat.tx_packets;
+        } else {
+            // add new sock io stat if sock ino no exists in cache before
+            stat = QSharedPointer<struct sock_io_stat_t>::create(batchStat);
+        }
+    }
+}
+
+void NetifMonitor::reportPacketQueue()
+{
+    const packet_queue_stats_t stats = m_packetQueue.stats();
+    if (stats.dropped != m_reportedDrops) {
+        qCWarning(app) << "Packet queue full, dropped" << stats.dropped - m_reportedDrops << "packets"
+                       << "depth:" << stats.depth << "max depth:" << stats.maxDepth << "capacity:" << m_packetQueue.capacity()
+                       << "batch latency:" << stats.lastLatencyUs << "us max:" << stats.maxLatencyUs << "us";
+        m_reportedDrops = stats.dropped;
+    } else {
+        qCDebug(app) << "Packet queue queued:" << stats.pushed << "batches:" << stats.batches
+                     << "depth:" << stats.depth << "max depth:" << stats.maxDepth
+                     << "batch latency:" << stats.lastLatencyUs << "us max:" << stats.maxLatencyUs << "us";
+    }
+}
+
+void NetifMonitor::addSockIO(ino_t ino, qulonglong rxBytes, qulonglong txBytes)
+{
+    QMutexLocker locker(&m_sockIOStatMapLock);
+    auto &stat = m_sockIOStatMap[ino];
+    if (!stat) {
+        stat = QSharedPointer<struct sock_io_stat_t>::create();
+        stat->ino = ino;
+    }
+    stat->rx_bytes += rxBytes;
+    stat->tx_bytes += txBytes;
+}
+
+void NetifMonitor::clearSockIOStats()
+{
+    QMutexLocker locker(&m_sockIOStatMapLock);
+    m_sockIOStatMap.clear();
 }
 
 }
@@ -8,11 +8,12 @@
 
 #include "common/time_period.h"
 #include "netif_packet_capture.h"
+#include "packet_queue.h"
 
 #include <QObject>
 #include <QBasicTimer>
 #include <QMutex>
-#include <QWaitCondition>
+#include <QElapsedTimer>
 #include <QThread>
 
 using namespace common::core;
@@ -44,7 +45,7 @@ public:
     inline void requestQuit()
     {
         m_quitRequested.store(true);
-        m_pktqWatcher.wakeAll();
+        m_packetQueue.wakeUp();
     }
 
 public:
@@ -53,6 +54,14 @@ public:
     void startNetmonitorJob();
 
     void handleNetData();
+
+    /**
+     * @brief Counters of the captured packet queue (thread safe)
+     */
+    inline packet_queue_stats_t packetQueueStats() const
+    {
+        return m_packetQueue.stats();
+    }
 public:
     /**
      * @brief Get socket io stat data with specified inode (thread safe accessor)
@@ -79,6 +88,15 @@ public:
 
         return ok;
     }
+    /**
+     * @brief Add traffic of a socket counted outside of packet capture (thread safe)
+     */
+    void addSockIO(ino_t ino, qulonglong rxBytes, qulonglong txBytes);
+    /**
+     * @brief Drop all cached socket io stats (thread safe)
+     */
+    void clearSockIOStats();
+
     // socket inode to io stat mapping
     QMap<ino_t, SockIOStat> m_sockIOStatMap     {};
 
@@ -87,14 +105,23 @@ private:
     // packet monitor thread object
     QThread m_packetMonitorThread;
 
-    // pending packet queue
-    PacketPayloadQueue  m_pendingPackets        {};
-    // pending packet queue locker
-    QMutex              m_pktqLock              {};
-    // packet queue watcher
-    QWaitCondition      m_pktqWatcher           {};
-    // local pending packet queue
-    PacketPayloadQueue  m_localPendingPackets   {}; // local cache
+    /**
+     * @brief Sum up a batch of packets per socket inode
+     */
+    static void aggregatePackets(const struct packet_payload_t *packets, int n, QVector<struct sock_io_stat_t> &stats);
+    /**
+     * @brief Merge per socket stats of a batch, taking the stat map lock once
+     */
+    void mergeSockIOStats(const QVector<struct sock_io_stat_t> &stats);
+    /**
+     * @brief Log queue depth, drops & latency if packets were dropped since the last report
+     */
+    void reportPacketQueue();
+
+    // captured packets, pushed by the capture thread
+    PacketQueue         m_packetQueue           {};
+    // dropped packets of the last report
+    quint64             m_reportedDrops         {};
 
 
     // socket io stat map access locker
@@ -5,7 +5,6 @@
 #include "ddlog.h"
 #include "netif_packet_capture.h"
 #include "netif_packet_parser.h"
-#include "common/hash.h"
 #include "netif_monitor.h"
 #include <arpa/inet.h>
 #include "device_db.h"
@@ -27,8 +26,7 @@
 //#define PACKET_DISPATCH_IDLE_TIME 200 // pcap dispatch interval
 #define PACKET_DISPATCH_IDLE_TIME 50   // pcap dispatch interval
 #define PACKET_DISPATCH_BATCH_COUNT 64   // packets to process in a batch
-#define PACKET_DISPATCH_QUEUE_LWAT 64   // queue low water mark
-#define PACKET_DISPATCH_QUEUE_HWAT 256   // queue high water mark
+#define PACKET_DISPATCH_BATCHES_PER_RUN 16   // batches dispatched before returning to the event loop
 
 #define SOCKSTAT_REFRESH_INTERVAL 2   // socket stat refresh interval (2 seconds)
 #define IFADDRS_HASH_CACHE_REFRESH_INTERVAL 10   // socket ifaddrs cache refresh interval (10 seconds)
@@ -43,6 +41,11 @@ NetifPacketCapture::NetifPacketCapture(NetifMonitor *netIfmontor, QObject *paren
     : QObject(parent), m_netifMonitor(netIfmontor)
 {
     qCDebug(app) << "NetifPacketCapture constructor";
+    m_sockDiag.reset(new SockDiag());
+    if (!m_sockDiag->isValid()) {
+        qCWarning(app) << "sock_diag unavailable, reading /proc/net socket tables instead";
+        m_sockDiag.reset();
+    }
     m_timer = new QTimer(this);
     m_timer->setSingleShot(true);
     // dispatch packets on timerout signal
@@ -212,6 +215,7 @@ void NetifPacketCapture::startNetifMonitorJob()
     m_handle = pcap_create(m_devName.toLocal8Bit().data(), errbuf);
     if (!m_handle) {
         qCWarning(app) << "Failed to create pcap handler:" << errbuf;
+        startSockIOPolling();
         return;
     }
 
@@ -241,6 +245,8 @@ void NetifPacketCapture::startNetifMonitorJob()
     } else if (rc < 0) {
         qCWarning(app) << "pcap_activate failed:" << pcap_statustostr(rc);
         pcap_close(m_handle);
+        m_handle = nullptr;
+        startSockIOPolling();
         return;
     }
     qCDebug(app) << "pcap handler activated successfully.";
@@ -250,6 +256,8 @@ void NetifPacketCapture::startNetifMonitorJob()
     if (rc == -1) {
         qCWarning(app) << "Failed to set non-blocking mode:" << errbuf;
         pcap_close(m_handle);
+        m_handle = nullptr;
+        startSockIOPolling();
         return;
     }
     qCDebug(app) << "pcap handler set to non-blocking mode.";
@@ -261,11 +269,6 @@ void NetifPacketCapture::startNetifMonitorJob()
 
 void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char *packet)
 {
-    qCDebug(app) << "pcap_callback triggered for a packet";
-    QByteArray fmtbuf;
-    uint64_t hash {}, cchash[2] {};
-    QString pattern {};
-
     // packet payload calc
     if (!context)
         return;
@@ -277,127 +280,44 @@ void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char
     Q_ASSERT(netifMonitor != nullptr);
 
     // parse packet & calculate payload
-    PacketPayload payload = QSharedPointer<struct packet_payload_t>::create();
+    struct packet_payload_t payload {};
     auto ok = NetifPacketParser::parsePacket(hdr, packet, payload);
     if (!ok) {
-        qCDebug(app) << "Failed to parse packet";
         return;
     }
 
-    char dMac[256];
-    auto *eth_hdr = reinterpret_cast<const struct ether_header *>(packet);
-    sprintf(dMac, "%x:%x:%x:%x:%x:%x", (eth_hdr->ether_dhost)[0], (eth_hdr->ether_dhost)[1],
-            (eth_hdr->ether_dhost)[2], (eth_hdr->ether_dhost)[3],
-            (eth_hdr->ether_dhost)[4], (eth_hdr->ether_dhost)[5]);
-
-    // calc hash from caputured packet's src:sport-dest:dport
-    if (payload->sa_family == AF_INET) {
-        // ipv4 packet payload
-        char saddr_str[INET_ADDRSTRLEN + 1] {}, daddr_str[INET_ADDRSTRLEN + 1] {};
-        // convert ipv4 source & destination address to string format
-        inet_ntop(AF_INET, &payload->s_addr.in4, saddr_str, INET_ADDRSTRLEN);
-        inet_ntop(AF_INET, &payload->d_addr.in4, daddr_str, INET_ADDRSTRLEN);
-
-        // pattern that matches kernel sock stat table
-        pattern = QString("%1:%2-%3:%4").arg(saddr_str).arg(payload->s_port).arg(daddr_str).arg(payload->d_port);
-        uint64_t saddr_hpair[2] {}, daddr_hpair[2] {};
-        // generate source address hash
-        util::common::hash(saddr_str, int(strlen(saddr_str)), util::common::global_seed, saddr_hpair);
-        // generate destination address hash
-        util::common::hash(daddr_str, int(strlen(daddr_str)), util::common::global_seed, daddr_hpair);
-        if (netifMonitorJob->m_ifaddrsHashCache.contains(saddr_hpair[0])) {
-            payload->direction = kOutboundPacket;
-            qCDebug(app) << "Outbound packet:" << pattern;
-        } else if (netifMonitorJob->m_ifaddrsHashCache.contains(daddr_hpair[0])) {
-            payload->direction = kInboundPacket;
-            qCDebug(app) << "Inbound packet:" << pattern;
-        } else {
-            qCDebug(app) << "Packet not matching local addresses:" << pattern;
-            return;
-        }
-
-    } else if (payload->sa_family == AF_INET6) {
-        // ipv6 packet payload
-        char saddr6_str[INET6_ADDRSTRLEN + 1] {}, daddr6_str[INET6_ADDRSTRLEN + 1] {};
-        inet_ntop(AF_INET6, &payload->s_addr.in6, saddr6_str, INET6_ADDRSTRLEN);
-        inet_ntop(AF_INET6, &payload->d_addr.in6, daddr6_str, INET6_ADDRSTRLEN);
-
-        // pattern that matches kernel sock stat table
-        pattern = QString("%1:%2-%3:%4").arg(saddr6_str).arg(payload->s_port).arg(daddr6_str).arg(payload->d_port);
-        uint64_t saddr6_hpair[2] {}, daddr6_hpair[2] {};
-        // generate source address hash
-        util::common::hash(saddr6_str, int(strlen(saddr6_str)), util::common::global_seed, saddr6_hpair);
-        // generate destination address hash
-        util::common::hash(daddr6_str, int(strlen(daddr6_str)), util::common::global_seed, daddr6_hpair);
-        if (netifMonitorJob->m_ifaddrsHashCache.contains(saddr6_hpair[0])) {
-            payload->direction = kOutboundPacket;
-            qCDebug(app) << "Outbound packet:" << pattern;
-        } else if (netifMonitorJob->m_ifaddrsHashCache.contains(daddr6_hpair[0])) {
-            payload->direction = kInboundPacket;
-            qCDebug(app) << "Inbound packet:" << pattern;
-        } else {
-            qCDebug(app) << "Packet not matching local addresses:" << pattern;
-            return;
-        }
-
+    // packet direction, socket keys are oriented from the local end
+    sock_tuple_t key;
+    if (netifMonitorJob->isLocalAddr(payload.sa_family, &payload.s_addr)) {
+        payload.direction = kOutboundPacket;
+        key = makeSockTuple(payload.sa_family, int(payload.proto), &payload.s_addr, payload.s_port, &payload.d_addr, payload.d_port);
+    } else if (netifMonitorJob->isLocalAddr(payload.sa_family, &payload.d_addr)) {
+        payload.direction = kInboundPacket;
+        key = makeSockTuple(payload.sa_family, int(payload.proto), &payload.d_addr, payload.d_port, &payload.s_addr, payload.s_port);
     } else {
-        // unexpected here
+        // packet not matching local addresses
+        return;
     }
 
-    fmtbuf = pattern.toLocal8Bit();
-    util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-    hash = cchash[0];
-    // get ino from map
-    if (netifMonitorJob->m_sockStats.contains(hash)) {
-        QMultiMap<uint64_t, SockStat>::const_iterator it = netifMonitorJob->m_sockStats.find(hash);
-        while (it != netifMonitorJob->m_sockStats.cend() && it.key() == hash) {
-            // TODO: UDP traffic identify method refine
-            // UDP socks may have same kernel hash slot (sl: hash generated with same src:port + dest:port),
-            // which means there's no way to distinguish which packet sent/received by which socket, what
-            // makes it very tricky to get the real UDP traffic for specific process, we assume
-            // socks with same sl are created by same process for temporary, need a much fine way to
-            // distinguish the traffic at a later time.
-            payload->ino = it.value()->ino;
-            break;
-        }
-    } else {
+    // get ino from socket index
+    // TODO: UDP traffic identify method refine
+    // unconnected UDP sockets are matched on the local end only, packets of sockets sharing
+    // the same local address & port (SO_REUSEPORT) are accounted to one of them.
+    const sock_info_t *sock = netifMonitorJob->m_sockIndex.lookup(key);
+    if (!sock) {
         // no matching sockets in /proc tcp/udp table, which means we cant grab inode from socket table,
         // the only thing we can do here is ignore this packet.
         return;
     }
+    payload.ino = sock->ino;
 
-    netifMonitorJob->m_localPendingPackets.enqueue(payload);
-    auto npkts = netifMonitorJob->m_localPendingPackets.size();
-    if (npkts >= PACKET_DISPATCH_QUEUE_LWAT && npkts < PACKET_DISPATCH_QUEUE_HWAT) {
-        // if dispatch queue is between low & high water mark, then we can just use try lock in relax way
-        if (netifMonitor->m_pktqLock.tryLock()) {
-            netifMonitor->m_pendingPackets.append(netifMonitorJob->m_localPendingPackets);
-            netifMonitor->m_pktqLock.unlock();
-
-            // clear local pending queue after move packets to monitor instance's queue
-            netifMonitorJob->m_localPendingPackets.clear();
-
-            netifMonitor->m_pktqWatcher.wakeAll();
-            qCDebug(app) << "Dispatched" << npkts << "packets (relaxed mode)";
-        }
-    } else if (npkts >= PACKET_DISPATCH_QUEUE_HWAT) {
-        // otherwise we forcefully use lock instead
-        netifMonitor->m_pktqLock.lock();
-        netifMonitor->m_pendingPackets.append(netifMonitorJob->m_localPendingPackets);
-        netifMonitor->m_pktqLock.unlock();
-
-        // clear local pending queue after move packets to monitor instance's queue
-        netifMonitorJob->m_localPendingPackets.clear();
-
-        netifMonitor->m_pktqWatcher.wakeAll();
-        qCDebug(app) << "Dispatched" << npkts << "packets (force mode)";
-    }
+    // queue for accounting, dropped & counted if the accounting thread lags behind
+    netifMonitor->m_packetQueue.push(payload);
 }
 
 // dispatch packet handler
 void NetifPacketCapture::dispatchPackets()
 {
-    usleep(20000);
     if (!go) {
         qCDebug(app) << "Packet capture stopped";
         return;
@@ -408,38 +328,16 @@ void NetifPacketCapture::dispatchPackets()
         return;
     }
 
-    // check pending packets before dispatching packets
-    auto npkts = m_localPendingPackets.size();
-    if (npkts > 0) {
-        if (npkts >= PACKET_DISPATCH_QUEUE_LWAT && npkts < PACKET_DISPATCH_QUEUE_HWAT) {
-            // pending packets between low & high water mark
-            if (m_netifMonitor->m_pktqLock.tryLock()) {
-                m_netifMonitor->m_pendingPackets.append(m_localPendingPackets);
-                m_netifMonitor->m_pktqLock.unlock();
-
-                m_netifMonitor->m_pktqWatcher.wakeAll();
-
-                m_localPendingPackets.clear();
-                qCDebug(app) << "Dispatched" << npkts << "packets (relaxed mode)";
-            }
-        } else if (npkts >= PACKET_DISPATCH_QUEUE_HWAT) {
-            // acquire lock forcefully if too many packets pending
-            m_netifMonitor->m_pktqLock.lock();
-            m_netifMonitor->m_pendingPackets.append(m_localPendingPackets);
-            m_netifMonitor->m_pktqLock.unlock();
-
-            m_netifMonitor->m_pktqWatcher.wakeAll();
-
-            m_localPendingPackets.clear();
-            qCDebug(app) << "Dispatched" << npkts << "packets (force mode)";
-        }
+    // packets can not be captured, poll socket counters instead
+    if (!m_handle) {
+        if (m_quitRequested.load())
+            return;
+        pollSockIO();
+        m_timer->start(SOCKSTAT_REFRESH_INTERVAL * 1000);
+        return;
     }
 
-    time_t last_sockstat {};
-    time_t last_ifaddrs_refresh {};
-
-    do {
-        usleep(20000);
+    for (int nbatches = 1;; ++nbatches) {
         // quit requested, break the loop then
         auto quit = m_quitRequested.load();
         if (quit) {
@@ -448,20 +346,19 @@ void NetifPacketCapture::dispatchPackets()
             break;
         }
 
-        // refresh m_sockStat cache every 2 seconds
+        // refresh m_sockIndex every 2 seconds
         time_t now = time(nullptr);
-        if (!last_sockstat || (now - last_sockstat) >= SOCKSTAT_REFRESH_INTERVAL) {
+        if (!m_lastSockStatRefresh || (now - m_lastSockStatRefresh) >= SOCKSTAT_REFRESH_INTERVAL) {
             qCDebug(app) << "Refreshing socket statistics";
-            m_sockStats.clear();
-            SysInfo::readSockStat(m_sockStats);
-            last_sockstat = now;
+            refreshSockIndex();
+            m_lastSockStatRefresh = now;
         }
 
-        // refresh m_ifaddrsHashCache every 10 seconds in case user change ip address on the fly
-        if (!last_ifaddrs_refresh || (now - last_ifaddrs_refresh) >= IFADDRS_HASH_CACHE_REFRESH_INTERVAL) {
+        // refresh m_localAddrs every 10 seconds in case user change ip address on the fly
+        if (!m_lastIfAddrsRefresh || (now - m_lastIfAddrsRefresh) >= IFADDRS_HASH_CACHE_REFRESH_INTERVAL) {
             qCDebug(app) << "Refreshing interface address cache";
             refreshIfAddrsHashCache();
-            last_ifaddrs_refresh = now;
+            m_lastIfAddrsRefresh = now;
         }
 
         // start packet dispatching
@@ -469,7 +366,15 @@ void NetifPacketCapture::dispatchPackets()
                                 PACKET_DISPATCH_BATCH_COUNT,
                                 pcap_callback,
                                 reinterpret_cast<u_char *>(this));
-        if (nr == 0) {
+        if (nr > 0) {
+            // wake the accounting thread once per batch
+            m_netifMonitor->m_packetQueue.notify();
+            // let queued events (device change checks) run between bursts of traffic
+            if (nbatches >= PACKET_DISPATCH_BATCHES_PER_RUN) {
+                m_timer->start(0);
+                return;
+            }
+        } else if (nr == 0) {
             // no packets are available, idle this loop for a fraction second
             m_timer->start(PACKET_DISPATCH_IDLE_TIME);
             return;
@@ -484,10 +389,44 @@ void NetifPacketCapture::dispatchPackets()
             m_timer->stop();
             break;
         }
-    } while (true);
+    }
 
     // close pcap handle
     pcap_close(m_handle);
+    m_handle = nullptr;
+    go = false;
+}
+
+void NetifPacketCapture::refreshSockIndex(QVector<sock_io_delta_t> *ioDeltas)
+{
+    if (m_sockDiag) {
+        // counters of the previous dump are needed to report any traffic
+        if (m_sockDiag->dump(m_sockIndex, m_sockIndex.isEmpty() ? nullptr : ioDeltas))
+            return;
+        qCWarning(app) << "sock_diag dump failed, reading /proc/net socket tables instead";
+        m_sockDiag.reset();
+    }
+    if (ioDeltas)
+        ioDeltas->clear();
+    SysInfo::readSockStat(m_sockIndex);
+}
+
+void NetifPacketCapture::startSockIOPolling()
+{
+    if (!m_sockDiag) {
+        qCWarning(app) << "Neither packet capture nor sock_diag available, socket io stats disabled";
+        return;
+    }
+    qCInfo(app) << "Packet capture unavailable, polling tcp counters through sock_diag";
+    go = true;
+    m_timer->start();
+}
+
+void NetifPacketCapture::pollSockIO()
+{
+    refreshSockIndex(&m_sockIODeltas);
+    for (const sock_io_delta_t &delta : m_sockIODeltas)
+        m_netifMonitor->addSockIO(delta.ino, delta.rxBytes, delta.txBytes);
 }
 
 bool readNetIfAddrs(NetIFAddrsMap &addrsMap)
@@ -528,7 +467,7 @@ bool readNetIfAddrs(NetIFAddrsMap &addrsMap)
     }
 }
 
-// refresh network interface hash cache
+// refresh local address cache
 void NetifPacketCapture::refreshIfAddrsHashCache()
 {
     NetIFAddrsMap addrsMap;
@@ -536,35 +475,28 @@ void NetifPacketCapture::refreshIfAddrsHashCache()
     // get network interface map
     auto ok = readNetIfAddrs(addrsMap);
     if (ok) {
+        m_localAddrs.clear();
         NetIFAddrsMap::const_iterator it = addrsMap.constBegin();
         // process each address in map
         while (it != addrsMap.constEnd()) {
-            auto ifaddr = it.value();
-
-            uint64_t ifaddr_hash[2] {};
-            if (ifaddr->family == AF_INET) {
-                char addr_str[INET_ADDRSTRLEN + 1] {};
-                // convert to ipv4 format string
-                inet_ntop(AF_INET, &ifaddr->addr.in4, addr_str, INET_ADDRSTRLEN);
-
-                // calculate hash
-                util::common::hash(addr_str, int(strlen(addr_str)), util::common::global_seed, ifaddr_hash);
-                m_ifaddrsHashCache[ifaddr_hash[0]] = 0;
-
-            } else if (ifaddr->family == AF_INET6) {
-                char addr6_str[INET6_ADDRSTRLEN + 1] {};
-                // convert to ipv6 format string
-                inet_ntop(AF_INET6, &ifaddr->addr.in6, addr6_str, INET6_ADDRSTRLEN);
-
-                // calculate hash
-                util::common::hash(addr6_str, int(strlen(addr6_str)), util::common::global_seed, ifaddr_hash);
-                m_ifaddrsHashCache[ifaddr_hash[0]] = 0;
-            }
-
+            const sock_addr_t addr = makeSockAddr(it.value()->family, &it.value()->addr);
+            if (!m_localAddrs.contains(addr))
+                m_localAddrs << addr;
             ++it;
         }
     }
 }
 
+bool NetifPacketCapture::isLocalAddr(int family, const void *addr) const
+{
+    // few addresses per host, a linear scan beats hashing the address
+    const sock_addr_t key = makeSockAddr(family, addr);
+    for (const sock_addr_t &local : m_localAddrs) {
+        if (local == key)
+            return true;
+    }
+    return false;
+}
+
 }   // namespace system
 }   // namespace core
@@ -8,10 +8,14 @@
 
 #include <QObject>
 #include "packet.h"
+#include "socket_index.h"
+#include "sock_diag.h"
 #include <QTimer>
 #include <QMap>
 #include <unistd.h>
 
+#include <memory>
+
 
 namespace core {
 namespace system {
@@ -58,23 +62,42 @@ public slots:
 private:
 
     /**
-     * @brief Refresh network interface address hash cache
+     * @brief Refresh network interface address cache
      */
     void refreshIfAddrsHashCache();
+    /**
+     * @brief Check if addr (in_addr or in6_addr of family) belongs to a local network interface
+     */
+    bool isLocalAddr(int family, const void *addr) const;
+    /**
+     * @brief Refresh socket index through sock_diag, /proc/net socket tables as fallback
+     * @param ioDeltas if not null, tcp traffic per socket since the last refresh (sock_diag only)
+     */
+    void refreshSockIndex(QVector<sock_io_delta_t> *ioDeltas = nullptr);
+    /**
+     * @brief Account tcp traffic from sock_diag counters when packets can not be captured
+     */
+    void startSockIOPolling();
+    void pollSockIO();
 
 
 private:
-    // socket io stat cache
-    SockStatMap     m_sockStats {};
-    // network interface name hash cache
-    QMap<uint64_t, int> m_ifaddrsHashCache; // key: hash code generated from ifaddr; value: not used
+    // kernel socket table, keyed by binary 5-tuple
+    SocketIndex     m_sockIndex {};
+    // sock_diag reader, null if unavailable
+    std::unique_ptr<SockDiag> m_sockDiag {};
+    // tcp traffic per socket of the last poll, packet capture unavailable
+    QVector<sock_io_delta_t> m_sockIODeltas {};
+    // local network interface addresses
+    QVector<sock_addr_t> m_localAddrs {};
 
     // network interface monitor
     NetifMonitor       *m_netifMonitor         {};
     // pcap handler instance
     pcap_t             *m_handle               {};
-    // local pending packet queue
-    PacketPayloadQueue  m_localPendingPackets  {};
+    // last socket table & interface address refresh
+    time_t              m_lastSockStatRefresh  {};
+    time_t              m_lastIfAddrsRefresh   {};
 
     // request quit atomic flag
     std::atomic_bool m_quitRequested {false};
@@ -36,13 +36,10 @@ namespace system {
 
 bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
                                     const u_char *packet,
-                                    PacketPayload &payload)
+                                    struct packet_payload_t &payload)
 {
     // qCDebug(app) << "Parsing packet, captured length:" << pkt_hdr->caplen;
-    if (!payload) {
-        payload = QSharedPointer<struct packet_payload_t>::create();
-    }
-    payload->ts = pkt_hdr->ts;
+    payload.ts = pkt_hdr->ts;
     const u_char *hdr = packet;
     // parse hdr&packet
     auto *eth_hdr = reinterpret_cast<const struct ether_header *>(packet);
@@ -67,10 +64,10 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
             return false;
         }
 
-        payload->sa_family = AF_INET;
-        payload->proto = proto;
-        payload->s_addr.in4 = ip_hdr->ip_src;
-        payload->d_addr.in4 = ip_hdr->ip_dst;
+        payload.sa_family = AF_INET;
+        payload.proto = proto;
+        payload.s_addr.in4 = ip_hdr->ip_src;
+        payload.d_addr.in4 = ip_hdr->ip_dst;
 
     } else if (type == ETHERTYPE_IPV6) {
         qCDebug(app) << "Packet is ETHERTYPE_IPV6";
@@ -167,10 +164,10 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
             } // !switch
         } // !while
 
-        payload->sa_family = AF_INET6;
-        payload->proto = proto;
-        payload->s_addr.in6 = ip6_hdr->ip6_src;
-        payload->d_addr.in6 = ip6_hdr->ip6_dst;
+        payload.sa_family = AF_INET6;
+        payload.proto = proto;
+        payload.s_addr.in6 = ip6_hdr->ip6_src;
+        payload.d_addr.in6 = ip6_hdr->ip6_dst;
 
     } else {
         // ignore non ip4 & ip6 packets
@@ -187,10 +184,10 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
             qCWarning(app) << "Truncated TCP packet, captured length" << pkt_hdr->caplen << "is less than or equal to header length" << eth_hdr_len + ip_hdr_len + tcp_hdr_len;
             return false;
         }
-        payload->payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - tcp_hdr_len;
-        payload->s_port = ntohs(tcp_hdr->th_sport);
-        payload->d_port = ntohs(tcp_hdr->th_dport);
-        qCDebug(app) << "Parsed TCP packet: src port" << payload->s_port << "dst port" << payload->d_port << "payload size" << payload->payload;
+        payload.payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - tcp_hdr_len;
+        payload.s_port = ntohs(tcp_hdr->th_sport);
+        payload.d_port = ntohs(tcp_hdr->th_dport);
+        qCDebug(app) << "Parsed TCP packet: src port" << payload.s_port << "dst port" << payload.d_port << "payload size" << payload.payload;
 
     } else if (proto == IPPROTO_UDP) {
         qCDebug(app) << "Parsing UDP header";
@@ -214,10 +211,10 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
             qCWarning(app) << "Truncated UDP packet, captured length" << pkt_hdr->caplen << "is less than or equal to header length" << eth_hdr_len + ip_hdr_len + ulen;
             return false;
         }
-        payload->payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - ulen;
-        payload->s_port = ntohs(udp_hdr->uh_sport);
-        payload->d_port = ntohs(udp_hdr->uh_dport);
-        qCDebug(app) << "Parsed UDP packet: src port" << payload->s_port << "dst port" << payload->d_port << "payload size" << payload->payload;
+        payload.payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - ulen;
+        payload.s_port = ntohs(udp_hdr->uh_sport);
+        payload.d_port = ntohs(udp_hdr->uh_dport);
+        qCDebug(app) << "Parsed UDP packet: src port" << payload.s_port << "dst port" << payload.d_port << "payload size" << payload.payload;
 
     } else {
         // unexpected case, unknown proto type
@@ -16,7 +16,7 @@ class NetifPacketParser
 public:
     static bool parsePacket(const struct pcap_pkthdr *pkt_hdr,
                             const u_char *packet,
-                            PacketPayload &payload);
+                            struct packet_payload_t &payload);
 
 
 private:
@@ -0,0 +1,264 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "nvidia_smi_stream.h"
+#include "ddlog.h"
+#include "common/common.h"
+
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QThread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+
+// fields of a record, in the order parseRecord() reads them
+#define NVIDIA_SMI_QUERY "--query-gpu=index,name,utilization.gpu,utilization.memory,memory.total,memory.used," \
+                         "memory.free,temperature.gpu,clocks.current.graphics,pci.bus_id"
+#define NVIDIA_SMI_FORMAT "--format=csv,noheader,nounits"
+#define NVIDIA_SMI_FIELD_COUNT 10
+// reader wakes up this often to check for quit requests
+#define NVIDIA_SMI_POLL_MS 200
+// delay before the tool is started again once it exited
+#define NVIDIA_SMI_RESTART_MS 5000
+// time the tool is given to exit on SIGTERM before it is killed
+#define NVIDIA_SMI_TERM_MS 1000
+// a partial line longer than this is garbage, it is dropped
+#define NVIDIA_SMI_LINE_MAX 4096
+
+using namespace DDLog;
+using namespace common::error;
+
+namespace core {
+namespace system {
+
+NvidiaSmiStream::NvidiaSmiStream(const QString &program, int intervalMs)
+    : m_path()
+    , m_intervalMs(qMax(100, intervalMs))
+    , m_child(-1)
+    , m_thread {}
+    , m_quitRequested {false}
+    , m_running(false)
+    , m_pending()
+    , m_records()
+    , m_stats {}
+{
+    const QString path = QFileInfo(program).isAbsolute() ? program : QStandardPaths::findExecutable(program);
+    if (QFileInfo(path).isExecutable())
+        m_path = path.toLocal8Bit();
+}
+
+NvidiaSmiStream::~NvidiaSmiStream()
+{
+    stop();
+}
+
+bool NvidiaSmiStream::start()
+{
+    if (m_running)
+        return true;
+    if (m_path.isEmpty()) {
+        qCInfo(app) << "nvidia-smi not found, NVIDIA telemetry unavailable";
+        return false;
+    }
+
+    m_quitRequested.store(false);
+    m_thread.reset(QThread::create([this]() { run(); }));
+    m_thread->start();
+    m_running = true;
+    qCInfo(app) << "NVIDIA telemetry stream started, sampling every" << m_intervalMs << "ms";
+    return true;
+}
+
+void NvidiaSmiStream::stop()
+{
+    if (m_thread) {
+        m_quitRequested.store(true);
+        m_thread->wait();
+        m_thread.reset();
+    }
+    m_running = false;
+}
+
+QList<GPUInfo> NvidiaSmiStream::latest() const
+{
+    QList<GPUInfo> gpus;
+    QMutexLocker locker(&m_lock);
+    for (const gpu_info_t &record : m_records)
+        gpus << std::make_shared<gpu_info_t>(record);
+    return gpus;
+}
+
+nvidia_smi_stream_stats_t NvidiaSmiStream::stats() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_stats;
+}
+
+bool NvidiaSmiStream::parseRecord(const QByteArray &line, gpu_info_t &gpu)
+{
+    const QStringList parts = QString::fromUtf8(line).split(", ");
+    if (parts.size() < NVIDIA_SMI_FIELD_COUNT)
+        return false;
+
+    bool ok {false};
+    gpu.index = parts[0].trimmed().toInt(&ok);
+    if (!ok)
+        return false;
+
+    gpu.name = parts[1].trimmed();
+    gpu.vendor = "NVIDIA";
+    gpu.isIntegrated = false;
+    gpu.gpuUtilization = parts[2].toFloat();
+    gpu.memoryUtilization = parts[3].toFloat();
+    // Memory values are in MiB, convert to bytes
+    gpu.totalMemory = static_cast<quint64>(parts[4].toDouble() * 1024 * 1024);
+    gpu.usedMemory = static_cast<quint64>(parts[5].toDouble() * 1024 * 1024);
+    gpu.freeMemory = static_cast<quint64>(parts[6].toDouble() * 1024 * 1024);
+    gpu.temperature = parts[7].toFloat();
+    gpu.clockSpeed = parts[8].toULongLong();
+    gpu.busInfo = QString("PCIe %1").arg(parts[9].trimmed());
+    gpu.engineNames = QStringList {"Graphics"};
+    gpu.engineLoads = QList<float> {gpu.gpuUtilization};
+    gpu.isAvailable = true;
+    return true;
+}
+
+void NvidiaSmiStream::parseOutput(const char *buf, size_t len)
+{
+    m_pending.append(buf, int(len));
+
+    int start = 0;
+    int end;
+    while ((end = m_pending.indexOf('\n', start)) >= 0) {
+        const QByteArray line = m_pending.mid(start, end - start).trimmed();
+        start = end + 1;
+        if (line.isEmpty())
+            continue;
+
+        gpu_info_t gpu;
+        bool ok = parseRecord(line, gpu);
+        QMutexLocker locker(&m_lock);
+        if (ok) {
+            m_records.insert(gpu.index, gpu);
+            m_stats.records++;
+        } else {
+            m_stats.badRecords++;
+        }
+    }
+    m_pending.remove(0, start);
+    if (m_pending.size() > NVIDIA_SMI_LINE_MAX)
+        m_pending.clear();
+}
+
+int NvidiaSmiStream::launch()
+{
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) < 0) {
+        print_errno(errno, "create nvidia-smi pipe failed");
+        return -1;
+    }
+
+    // everything the child needs is prepared before fork
+    const QByteArray interval = QByteArray::number(m_intervalMs);
+    const char *argv[] = {m_path.constData(), NVIDIA_SMI_QUERY, NVIDIA_SMI_FORMAT, "-lms", interval.constData(), nullptr};
+    const pid_t parent = getpid();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // only async signal safe calls until exec, the tool goes away with the reader thread
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+        if (getppid() != parent)
+            _exit(127);
+        dup2(fds[1], STDOUT_FILENO);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0)
+            dup2(devnull, STDERR_FILENO);
+        execv(argv[0], const_cast<char *const *>(argv));
+        _exit(127);
+    }
+
+    close(fds[1]);
+    if (pid < 0) {
+        print_errno(errno, "start nvidia-smi failed");
+        close(fds[0]);
+        return -1;
+    }
+
+    m_child = pid;
+    QMutexLocker locker(&m_lock);
+    m_stats.launches++;
+    return fds[0];
+}
+
+void NvidiaSmiStream::reap()
+{
+    if (m_child <= 0)
+        return;
+
+    kill(m_child, SIGTERM);
+    int waited = 0;
+    while (waitpid(m_child, nullptr, WNOHANG) == 0) {
+        if (waited >= NVIDIA_SMI_TERM_MS) {
+            kill(m_child, SIGKILL);
+            waitpid(m_child, nullptr, 0);
+            break;
+        }
+        QThread::msleep(10);
+        waited += 10;
+    }
+    m_child = -1;
+}
+
+void NvidiaSmiStream::run()
+{
+    char buf[4096];
+
+    while (!m_quitRequested.load()) {
+        int fd = launch();
+        if (fd >= 0) {
+            struct pollfd pfd {fd, POLLIN, 0};
+            while (!m_quitRequested.load()) {
+                int rc = poll(&pfd, 1, NVIDIA_SMI_POLL_MS);
+                if (rc < 0 && errno != EINTR) {
+                    print_errno(errno, "poll nvidia-smi output failed");
+                    break;
+                }
+                if (rc <= 0)
+                    continue;
+
+                ssize_t n = read(fd, buf, sizeof(buf));
+                if (n > 0) {
+                    parseOutput(buf, size_t(n));
+                    continue;
+                }
+                if (n < 0 && errno == EINTR)
+                    continue;
+                // end of output, the tool exited
+                break;
+            }
+            close(fd);
+            reap();
+
+            // records of a tool that stopped are not refreshed anymore
+            QMutexLocker locker(&m_lock);
+            m_records.clear();
+            m_pending.clear();
+        }
+
+        if (!m_quitRequested.load())
+            qCWarning(app) << "nvidia-smi exited, restarting in" << NVIDIA_SMI_RESTART_MS << "ms";
+        for (int waited = 0; waited < NVIDIA_SMI_RESTART_MS && !m_quitRequested.load(); waited += NVIDIA_SMI_POLL_MS)
+            QThread::msleep(NVIDIA_SMI_POLL_MS);
+    }
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NVIDIA_SMI_STREAM_H
+#define NVIDIA_SMI_STREAM_H
+
+#include "gpu_info.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+#include <sys/types.h>
+
+class QThread;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Counters of the telemetry stream, since it was created
+ */
+struct nvidia_smi_stream_stats_t {
+    quint64 launches; // tool processes started
+    quint64 records; // lines parsed into a gpu record
+    quint64 badRecords; // lines that could not be parsed
+};
+
+/**
+ * @brief Long lived nvidia-smi telemetry reader
+ *
+ * The tool is started once in loop mode (-lms), its CSV records are read & parsed on a reader thread as they
+ * stream in, latest() hands out the last record of each GPU. If the tool exits, the records are dropped and it
+ * is started again after NVIDIA_SMI_RESTART_MS.
+ */
+class NvidiaSmiStream
+{
+public:
+    /**
+     * @param program tool to run, looked up in PATH if not absolute
+     * @param intervalMs sample interval asked to the tool
+     */
+    explicit NvidiaSmiStream(const QString &program, int intervalMs);
+    ~NvidiaSmiStream();
+
+    NvidiaSmiStream(const NvidiaSmiStream &) = delete;
+    NvidiaSmiStream &operator=(const NvidiaSmiStream &) = delete;
+
+    /**
+     * @brief Start the reader thread
+     * @return false if program was not found
+     */
+    bool start();
+    /**
+     * @brief Stop the reader thread & terminate the tool
+     */
+    void stop();
+
+    inline bool isRunning() const
+    {
+        return m_running;
+    }
+
+    /**
+     * @brief Last record of each GPU, by GPU index. Copies, the reader keeps updating its own.
+     */
+    QList<GPUInfo> latest() const;
+
+    nvidia_smi_stream_stats_t stats() const;
+
+    /**
+     * @brief Parse one CSV record of the query fields
+     * @return false if line is not a complete record
+     */
+    static bool parseRecord(const QByteArray &line, gpu_info_t &gpu);
+
+    /**
+     * @brief Fold a chunk of tool output into the records, incomplete trailing lines are kept for the next chunk
+     */
+    void parseOutput(const char *buf, size_t len);
+
+private:
+    void run();
+    /**
+     * @brief Start the tool with its stdout connected to a pipe
+     * @return read end of the pipe, -1 on failure
+     */
+    int launch();
+    void reap();
+
+    QByteArray m_path; // resolved program path
+    int m_intervalMs;
+    pid_t m_child;
+
+    std::unique_ptr<QThread> m_thread;
+    std::atomic_bool m_quitRequested;
+    bool m_running;
+
+    QByteArray m_pending; // partial line, only touched by the reader
+
+    // guarded by m_lock
+    mutable QMutex m_lock;
+    QMap<int, gpu_info_t> m_records;
+    nvidia_smi_stream_stats_t m_stats;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // NVIDIA_SMI_STREAM_H
@@ -6,7 +6,7 @@
 #ifndef PACKET_H
 #define PACKET_H
 
-#include <QQueue>
+#include <QMultiMap>
 #include <QSharedPointer>
 
 #include <memory>
@@ -55,32 +55,12 @@ struct net_ifaddr_t {
     // broadcast/p2p
 };
 
-// from /proc/net/tcp & /proc/net/udp & /proc/net/tcp6 & /proc/net/udp6
-struct sock_stat_t {
-    ino_t   ino;              // socket inode
-    int     sa_family;        // AF_INET & AF_INET6
-    int     proto;            // IPPROTO_TCP & IPPROTO_UDP
-    union {
-        in_addr in4;
-        in6_addr in6;
-    }       s_addr;           // source address
-    uint    s_port;           // source port
-    union {
-        in_addr in4;
-        in6_addr in6;
-    }       d_addr;           // remote address
-    uint    d_port;           // remote port
-    uid_t   uid;              // socket uid
-};
-
-using PacketPayload      = QSharedPointer<struct packet_payload_t>;
-using PacketPayloadQueue = QQueue<PacketPayload>;
-using SockStat      = QSharedPointer<struct sock_stat_t>;
-using SockStatMap   = QMultiMap<uint64_t, SockStat>; // [hash, SockStat]
 using NetIFAddr     = QSharedPointer<struct net_ifaddr_t>;
 using NetIFAddrsMap = QMultiMap<QString, NetIFAddr>;
 
 } // namespace system
 } // namespace core
 
+Q_DECLARE_TYPEINFO(core::system::packet_payload_t, Q_PRIMITIVE_TYPE);
+
 #endif // PACKET_H
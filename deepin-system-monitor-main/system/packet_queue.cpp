@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packet_queue.h"
+
+namespace core {
+namespace system {
+
+PacketQueue::PacketQueue(int capacity)
+    : m_ring {}
+    , m_mask {0}
+{
+    int size = 2;
+    while (size < capacity)
+        size <<= 1;
+    m_ring.resize(size);
+    m_mask = quint32(size - 1);
+}
+
+bool PacketQueue::push(const struct packet_payload_t &payload)
+{
+    const quint32 tail = m_tail.load(std::memory_order_relaxed);
+    const quint32 head = m_head.load(std::memory_order_acquire);
+    const int depth = int(tail - head);
+    if (depth >= m_ring.size()) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_ring[int(tail & m_mask)] = payload;
+    m_tail.store(tail + 1, std::memory_order_release);
+
+    if (depth + 1 > m_maxDepth.load(std::memory_order_relaxed))
+        m_maxDepth.store(depth + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void PacketQueue::notify()
+{
+    // pairs with the fence in wait(): either the consumer sees the new tail, or we see it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiting.exchange(false))
+        m_ready.release();
+}
+
+int PacketQueue::pop(struct packet_payload_t *out, int max)
+{
+    const quint32 head = m_head.load(std::memory_order_relaxed);
+    const quint32 tail = m_tail.load(std::memory_order_acquire);
+    const int n = qMin(int(tail - head), max);
+    for (int i = 0; i < n; ++i)
+        out[i] = m_ring.at(int((head + quint32(i)) & m_mask));
+    m_head.store(head + quint32(n), std::memory_order_release);
+    return n;
+}
+
+bool PacketQueue::wait(int timeoutMs)
+{
+    m_waiting.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_tail.load(std::memory_order_acquire) != m_head.load(std::memory_order_relaxed)) {
+        m_waiting.store(false);
+        return true;
+    }
+
+    // a late release() from notify() only makes the next wait return early
+    bool ok = m_ready.tryAcquire(1, timeoutMs);
+    m_waiting.store(false);
+    return ok;
+}
+
+void PacketQueue::wakeUp()
+{
+    m_ready.release();
+}
+
+void PacketQueue::recordBatch(qint64 latencyUs)
+{
+    m_batches.fetch_add(1, std::memory_order_relaxed);
+    m_lastLatencyUs.store(latencyUs, std::memory_order_relaxed);
+    if (latencyUs > m_maxLatencyUs.load(std::memory_order_relaxed))
+        m_maxLatencyUs.store(latencyUs, std::memory_order_relaxed);
+}
+
+packet_queue_stats_t PacketQueue::stats() const
+{
+    packet_queue_stats_t stats {};
+    const quint32 tail = m_tail.load(std::memory_order_acquire);
+    const quint32 head = m_head.load(std::memory_order_acquire);
+    stats.pushed = tail;
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.batches = m_batches.load(std::memory_order_relaxed);
+    stats.depth = int(tail - head);
+    stats.maxDepth = m_maxDepth.load(std::memory_order_relaxed);
+    stats.lastLatencyUs = m_lastLatencyUs.load(std::memory_order_relaxed);
+    stats.maxLatencyUs = m_maxLatencyUs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PACKET_QUEUE_H
+#define PACKET_QUEUE_H
+
+#include "packet.h"
+
+#include <QVector>
+#include <QSemaphore>
+
+#include <atomic>
+
+#define PACKET_QUEUE_CAPACITY 4096 // pending packets, power of 2
+#define PACKET_QUEUE_BATCH_SIZE 256 // packets accounted per batch
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Packet queue counters
+ */
+struct packet_queue_stats_t {
+    quint64 pushed; // packets queued, wraps at 2^32
+    quint64 dropped; // packets dropped because the queue was full
+    quint64 batches; // batches consumed
+    int depth; // packets pending
+    int maxDepth; // highest depth seen
+    qint64 lastLatencyUs; // capture to accounting latency of the oldest packet of the last batch
+    qint64 maxLatencyUs;
+};
+
+/**
+ * @brief Bounded single producer single consumer ring of packet payloads
+ *
+ * The capture thread pushes, the netif monitor thread pops in batches, neither side takes a lock.
+ * When the ring is full new packets are dropped & counted instead of blocking the capture.
+ * The consumer only sleeps when the ring is empty, and is woken once per captured batch.
+ */
+class PacketQueue
+{
+public:
+    explicit PacketQueue(int capacity = PACKET_QUEUE_CAPACITY);
+
+    PacketQueue(const PacketQueue &) = delete;
+    PacketQueue &operator=(const PacketQueue &) = delete;
+
+    inline int capacity() const
+    {
+        return m_ring.size();
+    }
+
+    /**
+     * @brief Queue a packet (producer thread)
+     * @return false if the queue is full, the packet is dropped
+     */
+    bool push(const struct packet_payload_t &payload);
+    /**
+     * @brief Wake the consumer if it is waiting (producer thread), called once per batch of pushes
+     */
+    void notify();
+
+    /**
+     * @brief Take up to max packets (consumer thread)
+     * @return Number of packets copied to out
+     */
+    int pop(struct packet_payload_t *out, int max);
+    /**
+     * @brief Wait for packets (consumer thread)
+     * @return false on timeout
+     */
+    bool wait(int timeoutMs);
+    /**
+     * @brief Wake the consumer unconditionally, e.g. to quit (any thread)
+     */
+    void wakeUp();
+
+    /**
+     * @brief Record the latency of a consumed batch (consumer thread)
+     */
+    void recordBatch(qint64 latencyUs);
+
+    packet_queue_stats_t stats() const;
+
+private:
+    QVector<struct packet_payload_t> m_ring;
+    quint32 m_mask;
+
+    // consumer & producer positions on separate cache lines
+    alignas(64) std::atomic<quint32> m_head {0};
+    alignas(64) std::atomic<quint32> m_tail {0};
+
+    alignas(64) std::atomic<quint64> m_dropped {0};
+    std::atomic<int> m_maxDepth {0};
+    std::atomic<quint64> m_batches {0};
+    std::atomic<qint64> m_lastLatencyUs {0};
+    std::atomic<qint64> m_maxLatencyUs {0};
+
+    std::atomic_bool m_waiting {false};
+    QSemaphore m_ready;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // PACKET_QUEUE_H
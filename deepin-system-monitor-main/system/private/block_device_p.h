@@ -6,9 +6,13 @@
 #ifndef BLOCK_DEVICE_P_H
 #define BLOCK_DEVICE_P_H
 
+#include "system/disk_stats.h"
+
 #include <QSharedData>
 #include <QDateTime>
 
+#include <sys/time.h>
+
 namespace core {
 namespace system {
 
@@ -44,6 +48,9 @@ public:
         , write_merged{0}
         , discard_sector{0}
         , _time_Sec{ QDateTime::currentSecsSinceEpoch() }
+        , stats {}
+        , uptime {0, 0}
+        , statsRow {-1}
     {
     }
     BlockDevicePrivate(const BlockDevicePrivate &other)
@@ -73,6 +80,9 @@ public:
         , write_merged{other.write_merged}
         , discard_sector{other.discard_sector}
         , _time_Sec{other._time_Sec}
+        , stats(other.stats)
+        , uptime(other.uptime)
+        , statsRow(other.statsRow)
     {
     }
 
@@ -106,6 +116,10 @@ private:
 
     qint64 _time_Sec;   //记录的时间
 
+    DiskStats stats; // diskstats counters of the last update
+    timeval uptime; // uptime of the last update
+    int statsRow; // diskstats row of the last update, lookup hint
+
     friend class BlockDevice;
 };
 
@@ -11,10 +11,15 @@
 #include <QSharedData>
 #include <QMap>
 
+#include <memory>
+
 namespace core {
 namespace system {
 
 class CPUSet;
+class UDev;
+class UDevMonitor;
+class CPUFreqReader;
 
 enum StatIndex {
     kLastStat = 0,
@@ -43,6 +48,11 @@ public:
         , m_usageDB {}
         , m_info {}
         , m_infos {}
+        , m_topologyLoaded {false}
+        , m_dynamicFreq {false}
+        , m_udev {}
+        , m_hotplugMonitor {}
+        , m_freqReader {}
     {
 
     }
@@ -62,6 +72,11 @@ public:
         , m_stat(std::make_shared<cpu_stat_t>(*(other.m_stat)))
         , m_usage(std::make_shared<cpu_usage_t>(*(other.m_usage)))
         , m_info(other.m_info)
+        , m_topologyLoaded(other.m_topologyLoaded)
+        , m_dynamicFreq(other.m_dynamicFreq)
+        , m_udev(other.m_udev)
+        , m_hotplugMonitor(other.m_hotplugMonitor)
+        , m_freqReader(other.m_freqReader)
     {
         for (auto &stat : other.m_statDB) {
             if (stat) {
@@ -105,6 +120,15 @@ private:
 
     QMap<QString, QString> m_info;   //overall info
     QList<CPUInfo> m_infos;         //per cpu info
+
+    // static topology (model, caches, sockets/cores) is loaded once, then only on cpu hotplug
+    bool m_topologyLoaded;
+    // current frequency is reported by cpufreq scaling and changes between updates
+    bool m_dynamicFreq;
+    std::shared_ptr<UDev> m_udev;
+    std::shared_ptr<UDevMonitor> m_hotplugMonitor;
+    // scaling_cur_freq of the online cpus, read on every update
+    std::shared_ptr<CPUFreqReader> m_freqReader;
 };
 
 } // namespace system
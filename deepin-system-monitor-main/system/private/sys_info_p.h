@@ -14,6 +14,7 @@ namespace core {
 namespace system {
 
 class SysInfo;
+class SysCounterReader;
 struct load_avg_t;
 using LoadAvg = std::shared_ptr<struct load_avg_t>;
 
@@ -39,6 +40,7 @@ public:
         , group_name {}
         , effective_user_name {}
         , effective_group_name {}
+        , counters {}
     {
     }
     SysInfoPrivate(const SysInfoPrivate &other)
@@ -60,6 +62,7 @@ public:
         , group_name(other.group_name)
         , effective_user_name(other.effective_user_name)
         , effective_group_name(other.effective_group_name)
+        , counters(other.counters)
     {
     }
     ~SysInfoPrivate() {}
@@ -86,6 +89,8 @@ private:
     QByteArray effective_user_name; // effective user name
     QByteArray effective_group_name; // effective group name
 
+    std::shared_ptr<SysCounterReader> counters; // open /proc counter files
+
     friend class SysInfo;
 };
 
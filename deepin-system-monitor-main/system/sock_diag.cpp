@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sock_diag.h"
+#include "ddlog.h"
+#include "common/common.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <linux/tcp.h>
+
+// kernel side tcp states (include/net/tcp_states.h), sockets in these states have no inode
+#define SOCK_DIAG_TCP_SYN_RECV 3
+#define SOCK_DIAG_TCP_TIME_WAIT 6
+
+// large enough for the biggest dump chunk the kernel sends at once
+#define SOCK_DIAG_BUFFER_SIZE (64 * 1024)
+
+using namespace DDLog;
+using namespace common::error;
+
+namespace core {
+namespace system {
+
+SockDiag::SockDiag()
+    : m_fd(-1)
+    , m_seq(0)
+    , m_buf(SOCK_DIAG_BUFFER_SIZE)
+{
+    m_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (m_fd < 0)
+        print_errno(errno, "create NETLINK_SOCK_DIAG socket failed");
+}
+
+SockDiag::~SockDiag()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool SockDiag::dump(SocketIndex &index, QVector<sock_io_delta_t> *ioDeltas)
+{
+    if (m_fd < 0)
+        return false;
+
+    if (ioDeltas)
+        ioDeltas->clear();
+
+    index.beginUpdate();
+    bool ok = dumpTable(AF_INET, IPPROTO_TCP, index, ioDeltas);
+    ok = ok && dumpTable(AF_INET, IPPROTO_UDP, index, ioDeltas);
+    ok = ok && dumpTable(AF_INET6, IPPROTO_TCP, index, ioDeltas);
+    ok = ok && dumpTable(AF_INET6, IPPROTO_UDP, index, ioDeltas);
+    // keep sockets of tables not dumped, the fallback reader refreshes them
+    if (ok)
+        index.removeStale();
+    return ok;
+}
+
+bool SockDiag::dumpTable(int family, int proto, SocketIndex &index, QVector<sock_io_delta_t> *ioDeltas)
+{
+    struct {
+        struct nlmsghdr nlh;
+        struct inet_diag_req_v2 req;
+    } msg {};
+
+    msg.nlh.nlmsg_len = sizeof(msg);
+    msg.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    msg.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    msg.nlh.nlmsg_seq = ++m_seq;
+    msg.req.sdiag_family = uint8_t(family);
+    msg.req.sdiag_protocol = uint8_t(proto);
+    msg.req.idiag_states = ~0u;
+    if (proto == IPPROTO_TCP) {
+        msg.req.idiag_states &= ~((1u << SOCK_DIAG_TCP_SYN_RECV) | (1u << SOCK_DIAG_TCP_TIME_WAIT));
+        msg.req.idiag_ext = uint8_t(1 << (INET_DIAG_INFO - 1));
+    }
+
+    struct sockaddr_nl nladdr {};
+    nladdr.nl_family = AF_NETLINK;
+
+    ssize_t n;
+    do {
+        n = sendto(m_fd, &msg, sizeof(msg), 0, reinterpret_cast<struct sockaddr *>(&nladdr), sizeof(nladdr));
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        print_errno(errno, "send sock_diag request failed");
+        return false;
+    }
+
+    bool done = false;
+    while (!done) {
+        n = recv(m_fd, m_buf.data(), size_t(m_buf.size()), 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            print_errno(errno, "receive sock_diag dump failed");
+            return false;
+        }
+        if (n == 0)
+            break;
+
+        if (!parseMessages(m_buf.constData(), size_t(n), proto, index, ioDeltas, done)) {
+            qCWarning(app) << "sock_diag dump failed, family:" << family << "protocol:" << proto;
+            // drain the rest of the dump, so the next request starts on a clean socket
+            while (!done && (n = recv(m_fd, m_buf.data(), size_t(m_buf.size()), MSG_DONTWAIT)) > 0)
+                parseMessages(m_buf.constData(), size_t(n), proto, index, nullptr, done);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SockDiag::parseMessages(const char *buf, size_t len, int proto, SocketIndex &index,
+                             QVector<sock_io_delta_t> *ioDeltas, bool &done)
+{
+    int remain = int(len);
+    for (auto *nlh = reinterpret_cast<const struct nlmsghdr *>(buf); NLMSG_OK(nlh, remain); nlh = NLMSG_NEXT(nlh, remain)) {
+        if (nlh->nlmsg_type == NLMSG_DONE) {
+            done = true;
+            return true;
+        }
+        if (nlh->nlmsg_type == NLMSG_ERROR) {
+            done = true;
+            if (nlh->nlmsg_len >= NLMSG_LENGTH(sizeof(struct nlmsgerr))) {
+                auto *err = static_cast<const struct nlmsgerr *>(NLMSG_DATA(nlh));
+                print_errno(-err->error, "sock_diag request failed");
+            }
+            return false;
+        }
+        if (nlh->nlmsg_type != SOCK_DIAG_BY_FAMILY || nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg)))
+            continue;
+
+        auto *diag = static_cast<const struct inet_diag_msg *>(NLMSG_DATA(nlh));
+        // socket still in waiting state
+        if (diag->idiag_inode == 0)
+            continue;
+
+        sock_info_t info {};
+        info.ino = ino_t(diag->idiag_inode);
+        info.uid = uid_t(diag->idiag_uid);
+
+        // tcp_info attribute, older kernels may send a shorter structure
+        int attrlen = int(nlh->nlmsg_len - NLMSG_LENGTH(sizeof(struct inet_diag_msg)));
+        for (auto *attr = reinterpret_cast<const struct rtattr *>(diag + 1); RTA_OK(attr, attrlen); attr = RTA_NEXT(attr, attrlen)) {
+            if (attr->rta_type != INET_DIAG_INFO)
+                continue;
+            auto *tcpi = static_cast<const struct tcp_info *>(RTA_DATA(attr));
+            if (RTA_PAYLOAD(attr) >= offsetof(struct tcp_info, tcpi_bytes_received) + sizeof(tcpi->tcpi_bytes_received)) {
+                info.rxBytes = tcpi->tcpi_bytes_received;
+                info.txBytes = tcpi->tcpi_bytes_acked;
+            }
+        }
+
+        const sock_tuple_t key = makeSockTuple(diag->idiag_family, proto,
+                                               diag->id.idiag_src, ntohs(diag->id.idiag_sport),
+                                               diag->id.idiag_dst, ntohs(diag->id.idiag_dport));
+        if (ioDeltas && proto == IPPROTO_TCP) {
+            const sock_info_t *prev = index.find(key);
+            // counters of a reused tuple start over with the new socket
+            quint64 rx = info.rxBytes, tx = info.txBytes;
+            if (prev && prev->ino == info.ino) {
+                rx = info.rxBytes >= prev->rxBytes ? info.rxBytes - prev->rxBytes : 0;
+                tx = info.txBytes >= prev->txBytes ? info.txBytes - prev->txBytes : 0;
+            }
+            if (rx > 0 || tx > 0)
+                ioDeltas->append({info.ino, rx, tx});
+        }
+        index.insert(key, info);
+    }
+    return true;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCK_DIAG_H
+#define SOCK_DIAG_H
+
+#include "socket_index.h"
+
+#include <QVector>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Tcp traffic of a socket between two dumps
+ */
+struct sock_io_delta_t {
+    ino_t ino;
+    quint64 rxBytes;
+    quint64 txBytes;
+};
+
+/**
+ * @brief NETLINK_SOCK_DIAG (inet_diag) socket table reader
+ *
+ * Dumps tcp & udp sockets of both address families as binary records, so refreshing the socket
+ * index does not format or parse any text. Sockets are applied to the index incrementally, only
+ * closed sockets are removed. Tcp sockets carry the tcp_info byte counters (bytes_received &
+ * bytes_acked), from which per socket traffic can be derived without capturing packets.
+ */
+class SockDiag
+{
+public:
+    SockDiag();
+    ~SockDiag();
+
+    SockDiag(const SockDiag &) = delete;
+    SockDiag &operator=(const SockDiag &) = delete;
+
+    inline bool isValid() const
+    {
+        return m_fd >= 0;
+    }
+
+    /**
+     * @brief Dump all tcp & udp sockets into index
+     * @param ioDeltas if not null, filled with tcp bytes received & sent since the previous dump
+     * @return false if any table could not be dumped, index is left partially refreshed then
+     */
+    bool dump(SocketIndex &index, QVector<sock_io_delta_t> *ioDeltas = nullptr);
+
+    /**
+     * @brief Apply a buffer of inet_diag messages to index
+     * @param done set when the end of the dump (NLMSG_DONE) is reached
+     * @return false on NLMSG_ERROR
+     */
+    static bool parseMessages(const char *buf, size_t len, int proto, SocketIndex &index,
+                              QVector<sock_io_delta_t> *ioDeltas, bool &done);
+
+private:
+    bool dumpTable(int family, int proto, SocketIndex &index, QVector<sock_io_delta_t> *ioDeltas);
+
+    int m_fd;
+    quint32 m_seq;
+    QVector<char> m_buf;
+};
+
+} // namespace system
+} // namespace core
+
+Q_DECLARE_TYPEINFO(core::system::sock_io_delta_t, Q_PRIMITIVE_TYPE);
+
+#endif // SOCK_DIAG_H
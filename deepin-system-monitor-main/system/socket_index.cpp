@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "socket_index.h"
+
+#include <sys/socket.h>
+
+namespace core {
+namespace system {
+
+static inline bool is_v4_mapped(const in6_addr *addr)
+{
+    return IN6_IS_ADDR_V4MAPPED(addr);
+}
+
+sock_tuple_t makeSockTuple(int family, int proto, const void *saddr, uint16_t sport, const void *daddr, uint16_t dport)
+{
+    sock_tuple_t key;
+    memset(&key, 0, sizeof(key));
+    key.proto = uint8_t(proto);
+    key.sport = sport;
+    key.dport = dport;
+
+    if (family == AF_INET6) {
+        auto *s6 = static_cast<const in6_addr *>(saddr);
+        auto *d6 = static_cast<const in6_addr *>(daddr);
+        // dual stack sockets, kernel tables list them as ipv6 while packets are ipv4
+        if (is_v4_mapped(s6) && (is_v4_mapped(d6) || IN6_IS_ADDR_UNSPECIFIED(d6))) {
+            key.family = AF_INET;
+            memcpy(key.saddr, &s6->s6_addr[12], 4);
+            if (!IN6_IS_ADDR_UNSPECIFIED(d6))
+                memcpy(key.daddr, &d6->s6_addr[12], 4);
+        } else {
+            key.family = AF_INET6;
+            memcpy(key.saddr, s6, 16);
+            memcpy(key.daddr, d6, 16);
+        }
+    } else {
+        key.family = AF_INET;
+        memcpy(key.saddr, saddr, 4);
+        memcpy(key.daddr, daddr, 4);
+    }
+    return key;
+}
+
+sock_addr_t makeSockAddr(int family, const void *addr)
+{
+    sock_addr_t saddr;
+    memset(&saddr, 0, sizeof(saddr));
+    if (family == AF_INET6 && !is_v4_mapped(static_cast<const in6_addr *>(addr))) {
+        saddr.family = AF_INET6;
+        memcpy(saddr.addr, addr, 16);
+    } else {
+        saddr.family = AF_INET;
+        memcpy(saddr.addr, family == AF_INET6 ? &static_cast<const in6_addr *>(addr)->s6_addr[12] : addr, 4);
+    }
+    return saddr;
+}
+
+SocketIndex::SocketIndex()
+    : m_index {}
+    , m_generation {0}
+{
+}
+
+void SocketIndex::clear()
+{
+    m_index.clear();
+}
+
+void SocketIndex::reserve(int n)
+{
+    m_index.reserve(n);
+}
+
+void SocketIndex::insert(const sock_tuple_t &key, const sock_info_t &info)
+{
+    m_index.insert(key, entry_t {info, m_generation});
+}
+
+bool SocketIndex::remove(const sock_tuple_t &key)
+{
+    return m_index.remove(key);
+}
+
+void SocketIndex::beginUpdate()
+{
+    ++m_generation;
+}
+
+int SocketIndex::removeStale()
+{
+    int n = 0;
+    // backwards, remove() fills the hole with the last entry which is already checked
+    for (int i = m_index.size() - 1; i >= 0; --i) {
+        if (m_index.valueAt(i).stamp != m_generation) {
+            const sock_tuple_t key = m_index.keyAt(i);
+            m_index.remove(key);
+            ++n;
+        }
+    }
+    return n;
+}
+
+const sock_info_t *SocketIndex::find(const sock_tuple_t &key) const
+{
+    const entry_t *entry = m_index.find(key);
+    return entry ? &entry->info : nullptr;
+}
+
+const sock_info_t *SocketIndex::lookup(const sock_tuple_t &key) const
+{
+    const sock_info_t *info = find(key);
+    if (info)
+        return info;
+
+    // unconnected socket bound to the local address, e.g. udp servers
+    sock_tuple_t wildcard = key;
+    memset(wildcard.daddr, 0, sizeof(wildcard.daddr));
+    wildcard.dport = 0;
+    if ((info = find(wildcard)))
+        return info;
+
+    // bound to the wildcard address
+    memset(wildcard.saddr, 0, sizeof(wildcard.saddr));
+    if ((info = find(wildcard)))
+        return info;
+
+    // dual stack socket bound to [::]
+    if (wildcard.family == AF_INET) {
+        wildcard.family = AF_INET6;
+        return find(wildcard);
+    }
+    return nullptr;
+}
+
+uint sock_tuple_traits_t::hash(const sock_tuple_t &key)
+{
+    uint64_t words[sizeof(sock_tuple_t) / sizeof(uint64_t)];
+    memcpy(words, &key, sizeof(words));
+
+    uint64_t h = 0x9e3779b97f4a7c15ull;
+    for (uint64_t w : words) {
+        h ^= w;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 32;
+    }
+    return uint(h ^ (h >> 29));
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCKET_INDEX_H
+#define SOCKET_INDEX_H
+
+#include "common/flat_index.h"
+
+#include <QVector>
+
+#include <string.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Packed binary socket key, oriented from the local end of the socket
+ *
+ * IPv4 addresses use the first 4 bytes of the address arrays, unused bytes are always zero,
+ * so keys are hashed & compared as plain memory.
+ */
+struct sock_tuple_t {
+    uint8_t family; // AF_INET & AF_INET6
+    uint8_t proto; // IPPROTO_TCP & IPPROTO_UDP
+    uint16_t sport; // local port, host byte order
+    uint16_t dport; // remote port, host byte order
+    uint16_t reserved;
+    uint8_t saddr[16]; // local address, network byte order
+    uint8_t daddr[16]; // remote address, network byte order
+};
+static_assert(sizeof(sock_tuple_t) == 40, "sock_tuple_t must not have padding");
+
+/**
+ * @brief Binary address of a local network interface
+ */
+struct sock_addr_t {
+    uint8_t family;
+    uint8_t addr[16];
+};
+
+/**
+ * @brief Socket found in the kernel socket tables
+ */
+struct sock_info_t {
+    ino_t ino; // socket inode
+    uid_t uid; // socket uid
+    quint64 rxBytes; // tcp bytes received, sock_diag only
+    quint64 txBytes; // tcp bytes acked by the peer, sock_diag only
+};
+
+/**
+ * @brief Build a socket key, IPv4 mapped IPv6 addresses are converted to IPv4
+ * @param saddr in_addr or in6_addr of the local end, depending on family
+ * @param daddr in_addr or in6_addr of the remote end
+ */
+sock_tuple_t makeSockTuple(int family, int proto, const void *saddr, uint16_t sport, const void *daddr, uint16_t dport);
+
+/**
+ * @brief Binary address of family, IPv4 mapped IPv6 addresses are converted to IPv4
+ */
+sock_addr_t makeSockAddr(int family, const void *addr);
+
+inline bool operator==(const sock_addr_t &lhs, const sock_addr_t &rhs)
+{
+    return lhs.family == rhs.family && memcmp(lhs.addr, rhs.addr, sizeof(lhs.addr)) == 0;
+}
+
+} // namespace system
+} // namespace core
+
+Q_DECLARE_TYPEINFO(core::system::sock_tuple_t, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(core::system::sock_addr_t, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(core::system::sock_info_t, Q_PRIMITIVE_TYPE);
+
+namespace core {
+namespace system {
+
+struct sock_tuple_traits_t {
+    enum { kMinTableSize = 256 };
+
+    static uint hash(const sock_tuple_t &key);
+    static inline bool equal(const sock_tuple_t &lhs, const sock_tuple_t &rhs)
+    {
+        return memcmp(&lhs, &rhs, sizeof(lhs)) == 0;
+    }
+};
+
+/**
+ * @brief Flat socket table keyed by sock_tuple_t
+ *
+ * Sockets are kept in a common::FlatIndex, lookups neither format strings nor allocate.
+ */
+class SocketIndex
+{
+public:
+    SocketIndex();
+
+    inline int size() const
+    {
+        return m_index.size();
+    }
+    inline bool isEmpty() const
+    {
+        return m_index.isEmpty();
+    }
+
+    /**
+     * @brief Remove all sockets, table capacity is kept for the next refresh
+     */
+    void clear();
+    void reserve(int n);
+
+    /**
+     * @brief Start a refresh, sockets inserted from now on are marked as seen
+     */
+    void beginUpdate();
+    /**
+     * @brief Finish a refresh, removing sockets not inserted since beginUpdate()
+     * @return Number of sockets removed
+     */
+    int removeStale();
+
+    void insert(const sock_tuple_t &key, const sock_info_t &info);
+    bool remove(const sock_tuple_t &key);
+    const sock_info_t *find(const sock_tuple_t &key) const;
+
+    /**
+     * @brief Socket a packet belongs to
+     *
+     * Connected sockets are matched on the full tuple first, then unconnected sockets
+     * (remote end any) bound to the local address, then ones bound to the wildcard address,
+     * ipv4 packets also match dual stack sockets bound to the ipv6 wildcard address.
+     * @param key packet tuple oriented from the local end
+     */
+    const sock_info_t *lookup(const sock_tuple_t &key) const;
+
+    inline const QVector<sock_tuple_t> &keys() const
+    {
+        return m_index.keys();
+    }
+    inline const sock_info_t &infoAt(int i) const
+    {
+        return m_index.valueAt(i).info;
+    }
+
+private:
+    struct entry_t {
+        sock_info_t info;
+        quint32 stamp; // refresh generation the entry was last inserted in
+    };
+
+    ::common::FlatIndex<sock_tuple_t, entry_t, sock_tuple_traits_t> m_index;
+    quint32 m_generation;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // SOCKET_INDEX_H
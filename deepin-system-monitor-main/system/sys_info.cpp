@@ -9,26 +9,28 @@
 #include "common/time_period.h"
 #include "common/sample.h"
 #include "common/common.h"
+#include "common/source_reader.h"
+#include "common/source_root.h"
 #include "system/system_monitor.h"
 #include "common/thread_manager.h"
 #include "system/system_monitor_thread.h"
-#include "packet.h"
+#include "socket_index.h"
 #include <DSysInfo>
 
 #include <QString>
 #include <QtDBus>
-#include <QFileInfo>
-#include <QDir>
 
 #include <sys/time.h>
 #include <unistd.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/utsname.h>
 #include <errno.h>
 #include <stdio.h>
 #include <sys/sysinfo.h>
-#include <arpa/inet.h>
-#include "common/hash.h"
+#include <stdlib.h>
 
 #define PROC_PATH_SOCK_TCP  "/proc/net/tcp"
 #define PROC_PATH_SOCK_TCP6 "/proc/net/tcp6"
@@ -50,6 +52,55 @@ DCORE_USE_NAMESPACE
 namespace core {
 namespace system {
 
+/**
+ * @brief Small /proc counter files read on each update, kept open & re-read with pread
+ */
+class SysCounterReader
+{
+public:
+    enum File { kFileNr, kUptime, kLoadAvg, kFileCount };
+
+    SysCounterReader()
+    {
+        static const char *const paths[kFileCount] = {PROC_PATH_FILE_NR, PROC_PATH_UPTIME, PROC_PATH_LOADAVG};
+        for (int i = 0; i < kFileCount; ++i) {
+            m_fds[i] = common::source::reader()->open(common::source::path(paths[i]).constData());
+            if (m_fds[i] < 0)
+                print_errno(errno, QString("open %1 failed").arg(paths[i]));
+        }
+    }
+    ~SysCounterReader()
+    {
+        for (int fd : m_fds) {
+            if (fd >= 0)
+                common::source::reader()->close(fd);
+        }
+    }
+
+    SysCounterReader(const SysCounterReader &) = delete;
+    SysCounterReader &operator=(const SysCounterReader &) = delete;
+
+    /**
+     * @brief Null terminated content of file, valid until the next read
+     * @return nullptr if file could not be read
+     */
+    const char *read(File file)
+    {
+        if (m_fds[file] < 0)
+            return nullptr;
+
+        ssize_t n = common::source::reader()->pread(m_fds[file], m_buf, sizeof(m_buf) - 1, 0);
+        if (n <= 0)
+            return nullptr;
+        m_buf[n] = '\0';
+        return m_buf;
+    }
+
+private:
+    int m_fds[kFileCount];
+    char m_buf[256];
+};
+
 SysInfo::SysInfo()
     : d(new SysInfoPrivate())
 {
@@ -82,142 +133,128 @@ SysInfo *SysInfo::instance()
     return monitor->sysInfo();
 }
 
-bool SysInfo::readSockStat(SockStatMap &statMap)
+static inline int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// "0100007F:0277", each 32bit word is printed by the kernel as a native integer (%08X),
+// so writing the words back in host order restores the network order bytes
+static bool parse_sock_addr(const char *&p, int nwords, uint32_t *words, uint16_t &port)
+{
+    while (*p == ' ')
+        ++p;
+    for (int i = 0; i < nwords; ++i) {
+        uint32_t v = 0;
+        for (int j = 0; j < 8; ++j, ++p) {
+            int d = hex_value(*p);
+            if (d < 0)
+                return false;
+            v = (v << 4) | uint32_t(d);
+        }
+        words[i] = v;
+    }
+    if (*p++ != ':')
+        return false;
+
+    uint32_t v = 0;
+    int d;
+    for (int j = 0; j < 4; ++j, ++p) {
+        if ((d = hex_value(*p)) < 0)
+            return false;
+        v = (v << 4) | uint32_t(d);
+    }
+    port = uint16_t(v);
+    return true;
+}
+
+static inline const char *skip_sock_field(const char *p)
+{
+    while (*p == ' ')
+        ++p;
+    while (*p && *p != ' ')
+        ++p;
+    return p;
+}
+
+bool SysInfo::parseSockLine(const char *line, int family, int proto, SocketIndex &index)
+{
+    // sl local_address rem_address st tx_queue:rx_queue tr:tm->when retrnsmt uid timeout inode
+    const char *p = skip_sock_field(line);
+    int nwords = (family == AF_INET6) ? 4 : 1;
+    uint32_t saddr[4] {}, daddr[4] {};
+    uint16_t sport {}, dport {};
+
+    // header line
+    if (!parse_sock_addr(p, nwords, saddr, sport) || !parse_sock_addr(p, nwords, daddr, dport))
+        return false;
+
+    // st, tx_queue:rx_queue, tr:tm->when, retrnsmt
+    for (int i = 0; i < 4; ++i)
+        p = skip_sock_field(p);
+
+    char *next = nullptr;
+    sock_info_t info {};
+    info.uid = uid_t(strtoul(p, &next, 10));
+    p = skip_sock_field(next);
+    info.ino = ino_t(strtoull(p, &next, 10));
+    if (next == p)
+        return false;
+
+    // socket still in waiting state
+    if (info.ino == 0)
+        return false;
+
+    index.insert(makeSockTuple(family, proto, saddr, sport, daddr, dport), info);
+    return true;
+}
+
+bool SysInfo::readSockStat(SocketIndex &index)
 {
     qCDebug(app) << "Reading socket statistics...";
     bool ok {true};
 
-    auto parseSocks = [](int family, int proto, const char *proc, SockStatMap & statMap) -> bool {
+    auto parseSocks = [](int family, int proto, const char *proc, SocketIndex &index) -> bool {
         qCDebug(app) << "Parsing socket stats from" << proc;
-        bool ok {true};
         FILE *fp {};
-        const size_t BLEN = 4096;
-        QByteArray buffer {BLEN, 0};
-        int nr {};
-        ino_t ino {};
-        char s_addr[128] {}, d_addr[128] {};
-        uint64_t hash {};
-        QByteArray fmtbuf {};
-        uint64_t cchash[2] {};
-        QString patternA {}, patternB {};
+        char line[512];
         int count = 0;
 
         errno = 0;
-        if (!(fp = fopen(proc, "r")))
-        {
+        if (!(fp = fopen(common::source::path(proc).constData(), "r"))) {
             qCWarning(app) << "Failed to open" << proc << ":" << strerror(errno);
-            return !ok;
+            return false;
         }
 
-        while (fgets(buffer.data(), BLEN, fp))
-        {
-            auto stat = QSharedPointer<struct sock_stat_t>::create();
-
-            //*****************************************************************
-            nr = sscanf(buffer.data(), "%*s %64[0-9A-Fa-f]:%x %64[0-9A-Fa-f]:%x %*x %*s %*s %*s %u %*u %ld",
-                        s_addr,
-                        &stat->s_port,
-                        d_addr,
-                        &stat->d_port,
-                        &stat->uid,
-                        &ino);
-
-            // ignore first line
-            if (nr == 0)
-                continue;
-
-            // socket still in waiting state
-            if (ino == 0) {
-                continue;
-            }
-            count++;
-
-            stat->ino = ino;
-            stat->sa_family = family;
-            stat->proto = proto;
-
-            // saddr & daddr
-            if (family == AF_INET6) {
-                sscanf(s_addr, "%08x%08x%08x%08x",
-                       &stat->s_addr.in6.s6_addr32[0],
-                       &stat->s_addr.in6.s6_addr32[1],
-                       &stat->s_addr.in6.s6_addr32[2],
-                       &stat->s_addr.in6.s6_addr32[3]);
-                sscanf(d_addr, "%08x%08x%08x%08x",
-                       &stat->d_addr.in6.s6_addr32[0],
-                       &stat->d_addr.in6.s6_addr32[1],
-                       &stat->d_addr.in6.s6_addr32[2],
-                       &stat->d_addr.in6.s6_addr32[3]);
-                // convert ipv4 mapped ipv6 address to ipv4
-                if (stat->s_addr.in6.s6_addr32[0] == 0x0 &&
-                        stat->s_addr.in6.s6_addr32[1] == 0x0 &&
-                        stat->s_addr.in6.s6_addr32[2] == 0xffff0000) {
-                    stat->sa_family = AF_INET;
-                    stat->s_addr.in4.s_addr = stat->s_addr.in6.s6_addr32[3];
-                    stat->d_addr.in4.s_addr = stat->d_addr.in6.s6_addr32[3];
-                }
-            } else {
-                sscanf(s_addr, "%x", &stat->s_addr.in4.s_addr);
-                sscanf(d_addr, "%x", &stat->d_addr.in4.s_addr);
-            }
-
-            if (stat->sa_family == AF_INET) {
-                char saddr_str[INET_ADDRSTRLEN + 1] {}, daddr_str[INET_ADDRSTRLEN + 1] {};
-                inet_ntop(AF_INET, &stat->s_addr.in4, saddr_str, INET_ADDRSTRLEN);
-                inet_ntop(AF_INET, &stat->d_addr.in4, daddr_str, INET_ADDRSTRLEN);
-
-                patternA = QString("%1:%2-%3:%4").arg(saddr_str).arg(stat->s_port).arg(daddr_str).arg(stat->d_port);
-                if (proto == IPPROTO_TCP) {
-                    patternB = QString("%1:%2-%3:%4").arg(daddr_str).arg(stat->d_port).arg(saddr_str).arg(stat->s_port);
-                }
-
-            } else if (stat->sa_family == AF_INET6) {
-                char saddr6_str[INET6_ADDRSTRLEN + 1] {}, daddr6_str[INET6_ADDRSTRLEN + 1] {};
-                inet_ntop(AF_INET6, &stat->s_addr.in6, saddr6_str, INET6_ADDRSTRLEN);
-                inet_ntop(AF_INET6, &stat->d_addr.in6, daddr6_str, INET6_ADDRSTRLEN);
-
-                patternA = QString("%1:%2-%3:%4").arg(saddr6_str).arg(stat->s_port).arg(daddr6_str).arg(stat->d_port);
-                if (proto == IPPROTO_TCP) {
-                    patternB = QString("%1:%2-%3:%4").arg(daddr6_str).arg(stat->d_port).arg(saddr6_str).arg(stat->s_port);
-                }
-
-            } else {
-                qCWarning(app) << "Unexpected socket family:" << stat->sa_family;
-            }
-
-            fmtbuf = patternA.toLocal8Bit();
-            util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-            hash = cchash[0];
-            statMap.insert(hash, stat);
-
-            // if it's TCP, we need add reverse mapping due to its bidirectional piping feature,
-            // otherwise we wont be able to get the inode
-            if (proto == IPPROTO_TCP) {
-                fmtbuf = patternB.toLocal8Bit();
-                util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-                hash = cchash[0];
-                statMap.insert(hash, stat);
-            }
+        while (fgets(line, sizeof(line), fp)) {
+            if (parseSockLine(line, family, proto, index))
+                count++;
         }
-        if (ferror(fp))
-        {
+        bool ok = !ferror(fp);
+        if (!ok)
             qCWarning(app) << "Error reading from" << proc << ":" << strerror(errno);
-            ok = !ok;
-        }
         fclose(fp);
 
         qCDebug(app) << "Parsed" << count << "socket entries from" << proc;
         return ok;
     };
 
-    statMap.clear();
+    // sockets still open keep their slots, only closed ones are removed
+    index.beginUpdate();
 
-    ok = parseSocks(AF_INET, IPPROTO_TCP, PROC_PATH_SOCK_TCP, statMap);
-    ok = parseSocks(AF_INET, IPPROTO_UDP, PROC_PATH_SOCK_UDP, statMap) && ok;
-    ok = parseSocks(AF_INET6, IPPROTO_TCP, PROC_PATH_SOCK_TCP6, statMap) && ok;
-    ok = parseSocks(AF_INET6, IPPROTO_UDP, PROC_PATH_SOCK_UDP6, statMap) && ok;
+    ok = parseSocks(AF_INET, IPPROTO_TCP, PROC_PATH_SOCK_TCP, index);
+    ok = parseSocks(AF_INET, IPPROTO_UDP, PROC_PATH_SOCK_UDP, index) && ok;
+    ok = parseSocks(AF_INET6, IPPROTO_TCP, PROC_PATH_SOCK_TCP6, index) && ok;
+    ok = parseSocks(AF_INET6, IPPROTO_UDP, PROC_PATH_SOCK_UDP6, index) && ok;
+    index.removeStale();
 
-    qCDebug(app) << "Finished reading socket statistics. Total entries:" << statMap.size() << "Success:" << ok;
+    qCDebug(app) << "Finished reading socket statistics. Total entries:" << index.size() << "Success:" << ok;
     return ok;
 }
 
@@ -225,11 +262,15 @@ void SysInfo::readSysInfo()
 {
     qCDebug(app) << "Reading dynamic system info...";
     d->nfds = read_file_nr();
-    d->nprocs = read_processes();
-    d->nthrs = read_threads();
-    
+    // 进程数由进程扫描更新 (ProcessSet::scanProcess), 首次扫描之前才遍历 /proc
+    if (d->nprocs == 0)
+        d->nprocs = read_processes();
+
     read_uptime(d->uptime);
-    read_btime(d->btime);
+    // 启动时间不会变化
+    if (d->btime.tv_sec == 0)
+        read_btime(d->btime);
+    // 同时读取线程数
     read_loadavg(d->loadAvg);
     qCDebug(app) << "Dynamic system info read:" << "nfds=" << d->nfds << "nprocs=" << d->nprocs << "nthrs=" << d->nthrs;
 }
@@ -257,57 +298,57 @@ void SysInfo::readSysInfoStatic()
     qCDebug(app) << "Static system info read:" << "user=" << d->user_name << "host=" << d->hostname << "arch=" << d->arch;
 }
 
-quint32 SysInfo::read_file_nr()
+SysCounterReader *SysInfo::counters()
 {
-    FILE *fp;
-    unsigned int file_nr = 0;
-
-    errno = 0;
-    if ((fp = fopen(PROC_PATH_FILE_NR, "r"))) {
-        uFile fPtr;
-        fPtr.reset(fp);
-
-        char buf[128] {};
-        if (fgets(buf, sizeof(buf), fp)) {
-            int nm = sscanf(buf, "%u", &file_nr);
-            if (nm == 1)
-                return file_nr;
+    if (!d->counters)
+        d->counters = std::make_shared<SysCounterReader>();
+    return d->counters.get();
+}
 
-            qCWarning(app) << "Failed to read file descriptor count from" << PROC_PATH_FILE_NR << ":" << strerror(errno);
-            return 0;
-        } // ::if(fgets)
-    } // ::if(fopen)
+quint32 SysInfo::read_file_nr()
+{
+    const char *buf = counters()->read(SysCounterReader::kFileNr);
+    if (!buf) {
+        qCWarning(app) << "Failed to read" << PROC_PATH_FILE_NR << ":" << strerror(errno);
+        return 0;
+    }
 
-    qCWarning(app) << "Failed to open" << PROC_PATH_FILE_NR << ":" << strerror(errno);
-    return 0;
+    // allocated, free & max file handles
+    char *end = nullptr;
+    unsigned long file_nr = strtoul(buf, &end, 10);
+    if (end == buf) {
+        qCWarning(app) << "Failed to read file descriptor count from" << PROC_PATH_FILE_NR;
+        return 0;
+    }
+    return quint32(file_nr);
 }
 
 quint32 SysInfo::read_threads()
 {
-    QDir dir("/proc");
-    QFileInfoList infoList = dir.entryInfoList();
+    load_avg_t loadAvg {};
     quint32 threads = 0;
-    for (QFileInfo info : infoList) {
-        if (info.isDir() && info.fileName().toInt() > 0) {
-            QDir taskDir("/proc/" + info.fileName() + "/task");
-            threads += taskDir.entryInfoList().count();
-        }
-    }
-
+    parse_loadavg(loadAvg, threads);
     return threads;
 }
 
 quint32 SysInfo::read_processes()
 {
-    QDir dir("/proc");
-    QFileInfoList infoList = dir.entryInfoList();
+    // readdir only, d_type saves a stat() per entry
+    uDir dir;
+    dir.reset(opendir(common::source::procRoot().constData()));
+    if (!dir) {
+        qCWarning(app) << "Failed to open /proc:" << strerror(errno);
+        return 0;
+    }
+
     quint32 processes = 0;
-    for (QFileInfo info : infoList) {
-        if (info.isDir() && info.fileName().toInt() > 0) {
+    struct dirent *entry;
+    while ((entry = readdir(dir.get()))) {
+        if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)
+            continue;
+        if (isdigit(entry->d_name[0]))
             processes++;
-        }
     }
-
     return processes;
 }
 
@@ -348,37 +389,29 @@ QString SysInfo::read_version()
 
 void SysInfo::read_uptime(struct timeval &uptime)
 {
-    FILE *fp;
-    errno = 0;
-
-    if ((fp = fopen(PROC_PATH_UPTIME, "r"))) {
-        uFile fPtr;
-        fPtr.reset(fp);
-
-        char buf[128] {};
-        long up_sec, up_usec;
-        if (fgets(buf, sizeof(buf), fp)) {
-            int nm = sscanf(buf, "%ld.%ld", &up_sec, &up_usec);
-            if (nm == 2) {
-                uptime.tv_sec = up_sec;
-                uptime.tv_usec = up_usec * 1000000;
-
-                return;
-            }
-        } // ::if(gets)
-
-        qCWarning(app) << "Failed to read uptime from" << PROC_PATH_UPTIME << ":" << strerror(errno);
+    const char *buf = counters()->read(SysCounterReader::kUptime);
+    if (!buf) {
+        qCWarning(app) << "Failed to read" << PROC_PATH_UPTIME << ":" << strerror(errno);
         return;
-    } // ::if(fopen)
+    }
 
-    qCWarning(app) << "Failed to open" << PROC_PATH_UPTIME << ":" << strerror(errno);
+    // seconds with 2 decimals, e.g. 12345.67
+    char *end = nullptr;
+    long up_sec = strtol(buf, &end, 10);
+    if (end == buf || *end != '.') {
+        qCWarning(app) << "Failed to read uptime from" << PROC_PATH_UPTIME;
+        return;
+    }
+    long up_csec = strtol(end + 1, nullptr, 10);
+    uptime.tv_sec = up_sec;
+    uptime.tv_usec = up_csec * 10000;
 }
 
 void SysInfo::read_btime(struct timeval &btime)
 {
     FILE *fp;
     errno = 0;
-    if ((fp = fopen(PROC_PATH_STAT, "r"))) {
+    if ((fp = fopen(common::source::path(PROC_PATH_STAT).constData(), "r"))) {
         uFile fPtr;
         fPtr.reset(fp);
 
@@ -405,33 +438,46 @@ void SysInfo::read_btime(struct timeval &btime)
 
 void SysInfo::read_loadavg(LoadAvg &loadAvg)
 {
-    QFile file("/proc/loadavg");
-    if (file.exists() && file.open(QFile::ReadOnly)) {
-        // 只需要读取第一行数据
-        QByteArray lineData = file.readLine();
-        file.close();
-        /*样例数据:
-            $ cat /proc/loadavg
-            0.41 0.46 0.36 2/2646 20183
-        */
-
-        // 分割数据 取前3
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QStringList cpuStatus = QString(lineData).split(" ", QString::SkipEmptyParts);
-#else
-        QStringList cpuStatus = QString(lineData).split(" ", Qt::SkipEmptyParts);
-#endif
-
-        if (cpuStatus.size() > 3) {
-            loadAvg->lavg_1m = cpuStatus[0].toFloat();
-            loadAvg->lavg_5m = cpuStatus[1].toFloat();
-            loadAvg->lavg_15m = cpuStatus[2].toFloat();
-
-            return ;
-        }
+    quint32 threads = 0;
+    if (parse_loadavg(*loadAvg, threads))
+        d->nthrs = threads;
+}
+
+bool SysInfo::parse_loadavg(load_avg_t &loadAvg, quint32 &nthreads)
+{
+    /*样例数据:
+        $ cat /proc/loadavg
+        0.41 0.46 0.36 2/2646 20183
+        1/5/15 分钟平均负载, 可运行/总调度实体(线程)数, 最近的pid
+    */
+    const char *buf = counters()->read(SysCounterReader::kLoadAvg);
+    if (!buf) {
+        qCWarning(app) << "Failed to read load average:" << strerror(errno);
+        return false;
     }
 
-    qCWarning(app) << "Failed to read load average:" << strerror(errno);
+    char *p = const_cast<char *>(buf);
+    char *end = nullptr;
+    float lavg[3] {};
+    for (float &value : lavg) {
+        value = strtof(p, &end);
+        if (end == p) {
+            qCWarning(app) << "Failed to parse" << PROC_PATH_LOADAVG;
+            return false;
+        }
+        p = end;
+    }
+    loadAvg.lavg_1m = lavg[0];
+    loadAvg.lavg_5m = lavg[1];
+    loadAvg.lavg_15m = lavg[2];
+
+    strtoul(p, &end, 10);
+    if (*end != '/') {
+        qCWarning(app) << "Failed to parse thread count from" << PROC_PATH_LOADAVG;
+        return false;
+    }
+    nthreads = quint32(strtoul(end + 1, nullptr, 10));
+    return true;
 }
 
 } // namespace system
@@ -8,7 +8,7 @@
 
 // local
 #include "private/sys_info_p.h"
-#include "packet.h"
+#include "socket_index.h"
 // qt
 #include <QtGlobal>
 #include <QSharedDataPointer>
@@ -31,6 +31,8 @@ using namespace core::process;
 namespace core {
 namespace system {
 
+class SysCounterReader;
+
 struct load_avg_t {
     float lavg_1m {0};
     float lavg_5m {0};
@@ -77,18 +79,39 @@ public:
 
     void readSysInfo();
     void readSysInfoStatic();
-    static bool readSockStat(SockStatMap &statMap);
+    /**
+     * @brief Read sockets of /proc/net/{tcp,udp}{,6} into index, keyed from the local end
+     *
+     * Fallback of SockDiag::dump, sockets no longer listed are removed from index.
+     */
+    static bool readSockStat(SocketIndex &index);
 
 private:
+    /**
+     * @brief Parse one /proc/net/{tcp,udp}{,6} line into index
+     * @return false for the header line, malformed lines & sockets without inode
+     */
+    static bool parseSockLine(const char *line, int family, int proto, SocketIndex &index);
+    SysCounterReader *counters();
     quint32 read_file_nr();
+    /**
+     * @brief Number of threads, nr_threads field of /proc/loadavg
+     */
     quint32 read_threads();
+    /**
+     * @brief Number of processes, only used until the first process scan reports its count
+     */
     quint32 read_processes();
     QString read_hostname();
     QString read_arch();
     QString read_version();
     void read_uptime(struct timeval &uptime);
     void read_btime(struct timeval &btime);
+    /**
+     * @brief Load averages, also updates the thread count
+     */
     void read_loadavg(LoadAvg &loadAvg);
+    bool parse_loadavg(struct load_avg_t &loadAvg, quint32 &nthreads);
 
     inline void set_nprocesses(quint32 nprocs);
     inline void set_nthreads(quint32 nthrs);
@@ -98,7 +121,7 @@ private:
     QSharedDataPointer<SysInfoPrivate> d;
 
     friend class CPUSet;
-    friend class ProcessSet;
+    friend class core::process::ProcessSet;
 };
 
 inline quint32 SysInfo::nprocesses() const
@@ -11,12 +11,20 @@
 #include "process/desktop_entry_cache_updater.h"
 #include "wm/wm_window_list.h"
 #include "sys_info.h"
+#include "collector.h"
 
 #include <QTimerEvent>
 
+#include <atomic>
+
 using namespace common::core;
 using namespace DDLog;
 
+// interval between two monitor ticks, each one collects then publishes a snapshot
+#define COLLECT_TICK_INTERVAL SystemMonitor::kTickInterval
+// refresh interval of the system counters, in ms
+#define SYS_INFO_COLLECT_INTERVAL 1000
+
 namespace core {
 namespace system {
 
@@ -25,15 +33,27 @@ SystemMonitor::SystemMonitor(QObject *parent)
     , m_sysInfo(new SysInfo())
     , m_deviceDB(new DeviceDB())
     , m_processDB(new ProcessDB(this))
+    , m_collectors(new CollectorSet(COLLECT_TICK_INTERVAL))
+    , m_snapshot()
+    , m_snapshotSeq(0)
 {
     qCDebug(app) << "SystemMonitor created";
     m_sysInfo->readSysInfoStatic();
+
+    // same order as a full update: counters, devices, then processes
+    m_collectors->add("sys_info", SYS_INFO_COLLECT_INTERVAL, [this]() { m_sysInfo->readSysInfo(); });
+    m_deviceDB->addCollectors(*m_collectors);
+    m_processDB->addCollectors(*m_collectors);
 }
 
 SystemMonitor::~SystemMonitor()
 {
     qCDebug(app) << "SystemMonitor destroyed";
     m_basictimer.stop();
+    if (m_collectors) {
+        delete m_collectors;
+        m_collectors = nullptr;
+    }
     if (m_sysInfo) {
         delete m_sysInfo;
         m_sysInfo = nullptr;
@@ -68,43 +88,49 @@ SysInfo *SystemMonitor::SystemMonitor::sysInfo()
     return m_sysInfo;
 }
 
+CollectorSet *SystemMonitor::collectors()
+{
+    return m_collectors;
+}
+
+SystemSnapshotPtr SystemMonitor::snapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+void SystemMonitor::publishSnapshot()
+{
+    SystemSnapshotPtr snapshot = SystemSnapshot::capture(++m_snapshotSeq, m_sysInfo, m_deviceDB, m_processDB->processSet(),
+                                                         m_snapshot.get());
+    std::atomic_store(&m_snapshot, snapshot);
+}
+
 void SystemMonitor::startMonitorJob()
 {
     qCDebug(app) << "Starting monitor job";
     common::init::global_init();
 
     m_basictimer.stop();
-    m_basictimer.start(1000, Qt::VeryCoarseTimer, this);
+    m_basictimer.start(COLLECT_TICK_INTERVAL, Qt::VeryCoarseTimer, this);
     updateSystemMonitorInfo();
 }
-static uint cnt = 0 ;
 void SystemMonitor::timerEvent(QTimerEvent *event)
 {
-
     QObject::timerEvent(event);
     if (event->timerId() == m_basictimer.timerId()) {
-        // qCDebug(app) << "Timer event triggered, cnt =" << cnt;
-        if(cnt & 0x0001){
-            // qCDebug(app) << "Updating system info, device DB, and process DB";
-            m_sysInfo->readSysInfo();
-            m_deviceDB->update();
-            m_processDB->update();
-        } else {
-            // qCDebug(app) << "Emitting statInfoUpdated and recounting apps/processes";
-            emit statInfoUpdated();
-            recountAppAndProcess();
-        }
-        if(cnt++ >250)
-            cnt = 0;
+        // consumers are told as soon as the values of this tick are published
+        m_collectors->tick();
+        publishSnapshot();
+        emit statInfoUpdated();
+        recountAppAndProcess();
     }
 }
 
 void SystemMonitor::updateSystemMonitorInfo()
 {
     qCDebug(app) << "Forcing update of system monitor info";
-    m_sysInfo->readSysInfo();
-    m_deviceDB->update();
-    m_processDB->update();
+    m_collectors->collectAll();
+    publishSnapshot();
 
     emit statInfoUpdated();
     recountAppAndProcess();
@@ -116,18 +142,13 @@ void SystemMonitor::updateSystemMonitorInfo()
 void SystemMonitor::recountAppAndProcess()
 {
     qCDebug(app) << "Recounting apps and processes";
-    ProcessSet *processSet = m_processDB->processSet();
-    // count all app
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    int appCount = 0;
-    for (const auto &pid : newpidlst) {
-        auto process = processSet->getProcessById(pid);
-        if (process.appType() == kFilterApps)
-            appCount++;
-    }
+    // counted by the process scan itself
+    SystemSnapshotPtr snapshot = this->snapshot();
+    int appCount = snapshot ? snapshot->appCount() : 0;
+    int procCount = snapshot ? snapshot->procCount() : 0;
 
-    qCDebug(app) << "App count:" << appCount << "Process count:" << newpidlst.size();
-    emit appAndProcCountUpdate(appCount, newpidlst.size());
+    qCDebug(app) << "App count:" << appCount << "Process count:" << procCount;
+    emit appAndProcCountUpdate(appCount, procCount);
 }
 
 } // namespace system
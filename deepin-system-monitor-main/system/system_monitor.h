@@ -6,6 +6,8 @@
 #ifndef SYSTEM_MONITOR_H
 #define SYSTEM_MONITOR_H
 
+#include "system_snapshot.h"
+
 #include <QObject>
 #include <QBasicTimer>
 
@@ -22,6 +24,7 @@ namespace system {
 
 class DeviceDB;
 class SysInfo;
+class CollectorSet;
 
 class SystemMonitor : public QObject
 {
@@ -38,9 +41,33 @@ public:
 
     static SystemMonitor *instance();
 
+    /**
+     * @brief Interval between two ticks in ms, statInfoUpdated is emitted once per tick
+     */
+    static constexpr int kTickInterval = 1000;
+    /**
+     * @return number of ticks in seconds, the points a history chart keeps to cover that span
+     */
+    static constexpr int ticks(int seconds)
+    {
+        return seconds * 1000 / kTickInterval;
+    }
+
     SysInfo *sysInfo();
     DeviceDB *deviceDB();
     ProcessDB *processDB();
+    CollectorSet *collectors();
+
+    /**
+     * @brief Snapshot published by the last tick, null before the first one
+     *
+     * Safe to call from any thread, the snapshot returned stays valid & unchanged while it is held.
+     */
+    SystemSnapshotPtr snapshot() const;
+    /**
+     * @brief Capture the values collected so far & publish them as the current snapshot
+     */
+    void publishSnapshot();
 
     void startMonitorJob();
 
@@ -55,6 +82,11 @@ private:
     SysInfo      *m_sysInfo;
     DeviceDB     *m_deviceDB;
     ProcessDB    *m_processDB;
+    CollectorSet *m_collectors;
+
+    // swapped atomically, readers never take a lock
+    SystemSnapshotPtr m_snapshot;
+    quint64 m_snapshotSeq;
 
     QBasicTimer m_basictimer;
 };
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "system_snapshot.h"
+#include "ddlog.h"
+
+#include "block_device_info_db.h"
+#include "cpu_set.h"
+#include "device_db.h"
+#include "netif_info_db.h"
+#include "process/process.h"
+#include "common/perf_stats.h"
+
+using namespace DDLog;
+using namespace common::perf;
+using namespace core::process;
+
+namespace core {
+namespace system {
+
+SystemSnapshot::SystemSnapshot()
+    : m_seq(0)
+    , m_capturedNs(0)
+    , m_processCapturedNs(0)
+    , m_uptime {0, 0}
+    , m_loadAvg {}
+    , m_nprocesses(0)
+    , m_nthreads(0)
+    , m_nfds(0)
+    , m_appCount(0)
+    , m_procCount(0)
+{
+}
+
+std::shared_ptr<SystemSnapshot> SystemSnapshot::capture(quint64 seq,
+                                                        const SysInfo *sysInfo,
+                                                        DeviceDB *deviceDB,
+                                                        const ProcessSet *processSet,
+                                                        const SystemSnapshot *previous)
+{
+    PerfScope perfScope(kStageSnapshot);
+    auto snapshot = std::make_shared<SystemSnapshot>();
+    snapshot->m_seq = seq;
+    snapshot->m_capturedNs = PerfScope::monotonicNs();
+
+    if (sysInfo) {
+        snapshot->m_uptime = sysInfo->uptime();
+        if (sysInfo->loadAvg())
+            snapshot->m_loadAvg = *sysInfo->loadAvg();
+        snapshot->m_nprocesses = sysInfo->nprocesses();
+        snapshot->m_nthreads = sysInfo->nthreads();
+        snapshot->m_nfds = sysInfo->nfds();
+    }
+
+    if (deviceDB) {
+        const CPUSet *cpuSet = deviceDB->cpuSet();
+        if (cpuSet->stat())
+            snapshot->m_cpuStat = *cpuSet->stat();
+        if (cpuSet->usage())
+            snapshot->m_cpuUsage = *cpuSet->usage();
+        const QList<QByteArray> cpus = cpuSet->cpuLogicName();
+        snapshot->m_cpuUsages.reserve(cpus.size());
+        for (const QByteArray &cpu : cpus) {
+            const CPUUsage usage = cpuSet->usageDB(cpu);
+            if (usage)
+                snapshot->m_cpuUsages << *usage;
+        }
+
+        const QList<BlockDevice> devices = deviceDB->blockDeviceInfoDB()->deviceList();
+        snapshot->m_blockDevices.reserve(devices.size());
+        for (const BlockDevice &device : devices)
+            snapshot->m_blockDevices << block_dev_metrics_t {device.deviceName(), device.readSpeed(), device.writeSpeed()};
+
+        const QMap<QByteArray, NetifInfoPtr> netifs = deviceDB->netifInfoDB()->infoDB();
+        snapshot->m_netifs.reserve(netifs.size());
+        for (auto it = netifs.cbegin(); it != netifs.cend(); ++it) {
+            if (it.value())
+                snapshot->m_netifs << netif_metrics_t {it.key(), it.value()->rxBytes(), it.value()->txBytes()};
+        }
+    }
+
+    if (processSet && previous && previous->m_processDelta.seq == processSet->lastDelta().seq) {
+        // counters are collected more often than processes, the arrays are shared, not copied
+        snapshot->m_processes = previous->m_processes;
+        snapshot->m_processTexts = previous->m_processTexts;
+        snapshot->m_processIndex = previous->m_processIndex;
+        snapshot->m_processCapturedNs = previous->m_processCapturedNs;
+        snapshot->m_processDelta = previous->m_processDelta;
+        snapshot->m_appCount = previous->m_appCount;
+        snapshot->m_procCount = previous->m_procCount;
+    } else if (processSet) {
+        snapshot->m_processCapturedNs = snapshot->m_capturedNs;
+        const QList<pid_t> pids = processSet->getPIDList();
+        snapshot->m_processes.reserve(pids.size());
+        snapshot->m_processTexts.reserve(pids.size());
+        snapshot->m_processIndex.reserve(pids.size());
+        for (pid_t pid : pids) {
+            const Process proc = processSet->getProcessById(pid);
+            if (proc.isValid())
+                snapshot->addProcess(proc);
+        }
+        snapshot->m_processDelta = processSet->lastDelta();
+        snapshot->m_appCount = processSet->appCount();
+        snapshot->m_procCount = processSet->processCount();
+    }
+
+    return snapshot;
+}
+
+void SystemSnapshot::addProcess(const Process &proc)
+{
+    process_metrics_t metrics;
+    metrics.pid = proc.pid();
+    metrics.ppid = proc.ppid();
+    metrics.uid = proc.uid();
+    metrics.priority = proc.priority();
+    metrics.appType = proc.appType();
+    metrics.state = proc.state();
+    metrics.cpu = proc.cpu();
+    metrics.memory = proc.memory();
+    metrics.sharedMemory = proc.sharememory();
+    metrics.virtualMemory = proc.vtrmemory();
+    metrics.readBps = proc.readBps();
+    metrics.writeBps = proc.writeBps();
+    metrics.recvBps = proc.recvBps();
+    metrics.sentBps = proc.sentBps();
+    metrics.gpu = proc.gpu();
+    metrics.gpuMemory = proc.gpuMemory();
+
+    // strings & icon data are shared with the process, nothing is deep copied
+    m_processIndex.insert(metrics.pid, m_processes.size());
+    m_processes << metrics;
+    m_processTexts << process_text_t {proc.name(), proc.displayName(), proc.userName(), proc.cmdline(), proc.iconData()};
+}
+
+} // namespace system
+} // namespace core
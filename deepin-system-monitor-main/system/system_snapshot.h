@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SYSTEM_SNAPSHOT_H
+#define SYSTEM_SNAPSHOT_H
+
+#include "cpu.h"
+#include "sys_info.h"
+#include "process/pid_index.h"
+#include "process/process_set.h"
+
+#include <QByteArrayList>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+#include <sys/time.h>
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+struct icon_data_t;
+} // namespace process
+
+namespace system {
+
+class DeviceDB;
+
+/**
+ * @brief Displayed values of a process
+ */
+struct process_metrics_t {
+    pid_t pid {0};
+    pid_t ppid {0};
+    uid_t uid {0};
+    int priority {0};
+    int appType {0};
+    char state {0};
+    qreal cpu {0}; // percent
+    qulonglong memory {0}; // KB
+    qulonglong sharedMemory {0}; // KB
+    qulonglong virtualMemory {0}; // KB
+    qreal readBps {0};
+    qreal writeBps {0};
+    qreal recvBps {0};
+    qreal sentBps {0};
+    qreal gpu {0}; // percent
+    qulonglong gpuMemory {0}; // B
+};
+
+/**
+ * @brief Names & icon of a process, kept apart from the metrics summed over all processes
+ */
+struct process_text_t {
+    QString name;
+    QString displayName;
+    QString userName;
+    QByteArrayList cmdline; // joined on demand, only tooltips show it
+    std::shared_ptr<const core::process::icon_data_t> icon; // QIcon built by ProcessIcon::iconOf() on the GUI thread
+};
+
+struct block_dev_metrics_t {
+    QByteArray name;
+    quint64 readBps {0};
+    quint64 writeBps {0};
+};
+
+struct netif_metrics_t {
+    QByteArray name;
+    qulonglong rxBytes {0};
+    qulonglong txBytes {0};
+};
+
+/**
+ * @brief Values collected by one SystemMonitor tick
+ *
+ * Built on the monitor thread once the collectors of the tick ran, then published immutable: readers on
+ * any thread hold a reference & never see a half updated tick, the collectors keep mutating their own
+ * objects for the next one. Processes are stored in two flat arrays indexed alike, located by pid through
+ * indexOf().
+ */
+class SystemSnapshot
+{
+public:
+    SystemSnapshot();
+
+    /**
+     * @brief Copy the current values of sysInfo, deviceDB & processSet, on the monitor thread
+     * @param seq publication sequence number
+     * @param previous snapshot published before, its process arrays are shared when no scan ran since
+     */
+    static std::shared_ptr<SystemSnapshot> capture(quint64 seq,
+                                                   const SysInfo *sysInfo,
+                                                   DeviceDB *deviceDB,
+                                                   const core::process::ProcessSet *processSet,
+                                                   const SystemSnapshot *previous = nullptr);
+
+    /**
+     * @brief Append proc to the process arrays, only while the snapshot is built
+     */
+    void addProcess(const core::process::Process &proc);
+
+    inline quint64 seq() const
+    {
+        return m_seq;
+    }
+    /**
+     * @brief CLOCK_MONOTONIC time the snapshot was built at, in ns
+     */
+    inline quint64 capturedNs() const
+    {
+        return m_capturedNs;
+    }
+    /**
+     * @brief CLOCK_MONOTONIC time the process arrays were read at, older than capturedNs() when shared
+     */
+    inline quint64 processCapturedNs() const
+    {
+        return m_processCapturedNs;
+    }
+
+    inline const timeval &uptime() const
+    {
+        return m_uptime;
+    }
+    inline const load_avg_t &loadAvg() const
+    {
+        return m_loadAvg;
+    }
+    inline quint32 nprocesses() const
+    {
+        return m_nprocesses;
+    }
+    inline quint32 nthreads() const
+    {
+        return m_nthreads;
+    }
+    inline quint32 nfds() const
+    {
+        return m_nfds;
+    }
+
+    inline const cpu_stat_t &cpuStat() const
+    {
+        return m_cpuStat;
+    }
+    inline const cpu_usage_t &cpuUsage() const
+    {
+        return m_cpuUsage;
+    }
+    /**
+     * @brief Usage of each logical cpu, in cpu name order
+     */
+    inline const QVector<cpu_usage_t> &cpuUsages() const
+    {
+        return m_cpuUsages;
+    }
+
+    inline const QVector<block_dev_metrics_t> &blockDevices() const
+    {
+        return m_blockDevices;
+    }
+    inline const QVector<netif_metrics_t> &netifs() const
+    {
+        return m_netifs;
+    }
+
+    inline int processCount() const
+    {
+        return m_processes.size();
+    }
+    inline const process_metrics_t &process(int i) const
+    {
+        return m_processes.at(i);
+    }
+    inline const process_text_t &processText(int i) const
+    {
+        return m_processTexts.at(i);
+    }
+    /**
+     * @return index of process pid, -1 if it is not in the snapshot
+     */
+    inline int indexOf(pid_t pid) const
+    {
+        return m_processIndex.value(pid, -1);
+    }
+    inline const QVector<process_metrics_t> &processes() const
+    {
+        return m_processes;
+    }
+
+    /**
+     * @brief Processes changed by the last process scan, its seq does not move on ticks without a scan
+     */
+    inline const core::process::ProcessSetDelta &processDelta() const
+    {
+        return m_processDelta;
+    }
+    /**
+     * @brief Number of applications & processes counted by the last process scan
+     */
+    inline int appCount() const
+    {
+        return m_appCount;
+    }
+    inline int procCount() const
+    {
+        return m_procCount;
+    }
+
+private:
+    quint64 m_seq;
+    quint64 m_capturedNs;
+    quint64 m_processCapturedNs;
+
+    timeval m_uptime;
+    load_avg_t m_loadAvg;
+    quint32 m_nprocesses;
+    quint32 m_nthreads;
+    quint32 m_nfds;
+
+    cpu_stat_t m_cpuStat;
+    cpu_usage_t m_cpuUsage;
+    QVector<cpu_usage_t> m_cpuUsages;
+
+    QVector<block_dev_metrics_t> m_blockDevices;
+    QVector<netif_metrics_t> m_netifs;
+
+    QVector<process_metrics_t> m_processes;
+    QVector<process_text_t> m_processTexts;
+    core::process::PidIndex<int> m_processIndex; // pid -> index in the process arrays
+    core::process::ProcessSetDelta m_processDelta;
+    int m_appCount;
+    int m_procCount;
+};
+
+using SystemSnapshotPtr = std::shared_ptr<const SystemSnapshot>;
+
+} // namespace system
+} // namespace core
+
+#endif // SYSTEM_SNAPSHOT_H
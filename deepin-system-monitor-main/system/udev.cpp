@@ -29,5 +29,51 @@ UDev::~UDev()
     }
 }
 
+UDevMonitor::UDevMonitor(const UDev *udev, const char *subsystem)
+    : m_monitor(nullptr)
+{
+    qCDebug(app) << "Creating UDevMonitor for subsystem" << subsystem;
+    if (!udev || !udev->handle()) {
+        qCWarning(app) << "No udev context, monitor for" << subsystem << "disabled";
+        return;
+    }
+
+    // events processed by udevd, the socket is created non-blocking
+    m_monitor = udev_monitor_new_from_netlink(udev->handle(), "udev");
+    if (!m_monitor) {
+        qCWarning(app) << "Failed to create udev monitor for subsystem" << subsystem;
+        return;
+    }
+    if (udev_monitor_filter_add_match_subsystem_devtype(m_monitor, subsystem, nullptr) < 0
+            || udev_monitor_enable_receiving(m_monitor) < 0) {
+        qCWarning(app) << "Failed to enable udev monitor for subsystem" << subsystem;
+        udev_monitor_unref(m_monitor);
+        m_monitor = nullptr;
+    }
+}
+
+UDevMonitor::~UDevMonitor()
+{
+    qCDebug(app) << "Destroying UDevMonitor object";
+    if (m_monitor) {
+        udev_monitor_unref(m_monitor);
+    }
+}
+
+int UDevMonitor::pendingEvents()
+{
+    if (!m_monitor)
+        return 0;
+
+    int n = 0;
+    struct udev_device *dev;
+    while ((dev = udev_monitor_receive_device(m_monitor))) {
+        qCDebug(app) << "udev event" << udev_device_get_action(dev) << "on" << udev_device_get_syspath(dev);
+        udev_device_unref(dev);
+        ++n;
+    }
+    return n;
+}
+
 } // namespace system
 } // namespace core
@@ -11,6 +11,7 @@
 #include <memory>
 
 struct udev;
+struct udev_monitor;
 
 namespace core {
 namespace system {
@@ -52,6 +53,39 @@ inline UDev::HANDLE UDev::handle() const
     return m_udev;
 }
 
+/**
+ * @brief Non-blocking listener of udev events of one subsystem
+ *
+ * Events are not dispatched, callers poll pendingEvents() from their own refresh loop.
+ */
+class UDevMonitor
+{
+public:
+    using HANDLE = struct udev_monitor *;
+
+    explicit UDevMonitor(const UDev *udev, const char *subsystem);
+    virtual ~UDevMonitor();
+
+    UDevMonitor(const UDevMonitor &) = delete;
+    UDevMonitor &operator=(const UDevMonitor &) = delete;
+
+    bool isValid() const;
+
+    /**
+     * @brief Drain queued events
+     * @return number of events received since the last call
+     */
+    int pendingEvents();
+
+private:
+    HANDLE m_monitor;
+};
+
+inline bool UDevMonitor::isValid() const
+{
+    return m_monitor != nullptr;
+}
+
 } // namespace system
 } // namespace core
 
@@ -190,6 +190,12 @@ void WMWindowList::removeDesktopEntryApp(pid_t pid)
     m_desktopEntryCache.removeAll(pid);
 }
 
+WMWId WMWindowList::getWindowId(pid_t pid) const
+{
+    auto search = m_guiAppcache.find(pid);
+    return search != m_guiAppcache.end() ? search->second->winId : WMWId(XCB_WINDOW_NONE);
+}
+
 QImage WMWindowList::getWindowIcon(pid_t pid) const
 {
     qCDebug(app) << "Getting window icon for pid:" << pid;
@@ -323,6 +329,12 @@ void WMWindowList::updateWindowListCache()
     if (!reply)
         return;
 
+    // windows listed before, to tell whether the list changed
+    std::vector<std::pair<pid_t, WMWId>> windows;
+    windows.reserve(m_guiAppcache.size());
+    for (const auto &it : m_guiAppcache)
+        windows.emplace_back(it.first, it.second->winId);
+
     m_guiAppcache.clear();
     const xcb_get_property_reply_t *R = reply.get();
     xcb_window_t *clientList = reinterpret_cast<xcb_window_t *>(xcb_get_property_value(R));
@@ -337,6 +349,14 @@ void WMWindowList::updateWindowListCache()
         }
     }
 
+    // both are ordered by pid
+    bool changed = windows.size() != m_guiAppcache.size();
+    auto prev = windows.cbegin();
+    for (auto it = m_guiAppcache.cbegin(); !changed && it != m_guiAppcache.cend(); ++it, ++prev)
+        changed = prev->first != it->first || prev->second != it->second->winId;
+    if (changed)
+        m_generation++;
+
     m_trayAppcache.clear();
     const QList<WMWId> &trayWndList = getTrayWindows();
     for (auto i = 0; i < trayWndList.size(); i++) {
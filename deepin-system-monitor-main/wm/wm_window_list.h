@@ -43,6 +43,10 @@ public:
     int getAppCount();
 
     QImage getWindowIcon(pid_t pid) const;
+    /**
+     * @return window listed for pid, XCB_WINDOW_NONE if it has none
+     */
+    WMWId getWindowId(pid_t pid) const;
     QString getWindowTitle(pid_t pid) const;
 
     bool isTrayApp(pid_t pid) const;
@@ -52,6 +56,13 @@ public:
 
     void removeDesktopEntryApp(pid_t pid);
     void updateWindowListCache();
+    /**
+     * @brief Bumped by updateWindowListCache() when the listed windows or their pids changed
+     */
+    inline quint64 generation() const
+    {
+        return m_generation;
+    }
 
 private:
     QList<WMWId> getTrayWindows() const;
@@ -66,6 +77,7 @@ private:
 
     QList<pid_t> m_desktopEntryCache;
     WMConnection m_conn;
+    quint64 m_generation {0};
 };
 
 } // namespace wm
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dkapture_shm_writer.h"
+#include "ddlog.h"
+
+#include <QDebug>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+DKaptureShmWriter::DKaptureShmWriter(quint32 slotCount, quint32 slotRecords)
+    : m_fd(-1)
+    , m_roFd(-1)
+    , m_base(nullptr)
+    , m_size(dkShmSize(slotCount, slotRecords))
+    , m_slotRecords(slotRecords)
+    , m_seq(0)
+    , m_slot(nullptr)
+{
+    m_fd = memfd_create("dkapture-proc", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (m_fd < 0) {
+        qCWarning(DDLog::app) << "SystemServer: memfd_create failed:" << strerror(errno);
+        return;
+    }
+
+    if (ftruncate(m_fd, off_t(m_size)) < 0) {
+        qCWarning(DDLog::app) << "SystemServer: failed to size DKapture segment:" << strerror(errno);
+        return;
+    }
+
+    // the writable mapping must exist before F_SEAL_FUTURE_WRITE, it is the only one allowed afterwards
+    void *base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        qCWarning(DDLog::app) << "SystemServer: failed to map DKapture segment:" << strerror(errno);
+        return;
+    }
+
+    // a client reopening its descriptor through /proc read write can neither write nor resize the segment
+    if (fchmod(m_fd, S_IRUSR | S_IRGRP | S_IROTH) < 0
+        || fcntl(m_fd, F_ADD_SEALS, DKAPTURE_SHM_SEALS | F_SEAL_SEAL) < 0) {
+        qCWarning(DDLog::app) << "SystemServer: failed to seal DKapture segment:" << strerror(errno);
+        munmap(base, m_size);
+        return;
+    }
+
+    // a second open file description with read only access, handed over to clients
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", m_fd);
+    m_roFd = open(path, O_RDONLY | O_CLOEXEC);
+    if (m_roFd < 0) {
+        qCWarning(DDLog::app) << "SystemServer: failed to reopen DKapture segment read only:" << strerror(errno);
+        munmap(base, m_size);
+        return;
+    }
+    m_base = base;
+
+    dk_shm_header_t *hdr = static_cast<dk_shm_header_t *>(m_base);
+    hdr->magic = DKAPTURE_SHM_MAGIC;
+    hdr->version = DKAPTURE_SHM_VERSION;
+    hdr->recordSize = sizeof(dk_proc_record_t);
+    hdr->slotCount = slotCount;
+    hdr->slotRecords = slotRecords;
+    hdr->size = m_size;
+
+    // sequence numbers must not repeat after a restart of the server, a client may still map the old segment
+    struct timespec ts {};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    m_seq = quint64(ts.tv_sec) * 1000000000ULL + quint64(ts.tv_nsec);
+
+    qCInfo(DDLog::app) << "SystemServer: DKapture segment of" << m_size << "bytes," << slotCount << "x" << slotRecords << "records";
+}
+
+DKaptureShmWriter::~DKaptureShmWriter()
+{
+    if (m_base)
+        munmap(m_base, m_size);
+    if (m_roFd >= 0)
+        close(m_roFd);
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+dk_proc_record_t *DKaptureShmWriter::beginBatch()
+{
+    if (!m_base)
+        return nullptr;
+
+    const dk_shm_header_t *hdr = static_cast<const dk_shm_header_t *>(m_base);
+    m_slot = dkShmSlot(m_base, hdr, m_seq + 1);
+    m_slot->seq.store(0, std::memory_order_relaxed);
+    // readers of the old batch must see the slot busy before any record changes
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return dkShmRecords(m_slot);
+}
+
+quint64 DKaptureShmWriter::commit(quint32 count, quint32 dropped)
+{
+    if (!m_slot)
+        return 0;
+
+    m_slot->count = qMin(count, m_slotRecords);
+    m_slot->dropped = dropped;
+    m_slot->seq.store(++m_seq, std::memory_order_release);
+    m_slot = nullptr;
+    return m_seq;
+}
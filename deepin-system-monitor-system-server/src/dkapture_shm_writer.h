@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DKAPTURE_SHM_WRITER_H
+#define DKAPTURE_SHM_WRITER_H
+
+#include "dkapture_shm.h"
+
+#include <sys/types.h>
+
+/**
+ * @brief Writer side of the DKapture process record memfd, see dkapture_shm.h
+ *
+ * The segment is sealed against resizing and, once the server mapped it, against writes
+ * (F_SEAL_FUTURE_WRITE). Clients get a descriptor opened read only; reopening it read write
+ * through /proc neither lets them write the records nor truncate the mapping under the server.
+ */
+class DKaptureShmWriter
+{
+public:
+    explicit DKaptureShmWriter(quint32 slotCount = DKAPTURE_SHM_SLOTS, quint32 slotRecords = DKAPTURE_SHM_SLOT_RECORDS);
+    ~DKaptureShmWriter();
+
+    DKaptureShmWriter(const DKaptureShmWriter &) = delete;
+    DKaptureShmWriter &operator=(const DKaptureShmWriter &) = delete;
+
+    inline bool isValid() const
+    {
+        return m_base != nullptr;
+    }
+    /**
+     * @brief Read only descriptor of the segment, to be handed over D-Bus
+     */
+    inline int readOnlyFd() const
+    {
+        return m_roFd;
+    }
+    inline quint32 capacity() const
+    {
+        return m_slotRecords;
+    }
+
+    /**
+     * @brief Start writing the next batch, its slot is marked busy until commit()
+     * @return Record array of the slot, capacity() entries
+     */
+    dk_proc_record_t *beginBatch();
+    /**
+     * @brief Publish the batch started by beginBatch()
+     * @return Sequence number of the batch
+     */
+    quint64 commit(quint32 count, quint32 dropped);
+
+private:
+    int m_fd;
+    int m_roFd;
+    void *m_base;
+    size_t m_size;
+    quint32 m_slotRecords;
+    quint64 m_seq;
+    dk_shm_slot_t *m_slot;
+};
+
+#endif // DKAPTURE_SHM_WRITER_H
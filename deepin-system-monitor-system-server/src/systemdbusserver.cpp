@@ -7,7 +7,8 @@
 
 #ifdef ENABLE_DKAPTURE
 #include "dkapture_manager.h"
-#include <QSet>
+#include <QHash>
+#include <QVector>
 #endif
 
 #include <QCoreApplication>
@@ -21,6 +22,8 @@
 
 #include <sys/sysinfo.h>
 #include <unistd.h>
+#include <string.h>
+#include <limits.h>
 #include <QStringList>
 #include <QDebug>
 #include <QRegularExpression>
@@ -267,6 +270,232 @@ bool SystemDBusServer::isDKaptureAvailable()
 #endif
 }
 
+#ifdef ENABLE_DKAPTURE
+namespace {
+// DKapture 回调上下文, 各数据表按 PID 合并进同一条记录
+struct DKaptureRecordContext {
+    const QSet<int> *targetPids; // 为空时保留全部线程组领头线程
+    dk_proc_record_t *records;
+    quint32 capacity;
+    quint32 count;
+    quint32 dropped;
+    QHash<int, quint32> index; // pid -> 记录下标, 记录已满时为 UINT_MAX
+    qulonglong hz;
+    qulonglong uptimeJiffies; // 0: 未知
+};
+} // namespace
+
+static int dkaptureRecordCallback(void *ctx, const void *data, size_t /*data_sz*/)
+{
+    DKaptureRecordContext *context = static_cast<DKaptureRecordContext *>(ctx);
+    const DKapture::DataHdr *hdr = static_cast<const DKapture::DataHdr *>(data);
+
+    // 只有目标进程的数据才返回给前端, 子线程的数据忽略
+    if (context->targetPids ? !context->targetPids->contains(hdr->pid) : hdr->pid != hdr->tgid)
+        return 0;
+
+    auto it = context->index.find(hdr->pid);
+    if (it == context->index.end()) {
+        if (context->count >= context->capacity) {
+            context->index.insert(hdr->pid, UINT_MAX);
+            context->dropped++;
+            return 0;
+        }
+        it = context->index.insert(hdr->pid, context->count);
+        dk_proc_record_t &rec = context->records[context->count++];
+        memset(&rec, 0, sizeof(rec));
+        rec.pid = hdr->pid;
+        rec.tgid = hdr->tgid;
+        memcpy(rec.comm, hdr->comm, qMin(sizeof(rec.comm), size_t(TASK_COMM_LEN)));
+    }
+    if (it.value() == UINT_MAX)
+        return 0;
+
+    dk_proc_record_t &rec = context->records[it.value()];
+    const char *payload = hdr->data;
+    switch (hdr->type) {
+    case DKapture::PROC_PID_STAT: {
+        const ProcPidStat *stat = reinterpret_cast<const ProcPidStat *>(payload);
+        rec.fields |= kDKFieldStat;
+        rec.state = stat->state;
+        rec.ppid = stat->ppid;
+
+        // CPU时间处理：不做增量计算，直接转换（除以10^7）
+        static const qulonglong DK_CONVERSION_FACTOR = 10000000ULL; // 10^7
+        qulonglong dk_utime = stat->utime / DK_CONVERSION_FACTOR;
+        qulonglong dk_stime = stat->stime / DK_CONVERSION_FACTOR;
+
+        // Convert back to jiffies for frontend compatibility
+        rec.utime = dk_utime * context->hz;
+        rec.stime = dk_stime * context->hz;
+        rec.cutime = stat->cutime / DK_CONVERSION_FACTOR * context->hz;
+        rec.cstime = stat->cstime / DK_CONVERSION_FACTOR * context->hz;
+
+        // Check for abnormal CPU time values that could cause overflow, allow 2x system uptime as buffer
+        if (context->uptimeJiffies && rec.utime + rec.stime > context->uptimeJiffies * 2) {
+            qCWarning(app) << "SystemServer: Abnormally large DKapture CPU time for PID" << hdr->pid
+                           << "- total CPU jiffies:" << rec.utime + rec.stime
+                           << "system uptime jiffies:" << context->uptimeJiffies
+                           << ". Data may be corrupted, setting to safe values.";
+            // CPU usage will be close to 0% rather than astronomical values
+            rec.utime = context->hz;
+            rec.stime = context->hz;
+            rec.cutime = 0;
+            rec.cstime = 0;
+        }
+        rec.cpu_time = dk_utime + dk_stime; // Keep original seconds for reference
+
+        rec.priority = stat->priority;
+        rec.nice = stat->nice;
+        rec.num_threads = stat->num_threads;
+        rec.start_time = stat->start_time;
+        rec.vsize = stat->vsize;
+        rec.rss = stat->rss;
+        break;
+    }
+    case DKapture::PROC_PID_IO: {
+        const ProcPidIo *io = reinterpret_cast<const ProcPidIo *>(payload);
+        rec.fields |= kDKFieldIo;
+        rec.rchar = io->rchar;
+        rec.wchar = io->wchar;
+        rec.syscr = io->syscr;
+        rec.syscw = io->syscw;
+        rec.read_bytes = io->read_bytes;
+        rec.write_bytes = io->write_bytes;
+        rec.cancelled_write_bytes = io->cancelled_write_bytes;
+        break;
+    }
+    case DKapture::PROC_PID_STATM: {
+        const ProcPidStatm *statm = reinterpret_cast<const ProcPidStatm *>(payload);
+        rec.fields |= kDKFieldStatm;
+        rec.memory_size = statm->size;
+        rec.memory_resident = statm->resident;
+        rec.memory_shared = statm->shared;
+        rec.memory_text = statm->text;
+        rec.memory_data = statm->data;
+        break;
+    }
+    case DKapture::PROC_PID_STATUS: {
+        const ProcPidStatus *status = reinterpret_cast<const ProcPidStatus *>(payload);
+        rec.fields |= kDKFieldStatus;
+        for (int i = 0; i < 4; ++i) {
+            rec.uid[i] = status->uid[i];
+            rec.gid[i] = status->gid[i];
+        }
+        rec.status_state = status->state;
+        rec.tracer_pid = status->tracer_pid;
+        rec.umask = status->umask;
+        break;
+    }
+    case DKapture::PROC_PID_SCHEDSTAT: {
+        const ProcPidSchedstat *schedstat = reinterpret_cast<const ProcPidSchedstat *>(payload);
+        // SchedStat数据：只传递rq_wait_time，与原有实现保持一致
+        rec.fields |= kDKFieldSchedstat;
+        rec.rq_wait_time = schedstat->rq_wait_time;
+        break;
+    }
+    default:
+        // 网络流量信息处理已禁用 - 前端使用传统方式获取网络数据
+        break;
+    }
+    return 0;
+}
+
+/**
+   @brief 记录转换为 getProcessInfoBatch() 返回的键值格式
+ */
+static QVariantMap recordToVariant(const dk_proc_record_t &rec)
+{
+    QVariantMap pidData;
+    pidData["pid"] = rec.pid;
+    pidData["tgid"] = rec.tgid;
+    pidData["comm"] = QString::fromUtf8(rec.comm, int(strnlen(rec.comm, sizeof(rec.comm))));
+
+    if (rec.fields & kDKFieldStat) {
+        pidData["state"] = rec.state;
+        pidData["ppid"] = rec.ppid;
+        // Store in jiffies for frontend compatibility
+        pidData["utime"] = static_cast<qulonglong>(rec.utime);
+        pidData["stime"] = static_cast<qulonglong>(rec.stime);
+        pidData["cutime"] = static_cast<qulonglong>(rec.cutime);
+        pidData["cstime"] = static_cast<qulonglong>(rec.cstime);
+        pidData["cpu_time"] = static_cast<qulonglong>(rec.cpu_time);
+        pidData["priority"] = rec.priority;
+        pidData["nice"] = rec.nice;
+        pidData["num_threads"] = rec.num_threads;
+        pidData["start_time"] = static_cast<qulonglong>(rec.start_time);
+        pidData["vsize"] = static_cast<qulonglong>(rec.vsize);
+        pidData["rss"] = static_cast<qulonglong>(rec.rss);
+    }
+    if (rec.fields & kDKFieldIo) {
+        pidData["rchar"] = static_cast<qulonglong>(rec.rchar);
+        pidData["wchar"] = static_cast<qulonglong>(rec.wchar);
+        pidData["syscr"] = static_cast<qulonglong>(rec.syscr);
+        pidData["syscw"] = static_cast<qulonglong>(rec.syscw);
+        pidData["read_bytes"] = static_cast<qulonglong>(rec.read_bytes);
+        pidData["write_bytes"] = static_cast<qulonglong>(rec.write_bytes);
+        pidData["cancelled_write_bytes"] = static_cast<qulonglong>(rec.cancelled_write_bytes);
+    }
+    if (rec.fields & kDKFieldStatm) {
+        pidData["memory_size"] = static_cast<qulonglong>(rec.memory_size);
+        pidData["memory_resident"] = static_cast<qulonglong>(rec.memory_resident);
+        pidData["memory_shared"] = static_cast<qulonglong>(rec.memory_shared);
+        pidData["memory_text"] = static_cast<qulonglong>(rec.memory_text);
+        pidData["memory_data"] = static_cast<qulonglong>(rec.memory_data);
+    }
+    if (rec.fields & kDKFieldStatus) {
+        // UID/GID信息 - 前端主要使用real uid/gid
+        pidData["uid"] = rec.uid[0];
+        pidData["euid"] = rec.uid[1];
+        pidData["suid"] = rec.uid[2];
+        pidData["fsuid"] = rec.uid[3];
+        pidData["gid"] = rec.gid[0];
+        pidData["egid"] = rec.gid[1];
+        pidData["sgid"] = rec.gid[2];
+        pidData["fsgid"] = rec.gid[3];
+        pidData["state_from_status"] = rec.status_state;
+        pidData["tracer_pid"] = rec.tracer_pid;
+        pidData["umask"] = rec.umask;
+    }
+    if (rec.fields & kDKFieldSchedstat) {
+        pidData["rq_wait_time"] = static_cast<qulonglong>(rec.rq_wait_time);
+    }
+    return pidData;
+}
+
+ssize_t SystemDBusServer::readProcessRecords(dk_proc_record_t *records, quint32 capacity, const QSet<int> *targetPids,
+                                             quint32 &count, quint32 &dropped)
+{
+    // 准备要获取的数据类型 - 禁用网络数据监听，前端使用传统方式
+    std::vector<DKapture::DataType> dataTypes = {
+        DKapture::PROC_PID_STAT,    // 基本进程信息
+        DKapture::PROC_PID_IO,      // I/O 信息
+        DKapture::PROC_PID_STATM,   // 内存信息
+        DKapture::PROC_PID_STATUS,  // 进程状态信息（UID/GID等）
+        DKapture::PROC_PID_SCHEDSTAT // 调度统计信息（cpu_time, rq_wait_time, timeslices）
+    };
+
+    DKaptureRecordContext context;
+    context.targetPids = targetPids;
+    context.records = records;
+    context.capacity = capacity;
+    context.count = 0;
+    context.dropped = 0;
+    context.index.reserve(targetPids ? targetPids->size() : 1024);
+    context.hz = qulonglong(sysconf(_SC_CLK_TCK));
+    // 系统运行时间每批读取一次, 用于检测异常的 CPU 时间
+    struct sysinfo si;
+    context.uptimeJiffies = sysinfo(&si) == 0 ? qulonglong(si.uptime) * context.hz : 0;
+
+    ssize_t bytesRead = m_dkaptureManager->read(dataTypes, dkaptureRecordCallback, &context);
+    count = context.count;
+    dropped = context.dropped;
+    if (dropped > 0)
+        qCWarning(app) << "SystemServer:" << dropped << "processes dropped, batch capacity" << capacity;
+    return bytesRead;
+}
+#endif
+
 QVariantMap SystemDBusServer::getProcessInfoBatch(const QList<int> &pids)
 {
     qCDebug(app) << "SystemServer: getProcessInfoBatch called for" << pids.size() << "PIDs";
@@ -285,222 +514,25 @@ QVariantMap SystemDBusServer::getProcessInfoBatch(const QList<int> &pids)
     }
 
     try {
-        QVariantMap processData;
-        
-        // 使用 DKapture 获取进程信息
         if (m_dkaptureManager) {
-            // 准备要获取的数据类型 - 禁用网络数据监听，前端使用传统方式
-            std::vector<DKapture::DataType> dataTypes = {
-                DKapture::PROC_PID_STAT,    // 基本进程信息
-                DKapture::PROC_PID_IO,      // I/O 信息
-                DKapture::PROC_PID_STATM,   // 内存信息
-                DKapture::PROC_PID_STATUS,  // 进程状态信息（UID/GID等）
-                DKapture::PROC_PID_SCHEDSTAT // 调度统计信息（cpu_time, rq_wait_time, timeslices）
-                // DKapture::PROC_PID_traffic  // 网络流量信息 - 已禁用，前端使用传统方式
-            };
-            
-            // 创建一个结构体来传递上下文
-            struct DKaptureContext {
-                QSet<int> targetPids;
-                QVariantMap *processData;
-                SystemDBusServer *server;
-            } context;
-
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-            context.targetPids = QSet<int>(pids.begin(), pids.end());
+            QSet<int> targetPids(pids.begin(), pids.end());
 #else
-            context.targetPids = QSet<int>::fromList(pids);
+            QSet<int> targetPids = QSet<int>::fromList(pids);
 #endif
-            context.processData = &processData;
-            context.server = this;
-            
-            // 设置回调函数来处理 DKapture 数据
-            auto callback = [](void *ctx, const void *data, size_t /*data_sz*/) -> int {
-                DKaptureContext *context = static_cast<DKaptureContext *>(ctx);
-                const DKapture::DataHdr *hdr = static_cast<const DKapture::DataHdr *>(data);
-                
-                // qCDebug(app) << "SystemServer: DKapture callback called for PID" << hdr->pid << "type" << hdr->type;
-                
-                // 检查是否为目标PID
-                bool isTargetPid = context->targetPids.contains(hdr->pid);
-                if (!isTargetPid) {
-                    // 对于子线程或子程序，记录基本信息但不立即打印详细数据
-                    // 详细数据将在处理完成后统一格式化输出
-                }
-                
-                QString pidKey = QString::number(hdr->pid);
-                QVariantMap pidData;
-                
-                // 如果已有此 PID 的数据，则获取它
-                if (context->processData->contains(pidKey)) {
-                    pidData = context->processData->value(pidKey).toMap();
-                } else {
-                    pidData["pid"] = hdr->pid;
-                    pidData["tgid"] = hdr->tgid;
-                    pidData["comm"] = QString::fromUtf8(hdr->comm, TASK_COMM_LEN);
-                }
-                
-
-                
-                // 根据数据类型解析数据
-                const char *payload = hdr->data;
-                switch (hdr->type) {
-                    case DKapture::PROC_PID_STAT: {
-                        // qCDebug(app) << "SystemServer: Processing STAT for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidStat *stat = reinterpret_cast<const ProcPidStat *>(payload);
-                        // qCDebug(app) << "SystemServer: STAT raw data - vsize:" << stat->vsize << "rss:" << stat->rss;
-    
-
-                        pidData["state"] = stat->state;
-                        pidData["ppid"] = stat->ppid;
-                        
-                        // CPU时间处理：不做增量计算，直接转换（除以10^7）
-                        static const qulonglong DK_CONVERSION_FACTOR = 10000000ULL; // 10^7
-                        
-                        qulonglong dk_utime = stat->utime / DK_CONVERSION_FACTOR;
-                        qulonglong dk_stime = stat->stime / DK_CONVERSION_FACTOR;
-                        qulonglong dk_cutime = stat->cutime / DK_CONVERSION_FACTOR;
-                        qulonglong dk_cstime = stat->cstime / DK_CONVERSION_FACTOR;
-
-                        // Convert back to jiffies for frontend compatibility
-                        // Frontend expects utime/stime in jiffies, not seconds
-                        long hz = sysconf(_SC_CLK_TCK);  // Get system HZ value
-                        qulonglong dk_utime_jiffies = dk_utime * hz;  // Convert seconds back to jiffies
-                        qulonglong dk_stime_jiffies = dk_stime * hz;
-                        qulonglong dk_cutime_jiffies = dk_cutime * hz;
-                        qulonglong dk_cstime_jiffies = dk_cstime * hz;
-                        
-                        // Check for abnormal CPU time values that could cause overflow
-                        // Use system uptime as a reasonable upper bound
-                        struct sysinfo si;
-                        if (sysinfo(&si) == 0) {
-                            qulonglong system_uptime_jiffies = si.uptime * hz;
-                            qulonglong total_cpu_jiffies = dk_utime_jiffies + dk_stime_jiffies;
-                            
-                            if (total_cpu_jiffies > system_uptime_jiffies * 2) { // Allow 2x system uptime as buffer
-                                qCWarning(app) << "SystemServer: Abnormally large DKapture CPU time for PID" << hdr->pid
-                                              << "- total CPU jiffies:" << total_cpu_jiffies 
-                                              << "system uptime jiffies:" << system_uptime_jiffies
-                                              << ". Data may be corrupted, setting to safe values.";
-                                
-                                // Set to very small values to prevent frontend calculation issues
-                                // This ensures CPU usage will be close to 0% rather than astronomical values
-                                dk_utime_jiffies = hz;  // 1 second worth of jiffies
-                                dk_stime_jiffies = hz;  // 1 second worth of jiffies  
-                                dk_cutime_jiffies = 0;
-                                dk_cstime_jiffies = 0;
-                            }
-                        }
-
-                        // Store in jiffies for frontend compatibility
-                        pidData["utime"] = dk_utime_jiffies;
-                        pidData["stime"] = dk_stime_jiffies;
-                        pidData["cutime"] = dk_cutime_jiffies;
-                        pidData["cstime"] = dk_cstime_jiffies;
-                        pidData["cpu_time"] = dk_utime + dk_stime; // Keep original seconds for reference
-                        
-
-                        pidData["priority"] = stat->priority;
-                        pidData["nice"] = stat->nice;
-                        pidData["num_threads"] = stat->num_threads;
-                        pidData["start_time"] = static_cast<qulonglong>(stat->start_time);
-                        pidData["vsize"] = static_cast<qulonglong>(stat->vsize);
-                        pidData["rss"] = static_cast<qulonglong>(stat->rss);
-                        break;
-                    }
-                    case DKapture::PROC_PID_IO: {
-                        // qCDebug(app) << "SystemServer: Processing IO for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidIo *io = reinterpret_cast<const ProcPidIo *>(payload);
-                        
-                        pidData["rchar"] = static_cast<qulonglong>(io->rchar);
-                        pidData["wchar"] = static_cast<qulonglong>(io->wchar);
-                        pidData["syscr"] = static_cast<qulonglong>(io->syscr);
-                        pidData["syscw"] = static_cast<qulonglong>(io->syscw);
-                        pidData["read_bytes"] = static_cast<qulonglong>(io->read_bytes);
-                        pidData["write_bytes"] = static_cast<qulonglong>(io->write_bytes);
-                        pidData["cancelled_write_bytes"] = static_cast<qulonglong>(io->cancelled_write_bytes);
-                        break;
-                    }
-                    case DKapture::PROC_PID_STATM: {
-                        // qCDebug(app) << "SystemServer: Processing STATM for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidStatm *statm = reinterpret_cast<const ProcPidStatm *>(payload);
-                        // qCDebug(app) << "SystemServer: STATM raw data - size:" << statm->size << "resident:" << statm->resident << "shared:" << statm->shared;
-    
+            QVector<dk_proc_record_t> records(targetPids.size());
+            quint32 count = 0, dropped = 0;
 
-                        pidData["memory_size"] = static_cast<qulonglong>(statm->size);
-                        pidData["memory_resident"] = static_cast<qulonglong>(statm->resident);
-                        pidData["memory_shared"] = static_cast<qulonglong>(statm->shared);
-                        pidData["memory_text"] = static_cast<qulonglong>(statm->text);
-                        pidData["memory_data"] = static_cast<qulonglong>(statm->data);
-                        break;
-                    }
-                    case DKapture::PROC_PID_STATUS: {
-                        // qCDebug(app) << "SystemServer: 🔍 Processing STATUS for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidStatus *status = reinterpret_cast<const ProcPidStatus *>(payload);
-                        
-                        // // 调试：输出原始STATUS数据
-                        // qCDebug(app) << "SystemServer: 📊 Raw STATUS data for PID" << hdr->pid 
-                        //             << "- uid[0-3]:" << status->uid[0] << status->uid[1] << status->uid[2] << status->uid[3]
-                        //             << "- gid[0-3]:" << status->gid[0] << status->gid[1] << status->gid[2] << status->gid[3]
-                        //             << "- state:" << (char)status->state << "- tracer_pid:" << status->tracer_pid;
-                        
-                        // UID/GID信息 - 前端主要使用real uid/gid
-                        pidData["uid"] = status->uid[0];        // real uid
-                        pidData["euid"] = status->uid[1];       // effective uid  
-                        pidData["suid"] = status->uid[2];       // saved uid
-                        pidData["fsuid"] = status->uid[3];      // filesystem uid
-                        pidData["gid"] = status->gid[0];        // real gid
-                        pidData["egid"] = status->gid[1];       // effective gid
-                        pidData["sgid"] = status->gid[2];       // saved gid
-                        pidData["fsgid"] = status->gid[3];      // filesystem gid
-                        
-                        // 进程状态和调试信息
-                        pidData["state_from_status"] = status->state;
-                        pidData["tracer_pid"] = status->tracer_pid;
-                        pidData["umask"] = status->umask;
-                        
-                        // qCDebug(app) << "SystemServer: ✅ STATUS data processed for PID" << hdr->pid 
-                        //             << "- final uid:" << pidData["uid"].toUInt() << "gid:" << pidData["gid"].toUInt();
-                        break;
-                    }
-                    case DKapture::PROC_PID_traffic: {
-                        // 网络流量信息处理已禁用 - 前端将使用传统方式获取网络数据
-                        // 这样可以避免DKapture系统级流量vs传统用户态socket流量的数据量差异问题
-                        qCDebug(app) << "SystemServer: Skipping traffic data for PID" << hdr->pid << "- using traditional network monitoring";
-                        break;
-                    }
-                    case DKapture::PROC_PID_SCHEDSTAT: {
-                        // qCDebug(app) << "SystemServer: 🔍 Processing SCHEDSTAT for PID" << hdr->pid;
-                        const ProcPidSchedstat *schedstat = reinterpret_cast<const ProcPidSchedstat *>(payload);
-                        
-                        // SchedStat数据：只传递rq_wait_time，与原有实现保持一致
-                        pidData["rq_wait_time"] = static_cast<qulonglong>(schedstat->rq_wait_time);
-                        
-                        // qCDebug(app) << "SystemServer: ✅ SCHEDSTAT data processed for PID" << hdr->pid 
-                        //             << "- rq_wait_time:" << pidData["rq_wait_time"].toULongLong();
-                        break;
-                    }
-                    default:
-                        break;
-                }
-                
-                // 只有目标PID的数据才添加到结果中返回给前端
-                if (isTargetPid) {
-                    context->processData->insert(pidKey, pidData);
-                    // qCDebug(app) << "SystemServer: Updated target PID" << hdr->pid << "final keys:" << pidData.keys();
-                }
-                return 0;
-            };
-            
-            // 读取 DKapture 数据
             qCDebug(app) << "SystemServer: About to read DKapture data for" << pids.size() << "PIDs";
-            // qCDebug(app) << "SystemServer: Target PIDs:" << pids;
-            
-            ssize_t bytesRead = m_dkaptureManager->read(dataTypes, callback, &context);
-            
-            // qCDebug(app) << "SystemServer: DKapture read returned" << bytesRead << "bytes";
+            ssize_t bytesRead = readProcessRecords(records.data(), quint32(records.size()), &targetPids, count, dropped);
+
+            QVariantMap processData;
+            for (quint32 i = 0; i < count; ++i) {
+                const dk_proc_record_t &rec = records.at(int(i));
+                processData.insert(QString::number(rec.pid), recordToVariant(rec));
+            }
             qCDebug(app) << "SystemServer: Process data collected for" << processData.size() << "processes";
-            
+
             if (bytesRead >= 0) {
                 result["success"] = true;
                 result["data"] = processData;
@@ -524,3 +556,64 @@ QVariantMap SystemDBusServer::getProcessInfoBatch(const QList<int> &pids)
 
     return result;
 }
+
+/**
+   @brief 返回 DKapture 进程记录共享内存的只读描述符, 布局见 dkapture_shm.h
+ */
+QDBusUnixFileDescriptor SystemDBusServer::getProcessInfoShm()
+{
+    qCDebug(app) << "SystemServer: getProcessInfoShm called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable()) {
+        sendErrorReply(QDBusError::NotSupported, "DKapture not available");
+        return {};
+    }
+
+    if (!m_shmWriter)
+        m_shmWriter.reset(new DKaptureShmWriter());
+    if (!m_shmWriter->isValid()) {
+        sendErrorReply(QDBusError::Failed, "DKapture shared memory not available");
+        return {};
+    }
+    return QDBusUnixFileDescriptor(m_shmWriter->readOnlyFd());
+#else
+    sendErrorReply(QDBusError::NotSupported, "DKapture support not compiled");
+    return {};
+#endif
+}
+
+/**
+   @brief 读取一批 DKapture 数据写入共享内存
+   @return 批次序号, 失败返回 0
+ */
+qulonglong SystemDBusServer::updateProcessInfoShm()
+{
+    // 重置退出定时器
+    resetExitTimer();
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable() || !m_shmWriter || !m_shmWriter->isValid()) {
+        qCWarning(app) << "SystemServer: updateProcessInfoShm called without shared memory";
+        return 0;
+    }
+
+    dk_proc_record_t *records = m_shmWriter->beginBatch();
+    quint32 count = 0, dropped = 0;
+    ssize_t bytesRead = readProcessRecords(records, m_shmWriter->capacity(), nullptr, count, dropped);
+    // 失败时同样发布 (空) 批次, 槽不会停留在写入状态
+    quint64 seq = m_shmWriter->commit(bytesRead >= 0 ? count : 0, dropped);
+    if (bytesRead < 0) {
+        qCWarning(app) << "SystemServer: Failed to read DKapture data:" << bytesRead;
+        return 0;
+    }
+
+    qCDebug(app) << "SystemServer: DKapture batch" << seq << "with" << count << "processes";
+    return seq;
+#else
+    return 0;
+#endif
+}
@@ -7,6 +7,7 @@
 
 #include <QObject>
 #include <QDBusContext>
+#include <QDBusUnixFileDescriptor>
 #include <QTimer>
 #include <QVariantMap>
 #include <QMap>
@@ -14,6 +15,10 @@
 
 #ifdef ENABLE_DKAPTURE
 #include "dkapture_manager.h"
+#include "dkapture_shm_writer.h"
+
+#include <QSet>
+#include <memory>
 #endif
 
 class SystemDBusServer : public QObject, protected QDBusContext
@@ -34,7 +39,9 @@ public Q_SLOTS:
     // DKapture 相关方法
     bool isDKaptureAvailable();
     QVariantMap getProcessInfoBatch(const QList<int> &pids);
-
+    // 共享内存传输: 获取只读 memfd, 之后每次刷新只返回批次序号 (0 表示失败)
+    QDBusUnixFileDescriptor getProcessInfoShm();
+    qulonglong updateProcessInfoShm();
 
 private:
     QString setServiceEnableImpl(const QString &serviceName, bool enable);
@@ -48,8 +55,18 @@ private:
     QTimer m_timer;
 
 #ifdef ENABLE_DKAPTURE
+    /**
+       @brief 读取 DKapture 数据, 每进程合并为一条记录
+       @param targetPids 只保留这些进程, 为空指针时保留全部线程组领头线程
+       @return DKapture read 返回值, 失败为负数
+     */
+    ssize_t readProcessRecords(dk_proc_record_t *records, quint32 capacity, const QSet<int> *targetPids,
+                               quint32 &count, quint32 &dropped);
+
     DKaptureManager *m_dkaptureManager;
     bool m_dkaptureInitialized;
+    // 共享内存写端, 首次 getProcessInfoShm() 时创建
+    std::unique_ptr<DKaptureShmWriter> m_shmWriter;
     
     // 用于增量计算的数据结构
     struct ProcessDeltaData {
@@ -0,0 +1,259 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// bench_main.cpp 回放基准测试入口
+//
+//   deepin-system-monitor-bench record <dir>                     record the host's /proc & /sys into dir
+//   deepin-system-monitor-bench synth <dir> [--processes N] [--sockets N]
+//   deepin-system-monitor-bench replay <dir> [--ticks N] [--max-tick-ms MS]
+//   deepin-system-monitor-bench [matrix] [--ticks N] [--max-tick-ms MS]
+//   deepin-system-monitor-bench pids                             time the scan diff over 1k/10k/50k pids
+//
+// matrix replays synthetic snapshots of 1k/10k/50k processes & 100k sockets, each in its own process so
+// that peak RSS is measured per snapshot. A non zero exit status is returned if a replay fails or the mean
+// tick exceeds --max-tick-ms.
+
+#include "snapshot.h"
+#include "pid_delta.h"
+
+#include "application.h"
+#include "common/perf_stats.h"
+#include "common/source_root.h"
+#include "model/process_table_model.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "system/block_device_info_db.h"
+#include "system/cpu_set.h"
+#include "system/device_db.h"
+#include "system/mem.h"
+#include "system/socket_index.h"
+#include "system/sys_info.h"
+#include "system/system_monitor.h"
+
+#include <QCoreApplication>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include <functional>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// host path of our own status, not redirected to the snapshot
+#define PROC_PATH_SELF_STATUS "/proc/self/status"
+
+using namespace bench;
+using namespace common::perf;
+using namespace core::process;
+using namespace core::system;
+
+struct bench_args_t {
+    QString command;
+    QString dir;
+    int ticks = 20;
+    double maxTickMs = 0;
+    synthetic_spec_t spec {1000, 2000, 8, 2};
+};
+
+struct bench_collector_t {
+    const char *name;
+    std::function<void()> run;
+    PerfHistogram latency;
+    quint64 allocs = 0;
+    quint64 syscalls = 0;
+};
+
+static bool parseArgs(int argc, char *argv[], bench_args_t &args)
+{
+    int i = 1;
+    if (i < argc && argv[i][0] != '-')
+        args.command = argv[i++];
+    if (args.command.isEmpty())
+        args.command = "matrix";
+    if (args.command != "matrix" && args.command != "pids") {
+        if (i >= argc)
+            return false;
+        args.dir = argv[i++];
+    }
+
+    for (; i < argc; ++i) {
+        if (i + 1 >= argc)
+            return false;
+        const char *opt = argv[i];
+        const char *value = argv[++i];
+        if (!strcmp(opt, "--ticks"))
+            args.ticks = qMax(1, atoi(value));
+        else if (!strcmp(opt, "--max-tick-ms"))
+            args.maxTickMs = atof(value);
+        else if (!strcmp(opt, "--processes"))
+            args.spec.processes = qMax(1, atoi(value));
+        else if (!strcmp(opt, "--sockets"))
+            args.spec.sockets = qMax(0, atoi(value));
+        else
+            return false;
+    }
+    return args.command == "record" || args.command == "synth" || args.command == "replay" || args.command == "matrix"
+            || args.command == "pids";
+}
+
+// VmRSS or VmHWM of this process in kB
+static quint64 readRss(const char *field)
+{
+    char buf[4096];
+    int fd = open(PROC_PATH_SELF_STATUS, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0)
+        return 0;
+    buf[n] = '\0';
+    const char *p = strstr(buf, field);
+    return p ? strtoull(p + strlen(field), nullptr, 10) : 0;
+}
+
+static int replay(int argc, char *argv[], const bench_args_t &args)
+{
+    // roots are set before the monitor objects are created, they open their files once
+    common::source::setProcRoot(Snapshot::procRoot(args.dir).toLocal8Bit());
+    common::source::setSysRoot(Snapshot::sysRoot(args.dir).toLocal8Bit());
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    Application app(argc, argv);
+
+    SystemMonitor *monitor = SystemMonitor::instance();
+    DeviceDB *deviceDB = monitor->deviceDB();
+    SysInfo *sysInfo = monitor->sysInfo();
+    ProcessSet *processSet = monitor->processDB()->processSet();
+    ProcessTableModel model;
+    SocketIndex sockets;
+
+    bench_collector_t collectors[] = {
+        {"sys_info", [=]() { sysInfo->readSysInfo(); }, {}},
+        {"cpu_set", [=]() { deviceDB->cpuSet()->update(); }, {}},
+        {"mem_info", [=]() { deviceDB->memInfo()->readMemInfo(); }, {}},
+        {"block_devices", [=]() { deviceDB->blockDeviceInfoDB()->update(); }, {}},
+        {"sock_stat", [&sockets]() { SysInfo::readSockStat(sockets); }, {}},
+        {"process_set", [=]() { processSet->refresh(); }, {}},
+        {"snapshot", [=]() { monitor->publishSnapshot(); }, {}},
+        {"process_model", [&model]() { QMetaObject::invokeMethod(&model, "updateProcessListDelay", Qt::DirectConnection); }, {}},
+    };
+
+    const quint64 baseRss = readRss("VmRSS:");
+    // first tick loads the static info & fills the caches, reported on its own
+    quint64 start = PerfScope::monotonicNs();
+    for (bench_collector_t &collector : collectors)
+        collector.run();
+    const quint64 firstTickNs = PerfScope::monotonicNs() - start;
+
+    PerfHistogram ticks;
+    for (int tick = 0; tick < args.ticks; ++tick) {
+        quint64 tickStart = PerfScope::monotonicNs();
+        for (bench_collector_t &collector : collectors) {
+            quint64 allocs = PerfScope::threadAllocs();
+            quint64 syscalls = PerfScope::threadSyscalls();
+            quint64 begin = PerfScope::monotonicNs();
+            collector.run();
+            collector.latency.record(PerfScope::monotonicNs() - begin);
+            collector.syscalls += PerfScope::threadSyscallsSince(syscalls);
+            collector.allocs += PerfScope::threadAllocs() - allocs;
+        }
+        ticks.record(PerfScope::monotonicNs() - tickStart);
+    }
+
+    auto us = [](quint64 ns) { return double(ns) / 1000.; };
+    printf("snapshot %s: %d processes, %d sockets, %d ticks\n", qPrintable(args.dir), processSet->processCount(),
+           sockets.size(), args.ticks);
+    printf("%-14s %10s %10s %10s %10s %12s %14s\n", "collector", "mean_us", "p50_us", "p99_us", "max_us",
+           "allocs/tick", "syscalls/tick");
+    for (const bench_collector_t &collector : collectors) {
+        const PerfHistogram &latency = collector.latency;
+        const quint64 n = qMax<quint64>(latency.count(), 1);
+        printf("%-14s %10.1f %10.1f %10.1f %10.1f %12s %14.1f\n", collector.name, us(latency.sum() / n),
+               us(latency.percentile(50)), us(latency.percentile(99)), us(latency.max()),
+               PerfStats::allocsCounted() ? qPrintable(QString::number(double(collector.allocs) / n, 'f', 1)) : "-",
+               double(collector.syscalls) / n);
+    }
+    const double meanTickMs = double(ticks.sum()) / qMax<quint64>(ticks.count(), 1) / 1e6;
+    printf("tick: mean %.2f ms, p99 %.2f ms, first %.2f ms\n", meanTickMs, double(ticks.percentile(99)) / 1e6,
+           double(firstTickNs) / 1e6);
+    printf("rss: %llu kB before the first tick, peak %llu kB\n\n", baseRss, readRss("VmHWM:"));
+    fflush(stdout);
+
+    if (args.maxTickMs > 0 && meanTickMs > args.maxTickMs) {
+        fprintf(stderr, "mean tick %.2f ms exceeds the budget of %.2f ms\n", meanTickMs, args.maxTickMs);
+        return 2;
+    }
+    return 0;
+}
+
+static int matrix(int argc, char *argv[], const bench_args_t &args)
+{
+    QCoreApplication app(argc, argv);
+    struct Scenario {
+        const char *name;
+        int processes;
+        int sockets;
+    };
+    static const Scenario scenarios[] = {
+        {"1k processes", 1000, 2000},
+        {"10k processes", 10000, 20000},
+        {"50k processes", 50000, 50000},
+        {"100k sockets", 1000, 100000},
+    };
+
+    int failed = 0;
+    for (const Scenario &scenario : scenarios) {
+        QTemporaryDir dir;
+        synthetic_spec_t spec = args.spec;
+        spec.processes = scenario.processes;
+        spec.sockets = scenario.sockets;
+        printf("== %s ==\n", scenario.name);
+        fflush(stdout);
+        if (!dir.isValid() || !Snapshot::writeSynthetic(dir.path(), spec)) {
+            fprintf(stderr, "failed to write the %s snapshot\n", scenario.name);
+            ++failed;
+            continue;
+        }
+
+        QProcess replay;
+        replay.setProcessChannelMode(QProcess::ForwardedChannels);
+        QStringList replayArgs {"replay", dir.path(), "--ticks", QString::number(args.ticks)};
+        if (args.maxTickMs > 0)
+            replayArgs << "--max-tick-ms" << QString::number(args.maxTickMs);
+        replay.start(QCoreApplication::applicationFilePath(), replayArgs);
+        if (!replay.waitForFinished(-1) || replay.exitStatus() != QProcess::NormalExit || replay.exitCode() != 0) {
+            fprintf(stderr, "replay of the %s snapshot failed\n", scenario.name);
+            ++failed;
+        }
+    }
+    return failed > 0 ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    bench_args_t args;
+    if (!parseArgs(argc, argv, args)) {
+        fprintf(stderr,
+                "usage: %s record <dir>\n"
+                "       %s synth <dir> [--processes N] [--sockets N]\n"
+                "       %s replay <dir> [--ticks N] [--max-tick-ms MS]\n"
+                "       %s [matrix] [--ticks N] [--max-tick-ms MS]\n"
+                "       %s pids\n",
+                argv[0], argv[0], argv[0], argv[0], argv[0]);
+        return 1;
+    }
+
+    if (args.command == "record")
+        return Snapshot::recordHost(args.dir) ? 0 : 1;
+    if (args.command == "synth")
+        return Snapshot::writeSynthetic(args.dir, args.spec) ? 0 : 1;
+    if (args.command == "replay")
+        return replay(argc, argv, args);
+    if (args.command == "pids")
+        return benchPidDelta() ? 0 : 1;
+    return matrix(argc, argv, args);
+}
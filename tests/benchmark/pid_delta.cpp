@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pid_delta.h"
+
+#include "process/pid_index.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QVector>
+
+#include <stdio.h>
+
+using namespace core::process;
+
+namespace bench {
+
+static void makeScans(int n, QVector<pid_t> &pre, QVector<pid_t> &cur)
+{
+    pre.clear();
+    cur.clear();
+    for (int i = 0; i < n; ++i) {
+        pid_t pid = 10 + i * 3;
+        pre << pid;
+        if (i % 100 != 0)
+            cur << pid;
+    }
+    for (int i = 0; i < n / 100; ++i)
+        cur << pid_t(10 + n * 3 + i);
+}
+
+bool benchPidDelta()
+{
+    bool ok = true;
+    printf("%-8s %12s %12s %12s\n", "pids", "qlist_us", "qmap_us", "pid_index_us");
+    for (int n : {1000, 10000, 50000}) {
+        QVector<pid_t> pre, cur;
+        makeScans(n, pre, cur);
+        QElapsedTimer timer;
+
+        qint64 listNs = -1;
+        // quadratic, too slow to be worth waiting for with 50k processes
+        if (n <= 10000) {
+            QList<pid_t> preList, curList;
+            for (pid_t pid : pre)
+                preList << pid;
+            timer.start();
+            for (pid_t pid : cur)
+                if (!curList.contains(pid))
+                    curList << pid;
+            int removed = 0, added = 0;
+            for (pid_t pid : preList)
+                removed += !curList.contains(pid);
+            for (pid_t pid : curList)
+                added += !preList.contains(pid);
+            listNs = timer.nsecsElapsed();
+            ok &= removed == n / 100 && added == n / 100;
+        }
+
+        QMap<pid_t, int> map;
+        timer.start();
+        for (pid_t pid : cur)
+            map.insert(pid, pid);
+        int mapHits = 0;
+        for (pid_t pid : pre)
+            mapHits += map.contains(pid);
+        qint64 mapNs = timer.nsecsElapsed();
+        ok &= mapHits == n - n / 100;
+
+        PidSet preIndex, curIndex;
+        for (pid_t pid : pre)
+            preIndex.insert(pid);
+        timer.start();
+        for (pid_t pid : cur)
+            curIndex.insert(pid);
+        int removed = 0, added = 0;
+        for (pid_t pid : pre)
+            removed += !curIndex.contains(pid);
+        for (pid_t pid : cur)
+            added += !preIndex.contains(pid);
+        qint64 indexNs = timer.nsecsElapsed();
+        ok &= removed == n / 100 && added == n / 100;
+
+        if (listNs < 0)
+            printf("%-8d %12s %12.1f %12.1f\n", n, "-", double(mapNs) / 1000., double(indexNs) / 1000.);
+        else
+            printf("%-8d %12.1f %12.1f %12.1f\n", n, double(listNs) / 1000., double(mapNs) / 1000., double(indexNs) / 1000.);
+    }
+    fflush(stdout);
+    return ok;
+}
+
+} // namespace bench
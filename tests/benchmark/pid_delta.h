@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BENCH_PID_DELTA_H
+#define BENCH_PID_DELTA_H
+
+namespace bench {
+
+/**
+ * @brief Time the scan diff of ProcessSet over 1k/10k/50k pids
+ *
+ * The QList membership tests & QMap bookkeeping ProcessSet used before are timed against PidSet, 1% of the
+ * pids exit & as many start between the two scans.
+ * @return false if a method found a wrong delta
+ */
+bool benchPidDelta();
+
+} // namespace bench
+
+#endif // BENCH_PID_DELTA_H
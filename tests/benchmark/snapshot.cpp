@@ -0,0 +1,342 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "snapshot.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QDir>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// files of /proc/[pid] read by the process scan, environ is left out on purpose
+static const char *const kPidFiles[] = {"stat", "status", "statm", "cmdline", "io", "schedstat", "comm"};
+// global /proc files read by the collectors
+static const char *const kProcFiles[] = {"stat", "meminfo", "cpuinfo", "diskstats", "uptime", "loadavg",
+                                         "sys/fs/file-nr", "net/dev", "net/tcp", "net/tcp6", "net/udp", "net/udp6"};
+// cache attributes of /sys/devices/system/cpu/cpu[N]/cache/index[N]
+static const char *const kCacheFiles[] = {"level", "type", "size", "shared_cpu_list"};
+
+namespace bench {
+
+// mkdir -p
+static bool makeDirs(const QByteArray &path)
+{
+    if (mkdir(path.constData(), 0755) == 0 || errno == EEXIST)
+        return true;
+    return QDir().mkpath(QString::fromLocal8Bit(path));
+}
+
+static bool writeFile(const QByteArray &path, const QByteArray &content)
+{
+    int fd = open(path.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        int slash = path.lastIndexOf('/');
+        if (slash <= 0 || !makeDirs(path.left(slash)))
+            return false;
+        fd = open(path.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+    }
+    const char *p = content.constData();
+    size_t left = size_t(content.size());
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        p += n;
+        left -= size_t(n);
+    }
+    close(fd);
+    return left == 0;
+}
+
+// procfs & sysfs files report a size of 0, read them until eof
+static bool readFile(const QByteArray &path, QByteArray &content)
+{
+    int fd = open(path.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    content.clear();
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0)
+        content.append(buf, int(n));
+    close(fd);
+    return n == 0;
+}
+
+static void copyFile(const QByteArray &from, const QByteArray &to)
+{
+    QByteArray content;
+    if (readFile(from, content))
+        writeFile(to, content);
+}
+
+static void copyLink(const QByteArray &from, const QByteArray &to)
+{
+    char target[PATH_MAX];
+    ssize_t n = readlink(from.constData(), target, sizeof(target) - 1);
+    if (n <= 0)
+        return;
+    target[n] = '\0';
+    if (symlink(target, to.constData()) < 0 && errno == ENOENT) {
+        makeDirs(to.left(to.lastIndexOf('/')));
+        symlink(target, to.constData());
+    }
+}
+
+static bool isPid(const char *name)
+{
+    if (!*name)
+        return false;
+    for (; *name; ++name) {
+        if (!isdigit(*name))
+            return false;
+    }
+    return true;
+}
+
+QString Snapshot::procRoot(const QString &dir)
+{
+    return dir + "/proc";
+}
+
+QString Snapshot::sysRoot(const QString &dir)
+{
+    return dir + "/sys";
+}
+
+bool Snapshot::recordHost(const QString &dir)
+{
+    const QByteArray proc = procRoot(dir).toLocal8Bit();
+    const QByteArray sys = sysRoot(dir).toLocal8Bit();
+    if (!makeDirs(proc) || !makeDirs(sys)) {
+        qWarning() << "Failed to create snapshot directory" << dir;
+        return false;
+    }
+
+    for (const char *file : kProcFiles)
+        copyFile(QByteArray("/proc/") + file, proc + '/' + file);
+
+    int nprocs = 0;
+    DIR *procDir = opendir("/proc");
+    if (!procDir)
+        return false;
+    while (struct dirent *dp = readdir(procDir)) {
+        if (!isPid(dp->d_name))
+            continue;
+        const QByteArray from = QByteArray("/proc/") + dp->d_name;
+        const QByteArray to = proc + '/' + dp->d_name;
+        if (!makeDirs(to + "/fd"))
+            continue;
+        for (const char *file : kPidFiles)
+            copyFile(from + '/' + file, to + '/' + file);
+        writeFile(to + "/environ", {});
+
+        // fds of processes owned by other users are not readable
+        if (DIR *fdDir = opendir((from + "/fd").constData())) {
+            while (struct dirent *fp = readdir(fdDir)) {
+                if (isPid(fp->d_name))
+                    copyLink(from + "/fd/" + fp->d_name, to + "/fd/" + fp->d_name);
+            }
+            closedir(fdDir);
+        }
+        ++nprocs;
+    }
+    closedir(procDir);
+
+    const QByteArray cpuRoot("/sys/devices/system/cpu");
+    copyFile(cpuRoot + "/online", sys + "/devices/system/cpu/online");
+    QDir cpus(cpuRoot, "cpu[0-9]*", QDir::Name, QDir::Dirs);
+    for (const QString &cpu : cpus.entryList()) {
+        const QByteArray from = cpuRoot + '/' + cpu.toLatin1();
+        const QByteArray to = sys + "/devices/system/cpu/" + cpu.toLatin1();
+        copyFile(from + "/cpufreq/scaling_cur_freq", to + "/cpufreq/scaling_cur_freq");
+        for (int index = 0;; ++index) {
+            const QByteArray cache = "/cache/index" + QByteArray::number(index);
+            if (access((from + cache).constData(), F_OK) != 0)
+                break;
+            for (const char *file : kCacheFiles)
+                copyFile(from + cache + '/' + file, to + cache + '/' + file);
+        }
+    }
+
+    // /sys/block entries are links into /sys/devices, keep the links & the attributes of their targets
+    QDir blocks("/sys/block", {}, QDir::Name, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System);
+    for (const QString &block : blocks.entryList()) {
+        const QByteArray from = "/sys/block/" + block.toLocal8Bit();
+        const QByteArray to = sys + "/block/" + block.toLocal8Bit();
+        copyLink(from, to);
+        copyFile(from + "/size", to + "/size");
+        copyFile(from + "/device/model", to + "/device/model");
+    }
+
+    qInfo() << "Recorded" << nprocs << "processes into" << dir;
+    return true;
+}
+
+// a tcp/udp table of count sockets, in the format of /proc/net/{tcp,udp}[6]
+static QByteArray sockTable(int count, bool v6, quint64 &inode)
+{
+    QByteArray table;
+    table.reserve(160 * (count + 1));
+    table += "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n";
+    char line[256];
+    for (int i = 0; i < count; ++i) {
+        unsigned port = 1024 + unsigned(i % 60000);
+        unsigned peer = 0x0A000001u + unsigned(i / 60000);
+        if (v6) {
+            snprintf(line, sizeof(line),
+                     "%6d: 0000000000000000FFFF00000100007F:%04X 0000000000000000FFFF0000%08X:01BB 01 00000000:00000000 00:00000000 00000000  1000        0 %llu 1 0000000000000000 20 4 30 10 -1\n",
+                     i, port, peer, inode++);
+        } else {
+            snprintf(line, sizeof(line),
+                     "%4d: 0100007F:%04X %08X:01BB 01 00000000:00000000 00:00000000 00000000  1000        0 %llu 1 0000000000000000 20 4 30 10 -1\n",
+                     i, port, peer, inode++);
+        }
+        table += line;
+    }
+    return table;
+}
+
+bool Snapshot::writeSynthetic(const QString &dir, const synthetic_spec_t &spec)
+{
+    const QByteArray proc = procRoot(dir).toLocal8Bit();
+    const QByteArray sys = sysRoot(dir).toLocal8Bit();
+    if (!makeDirs(proc) || !makeDirs(sys)) {
+        qWarning() << "Failed to create snapshot directory" << dir;
+        return false;
+    }
+    const uid_t uid = getuid();
+    const gid_t gid = getgid();
+    char buf[1024];
+
+    // global counters
+    QByteArray stat;
+    snprintf(buf, sizeof(buf), "cpu  %d 0 %d %d 0 0 0 0 0 0\n", 1000 * spec.cpus, 500 * spec.cpus, 10000 * spec.cpus);
+    stat += buf;
+    for (int cpu = 0; cpu < spec.cpus; ++cpu) {
+        snprintf(buf, sizeof(buf), "cpu%d 1000 0 500 10000 0 0 0 0 0 0\n", cpu);
+        stat += buf;
+    }
+    snprintf(buf, sizeof(buf), "btime 1700000000\nprocesses %d\nprocs_running 1\nprocs_blocked 0\n", spec.processes);
+    stat += buf;
+    bool ok = writeFile(proc + "/stat", stat);
+
+    ok = ok && writeFile(proc + "/meminfo",
+                         "MemTotal:       16384000 kB\nMemFree:         8192000 kB\nMemAvailable:   12288000 kB\n"
+                         "Buffers:          256000 kB\nCached:          2048000 kB\nSwapCached:            0 kB\n"
+                         "Active:          4096000 kB\nInactive:        2048000 kB\nSwapTotal:       2048000 kB\n"
+                         "SwapFree:        2048000 kB\nDirty:               100 kB\nShmem:            128000 kB\n"
+                         "Slab:             256000 kB\nMapped:           512000 kB\n");
+    QByteArray cpuinfo;
+    for (int cpu = 0; cpu < spec.cpus; ++cpu) {
+        snprintf(buf, sizeof(buf),
+                 "processor\t: %d\nvendor_id\t: Synthetic\nmodel name\t: Synthetic CPU\ncpu MHz\t\t: 2400.000\n"
+                 "cache size\t: 16384 KB\nphysical id\t: 0\ncore id\t\t: %d\ncpu cores\t: %d\n\n",
+                 cpu, cpu, spec.cpus);
+        cpuinfo += buf;
+    }
+    ok = ok && writeFile(proc + "/cpuinfo", cpuinfo);
+    ok = ok && writeFile(proc + "/uptime", "86400.00 172800.00\n");
+    snprintf(buf, sizeof(buf), "0.50 0.40 0.30 1/%d %d\n", spec.processes, spec.processes);
+    ok = ok && writeFile(proc + "/loadavg", buf);
+    ok = ok && writeFile(proc + "/sys/fs/file-nr", "10240\t0\t9223372036854775807\n");
+    ok = ok && writeFile(proc + "/net/dev",
+                         "Inter-|   Receive                                                |  Transmit\n"
+                         " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n"
+                         "    lo: 1000 10 0 0 0 0 0 0 1000 10 0 0 0 0 0 0\n"
+                         "  eth0: 100000 100 0 0 0 0 0 0 50000 50 0 0 0 0 0 0\n");
+
+    // sockets: 60% tcp, 20% tcp6, 15% udp, 5% udp6
+    quint64 inode = 100000;
+    int tcp = spec.sockets * 60 / 100;
+    int tcp6 = spec.sockets * 20 / 100;
+    int udp = spec.sockets * 15 / 100;
+    int udp6 = spec.sockets - tcp - tcp6 - udp;
+    ok = ok && writeFile(proc + "/net/tcp", sockTable(tcp, false, inode));
+    ok = ok && writeFile(proc + "/net/tcp6", sockTable(tcp6, true, inode));
+    ok = ok && writeFile(proc + "/net/udp", sockTable(udp, false, inode));
+    ok = ok && writeFile(proc + "/net/udp6", sockTable(udp6, true, inode));
+
+    // disks
+    QByteArray diskstats;
+    for (int disk = 0; disk < spec.disks; ++disk) {
+        const QByteArray name = "sd" + QByteArray(1, char('a' + disk % 26));
+        snprintf(buf, sizeof(buf), "   8 %7d %s 10000 0 200000 3000 4000 0 80000 5000 0 6000 8000 0 0 0 0 0 0\n",
+                 disk * 16, name.constData());
+        diskstats += buf;
+        const QByteArray device = "devices/pci0000:00/0000:00:1f.2/ata" + QByteArray::number(disk + 1) + "/block/" + name;
+        ok = ok && writeFile(sys + '/' + device + "/size", "1953525168\n");
+        ok = ok && writeFile(sys + '/' + device + "/device/model", "SYNTHETIC DISK\n");
+        makeDirs(sys + "/block");
+        symlink(("../" + device).constData(), (sys + "/block/" + name).constData());
+    }
+    ok = ok && writeFile(proc + "/diskstats", diskstats);
+
+    // cpus
+    snprintf(buf, sizeof(buf), "0-%d\n", spec.cpus - 1);
+    ok = ok && writeFile(sys + "/devices/system/cpu/online", buf);
+    for (int cpu = 0; cpu < spec.cpus; ++cpu) {
+        const QByteArray cpuDir = sys + "/devices/system/cpu/cpu" + QByteArray::number(cpu);
+        ok = ok && writeFile(cpuDir + "/cpufreq/scaling_cur_freq", "2400000\n");
+        ok = ok && writeFile(cpuDir + "/cache/index0/level", "1\n");
+        ok = ok && writeFile(cpuDir + "/cache/index0/type", "Data\n");
+        ok = ok && writeFile(cpuDir + "/cache/index0/size", "32K\n");
+        ok = ok && writeFile(cpuDir + "/cache/index0/shared_cpu_list", QByteArray::number(cpu) + '\n');
+    }
+
+    // processes: a tree of fan out 4 under pid 1, sockets spread over their fds
+    int socketsPerProc = spec.processes > 0 ? qMin(spec.sockets / spec.processes, 64) : 0;
+    quint64 sockInode = 100000;
+    for (int pid = 1; ok && pid <= spec.processes; ++pid) {
+        const QByteArray pidDir = proc + '/' + QByteArray::number(pid);
+        int ppid = pid == 1 ? 0 : qMax(1, pid / 4);
+        const QByteArray comm = "synth-" + QByteArray::number(pid % 500);
+
+        ok = makeDirs(pidDir) && makeDirs(pidDir + "/fd");
+        snprintf(buf, sizeof(buf),
+                 "%d (%s) S %d %d %d 0 -1 4194560 1000 0 10 0 %d %d 0 0 20 0 %d 0 %d 100000000 2000 "
+                 "18446744073709551615 1 1 0 0 0 0 0 4096 0 0 0 0 17 %d 0 0 0 0 0\n",
+                 pid, comm.constData(), ppid, pid, pid, 100 + pid % 50, 50 + pid % 20, 1 + pid % 8, 1000 + pid,
+                 pid % qMax(spec.cpus, 1));
+        ok = ok && writeFile(pidDir + "/stat", buf);
+        snprintf(buf, sizeof(buf),
+                 "Name:\t%s\nUmask:\t0022\nState:\tS (sleeping)\nTgid:\t%d\nNgid:\t0\nPid:\t%d\nPPid:\t%d\n"
+                 "TracerPid:\t0\nUid:\t%u\t%u\t%u\t%u\nGid:\t%u\t%u\t%u\t%u\nFDSize:\t64\nThreads:\t%d\n",
+                 comm.constData(), pid, pid, ppid, uid, uid, uid, uid, gid, gid, gid, gid, 1 + pid % 8);
+        ok = ok && writeFile(pidDir + "/status", buf);
+        ok = ok && writeFile(pidDir + "/statm", "25000 2000 1000 10 0 3000 0\n");
+        ok = ok && writeFile(pidDir + "/cmdline", "/usr/bin/" + comm + QByteArray("\0--synthetic\0", 13));
+        ok = ok && writeFile(pidDir + "/environ", {});
+        ok = ok && writeFile(pidDir + "/comm", comm + '\n');
+        snprintf(buf, sizeof(buf),
+                 "rchar: %d\nwchar: %d\nsyscr: 100\nsyscw: 50\nread_bytes: %d\nwrite_bytes: %d\ncancelled_write_bytes: 0\n",
+                 pid * 1000, pid * 500, pid * 4096, pid * 2048);
+        ok = ok && writeFile(pidDir + "/io", buf);
+        ok = ok && writeFile(pidDir + "/schedstat", "1000000 2000000 30\n");
+
+        for (int fd = 0; fd < 3 + socketsPerProc; ++fd) {
+            const QByteArray target = fd < 3 ? QByteArray("/dev/null") : "socket:[" + QByteArray::number(sockInode++) + ']';
+            symlink(target.constData(), (pidDir + "/fd/" + QByteArray::number(fd)).constData());
+        }
+    }
+
+    if (!ok)
+        qWarning() << "Failed to write synthetic snapshot into" << dir;
+    return ok;
+}
+
+} // namespace bench
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BENCH_SNAPSHOT_H
+#define BENCH_SNAPSHOT_H
+
+#include <QString>
+
+namespace bench {
+
+/**
+ * @brief Shape of a synthetic snapshot
+ */
+struct synthetic_spec_t {
+    int processes;
+    int sockets; // spread over tcp, tcp6, udp & udp6
+    int cpus;
+    int disks;
+};
+
+/**
+ * @brief Snapshot directory holding proc/ & sys/ trees, laid out like the host's /proc & /sys
+ *
+ * Only the files read by the collectors are kept. Process fds are recorded as the link text of the host's
+ * fd entries, socket links are dangling in a snapshot so their inodes are not matched on replay.
+ */
+class Snapshot
+{
+public:
+    /**
+     * @brief Record the host's /proc & /sys into dir
+     *
+     * environ of processes is not recorded, it may hold secrets. Files not readable are skipped.
+     */
+    static bool recordHost(const QString &dir);
+
+    /**
+     * @brief Write a synthetic snapshot into dir
+     */
+    static bool writeSynthetic(const QString &dir, const synthetic_spec_t &spec);
+
+    static QString procRoot(const QString &dir);
+    static QString sysRoot(const QString &dir);
+};
+
+} // namespace bench
+
+#endif // BENCH_SNAPSHOT_H
@@ -37,3 +37,12 @@ TEST(UT_HanLatin, test_convHanToLatin_01)
     QString words;
     convHanToLatin(words);
 }
+
+TEST(UT_HanLatin, test_convHanToLatin_02)
+{
+    // transliterators are reused between calls
+    QString words = QString::fromUtf8("\xe5\xbe\xae\xe4\xbf\xa1");
+    QString first = convHanToLatin(words);
+    EXPECT_EQ(first.remove(' '), "weixin");
+    EXPECT_EQ(convHanToLatin("bash"), "bash");
+}
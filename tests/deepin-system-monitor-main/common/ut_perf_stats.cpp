@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/perf_stats.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QString>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace common::perf;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+TEST(UT_PerfHistogram, test_bucketOf_001)
+{
+    // every value falls into the bucket whose range holds it
+    for (quint64 value = 0; value < 100000; ++value) {
+        int bucket = PerfHistogram::bucketOf(value);
+        ASSERT_GE(PerfHistogram::bucketHighest(bucket), value);
+        if (bucket > 0)
+            ASSERT_LT(PerfHistogram::bucketHighest(bucket - 1), value);
+    }
+    EXPECT_EQ(PerfHistogram::bucketOf(~quint64(0)), PerfHistogram::kBucketCount - 1);
+    EXPECT_EQ(PerfHistogram::bucketHighest(PerfHistogram::kBucketCount - 1), ~quint64(0));
+}
+
+TEST(UT_PerfHistogram, test_percentile_001)
+{
+    PerfHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0u);
+
+    for (quint64 value = 1; value <= 1000; ++value)
+        histogram.record(value * 1000);
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.max(), 1000000u);
+    EXPECT_EQ(histogram.sum(), 500500000u);
+
+    // within the 12.5% bucket precision
+    quint64 p50 = histogram.percentile(50);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 562500u);
+    quint64 p99 = histogram.percentile(99);
+    EXPECT_GE(p99, 990000u);
+    EXPECT_LE(p99, 1000000u);
+    EXPECT_EQ(histogram.percentile(100), 1000000u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(99), 0u);
+}
+
+TEST(UT_PerfStats, test_record_001)
+{
+    PerfStats stats;
+    stats.record(kStageCpuStats, 2000, 3, 5);
+    stats.record(kStageCpuStats, 4000, 3, 5);
+    // out of range stages are ignored
+    stats.record(kStageCount, 1000, 1, 1);
+
+    perf_stage_summary_t summary = stats.summary(kStageCpuStats);
+    EXPECT_EQ(summary.count, 2u);
+    EXPECT_EQ(summary.sumNs, 6000u);
+    EXPECT_EQ(summary.maxNs, 4000u);
+    EXPECT_EQ(summary.syscalls, 6u);
+    EXPECT_EQ(summary.allocs, 10u);
+    EXPECT_EQ(stats.summary(kStagePaint).count, 0u);
+
+    QString report = stats.report();
+    for (int i = 0; i < kStageCount; ++i)
+        EXPECT_TRUE(report.contains(PerfStats::stageName(PerfStage(i))));
+
+    stats.reset();
+    EXPECT_EQ(stats.summary(kStageCpuStats).count, 0u);
+}
+
+TEST(UT_PerfScope, test_scope_001)
+{
+    PerfStats *stats = PerfStats::instance();
+    stats->reset();
+
+    {
+        PerfScope scope(kStageNetifs);
+        // two reads of the calling thread
+        int fd = open("/dev/zero", O_RDONLY | O_CLOEXEC);
+        char c;
+        ASSERT_EQ(read(fd, &c, 1), 1);
+        ASSERT_EQ(read(fd, &c, 1), 1);
+        close(fd);
+    }
+    {
+        PerfScope scope(kStageProcessScan);
+        scope.setSyscalls(42);
+    }
+
+    perf_stage_summary_t summary = stats->summary(kStageNetifs);
+    EXPECT_EQ(summary.count, 1u);
+    // 0 if the kernel lacks io accounting
+    if (PerfScope::threadSyscalls() > 0)
+        EXPECT_EQ(summary.syscalls, 2u);
+    EXPECT_EQ(stats->summary(kStageProcessScan).syscalls, 42u);
+    stats->reset();
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/sample.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// period of the per process samples
+static TimePeriod processPeriod()
+{
+    return TimePeriod(TimePeriod::kNoPeriod, {2, 0});
+}
+
+TEST(UT_Sample, test_addSample_001)
+{
+    Sample<qreal> sample(TimePeriod(TimePeriod::k1Min, {2, 0}));
+    int ticks = int(sample.timePeriod().ticks());
+    for (int i = 0; i < ticks + 5; ++i)
+        sample.addSample(SampleFrame<qreal>(i));
+
+    EXPECT_EQ(sample.count(), ticks);
+    EXPECT_EQ(sample.sample(0)->data, 5.);
+    EXPECT_EQ(sample.recentSample()->data, qreal(ticks + 4));
+
+    auto pair = sample.recentSamplePair();
+    EXPECT_EQ(pair.first->data, qreal(ticks + 3));
+    EXPECT_EQ(pair.second->data, qreal(ticks + 4));
+    EXPECT_EQ(sample.sample(ticks), nullptr);
+}
+
+TEST(UT_Sample, test_updateTimePeriod_001)
+{
+    Sample<qreal> sample(TimePeriod(TimePeriod::k1Min, {2, 0}));
+    for (int i = 0; i < 100; ++i)
+        sample.addSample(SampleFrame<qreal>(i));
+
+    // shrinking keeps the most recent frames
+    sample.updateTimePeriod(processPeriod());
+    EXPECT_EQ(sample.count(), 2);
+    EXPECT_EQ(sample.sample(0)->data, 98.);
+    EXPECT_EQ(sample.sample(1)->data, 99.);
+
+    // a new interval drops the history
+    sample.updateTimePeriod(TimePeriod(TimePeriod::kNoPeriod, {1, 0}));
+    EXPECT_EQ(sample.count(), 0);
+    EXPECT_EQ(sample.recentSample(), nullptr);
+}
+
+TEST(UT_Sample, test_copy_001)
+{
+    IOPSSample sample(processPeriod());
+    sample.addSample(IOPSSampleFrame({1., 2.}));
+    sample.addSample(IOPSSampleFrame({3., 4.}));
+    sample.addSample(IOPSSampleFrame({5., 6.}));
+
+    IOPSSample copy(sample);
+    EXPECT_EQ(copy.count(), 2);
+    EXPECT_EQ(copy.sample(0)->data.inBps, 3.);
+    EXPECT_EQ(copy.recentSample()->data.outBps, 6.);
+}
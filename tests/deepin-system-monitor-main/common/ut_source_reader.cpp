@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/source_reader.h"
+#include "system/disk_stats.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QByteArray>
+
+#include <string.h>
+
+using namespace common::source;
+using namespace core::system;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// serves canned content for every path
+class CannedReader : public SourceReader
+{
+public:
+    explicit CannedReader(const QByteArray &content)
+        : m_content(content)
+    {
+    }
+
+    int open(const char *) override
+    {
+        return ++m_opened;
+    }
+    ssize_t pread(int, void *buf, size_t size, off_t offset) override
+    {
+        if (offset >= m_content.size())
+            return 0;
+        size_t n = qMin(size, size_t(m_content.size() - offset));
+        memcpy(buf, m_content.constData() + offset, n);
+        return ssize_t(n);
+    }
+    void close(int) override
+    {
+        ++m_closed;
+    }
+
+    int m_opened {0};
+    int m_closed {0};
+
+private:
+    QByteArray m_content;
+};
+
+TEST(UT_SourceReader, test_setReader_001)
+{
+    SourceReader *host = reader();
+    CannedReader canned("   8       0 sda 1 2 3 4 5 6 7 8 0 10 11\n");
+    setReader(&canned);
+    {
+        DiskStatsReader diskStats;
+        EXPECT_TRUE(diskStats.update());
+        ASSERT_EQ(diskStats.rows().size(), 1);
+        EXPECT_STREQ(diskStats.rows()[0].name, "sda");
+        EXPECT_EQ(diskStats.rows()[0][DiskStats::kSectorsRead], 3u);
+    }
+    EXPECT_EQ(canned.m_opened, 1);
+    EXPECT_EQ(canned.m_closed, 1);
+
+    // restores the default reader
+    setReader(nullptr);
+    EXPECT_EQ(reader(), host);
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/source_root.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QByteArray>
+
+#include <limits.h>
+
+using namespace common::source;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+class UT_SourceRoot : public ::testing::Test
+{
+protected:
+    virtual void TearDown()
+    {
+        setProcRoot(SOURCE_PROC_ROOT);
+        setSysRoot(SOURCE_SYS_ROOT);
+    }
+};
+
+TEST_F(UT_SourceRoot, test_path_001)
+{
+    // host paths are kept as is by default
+    EXPECT_FALSE(isRedirected());
+    EXPECT_EQ(path("/proc/stat"), QByteArray("/proc/stat"));
+    EXPECT_EQ(path("/sys/block"), QByteArray("/sys/block"));
+}
+
+TEST_F(UT_SourceRoot, test_path_002)
+{
+    setProcRoot("/tmp/snap/proc/");
+    setSysRoot("/tmp/snap/sys");
+    EXPECT_TRUE(isRedirected());
+    EXPECT_EQ(procRoot(), QByteArray("/tmp/snap/proc"));
+    EXPECT_EQ(path("/proc"), QByteArray("/tmp/snap/proc"));
+    EXPECT_EQ(path("/proc/stat"), QByteArray("/tmp/snap/proc/stat"));
+    EXPECT_EQ(path("/sys/block/sda/size"), QByteArray("/tmp/snap/sys/block/sda/size"));
+    // only whole path components are redirected
+    EXPECT_EQ(path("/processes"), QByteArray("/processes"));
+    EXPECT_EQ(path("/usr/share"), QByteArray("/usr/share"));
+}
+
+TEST_F(UT_SourceRoot, test_path_003)
+{
+    // empty roots fall back to the host's
+    setProcRoot("");
+    setSysRoot("/sys/");
+    EXPECT_FALSE(isRedirected());
+    EXPECT_EQ(procRoot(), QByteArray(SOURCE_PROC_ROOT));
+}
+
+TEST_F(UT_SourceRoot, test_formatPath_001)
+{
+    char buf[PATH_MAX];
+    EXPECT_EQ(formatPath(buf, sizeof(buf), "/proc/%d/stat", 42), 13);
+    EXPECT_STREQ(buf, "/proc/42/stat");
+
+    setProcRoot("/snap/proc");
+    EXPECT_EQ(formatPath(buf, sizeof(buf), "/proc/%d/stat", 42), 18);
+    EXPECT_STREQ(buf, "/snap/proc/42/stat");
+
+    // truncated like snprintf
+    char small[8];
+    EXPECT_EQ(formatPath(small, sizeof(small), "/proc/%d/stat", 42), 18);
+    EXPECT_STREQ(small, "/snap/p");
+}
@@ -472,6 +472,33 @@ TEST_F(UT_ProcessTableView, test_customizeProcessPriority_02)
     EXPECT_TRUE(m_tester->m_selectedPID.isValid());
 }
 
+TEST_F(UT_ProcessTableView, test_updateNetworkStatsDemand_01)
+{
+    SockInodeScan &scan = ProcessDB::instance()->processSet()->sockInodeScan();
+    auto hideNetworkColumns = [](ProcessTableView *view) {
+        view->header()->setSectionHidden(ProcessTableModel::kProcessUploadColumn, true);
+        view->header()->setSectionHidden(ProcessTableModel::kProcessDownloadColumn, true);
+        view->header()->setSortIndicator(ProcessTableModel::kProcessPIDColumn, Qt::AscendingOrder);
+        view->updateNetworkStatsDemand();
+    };
+
+    hideNetworkColumns(m_tester);
+    EXPECT_FALSE(scan.m_clients.contains(m_tester));
+
+    // upload & download totals of the user page need the stats even with the columns hidden, while the page is shown
+    ProcessTableView userView(nullptr, "deepin");
+    hideNetworkColumns(&userView);
+    EXPECT_FALSE(scan.m_clients.contains(&userView));
+
+    QShowEvent se;
+    userView.showEvent(&se);
+    EXPECT_TRUE(scan.m_clients.contains(&userView));
+
+    QHideEvent he;
+    userView.hideEvent(&he);
+    EXPECT_FALSE(scan.m_clients.contains(&userView));
+}
+
 
 
 
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_search_index.h"
+#include "process/process.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QRegularExpression>
+
+using namespace core::process;
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+static Process makeProcess(pid_t pid, const QString &name, const QString &user)
+{
+    Process proc(pid);
+    proc.setName(name);
+    proc.setUserName(user);
+    return proc;
+}
+
+TEST(UT_ProcessSearchIndex, test_matches_001)
+{
+    ProcessSearchIndex index(false);
+    index.update(makeProcess(1234, "Xorg", "root"));
+    index.update(makeProcess(42, "bash", "Deepin"));
+    EXPECT_EQ(index.size(), 2);
+
+    // case insensitive substring of name, pid & user
+    EXPECT_TRUE(index.matches(1234, index.makeQuery("xOR")));
+    EXPECT_TRUE(index.matches(1234, index.makeQuery("23")));
+    EXPECT_TRUE(index.matches(42, index.makeQuery("deep")));
+    EXPECT_FALSE(index.matches(42, index.makeQuery("xorg")));
+    // regex characters are plain text
+    EXPECT_FALSE(index.matches(42, index.makeQuery("b.sh")));
+    // empty search accepts everything
+    EXPECT_TRUE(index.matches(42, index.makeQuery("")));
+
+    // unknown pid
+    EXPECT_FALSE(index.matches(7, index.makeQuery("bash")));
+
+    index.remove(42);
+    EXPECT_FALSE(index.matches(42, index.makeQuery("bash")));
+}
+
+TEST(UT_ProcessSearchIndex, test_update_001)
+{
+    ProcessSearchIndex index(false);
+    index.update(makeProcess(100, "bash", "root"));
+    EXPECT_TRUE(index.matches(100, index.makeQuery("bash")));
+
+    // pid reused by another program
+    index.update(makeProcess(100, "python3", "root"));
+    EXPECT_FALSE(index.matches(100, index.makeQuery("bash")));
+    EXPECT_TRUE(index.matches(100, index.makeQuery("python")));
+    EXPECT_EQ(index.size(), 1);
+}
+
+TEST(UT_ProcessSearchIndex, test_pinyin_001)
+{
+    ProcessSearchIndex index(true);
+    // ascii search text has no pinyin form
+    EXPECT_TRUE(index.makeQuery("bash").pinyin.isEmpty());
+
+    ProcessSearchIndex::Query query = index.makeQuery(QString::fromUtf8("\xe5\xbe\xae\xe4\xbf\xa1"));
+    EXPECT_EQ(query.pinyin, "weixin");
+
+    index.update(makeProcess(10, "weixin", "deepin"));
+    EXPECT_TRUE(index.matches(10, query));
+}
+
+// same rows as the case insensitive regex over name, pid & user the filter used before
+TEST(UT_ProcessSearchIndex, test_matches_002)
+{
+    const int nprocs = 1000;
+    ProcessSearchIndex index(false);
+    QVector<Process> procs;
+    procs.reserve(nprocs);
+    for (int i = 0; i < nprocs; ++i) {
+        procs << makeProcess(i + 1, QString("worker-%1").arg(i), "deepin");
+        index.update(procs.last());
+    }
+
+    QRegularExpression regex("er-99", QRegularExpression::CaseInsensitiveOption);
+    ProcessSearchIndex::Query query = index.makeQuery("ER-99");
+    int matches = 0;
+    for (const Process &proc : procs) {
+        bool expected = proc.name().contains(regex) || QString::number(proc.pid()).contains(regex) || proc.userName().contains(regex);
+        EXPECT_EQ(index.matches(proc.pid(), query), expected) << proc.pid();
+        matches += expected;
+    }
+    // worker-99 & worker-990..999
+    EXPECT_EQ(matches, 11);
+}
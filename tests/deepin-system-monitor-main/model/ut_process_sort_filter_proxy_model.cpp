@@ -15,6 +15,8 @@
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
+//Qt
+#include <QStandardItemModel>
 /***************************************STUB begin*********************************************/
 int stub_proclessThan_sortColumn1(){
     return ProcessTableModel::kProcessNameColumn;
@@ -116,6 +118,23 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_filterAcceptsRow_001)
     m_tester->setFilterType(0);
 }
 
+TEST_F(UT_ProcessSortFilterProxyModel, test_endBatchUpdate_001)
+{
+    QStandardItemModel source(1, ProcessTableModel::kProcessColumnCount);
+    source.setData(source.index(0, ProcessTableModel::kProcessPIDColumn), kFilterApps, Qt::UserRole + 3);
+    m_tester->setFilterType(kFilterApps);
+    m_tester->setSourceModel(&source);
+    EXPECT_EQ(m_tester->rowCount(), 1);
+
+    // the row no longer passes the filter once the batch ends
+    m_tester->beginBatchUpdate();
+    source.setData(source.index(0, ProcessTableModel::kProcessPIDColumn), kNoFilter, Qt::UserRole + 3);
+    m_tester->endBatchUpdate();
+    EXPECT_EQ(m_tester->rowCount(), 0);
+
+    m_tester->setSourceModel(nullptr);
+}
+
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_001)
 {
     Stub b;
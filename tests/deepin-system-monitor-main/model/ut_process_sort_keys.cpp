@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_sort_keys.h"
+#include "model/process_table_model.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QStandardItemModel>
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// rows with the roles the process table model provides for sorting
+static void appendProcessRow(QStandardItemModel &model, const QString &name, qreal cpu, qulonglong mem, int pid, int nice)
+{
+    int row = model.rowCount();
+    model.insertRow(row);
+    auto set = [&](int column, const QVariant &value, int role) {
+        model.setData(model.index(row, column), value, role);
+    };
+    set(ProcessTableModel::kProcessNameColumn, name, Qt::DisplayRole);
+    set(ProcessTableModel::kProcessUserColumn, QString("user%1").arg(pid % 3), Qt::DisplayRole);
+    set(ProcessTableModel::kProcessCPUColumn, cpu, Qt::UserRole);
+    set(ProcessTableModel::kProcessMemoryColumn, mem, Qt::UserRole);
+    set(ProcessTableModel::kProcessUploadColumn, 0.0, Qt::UserRole);
+    set(ProcessTableModel::kProcessUploadColumn, qulonglong(pid), Qt::UserRole + 1);
+    set(ProcessTableModel::kProcessPIDColumn, pid, Qt::UserRole);
+    set(ProcessTableModel::kProcessNiceColumn, nice, Qt::UserRole);
+}
+
+TEST(UT_ProcessSortKeys, test_lessThan_001)
+{
+    QStandardItemModel model(0, ProcessTableModel::kProcessColumnCount);
+    appendProcessRow(model, "bash", 1.5, 4096, 30, 0);
+    appendProcessRow(model, "Xorg", 10.0, 1024, 10, -5);
+    appendProcessRow(model, "bash", 0.5, 4096, 20, 10);
+
+    ProcessSortKeys keys;
+
+    keys.prepare(&model, ProcessTableModel::kProcessPIDColumn);
+    EXPECT_EQ(keys.rows(), 3);
+    EXPECT_EQ(keys.sortedRows(ProcessTableModel::kProcessPIDColumn, Qt::AscendingOrder), QVector<int>({1, 2, 0}));
+
+    // same memory, cpu decides
+    keys.prepare(&model, ProcessTableModel::kProcessMemoryColumn);
+    EXPECT_EQ(keys.sortedRows(ProcessTableModel::kProcessMemoryColumn, Qt::AscendingOrder), QVector<int>({1, 2, 0}));
+
+    keys.prepare(&model, ProcessTableModel::kProcessCPUColumn);
+    EXPECT_EQ(keys.sortedRows(ProcessTableModel::kProcessCPUColumn, Qt::DescendingOrder), QVector<int>({1, 0, 2}));
+
+    // equal names fall back to cpu
+    keys.prepare(&model, ProcessTableModel::kProcessNameColumn);
+    EXPECT_TRUE(keys.lessThan(ProcessTableModel::kProcessNameColumn, 2, 0));
+    EXPECT_FALSE(keys.lessThan(ProcessTableModel::kProcessNameColumn, 0, 2));
+
+    // higher priority first
+    keys.prepare(&model, ProcessTableModel::kProcessNiceColumn);
+    EXPECT_TRUE(keys.lessThan(ProcessTableModel::kProcessNiceColumn, 2, 1));
+    EXPECT_FALSE(keys.lessThan(ProcessTableModel::kProcessNiceColumn, 0, 0));
+}
+
+TEST(UT_ProcessSortKeys, test_lessThan_002)
+{
+    QStandardItemModel model(0, ProcessTableModel::kProcessColumnCount);
+    appendProcessRow(model, "a", 0, 0, 1, 0);
+    appendProcessRow(model, "b", 0, 0, 2, 0);
+    appendProcessRow(model, "c", 0, 0, 3, 0);
+    auto setGpu = [&](int row, qreal gpu, qulonglong vram) {
+        model.setData(model.index(row, ProcessTableModel::kProcessGPUColumn), gpu, Qt::UserRole);
+        model.setData(model.index(row, ProcessTableModel::kProcessGPUMemoryColumn), vram, Qt::UserRole);
+    };
+    setGpu(0, 30.0, 100);
+    setGpu(1, 30.0, 200);
+    setGpu(2, 5.0, 300);
+
+    ProcessSortKeys keys;
+    // same gpu usage, vram decides
+    keys.prepare(&model, ProcessTableModel::kProcessGPUColumn);
+    EXPECT_EQ(keys.sortedRows(ProcessTableModel::kProcessGPUColumn, Qt::DescendingOrder), QVector<int>({1, 0, 2}));
+
+    keys.prepare(&model, ProcessTableModel::kProcessGPUMemoryColumn);
+    EXPECT_EQ(keys.sortedRows(ProcessTableModel::kProcessGPUMemoryColumn, Qt::DescendingOrder), QVector<int>({2, 1, 0}));
+}
+
+TEST(UT_ProcessSortKeys, test_invalidate_001)
+{
+    QStandardItemModel model(0, ProcessTableModel::kProcessColumnCount);
+    appendProcessRow(model, "a", 1.0, 1, 1, 0);
+    appendProcessRow(model, "b", 2.0, 2, 2, 0);
+
+    ProcessSortKeys keys;
+    keys.prepare(&model, ProcessTableModel::kProcessCPUColumn);
+    EXPECT_TRUE(keys.lessThan(ProcessTableModel::kProcessCPUColumn, 0, 1));
+
+    // keys stay until dropped
+    model.setData(model.index(0, ProcessTableModel::kProcessCPUColumn), 3.0, Qt::UserRole);
+    keys.prepare(&model, ProcessTableModel::kProcessCPUColumn);
+    EXPECT_TRUE(keys.lessThan(ProcessTableModel::kProcessCPUColumn, 0, 1));
+
+    keys.invalidate();
+    keys.prepare(&model, ProcessTableModel::kProcessCPUColumn);
+    EXPECT_FALSE(keys.lessThan(ProcessTableModel::kProcessCPUColumn, 0, 1));
+
+    // row count changes rebuild the keys
+    appendProcessRow(model, "c", 0.1, 3, 3, 0);
+    keys.prepare(&model, ProcessTableModel::kProcessCPUColumn);
+    EXPECT_EQ(keys.rows(), 3);
+    EXPECT_TRUE(keys.lessThan(ProcessTableModel::kProcessCPUColumn, 2, 1));
+}
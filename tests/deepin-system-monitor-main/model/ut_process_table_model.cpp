@@ -7,11 +7,13 @@
 #include "model/process_table_model.h"
 #include "process/process_db.h"
 #include "common/common.h"
+#include "common/perf_stats.h"
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 //Qt
 #include <QTimer>
+#include <QSignalSpy>
 #include <DApplication>
 
 static QString m_Sresult;
@@ -112,6 +114,27 @@ char stub_process_data_state2(){
     return 'T';
 }
 /***************************************STUB end**********************************************/
+// append a row for proc, read from a snapshot holding the processes of the rows before it & proc
+static void appendRow(ProcessTableModel *model, const Process &proc)
+{
+    auto snapshot = std::make_shared<SystemSnapshot>();
+    if (model->m_snapshot)
+        *snapshot = *model->m_snapshot;
+    snapshot->addProcess(proc);
+    model->m_procIdList << proc.pid();
+    model->setSnapshot(snapshot);
+    model->rebuildRowIndex();
+}
+
+// snapshot holding processes first to last
+static SystemSnapshotPtr makeSnapshot(pid_t first, pid_t last)
+{
+    auto snapshot = std::make_shared<SystemSnapshot>();
+    for (pid_t pid = first; pid <= last; ++pid)
+        snapshot->addProcess(Process(pid));
+    return snapshot;
+}
+
 class UT_ProcessTableModel: public ::testing::Test
 {
 public:
@@ -189,9 +212,7 @@ TEST_F(UT_ProcessTableModel, test_updateProcessListDelay_003)
 {
     Stub stub;
     stub.set(ADDR(ProcessSet, getPIDList), stub_getPIDList);
-    m_tester->m_procIdList.append(1);
-    Process proc;
-    m_tester->m_processList.append(proc);
+    appendRow(m_tester, Process(1));
     m_tester->updateProcessListDelay();
 }
 
@@ -368,7 +389,7 @@ TEST_F(UT_ProcessTableModel, test_data_003)
      Process *proc = new Process;
      QModelIndex *index = new QModelIndex();
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -387,7 +408,7 @@ TEST_F(UT_ProcessTableModel, test_data_004)
      Process *proc = new Process;
      QModelIndex *index = new QModelIndex();
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
 
@@ -410,7 +431,7 @@ TEST_F(UT_ProcessTableModel, test_data_005)
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
      Stub b5;
      b5.set(ADDR(Process,state),stub_process_data_state1);
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -431,7 +452,7 @@ TEST_F(UT_ProcessTableModel, test_data_006)
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
      Stub b5;
      b5.set(ADDR(Process,state),stub_process_data_state2);
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -452,7 +473,7 @@ TEST_F(UT_ProcessTableModel, test_data_007)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column2);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -472,7 +493,7 @@ TEST_F(UT_ProcessTableModel, test_data_008)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column3);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -492,7 +513,7 @@ TEST_F(UT_ProcessTableModel, test_data_009)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column4);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -512,7 +533,7 @@ TEST_F(UT_ProcessTableModel, test_data_010)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column5);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -532,7 +553,7 @@ TEST_F(UT_ProcessTableModel, test_data_011)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column6);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -552,7 +573,7 @@ TEST_F(UT_ProcessTableModel, test_data_012)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column7);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -572,7 +593,7 @@ TEST_F(UT_ProcessTableModel, test_data_013)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -592,7 +613,7 @@ TEST_F(UT_ProcessTableModel, test_data_014)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column9);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -612,7 +633,7 @@ TEST_F(UT_ProcessTableModel, test_data_015)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column10);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -632,7 +653,7 @@ TEST_F(UT_ProcessTableModel, test_data_016)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column11);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -652,7 +673,7 @@ TEST_F(UT_ProcessTableModel, test_data_017)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column12);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -672,7 +693,7 @@ TEST_F(UT_ProcessTableModel, test_data_018)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column13);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -692,7 +713,7 @@ TEST_F(UT_ProcessTableModel, test_data_019)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DecorationRole;
      m_tester->data(*index,role);
      delete proc;
@@ -712,7 +733,7 @@ TEST_F(UT_ProcessTableModel, test_data_020)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
      delete proc;
@@ -732,7 +753,7 @@ TEST_F(UT_ProcessTableModel, test_data_021)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column4);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
      delete proc;
@@ -752,7 +773,7 @@ TEST_F(UT_ProcessTableModel, test_data_022)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column5);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
      delete proc;
@@ -772,7 +793,7 @@ TEST_F(UT_ProcessTableModel, test_data_023)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column6);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
 
      delete proc;
@@ -792,7 +813,7 @@ TEST_F(UT_ProcessTableModel, test_data_024)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column2);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -813,7 +834,7 @@ TEST_F(UT_ProcessTableModel, test_data_025)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column7);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -834,7 +855,7 @@ TEST_F(UT_ProcessTableModel, test_data_026)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -855,7 +876,7 @@ TEST_F(UT_ProcessTableModel, test_data_027)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column11);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -876,7 +897,7 @@ TEST_F(UT_ProcessTableModel, test_data_028)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column9);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -897,7 +918,7 @@ TEST_F(UT_ProcessTableModel, test_data_029)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column10);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -918,7 +939,7 @@ TEST_F(UT_ProcessTableModel, test_data_030)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column12);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -939,7 +960,7 @@ TEST_F(UT_ProcessTableModel, test_data_031)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column7);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = (Qt::UserRole + 1);
      m_tester->data(*index,role);
 
@@ -960,7 +981,7 @@ TEST_F(UT_ProcessTableModel, test_data_032)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = (Qt::UserRole + 1);
      m_tester->data(*index,role);
 
@@ -981,7 +1002,7 @@ TEST_F(UT_ProcessTableModel, test_data_033)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::TextAlignmentRole;
      QVariant expect = m_tester->data(*index,role);
 
@@ -1003,7 +1024,7 @@ TEST_F(UT_ProcessTableModel, test_data_034)
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
      Stub b5;
      b5.set(ADDR(Process,state),stub_process_data_state1);
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole + 2;
      QVariant expect = m_tester->data(*index,role);
 
@@ -1024,7 +1045,7 @@ TEST_F(UT_ProcessTableModel, test_data_035)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole + 4;
      m_tester->data(*index,role);
 
@@ -1056,6 +1077,7 @@ TEST_F(UT_ProcessTableModel, test_getProcessPriority_001)
 {
      pid_t pid = getpid();
      m_tester->m_procIdList << pid;
+     m_tester->rebuildRowIndex();
      m_tester->getProcessPriority(pid);
 }
 
@@ -1070,8 +1092,7 @@ TEST_F(UT_ProcessTableModel, test_removeProcess_001)
 {
      pid_t pid = getpid();
      Process proc(pid);
-     m_tester->m_procIdList << pid;
-     m_tester->m_processList << proc;
+     appendRow(m_tester, proc);
      m_tester->removeProcess(pid);
 }
 
@@ -1080,21 +1101,115 @@ TEST_F(UT_ProcessTableModel, test_updateProcessState_001)
      pid_t pid = getpid();
      Process proc(pid);
      char state = 'Z';
-     m_tester->m_procIdList << pid;
-     m_tester->m_processList << proc;
+     appendRow(m_tester, proc);
 
      m_tester->updateProcessState(pid,state);
 
 }
 
+TEST_F(UT_ProcessTableModel, test_updateProcessState_002)
+{
+     appendRow(m_tester, Process(1));
+     m_tester->updateProcessState(1, 'T');
+     EXPECT_EQ(m_tester->getProcessState(1), 'T');
+
+     // a snapshot captured after the action shows the state read from the process again
+     auto snapshot = std::make_shared<SystemSnapshot>(*m_tester->m_snapshot);
+     snapshot->m_processCapturedNs = common::perf::PerfScope::monotonicNs();
+     m_tester->setSnapshot(snapshot);
+     EXPECT_EQ(m_tester->getProcessState(1), snapshot->process(0).state);
+}
+
+TEST_F(UT_ProcessTableModel, test_updateProcessState_003)
+{
+     appendRow(m_tester, Process(1));
+     m_tester->updateProcessState(1, 'T');
+
+     // a counter only tick shares the processes read before the action
+     auto snapshot = std::make_shared<SystemSnapshot>(*m_tester->m_snapshot);
+     snapshot->m_capturedNs = common::perf::PerfScope::monotonicNs();
+     m_tester->setSnapshot(snapshot);
+     EXPECT_EQ(m_tester->getProcessState(1), 'T');
+}
+
+TEST_F(UT_ProcessTableModel, test_data_gpu_001)
+{
+     Process proc(1);
+     proc.setGpuUsage(12.5, 64 << 20);
+     appendRow(m_tester, proc);
+
+     EXPECT_DOUBLE_EQ(m_tester->data(m_tester->index(0, ProcessTableModel::kProcessGPUColumn), Qt::UserRole).toDouble(), 12.5);
+     EXPECT_EQ(m_tester->data(m_tester->index(0, ProcessTableModel::kProcessGPUMemoryColumn), Qt::UserRole).toULongLong(), 64ull << 20);
+     EXPECT_EQ(m_tester->data(m_tester->index(0, ProcessTableModel::kProcessGPUColumn), Qt::DisplayRole).toString(), QString("12.5%"));
+}
+
 TEST_F(UT_ProcessTableModel, test_updateProcessPriority_001)
 {
      pid_t pid = getpid();
      Process proc(pid);
      int priority = 0;
-     m_tester->m_procIdList << pid;
-     m_tester->m_processList << proc;
+     appendRow(m_tester, proc);
 
      m_tester->updateProcessPriority(pid,priority);
 
 }
+
+TEST_F(UT_ProcessTableModel, test_applyProcessChanges_001)
+{
+     for (pid_t pid = 1; pid <= 10; ++pid)
+          m_tester->m_procIdList << pid;
+     m_tester->rebuildRowIndex();
+     m_tester->setSnapshot(makeSnapshot(1, 12));
+
+     QSignalSpy removedSpy(m_tester, &ProcessTableModel::rowsRemoved);
+     QSignalSpy insertedSpy(m_tester, &ProcessTableModel::rowsInserted);
+     QSignalSpy changedSpy(m_tester, &ProcessTableModel::dataChanged);
+
+     // rows 1-3 & 7 form two ranges, unknown pids are skipped
+     m_tester->applyProcessChanges({8, 2, 4, 3, 100}, {5, 9, 100}, {11, 12, 5});
+
+     QList<pid_t> expect {1, 5, 6, 7, 9, 10, 11, 12};
+     EXPECT_EQ(m_tester->m_procIdList, expect);
+     EXPECT_EQ(m_tester->m_rows.size(), expect.size());
+     for (int row = 0; row < expect.size(); ++row) {
+          EXPECT_EQ(m_tester->m_rowIndex.value(expect[row], -1), row);
+          EXPECT_EQ(m_tester->m_snapshot->process(m_tester->m_rows[row]).pid, expect[row]);
+     }
+
+     EXPECT_EQ(removedSpy.count(), 2);
+     EXPECT_EQ(insertedSpy.count(), 1);
+     ASSERT_EQ(changedSpy.count(), 1);
+     EXPECT_EQ(changedSpy.at(0).at(0).toModelIndex().row(), 1);
+     EXPECT_EQ(changedSpy.at(0).at(1).toModelIndex().row(), 4);
+}
+
+TEST_F(UT_ProcessTableModel, test_applyProcessChanges_002)
+{
+     const int nprocs = 5000;
+     for (pid_t pid = 1; pid <= nprocs; ++pid)
+          m_tester->m_procIdList << pid;
+     m_tester->rebuildRowIndex();
+
+     // one tick: every 10th process exits, each process changes, as many new ones start
+     QVector<pid_t> removed, changed, added;
+     for (pid_t pid = 1; pid <= nprocs; ++pid) {
+          if (pid % 10 == 0)
+               removed << pid;
+          else
+               changed << pid;
+     }
+     for (pid_t pid = nprocs + 1; pid <= nprocs + removed.size(); ++pid)
+          added << pid;
+
+     SystemSnapshotPtr snapshot = makeSnapshot(1, nprocs + removed.size());
+
+     QSignalSpy changedSpy(m_tester, &ProcessTableModel::dataChanged);
+     m_tester->setSnapshot(snapshot);
+     m_tester->applyProcessChanges(removed, changed, added);
+
+     // changed rows of the whole table are reported by one dataChanged
+     EXPECT_EQ(m_tester->rowCount(), nprocs);
+     EXPECT_EQ(changedSpy.count(), 1);
+     for (pid_t pid : added)
+          EXPECT_NE(m_tester->m_rowIndex.value(pid, -1), -1);
+}
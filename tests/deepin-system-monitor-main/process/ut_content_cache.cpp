@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/content_cache.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QString>
+
+using namespace core::process;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+TEST(UT_ContentCache, test_find_001)
+{
+    ContentCache<QString> cache("test", 1024);
+    EXPECT_FALSE(cache.find("/usr/bin/foo"));
+
+    auto value = std::make_shared<QString>("Foo");
+    cache.insert("/usr/bin/foo", value, 100);
+    // every lookup of the same content gets the same shared value
+    EXPECT_EQ(cache.find("/usr/bin/foo"), value);
+    EXPECT_EQ(cache.find("/usr/bin/foo"), value);
+
+    content_cache_stats_t stats = cache.stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.entries, 1);
+    EXPECT_DOUBLE_EQ(stats.hitRate(), 2. / 3. * 100.);
+    // the key is accounted too
+    EXPECT_EQ(stats.cost, 100 + QString("/usr/bin/foo").size() * int(sizeof(QChar)));
+}
+
+TEST(UT_ContentCache, test_insert_001)
+{
+    ContentCache<QString> cache("test", 1000);
+    cache.insert("a", std::make_shared<QString>("a"), 400);
+    cache.insert("b", std::make_shared<QString>("b"), 400);
+    // a is the most recently used one
+    EXPECT_TRUE(cache.find("a"));
+
+    // memory bound: the least recently used entry is dropped
+    cache.insert("c", std::make_shared<QString>("c"), 400);
+    EXPECT_TRUE(cache.contains("a"));
+    EXPECT_FALSE(cache.contains("b"));
+    EXPECT_TRUE(cache.contains("c"));
+    EXPECT_LE(cache.stats().cost, 1000);
+
+    // an entry larger than the whole cache is not kept
+    cache.insert("d", std::make_shared<QString>("d"), 2000);
+    EXPECT_FALSE(cache.contains("d"));
+
+    cache.clear();
+    EXPECT_EQ(cache.stats().entries, 0);
+    EXPECT_EQ(cache.stats().cost, 0);
+}
@@ -11,9 +11,34 @@
 #include <gtest/gtest.h>
 //Qt
 #include <QFileInfo>
+#include <QDir>
+#include <QTemporaryDir>
 
 using namespace core::process;
 
+/***************************************STUB begin*********************************************/
+static int g_createEntryCount = 0;
+DesktopEntry stub_createEntry_count(const QFileInfo &)
+{
+    ++g_createEntryCount;
+    return {};
+}
+/***************************************STUB end**********************************************/
+
+// desktop file of an app named name
+static void writeDesktopFile(const QString &path, const QString &name)
+{
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        file.write("[Desktop Entry]\n");
+        file.write(QString("Name=%1\n").arg(name).toUtf8());
+        file.write("Type=Application\n");
+        file.write(QString("Exec=/usr/bin/%1\n").arg(name).toUtf8());
+        file.write(QString("Icon=%1\n").arg(name).toUtf8());
+        file.close();
+    }
+}
+
 class UT_DesktopEntryCache : public ::testing::Test
 {
 public:
@@ -175,3 +200,76 @@ TEST_F(UT_DesktopEntryCache, test_updateCache_001)
     EXPECT_GT(m_tester->m_cache.size(), 0);
 
 }
+
+TEST_F(UT_DesktopEntryCache, test_updateCache_002)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(QDir(dir.path()).mkpath("data/applications"));
+    const QString appDir = dir.filePath("data/applications");
+    const QString indexPath = dir.filePath("desktop_entries.cache");
+
+    const QByteArray dataDirs = qgetenv("XDG_DATA_DIRS");
+    const QByteArray dataHome = qgetenv("XDG_DATA_HOME");
+    qputenv("XDG_DATA_DIRS", dir.filePath("data").toLocal8Bit());
+    qunsetenv("XDG_DATA_HOME");
+
+    writeDesktopFile(appDir + "/foo.desktop", "foo");
+    {
+        DesktopEntryCache cache;
+        cache.m_indexPath = indexPath;
+        EXPECT_TRUE(cache.updateCache());
+        EXPECT_TRUE(cache.contains("foo"));
+
+        // nothing changed, the index is saved once changes settled
+        EXPECT_FALSE(cache.updateCache());
+        EXPECT_TRUE(QFileInfo::exists(indexPath));
+
+        // changes are picked up from inotify events
+        writeDesktopFile(appDir + "/bar.desktop", "bar");
+        EXPECT_TRUE(cache.updateCache());
+        EXPECT_TRUE(cache.contains("bar"));
+
+        QFile::remove(appDir + "/foo.desktop");
+        EXPECT_TRUE(cache.updateCache());
+        EXPECT_FALSE(cache.contains("foo"));
+        EXPECT_FALSE(cache.updateCache());
+    }
+
+    // cold start from the index, files that did not change are not parsed again
+    {
+        g_createEntryCount = 0;
+        Stub stub;
+        stub.set(ADDR(DesktopEntryCacheUpdater, createEntry), stub_createEntry_count);
+
+        DesktopEntryCache cache;
+        cache.m_indexPath = indexPath;
+        EXPECT_TRUE(cache.updateCache());
+        EXPECT_TRUE(cache.contains("bar"));
+        EXPECT_FALSE(cache.contains("foo"));
+        EXPECT_EQ(g_createEntryCount, 0);
+    }
+
+    qputenv("XDG_DATA_DIRS", dataDirs);
+    if (dataHome.isEmpty())
+        qunsetenv("XDG_DATA_HOME");
+    else
+        qputenv("XDG_DATA_HOME", dataHome);
+}
+
+TEST_F(UT_DesktopEntryCache, test_applicationDirs_001)
+{
+    const QByteArray dataDirs = qgetenv("XDG_DATA_DIRS");
+    const QByteArray dataHome = qgetenv("XDG_DATA_HOME");
+    qputenv("XDG_DATA_DIRS", "/usr/share/:/usr/local/share:/usr/share");
+    qputenv("XDG_DATA_HOME", "/home/user/.local/share");
+
+    EXPECT_EQ(DesktopEntryCache::applicationDirs(),
+              QStringList({"/usr/share/applications", "/usr/local/share/applications", "/home/user/.local/share/applications"}));
+
+    qputenv("XDG_DATA_DIRS", dataDirs);
+    if (dataHome.isEmpty())
+        qunsetenv("XDG_DATA_HOME");
+    else
+        qputenv("XDG_DATA_HOME", dataHome);
+}
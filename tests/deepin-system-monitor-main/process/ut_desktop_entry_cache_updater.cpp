@@ -80,3 +80,47 @@ TEST_F(UT_DesktopEntryCacheUpdater, test_createEntry_001)
     }
 
 }
+
+TEST_F(UT_DesktopEntryCacheUpdater, test_createEntry_002)
+{
+    const QString filePath("linglong.desktop");
+    QFile file(filePath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        file.write("[Desktop Entry]\n");
+        file.write("Name=Example\n");
+        file.write("Type=Application\n");
+        file.write("TryExec=/usr/bin/ll-cli\n");
+        file.write("Exec=/usr/bin/ll-cli run org.example.app\n");
+        file.write("X-linglong=org.example.app\n");
+        file.close();
+    }
+
+    // ll-cli is not run while parsing, the name is looked up later
+    DesktopEntry entry = m_tester->createEntry(QFileInfo(filePath));
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->linglong, "org.example.app");
+    EXPECT_TRUE(entry->name.isEmpty());
+    EXPECT_EQ(entry->exec.first(), "/usr/bin/ll-cli");
+
+    file.remove();
+}
+
+TEST_F(UT_DesktopEntryCacheUpdater, test_parseLinglongInfo_001)
+{
+    EXPECT_EQ(DesktopEntryCacheUpdater::parseLinglongInfo("{\"appid\": \"org.example.app\", \"name\": \"example\"}"), "example");
+    EXPECT_TRUE(DesktopEntryCacheUpdater::parseLinglongInfo("{\"appid\": \"org.example.app\"}").isEmpty());
+    EXPECT_TRUE(DesktopEntryCacheUpdater::parseLinglongInfo("not json").isEmpty());
+}
+
+TEST_F(UT_DesktopEntryCacheUpdater, test_takeLinglongNames_001)
+{
+    // lookups are queued once, names are taken once
+    m_tester->m_requested.insert("org.example.app");
+    m_tester->requestLinglongName("org.example.app");
+    EXPECT_TRUE(m_tester->m_pending.isEmpty());
+
+    m_tester->m_names.insert("org.example.app", "example");
+    QHash<QString, QString> names = m_tester->takeLinglongNames();
+    EXPECT_EQ(names.value("org.example.app"), "example");
+    EXPECT_TRUE(m_tester->takeLinglongNames().isEmpty());
+}
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/dkapture_shm.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// segment laid out as the system server writes it, mapped writable for the test & read only for the reader
+class DKaptureShmSegment
+{
+public:
+    DKaptureShmSegment(quint32 slotCount, quint32 slotRecords)
+        : size(dkShmSize(slotCount, slotRecords))
+    {
+        fd = memfd_create("ut-dkapture", MFD_CLOEXEC);
+        if (fd < 0 || ftruncate(fd, off_t(size)) < 0)
+            return;
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+        dk_shm_header_t *hdr = static_cast<dk_shm_header_t *>(base);
+        hdr->magic = DKAPTURE_SHM_MAGIC;
+        hdr->version = DKAPTURE_SHM_VERSION;
+        hdr->recordSize = sizeof(dk_proc_record_t);
+        hdr->slotCount = slotCount;
+        hdr->slotRecords = slotRecords;
+        hdr->size = size;
+    }
+    ~DKaptureShmSegment()
+    {
+        munmap(base, size);
+        munmap(view, size);
+        close(fd);
+    }
+
+    quint64 writeBatch(quint64 seq, quint32 count)
+    {
+        dk_shm_slot_t *slot = dkShmSlot(base, static_cast<dk_shm_header_t *>(base), seq);
+        slot->seq.store(0);
+        dk_proc_record_t *records = dkShmRecords(slot);
+        for (quint32 i = 0; i < count; ++i) {
+            memset(&records[i], 0, sizeof(dk_proc_record_t));
+            records[i].pid = qint32(seq * 1000 + i);
+            records[i].fields = kDKFieldStat;
+        }
+        slot->count = count;
+        slot->seq.store(seq, std::memory_order_release);
+        return seq;
+    }
+
+    int fd {-1};
+    size_t size;
+    void *base {nullptr};
+    void *view {nullptr};
+};
+
+TEST(UT_DKaptureShm, test_header_001)
+{
+    DKaptureShmSegment seg(2, 8);
+    ASSERT_NE(seg.view, nullptr);
+    EXPECT_NE(dkShmHeader(seg.view, seg.size), nullptr);
+
+    // mapping size differs from the segment
+    EXPECT_EQ(dkShmHeader(seg.view, seg.size - 1), nullptr);
+    EXPECT_EQ(dkShmHeader(nullptr, seg.size), nullptr);
+
+    dk_shm_header_t *hdr = static_cast<dk_shm_header_t *>(seg.base);
+    hdr->recordSize += 8;
+    EXPECT_EQ(dkShmHeader(seg.view, seg.size), nullptr);
+    hdr->recordSize -= 8;
+
+    // slots beyond the mapping
+    hdr->slotRecords = 1000;
+    EXPECT_EQ(dkShmHeader(seg.view, seg.size), nullptr);
+    hdr->slotRecords = 8;
+
+    hdr->magic = 0;
+    EXPECT_EQ(dkShmHeader(seg.view, seg.size), nullptr);
+}
+
+TEST(UT_DKaptureShm, test_batch_001)
+{
+    DKaptureShmSegment seg(2, 8);
+    ASSERT_NE(seg.view, nullptr);
+
+    EXPECT_FALSE(dkShmBatch(seg.view, seg.size, 0).isValid());
+    // nothing written yet
+    EXPECT_FALSE(dkShmBatch(seg.view, seg.size, 5).isValid());
+
+    seg.writeBatch(5, 3);
+    dk_shm_batch_t batch = dkShmBatch(seg.view, seg.size, 5);
+    ASSERT_TRUE(batch.isValid());
+    EXPECT_EQ(batch.count, 3u);
+    EXPECT_EQ(batch.records[2].pid, 5002);
+    EXPECT_TRUE(batch.isCurrent());
+
+    // next batch goes to the other slot
+    seg.writeBatch(6, 1);
+    EXPECT_TRUE(batch.isCurrent());
+    EXPECT_EQ(dkShmBatch(seg.view, seg.size, 6).count, 1u);
+
+    // slot of batch 5 reused
+    seg.writeBatch(7, 8);
+    EXPECT_FALSE(batch.isCurrent());
+    EXPECT_FALSE(dkShmBatch(seg.view, seg.size, 5).isValid());
+}
+
+TEST(UT_DKaptureShm, test_batch_002)
+{
+    DKaptureShmSegment seg(2, 4);
+    ASSERT_NE(seg.view, nullptr);
+
+    // count written by a broken server is clamped to the slot
+    seg.writeBatch(1, 4);
+    dk_shm_slot_t *slot = dkShmSlot(seg.base, static_cast<dk_shm_header_t *>(seg.base), 1);
+    slot->count = 100000;
+    EXPECT_EQ(dkShmBatch(seg.view, seg.size, 1).count, 4u);
+
+    // batch being written
+    slot->seq.store(0);
+    EXPECT_FALSE(dkShmBatch(seg.view, seg.size, 1).isValid());
+}
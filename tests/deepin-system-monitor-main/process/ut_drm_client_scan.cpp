@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/drm_client_scan.h"
+#include "common/source_root.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <unistd.h>
+
+using namespace core::process;
+using namespace common::source;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// amdgpu style fdinfo of client id, render engine busy for busyNs
+static QByteArray amdgpuFdinfo(int clientId, quint64 busyNs)
+{
+    return QString("pos:\t0\nflags:\t02100002\nmnt_id:\t24\nino:\t1057\n"
+                   "drm-driver:\tamdgpu\ndrm-pdev:\t0000:03:00.0\ndrm-client-id:\t%1\n"
+                   "drm-memory-vram:\t2048 KiB\ndrm-memory-gtt:\t512 KiB\ndrm-memory-cpu:\t0 KiB\n"
+                   "drm-engine-gfx:\t%2 ns\ndrm-engine-compute:\t0 ns\n")
+            .arg(clientId)
+            .arg(busyNs)
+            .toUtf8();
+}
+
+class UT_DrmClientScan : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        setProcRoot(m_dir.path().toLocal8Bit());
+    }
+
+    virtual void TearDown()
+    {
+        setProcRoot(SOURCE_PROC_ROOT);
+    }
+
+    // fd of pid pointing to target, with fdinfo content
+    void addFd(pid_t pid, int fd, const char *target, const QByteArray &fdinfo)
+    {
+        QDir root(m_dir.path());
+        root.mkpath(QString("%1/fd").arg(pid));
+        root.mkpath(QString("%1/fdinfo").arg(pid));
+        QString link = root.filePath(QString("%1/fd/%2").arg(pid).arg(fd));
+        QFile::remove(link);
+        ASSERT_EQ(symlink(target, link.toLocal8Bit().constData()), 0);
+        setFdinfo(pid, fd, fdinfo);
+    }
+
+    void setFdinfo(pid_t pid, int fd, const QByteArray &fdinfo)
+    {
+        QFile file(QDir(m_dir.path()).filePath(QString("%1/fdinfo/%2").arg(pid).arg(fd)));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(fdinfo);
+    }
+
+    void removeFd(pid_t pid, int fd)
+    {
+        QDir root(m_dir.path());
+        QFile::remove(root.filePath(QString("%1/fd/%2").arg(pid).arg(fd)));
+        QFile::remove(root.filePath(QString("%1/fdinfo/%2").arg(pid).arg(fd)));
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(UT_DrmClientScan, test_parseFdinfo_001)
+{
+    drm_fdinfo_t info;
+    EXPECT_TRUE(DrmClientScan::parseFdinfo(amdgpuFdinfo(7, 1000).constData(), info));
+    EXPECT_EQ(info.pdev, QByteArray("0000:03:00.0"));
+    EXPECT_EQ(info.clientId, 7u);
+    ASSERT_EQ(info.engines.size(), 2);
+    EXPECT_EQ(info.engines[0].name, QByteArray("gfx"));
+    EXPECT_EQ(info.engines[0].busyNs, 1000u);
+    EXPECT_TRUE(info.hasVram);
+    EXPECT_EQ(info.vram, 2048u << 10);
+    EXPECT_EQ(info.memory, (2048u + 512u) << 10);
+}
+
+TEST_F(UT_DrmClientScan, test_parseFdinfo_002)
+{
+    // i915: engine capacity, system memory only; xe: cycle counters
+    drm_fdinfo_t i915;
+    EXPECT_TRUE(DrmClientScan::parseFdinfo("drm-driver:\ti915\ndrm-pdev:\t0000:00:02.0\ndrm-client-id:\t3\n"
+                                           "drm-engine-video:\t500 ns\ndrm-engine-capacity-video:\t2\n"
+                                           "drm-resident-system0:\t4 MiB\n",
+                                           i915));
+    ASSERT_EQ(i915.engines.size(), 1);
+    EXPECT_EQ(i915.engines[0].capacity, 2u);
+    EXPECT_FALSE(i915.hasVram);
+    EXPECT_EQ(i915.memory, 4u << 20);
+
+    drm_fdinfo_t xe;
+    EXPECT_TRUE(DrmClientScan::parseFdinfo("drm-client-id:\t9\ndrm-cycles-rcs:\t100\ndrm-total-cycles-rcs:\t400\n", xe));
+    ASSERT_EQ(xe.engines.size(), 1);
+    EXPECT_EQ(xe.engines[0].cycles, 100u);
+    EXPECT_EQ(xe.engines[0].totalCycles, 400u);
+
+    // regular file
+    drm_fdinfo_t file;
+    EXPECT_FALSE(DrmClientScan::parseFdinfo("pos:\t0\nflags:\t0100000\nmnt_id:\t24\n", file));
+}
+
+TEST_F(UT_DrmClientScan, test_scanProcess_001)
+{
+    // pid 100 holds the client on fds 3 & 4 (dup), pid 101 inherited it, fd 5 is not a DRM device
+    addFd(100, 3, "/dev/dri/renderD128", amdgpuFdinfo(7, 0));
+    addFd(100, 4, "/dev/dri/renderD128", amdgpuFdinfo(7, 0));
+    addFd(100, 5, "/dev/null", "pos:\t0\n");
+    addFd(101, 3, "/dev/dri/renderD128", amdgpuFdinfo(7, 0));
+
+    DrmClientScan scan;
+    int view = 0;
+
+    // nothing is read while GPU columns are not shown
+    scan.beginScan(0);
+    EXPECT_EQ(scan.scanProcess(100).memory, 0u);
+    scan.endScan();
+    EXPECT_EQ(scan.lastReads(), 0);
+
+    scan.setWanted(&view, true);
+    scan.beginScan(1000000000);
+    drm_usage_t usage = scan.scanProcess(100);
+    EXPECT_EQ(usage.gpu, 0.);
+    EXPECT_EQ(usage.memory, 2048u << 10);
+    // the client is accounted once
+    EXPECT_EQ(scan.scanProcess(101).memory, 0u);
+    scan.endScan();
+    EXPECT_EQ(scan.lastWalks(), 2);
+    EXPECT_EQ(scan.lastReads(), 3);
+
+    // gfx busy for half of the second
+    setFdinfo(100, 3, amdgpuFdinfo(7, 500000000));
+    setFdinfo(100, 4, amdgpuFdinfo(7, 500000000));
+    setFdinfo(101, 3, amdgpuFdinfo(7, 500000000));
+    scan.beginScan(2000000000);
+    usage = scan.scanProcess(100);
+    EXPECT_DOUBLE_EQ(usage.gpu, 50.);
+    EXPECT_EQ(scan.scanProcess(101).gpu, 0.);
+    scan.endScan();
+    // DRM fds are cached, only their fdinfo is read
+    EXPECT_EQ(scan.lastWalks(), 0);
+    EXPECT_EQ(scan.lastReads(), 3);
+}
+
+TEST_F(UT_DrmClientScan, test_scanProcess_002)
+{
+    addFd(100, 3, "/dev/dri/renderD128", amdgpuFdinfo(7, 0));
+    addFd(100, 4, "/dev/accel/accel0", amdgpuFdinfo(8, 0));
+
+    DrmClientScan scan;
+    int view = 0;
+    scan.setWanted(&view, true);
+    scan.beginScan(1000000000);
+    EXPECT_EQ(scan.scanProcess(100).memory, 2u * (2048u << 10));
+    scan.endScan();
+
+    // a closed fd marks the cached list stale, it is walked again on the next scan
+    removeFd(100, 4);
+    scan.beginScan(2000000000);
+    EXPECT_EQ(scan.scanProcess(100).memory, 2048u << 10);
+    scan.endScan();
+    EXPECT_EQ(scan.lastWalks(), 0);
+
+    scan.beginScan(3000000000);
+    scan.scanProcess(100);
+    scan.endScan();
+    EXPECT_EQ(scan.lastWalks(), 1);
+    ASSERT_TRUE(scan.m_pids.find(100));
+    EXPECT_EQ(scan.m_pids.find(100)->fds, QVector<int>({3}));
+
+    // processes & clients not seen by a scan are dropped
+    scan.beginScan(4000000000);
+    scan.endScan();
+    EXPECT_FALSE(scan.m_pids.contains(100));
+    EXPECT_TRUE(scan.m_drmClients.isEmpty());
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/pid_index.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QHash>
+#include <QVector>
+
+using namespace core::process;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// synthetic pid lists of one scan and the next one, 1% of the processes exit, 1% are started
+static void makeScans(int n, QVector<pid_t> &pre, QVector<pid_t> &cur)
+{
+    pre.clear();
+    cur.clear();
+    for (int i = 0; i < n; ++i) {
+        pid_t pid = 10 + i * 3;
+        pre << pid;
+        if (i % 100 != 0)
+            cur << pid;
+    }
+    for (int i = 0; i < n / 100; ++i)
+        cur << pid_t(10 + n * 3 + i);
+}
+
+TEST(UT_PidIndex, test_insert_001)
+{
+    PidIndex<int> index;
+    for (int pid = 1; pid <= 1000; ++pid)
+        index.insert(pid, pid * 2);
+
+    EXPECT_EQ(index.size(), 1000);
+    EXPECT_EQ(index.value(500), 1000);
+    EXPECT_EQ(index.value(1001, -1), -1);
+    EXPECT_EQ(index.find(2000), nullptr);
+
+    index.insert(500, 1);
+    EXPECT_EQ(index.size(), 1000);
+    EXPECT_EQ(index.value(500), 1);
+}
+
+TEST(UT_PidIndex, test_remove_001)
+{
+    PidIndex<int> index;
+    QHash<pid_t, int> ref;
+    for (int i = 0; i < 20000; ++i) {
+        pid_t pid = (i * 7919) % 4096;
+        if (i % 3 == 0) {
+            EXPECT_EQ(index.remove(pid), ref.remove(pid) > 0);
+        } else {
+            index.insert(pid, i);
+            ref.insert(pid, i);
+        }
+    }
+
+    EXPECT_EQ(index.size(), ref.size());
+    for (auto it = ref.cbegin(); it != ref.cend(); ++it)
+        EXPECT_EQ(index.value(it.key(), -1), it.value());
+    for (int i = 0; i < index.size(); ++i)
+        EXPECT_TRUE(ref.contains(index.keyAt(i)));
+}
+
+TEST(UT_PidIndex, test_clear_001)
+{
+    PidSet set;
+    set.insert(1);
+    set.insert(2);
+    set.clear();
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_FALSE(set.contains(1));
+
+    set.insert(2);
+    EXPECT_TRUE(set.contains(2));
+}
+
+// scan diff of ProcessSet: exited & started pids
+TEST(UT_PidIndex, test_scanDelta_001)
+{
+    QVector<pid_t> pre, cur;
+    makeScans(10000, pre, cur);
+
+    PidSet preIndex, curIndex;
+    for (pid_t pid : pre)
+        preIndex.insert(pid);
+    for (pid_t pid : cur)
+        curIndex.insert(pid);
+
+    int removed = 0, added = 0;
+    for (pid_t pid : pre)
+        removed += !curIndex.contains(pid);
+    for (pid_t pid : cur)
+        added += !preIndex.contains(pid);
+    EXPECT_EQ(removed, 100);
+    EXPECT_EQ(added, 100);
+    EXPECT_EQ(curIndex.size(), cur.size());
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/proc_connector.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QByteArray>
+
+#include <string.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+using namespace core::process;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// append a netlink message carrying one proc event to buf
+static void appendEvent(QByteArray &buf, quint32 what, quint64 timestampNs,
+                        pid_t pid, pid_t tgid, pid_t ppid = 0)
+{
+    QByteArray msg(NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(struct proc_event)), '\0');
+    auto *nlh = reinterpret_cast<struct nlmsghdr *>(msg.data());
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(struct proc_event));
+    nlh->nlmsg_type = NLMSG_DONE;
+    auto *cn = reinterpret_cast<struct cn_msg *>(NLMSG_DATA(nlh));
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(struct proc_event);
+
+    struct proc_event ev;
+    memset(&ev, 0, sizeof(ev));
+    memcpy(&ev.what, &what, sizeof(what));
+    ev.timestamp_ns = timestampNs;
+    if (what == 0x00000001u) {
+        ev.event_data.fork.parent_pid = __kernel_pid_t(ppid);
+        ev.event_data.fork.parent_tgid = __kernel_pid_t(ppid);
+        ev.event_data.fork.child_pid = __kernel_pid_t(pid);
+        ev.event_data.fork.child_tgid = __kernel_pid_t(tgid);
+    } else {
+        ev.event_data.exit.process_pid = __kernel_pid_t(pid);
+        ev.event_data.exit.process_tgid = __kernel_pid_t(tgid);
+    }
+    memcpy(cn->data, &ev, sizeof(ev));
+    buf.append(msg);
+}
+
+static void appendFork(QByteArray &buf, quint64 ts, pid_t pid, pid_t tgid, pid_t ppid)
+{
+    appendEvent(buf, 0x00000001u, ts, pid, tgid, ppid);
+}
+
+static void appendExit(QByteArray &buf, quint64 ts, pid_t pid, pid_t tgid)
+{
+    appendEvent(buf, 0x80000000u, ts, pid, tgid);
+}
+
+TEST(UT_ProcConnector, test_parseMessages_001)
+{
+    ProcConnector connector;
+    QByteArray buf;
+    appendFork(buf, 100, 4000000, 4000000, 1);
+    // thread of 4000000, skipped
+    appendFork(buf, 110, 4000001, 4000000, 4000000);
+    appendExit(buf, 120, 4000001, 4000000);
+    // process known to the previous take
+    appendExit(buf, 130, 3000000, 3000000);
+    // started & exited in between
+    appendFork(buf, 140, 4000002, 4000002, 1);
+    appendExit(buf, 1140, 4000002, 4000002);
+    connector.parseMessages(buf.constData(), size_t(buf.size()));
+
+    ProcChanges changes;
+    connector.takeChanges(changes);
+    EXPECT_FALSE(changes.overflowed);
+    EXPECT_EQ(changes.born, QVector<pid_t>({4000000}));
+    EXPECT_EQ(changes.exited, QVector<pid_t>({3000000}));
+    ASSERT_EQ(changes.shortLived.size(), 1);
+    EXPECT_EQ(changes.shortLived[0].pid, 4000002);
+    EXPECT_EQ(changes.shortLived[0].ppid, 1);
+    EXPECT_EQ(changes.shortLived[0].lifetimeNs, 1000u);
+
+    proc_connector_stats_t stats = connector.stats();
+    EXPECT_EQ(stats.forks, 2u);
+    EXPECT_EQ(stats.exits, 2u);
+    EXPECT_EQ(stats.shortLived, 1u);
+
+    // changes are moved out
+    connector.takeChanges(changes);
+    EXPECT_TRUE(changes.born.isEmpty());
+    EXPECT_TRUE(changes.exited.isEmpty());
+    EXPECT_TRUE(changes.shortLived.isEmpty());
+}
+
+TEST(UT_ProcConnector, test_parseMessages_002)
+{
+    ProcConnector connector;
+    QByteArray buf;
+    // pid reused by a new process between two takes
+    appendExit(buf, 100, 3000000, 3000000);
+    appendFork(buf, 200, 3000000, 3000000, 1);
+    connector.parseMessages(buf.constData(), size_t(buf.size()));
+
+    ProcChanges changes;
+    connector.takeChanges(changes);
+    EXPECT_EQ(changes.born, QVector<pid_t>({3000000}));
+    EXPECT_EQ(changes.exited, QVector<pid_t>({3000000}));
+
+    connector.markOverflow();
+    connector.takeChanges(changes);
+    EXPECT_TRUE(changes.overflowed);
+    EXPECT_EQ(connector.stats().overflows, 1u);
+}
+
+TEST(UT_ProcConnector, test_start_001)
+{
+    ProcConnector connector;
+    // needs CAP_NET_ADMIN, the listener is optional either way
+    if (connector.start()) {
+        EXPECT_TRUE(connector.isRunning());
+        connector.stop();
+    }
+    EXPECT_FALSE(connector.isRunning());
+}
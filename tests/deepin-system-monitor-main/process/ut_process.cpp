@@ -7,6 +7,7 @@
 #include "process/process.h"
 #include "common/common.h"
 #include "process/private/process_p.h"
+#include "process/dkapture_shm.h"
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
@@ -201,6 +202,27 @@ TEST_F(UT_Process, test_setState_001)
     EXPECT_EQ(state, m_tester->d->state);
 }
 
+TEST_F(UT_Process, test_applyDKaptureData_state_001)
+{
+    // DKapture 状态为位掩码, 两种传输方式解码结果一致
+    QVariantMap data;
+    data["state"] = 1;
+    m_tester->applyDKaptureData(data);
+    EXPECT_EQ(m_tester->state(), 'S');
+
+    dk_proc_record_t rec {};
+    rec.pid = getpid();
+    rec.fields = kDKFieldStat;
+    rec.state = 1;
+    m_tester->setState('R');
+    m_tester->applyDKaptureRecord(rec);
+    EXPECT_EQ(m_tester->state(), 'S');
+
+    data["state"] = 0;
+    m_tester->applyDKaptureData(data);
+    EXPECT_EQ(m_tester->state(), 'R');
+}
+
 TEST_F(UT_Process, test_cmdline_001)
 {
     QByteArrayList cmdline = m_tester->cmdline();
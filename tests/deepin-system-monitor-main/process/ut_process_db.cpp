@@ -40,8 +40,8 @@ void stub_killProcess_sendSignalToProcess(){
     return;
 }
 
-void stub_update_updateCache(){
-    return ;
+bool stub_update_updateCache(){
+    return false;
 }
 
 void stub_update_updateWindowListCache(){
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_fd_cache.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+using namespace core::process;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+class UT_ProcessFdCache : public ::testing::Test
+{
+public:
+    UT_ProcessFdCache() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessFdCache();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcessFdCache *m_tester;
+};
+
+TEST_F(UT_ProcessFdCache, initTest)
+{
+}
+
+TEST_F(UT_ProcessFdCache, test_read_001)
+{
+    char buf[1024] {};
+    pid_t pid = getpid();
+
+    ssize_t n1 = m_tester->read(pid, ProcessFdCache::kProcStat, buf, sizeof(buf) - 1);
+    EXPECT_GT(n1, 0);
+    EXPECT_EQ(m_tester->openedCount(), 1);
+
+    // second read reuses the descriptor
+    ssize_t n2 = m_tester->read(pid, ProcessFdCache::kProcStat, buf, sizeof(buf) - 1);
+    EXPECT_GT(n2, 0);
+    EXPECT_EQ(m_tester->openedCount(), 1);
+}
+
+TEST_F(UT_ProcessFdCache, test_read_002)
+{
+    char buf[64] {};
+    // pid 0 has no /proc entry
+    EXPECT_LT(m_tester->read(0, ProcessFdCache::kProcStatm, buf, sizeof(buf)), 0);
+    EXPECT_EQ(m_tester->openedCount(), 0);
+}
+
+TEST_F(UT_ProcessFdCache, test_release_001)
+{
+    char buf[1024] {};
+    pid_t pid = getpid();
+
+    m_tester->read(pid, ProcessFdCache::kProcStat, buf, sizeof(buf));
+    m_tester->read(pid, ProcessFdCache::kProcStatm, buf, sizeof(buf));
+    EXPECT_EQ(m_tester->openedCount(), 2);
+
+    m_tester->release(pid);
+    EXPECT_EQ(m_tester->openedCount(), 0);
+}
+
+TEST_F(UT_ProcessFdCache, test_lastRefreshSyscalls_001)
+{
+    char buf[1024] {};
+    pid_t pid = getpid();
+
+    // open + pread
+    m_tester->beginRefresh();
+    m_tester->read(pid, ProcessFdCache::kProcStat, buf, sizeof(buf));
+    m_tester->endRefresh();
+    EXPECT_EQ(m_tester->lastRefreshSyscalls(), 2u);
+
+    // pread only
+    m_tester->beginRefresh();
+    m_tester->read(pid, ProcessFdCache::kProcStat, buf, sizeof(buf));
+    m_tester->endRefresh();
+    EXPECT_EQ(m_tester->lastRefreshSyscalls(), 1u);
+}
@@ -5,6 +5,8 @@
 
 //self
 #include "process/process_icon.h"
+#include "process/process_icon_cache.h"
+#include "process/process_db.h"
 #include "process/private/process_p.h"
 #include "process/process.h"
 #include "process/desktop_entry_cache.h"
@@ -29,6 +31,14 @@ bool stub_str_isEmpty(){
 bool stub_getIcon_isTrayApp(){
     return true;
 }
+
+static int windowIconReads = 0;
+QImage stub_getWindowIcon(){
+    windowIconReads++;
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    return image;
+}
 /***************************************STUB end**********************************************/
 class UT_ProcessIcon : public ::testing::Test
 {
@@ -71,6 +81,20 @@ TEST_F(UT_ProcessIcon, test_icon_001)
 
 }
 
+TEST_F(UT_ProcessIcon, test_iconOf_001)
+{
+    std::shared_ptr<icon_data_t> data = ProcessIcon::shareIcon("[::test::]", m_tester->defaultIconData("foo"));
+    QIcon icon = ProcessIcon::iconOf(data);
+    EXPECT_EQ(ProcessIcon::iconOf(data).cacheKey(), icon.cacheKey());
+
+    // the key is resolved again, e.g. once desktop entries changed
+    std::shared_ptr<icon_data_t> resolved = ProcessIcon::shareIcon("[::test::]", m_tester->terminalIconData("foo"));
+    EXPECT_NE(ProcessIcon::iconOf(resolved).cacheKey(), icon.cacheKey());
+
+    EXPECT_TRUE(ProcessIcon::iconOf(nullptr).isNull());
+    ProcessIconCache::instance()->remove("[::test::]");
+}
+
 TEST_F(UT_ProcessIcon, test_defaultIconData_001)
 {
     QString proc = "111";
@@ -194,3 +218,27 @@ TEST_F(UT_ProcessIcon, test_getIcon_008)
     m_tester->getIcon(proc);
     delete proc;
 }
+
+TEST_F(UT_ProcessIcon, test_getIcon_009)
+{
+    Process *proc = new Process();
+    Stub b;
+    b.set(ADDR(WMWindowList,isGuiApp),stub_getIcon_isTrayApp);
+    Stub b1;
+    b1.set(ADDR(WMWindowList,getWindowIcon),stub_getWindowIcon);
+    QByteArrayList cmdline;
+    cmdline << "/usr/bin/null";
+    proc->d->cmdline = cmdline;
+    ProcessIconCache::instance()->m_windowKeys.clear();
+    windowIconReads = 0;
+
+    std::shared_ptr<icon_data_t> iconData = m_tester->getIcon(proc);
+    // the window icon is not read again while the window list is unchanged
+    EXPECT_EQ(m_tester->getIcon(proc), iconData);
+    EXPECT_EQ(windowIconReads, 1);
+
+    ProcessDB::instance()->windowList()->m_generation++;
+    EXPECT_EQ(m_tester->getIcon(proc), iconData);
+    EXPECT_EQ(windowIconReads, 2);
+    delete proc;
+}
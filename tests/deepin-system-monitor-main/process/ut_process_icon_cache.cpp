@@ -48,17 +48,63 @@ TEST_F(UT_ProcessIconCache, test_instance_001)
 
 }
 
-TEST_F(UT_ProcessIconCache, test_getProcessIcon_001)
+TEST_F(UT_ProcessIconCache, test_find_001)
 {
-    pid_t pid =1000;
-    m_tester->getProcessIcon(pid);
+    EXPECT_FALSE(m_tester->find("/usr/bin/foo"));
+    EXPECT_EQ(m_tester->stats().misses, 1u);
+}
+
+TEST_F(UT_ProcessIconCache, test_insert_001)
+{
+    m_tester->insert("/usr/bin/foo", std::shared_ptr<icon_data_t>(), 256);
+    EXPECT_TRUE(m_tester->contains("/usr/bin/foo"));
+    EXPECT_GE(m_tester->stats().cost, 256);
+
+    m_tester->remove("/usr/bin/foo");
+    EXPECT_FALSE(m_tester->contains("/usr/bin/foo"));
+}
+
+TEST_F(UT_ProcessIconCache, test_setMaxCost_001)
+{
+    m_tester->setMaxCost(1024);
+    m_tester->insert("/usr/bin/foo", std::shared_ptr<icon_data_t>(), 4096);
+    EXPECT_FALSE(m_tester->contains("/usr/bin/foo"));
+    EXPECT_EQ(m_tester->stats().maxCost, 1024);
+}
+
+TEST_F(UT_ProcessIconCache, test_findIcon_001)
+{
+    QIcon icon;
+    EXPECT_FALSE(m_tester->findIcon("/usr/bin/foo", nullptr, &icon));
+
+    QPixmap pixmap(16, 16);
+    pixmap.fill(Qt::red);
+    m_tester->insertIcon("/usr/bin/foo", nullptr, QIcon(pixmap));
+    EXPECT_TRUE(m_tester->findIcon("/usr/bin/foo", nullptr, &icon));
+    EXPECT_FALSE(icon.isNull());
+}
+
+TEST_F(UT_ProcessIconCache, test_findWindowKey_001)
+{
+    QString key;
+    EXPECT_FALSE(m_tester->findWindowKey(10, 100, &key));
 
+    m_tester->setWindowKey(10, 100, "[::window::]16x16:00");
+    EXPECT_TRUE(m_tester->findWindowKey(10, 100, &key));
+    EXPECT_EQ(key, QString("[::window::]16x16:00"));
+    // another window of the same pid is read again
+    EXPECT_FALSE(m_tester->findWindowKey(10, 101, &key));
 }
 
-TEST_F(UT_ProcessIconCache, test_addProcessIcon_001)
+TEST_F(UT_ProcessIconCache, test_syncWindowKeys_001)
 {
-    pid_t pid =1000;
-    ProcessIcon *icon = new ProcessIcon();
-    m_tester->addProcessIcon(pid,icon);
+    QString key;
+    m_tester->setWindowKey(10, 100, QString());
+    m_tester->syncWindowKeys(0);
+    EXPECT_TRUE(m_tester->findWindowKey(10, 100, &key));
+    EXPECT_TRUE(key.isEmpty());
 
+    // the window list changed
+    m_tester->syncWindowKeys(1);
+    EXPECT_FALSE(m_tester->findWindowKey(10, 100, &key));
 }
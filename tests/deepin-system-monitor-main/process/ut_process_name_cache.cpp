@@ -14,11 +14,8 @@
 #include <QCache>
 using namespace core::process;
 
-typedef QCache<pid_t, ProcessName> myCache;
 /***************************************STUB begin*********************************************/
-void stub_insert_insert(){
-    return;
-}
+
 /***************************************STUB end**********************************************/
 class UT_ProcessNameCache : public ::testing::Test
 {
@@ -55,30 +52,42 @@ TEST_F(UT_ProcessNameCache, test_instance_001)
 
 TEST_F(UT_ProcessNameCache, test_insert_001)
 {
-    ProcessName *name = new ProcessName;
-    Stub b;
-    b.set(ADDR(myCache,insert),stub_insert_insert);
-    m_tester->insert(1000,name);
-    delete name;
+    auto name = std::make_shared<display_name_t>();
+    name->kind = kDisplayNameFixed;
+    name->name = "Foo";
+    m_tester->insert("foo\n/usr/bin/foo\n\n00", name);
+    EXPECT_TRUE(m_tester->contains("foo\n/usr/bin/foo\n\n00"));
 }
 
 TEST_F(UT_ProcessNameCache, test_remove_001)
 {
-    m_tester->remove(1000);
+    m_tester->insert("foo", std::make_shared<display_name_t>());
+    m_tester->remove("foo");
+    EXPECT_FALSE(m_tester->contains("foo"));
 }
 
 
 TEST_F(UT_ProcessNameCache, test_clear_001)
 {
+    m_tester->insert("foo", std::make_shared<display_name_t>());
     m_tester->clear();
+    EXPECT_EQ(m_tester->stats().entries, 0);
 }
 
-TEST_F(UT_ProcessNameCache, test_processName_001)
+TEST_F(UT_ProcessNameCache, test_find_001)
 {
-    m_tester->processName(1000);
+    EXPECT_FALSE(m_tester->find("foo"));
+
+    // workers of the same program share one resolved name
+    auto name = std::make_shared<display_name_t>();
+    m_tester->insert("foo", name);
+    EXPECT_EQ(m_tester->find("foo"), name);
+    EXPECT_EQ(m_tester->find("foo"), name);
+    EXPECT_EQ(m_tester->stats().hits, 2u);
+    EXPECT_EQ(m_tester->stats().misses, 1u);
 }
 
 TEST_F(UT_ProcessNameCache, test_contains_001)
 {
-    m_tester->contains(1000);
+    EXPECT_FALSE(m_tester->contains("foo"));
 }
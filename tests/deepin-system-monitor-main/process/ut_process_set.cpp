@@ -8,6 +8,7 @@
 #include "process/process_db.h"
 #include "common/common.h"
 #include "wm/wm_window_list.h"
+#include "process/system_service_client.h"
 
 //gtest
 #include "stub.h"
@@ -15,6 +16,24 @@
 
 using namespace core::process;
 /***************************************STUB begin*********************************************/
+// batch whose slot the writer already reused for a later batch
+static dk_shm_slot_t tornSlot;
+static dk_proc_record_t tornRecord;
+dk_shm_batch_t stub_readProcessInfoShm()
+{
+    tornSlot.seq.store(2);
+    memset(&tornRecord, 0, sizeof(tornRecord));
+    tornRecord.pid = getpid();
+    tornRecord.fields = kDKFieldStat;
+    tornRecord.ppid = 1;
+
+    dk_shm_batch_t batch;
+    batch.slot = &tornSlot;
+    batch.records = &tornRecord;
+    batch.count = 1;
+    batch.seq = 1;
+    return batch;
+}
 
 /***************************************STUB end**********************************************/
 class UT_ProcessSet : public ::testing::Test
@@ -135,3 +154,76 @@ TEST_F(UT_ProcessSet, test_updateProcessPriority_001)
     pid_t pid = getpid();
     m_tester->updateProcessPriority(pid,0);
 }
+
+TEST_F(UT_ProcessSet, test_readProcessStats_001)
+{
+    QVector<Process> procs;
+    procs << Process(getpid());
+    m_tester->readProcessStats(procs);
+    EXPECT_TRUE(procs[0].isValid());
+}
+
+TEST_F(UT_ProcessSet, test_readProcessStats_002)
+{
+    // sharded over the worker pool
+    m_tester->m_refreshPool.reset(new QThreadPool());
+    m_tester->m_refreshPool->setMaxThreadCount(3);
+
+    // distinct pids, a pid is only read by the shard it falls in
+    m_tester->collectPids();
+    QVector<Process> procs;
+    for (const pid_t &pid : m_tester->m_curPid)
+        procs << Process(pid);
+    m_tester->readProcessStats(procs);
+
+    // processes may exit while read, not this one
+    int self = -1;
+    for (int i = 0; i < procs.size(); ++i) {
+        if (procs[i].pid() == getpid())
+            self = i;
+    }
+    ASSERT_GE(self, 0);
+    EXPECT_TRUE(procs[self].isValid());
+}
+
+TEST_F(UT_ProcessSet, test_lastDelta_001)
+{
+    m_tester->refresh();
+    const ProcessSetDelta &delta = m_tester->lastDelta();
+    EXPECT_EQ(delta.seq, 1u);
+    EXPECT_EQ(delta.added.size(), m_tester->processCount());
+    EXPECT_TRUE(delta.removed.isEmpty());
+
+    m_tester->refresh();
+    EXPECT_EQ(m_tester->lastDelta().seq, 2u);
+    for (const pid_t &pid : m_tester->lastDelta().changed)
+        EXPECT_TRUE(m_tester->getProcessById(pid).isValid());
+}
+
+TEST_F(UT_ProcessSet, test_removeProcess_002)
+{
+    m_tester->refresh();
+    pid_t pid = getpid();
+    m_tester->removeProcess(pid);
+    EXPECT_FALSE(m_tester->getProcessById(pid).isValid());
+
+    // still alive, reported as added again
+    m_tester->refresh();
+    EXPECT_TRUE(m_tester->lastDelta().added.contains(pid));
+}
+
+TEST_F(UT_ProcessSet, test_scanProcess_dkapture_001)
+{
+    Stub b;
+    b.set(ADDR(SystemServiceClient, readProcessInfoShm), stub_readProcessInfoShm);
+    m_tester->m_useSystemService = true;
+    m_tester->m_systemServiceClient = reinterpret_cast<SystemServiceClient *>(&tornSlot);
+
+    // records of an overwritten batch are not applied, the processes are read from /proc
+    m_tester->refresh();
+    m_tester->m_systemServiceClient = nullptr;
+    const Process *self = m_tester->m_set.find(getpid());
+    ASSERT_TRUE(self != nullptr);
+    EXPECT_EQ(self->ppid(), getppid());
+    EXPECT_TRUE(m_tester->m_dkaptureRecords.isEmpty());
+}
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/sock_inode_scan.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+using namespace core::process;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+TEST(UT_SockInodeScan, test_setWanted_001)
+{
+    SockInodeScan scan;
+    int view1 = 0, view2 = 0;
+
+    scan.beginScan();
+    EXPECT_FALSE(scan.isWanted());
+
+    scan.setWanted(&view1, true);
+    scan.setWanted(&view2, true);
+    scan.setWanted(&view1, false);
+    // demand is sampled at the beginning of a scan only
+    EXPECT_FALSE(scan.isWanted());
+    scan.beginScan();
+    EXPECT_TRUE(scan.isWanted());
+
+    scan.setWanted(&view2, false);
+    scan.beginScan();
+    EXPECT_FALSE(scan.isWanted());
+}
+
+TEST(UT_SockInodeScan, test_needsWalk_001)
+{
+    SockInodeScan scan;
+    SockInodeScanState state;
+    int view = 0;
+
+    // nothing is walked while network stats are not wanted
+    scan.beginScan();
+    EXPECT_FALSE(scan.needsWalk(1, state, 64));
+
+    scan.setWanted(&view, true);
+    scan.beginScan();
+    // first walk, then only when FDSize changes
+    EXPECT_TRUE(scan.needsWalk(1, state, 64));
+    EXPECT_EQ(state.fdSize, 64);
+    EXPECT_FALSE(scan.needsWalk(1, state, 64));
+    EXPECT_TRUE(scan.needsWalk(1, state, 128));
+
+    // demand turned off & on again walks every process
+    scan.setWanted(&view, false);
+    scan.beginScan();
+    scan.setWanted(&view, true);
+    scan.beginScan();
+    EXPECT_TRUE(scan.needsWalk(1, state, 128));
+}
+
+TEST(UT_SockInodeScan, test_needsWalk_002)
+{
+    SockInodeScan scan;
+    SockInodeScanState state;
+    int view = 0;
+
+    scan.setWanted(&view, true);
+    scan.beginScan();
+    EXPECT_TRUE(scan.needsWalk(7, state, 64));
+
+    // unchanged processes are walked again periodically
+    int walks = 0;
+    for (int i = 0; i < 20; ++i) {
+        scan.beginScan();
+        if (scan.needsWalk(7, state, 64))
+            ++walks;
+    }
+    EXPECT_GT(walks, 0);
+    EXPECT_LT(walks, 20);
+
+    // unreadable fd directories are retried on periodic walks only
+    SockInodeScanState denied;
+    denied.readable = false;
+    walks = 0;
+    for (int i = 0; i < 20; ++i) {
+        scan.beginScan();
+        if (scan.needsWalk(7, denied, -1))
+            ++walks;
+    }
+    EXPECT_LT(walks, 20);
+}
@@ -5,11 +5,18 @@
 
 //self
 #include "service/service_manager_worker.h"
+#include "service/system_service_entry.h"
+#include "dbus/systemd1_unit_interface.h"
 
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 
+//Qt
+#include <QSignalSpy>
+#include <QDBusObjectPath>
+#include <QTimer>
+
 static QString m_Sresult;
 /***************************************STUB begin*********************************************/
 
@@ -72,3 +79,92 @@ TEST_F(UT_ServiceManagerWorker, test_startJob_01)
 {
     m_tester->startJob();
 }
+
+TEST_F(UT_ServiceManagerWorker, test_applyUnitProperties_01)
+{
+    QVariantMap props;
+    props["Id"] = "cron.service";
+    props["LoadState"] = "loaded";
+    props["ActiveState"] = "active";
+    props["SubState"] = "running";
+    props["Description"] = "Regular background program processing daemon";
+    props["CanStart"] = true;
+    props["CanStop"] = true;
+    props["CanReload"] = false;
+    props["UnitFileState"] = "enabled";
+
+    SystemServiceEntry entry;
+    ServiceManagerWorker::applyUnitProperties(entry, props);
+    EXPECT_EQ(entry.getId(), "cron.service");
+    EXPECT_EQ(entry.getSName(), "cron");
+    EXPECT_EQ(entry.getActiveState(), "active");
+    EXPECT_EQ(entry.getSubState(), "running");
+    EXPECT_EQ(entry.getState(), "enabled");
+    EXPECT_TRUE(entry.getCanStart());
+    EXPECT_FALSE(entry.getCanReload());
+    EXPECT_FALSE(entry.getStartupType().isEmpty());
+
+    // name & unit file state of an alias are kept
+    SystemServiceEntry alias;
+    alias.setSName("dbus-org.freedesktop.cron");
+    alias.setState("alias");
+    ServiceManagerWorker::applyUnitProperties(alias, props);
+    EXPECT_EQ(alias.getSName(), "dbus-org.freedesktop.cron");
+    EXPECT_EQ(alias.getState(), "alias");
+    EXPECT_EQ(alias.getId(), "cron.service");
+}
+
+TEST_F(UT_ServiceManagerWorker, test_onUnitRemoved_01)
+{
+    QString cronPath = Systemd1UnitInterface::normalizeUnitPath("cron.service").path();
+    QString runPath = Systemd1UnitInterface::normalizeUnitPath("run-u1.service").path();
+
+    SystemServiceEntry cron("cron.service", "cron", "loaded", "active", "running", "enabled", "",
+                            cronPath, "cron", 1234, false, true, true);
+    SystemServiceEntry run("run-u1.service", "run-u1", "loaded", "active", "running", "", "",
+                           runPath, "transient", 4321, false, true, true);
+    m_tester->m_entries.insert(cronPath, cron);
+    m_tester->m_entries.insert(runPath, run);
+    m_tester->m_unitFileStates.insert("cron.service", "enabled");
+    m_tester->m_changedPaths << cronPath;
+
+    QSignalSpy updated(m_tester, &ServiceManagerWorker::entryUpdated);
+    QSignalSpy removed(m_tester, &ServiceManagerWorker::entryRemoved);
+
+    // installed service stays listed as stopped, the emitted entry is not touched
+    m_tester->onUnitRemoved("cron.service", QDBusObjectPath(cronPath));
+    ASSERT_EQ(updated.count(), 1);
+    SystemServiceEntry stopped = updated.at(0).at(0).value<SystemServiceEntry>();
+    EXPECT_EQ(stopped.getActiveState(), "inactive");
+    EXPECT_EQ(stopped.getMainPID(), 0u);
+    EXPECT_EQ(cron.getActiveState(), "active");
+    EXPECT_FALSE(m_tester->m_changedPaths.contains(cronPath));
+
+    // transient unit goes away
+    m_tester->onUnitRemoved("run-u1.service", QDBusObjectPath(runPath));
+    ASSERT_EQ(removed.count(), 1);
+    EXPECT_EQ(removed.at(0).at(0).toString(), "run-u1");
+    EXPECT_FALSE(m_tester->m_entries.contains(runPath));
+
+    // unknown unit
+    m_tester->onUnitRemoved("foo.service", QDBusObjectPath(Systemd1UnitInterface::normalizeUnitPath("foo.service").path()));
+    EXPECT_EQ(updated.count(), 1);
+    EXPECT_EQ(removed.count(), 1);
+}
+
+TEST_F(UT_ServiceManagerWorker, test_onUnitNew_01)
+{
+    QString cronPath = Systemd1UnitInterface::normalizeUnitPath("cron.service").path();
+    m_tester->m_entries.insert(cronPath, SystemServiceEntry());
+
+    // known units & other unit types are ignored
+    m_tester->onUnitNew("cron.service", QDBusObjectPath(cronPath));
+    m_tester->onUnitNew("tmp.mount", QDBusObjectPath(Systemd1UnitInterface::normalizeUnitPath("tmp.mount").path()));
+    EXPECT_TRUE(m_tester->m_changedPaths.isEmpty());
+
+    QString sshPath = Systemd1UnitInterface::normalizeUnitPath("ssh.service").path();
+    m_tester->onUnitNew("ssh.service", QDBusObjectPath(sshPath));
+    EXPECT_TRUE(m_tester->m_changedPaths.contains(sshPath));
+    // nothing listed yet, the first full load picks it up
+    EXPECT_FALSE(m_tester->m_refreshTimer->isActive());
+}
@@ -16,6 +16,9 @@
 #include <QFile>
 #include <QIODevice>
 #include <QTextStream>
+#include <QVector>
+
+#include "common/common.h"
 
 using namespace core::system;
 
@@ -122,33 +125,48 @@ TEST_F(UT_BlockDevice, test_readDeviceSize_02)
 
 TEST_F(UT_BlockDevice, test_calcDiskIoStates)
 {
-    QFile file(PROC_PATH_DISK);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return;
-    }
-    QList<QStringList> strList;
-    QTextStream in(&file);
-
-    QString line;
-    do{
-        line = in.readLine();
-        if (!line.contains("loop")){
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            strList << line.split(" ", QString::SkipEmptyParts);
-#else
-            strList << line.split(" ", Qt::SkipEmptyParts);
-#endif
-        }
-    }while (!line.isNull());
-    file.close();
-
-    if (strList.size()){
-        QStringList deviceInfo = strList[0];
-        if (deviceInfo.size() > 16 && deviceInfo[2] == m_tester->d->name) {
-            m_tester->calcDiskIoStates(deviceInfo);
-            EXPECT_TRUE(m_tester->readSpeed() != 0);
-        }
-     }
+    const char content[] =
+        "   8       0 sda 100 10 2000 50 200 20 4000 80 0 120 130 0 0 0 0 0 0\n";
+    QVector<DiskStats> rows;
+    DiskStatsReader::parse(content, sizeof(content) - 1, rows);
+    ASSERT_EQ(rows.size(), 1);
+
+    m_tester->d->name = "sda";
+    m_tester->calcDiskIoStates(rows[0], 2);
+    EXPECT_EQ(m_tester->readSpeed(), 2000u * SECTOR_SIZE / 2);
+    EXPECT_EQ(m_tester->writeSpeed(), 4000u * SECTOR_SIZE / 2);
+}
+
+TEST_F(UT_BlockDevice, test_updateStats)
+{
+    const char first[] =
+        " 259       0 nvme0n1 100 10 2000 50 200 20 4000 80 1 120 130 5 0 64 3 7 2\n";
+    const char second[] =
+        " 259       0 nvme0n1 300 30 6000 90 400 40 8000 100 0 620 700 9 0 128 4 9 3\n";
+    DiskStatsReader reader;
+
+    m_tester->setDeviceName("nvme0n1");
+    DiskStatsReader::parse(first, sizeof(first) - 1, reader.m_rows);
+    EXPECT_TRUE(m_tester->updateStats(reader, timeval {10, 0}));
+    EXPECT_EQ(m_tester->inFlight(), 1u);
+    EXPECT_EQ(m_tester->flushesCompleted(), 7u);
+    EXPECT_EQ(m_tester->readSpeed(), 0u);
+
+    DiskStatsReader::parse(second, sizeof(second) - 1, reader.m_rows);
+    EXPECT_TRUE(m_tester->updateStats(reader, timeval {12, 0}));
+    EXPECT_EQ(m_tester->readIssuer(), 300u);
+    EXPECT_EQ(m_tester->readRequestIssuedPerSecond(), 100.);
+    EXPECT_EQ(m_tester->sectorsWrittenPerSecond(), 2000.);
+    EXPECT_EQ(m_tester->readSpeed(), 2000u * SECTOR_SIZE);
+    // 500ms busy in 2s
+    EXPECT_DOUBLE_EQ(m_tester->percentUtilization(), .25);
+    EXPECT_EQ(m_tester->ioTicks(), 620u);
+    EXPECT_EQ(m_tester->weightedIoTicks(), 700u);
+    EXPECT_EQ(m_tester->discardsCompleted(), 9u);
+    EXPECT_EQ(m_tester->sectorsDiscarded(), 128u);
+
+    m_tester->setDeviceName("sdz");
+    EXPECT_FALSE(m_tester->updateStats(reader, timeval {14, 0}));
 }
 
 TEST_F(UT_BlockDevice, test_deviceName)
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/collector.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QString>
+
+using namespace core::system;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+TEST(UT_CollectorSet, test_tick_001)
+{
+    QString runs;
+    CollectorSet collectors(2000);
+    collectors.add("fast", 2000, [&runs]() { runs += "f"; });
+    // rounded up to 3 ticks
+    collectors.add("slow", 5000, [&runs]() { runs += "s"; });
+    // never faster than a tick
+    collectors.add("eager", 0, [&runs]() { runs += "e"; });
+
+    for (int i = 0; i < 4; ++i) {
+        collectors.tick();
+        runs += "|";
+    }
+    EXPECT_EQ(runs, QString("fse|fe|fe|fse|"));
+}
+
+TEST(UT_CollectorSet, test_tick_002)
+{
+    int counters = 0;
+    int processes = 0;
+    CollectorSet collectors(1000);
+    collectors.add("cpu", 1000, [&counters]() { counters++; });
+    collectors.add("processes", 2000, [&processes]() { processes++; });
+
+    int runs = 0;
+    for (int i = 0; i < 4; ++i)
+        runs += collectors.tick();
+    EXPECT_EQ(counters, 4);
+    EXPECT_EQ(processes, 2);
+    EXPECT_EQ(runs, 6);
+}
+
+TEST(UT_CollectorSet, test_collectAll_001)
+{
+    int slow = 0;
+    CollectorSet collectors(1000);
+    collectors.add("slow", 3000, [&slow]() { slow++; });
+
+    collectors.tick();
+    collectors.tick();
+    // restarts the cadence
+    collectors.collectAll();
+    EXPECT_EQ(slow, 2);
+    EXPECT_EQ(collectors.tick(), 0);
+    EXPECT_EQ(collectors.tick(), 0);
+    EXPECT_EQ(collectors.tick(), 1);
+    EXPECT_EQ(slow, 3);
+}
+
+TEST(UT_CollectorSet, test_collector_001)
+{
+    CollectorSet collectors(1000);
+    collectors.add("cpu", 1000, []() {});
+
+    Collector *collector = collectors.collector("cpu");
+    ASSERT_TRUE(collector != nullptr);
+    EXPECT_STREQ(collector->name(), "cpu");
+    EXPECT_EQ(collector->interval(), 1000);
+    EXPECT_TRUE(collectors.collector("gpu") == nullptr);
+}
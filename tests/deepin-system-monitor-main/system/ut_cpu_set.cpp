@@ -324,3 +324,23 @@ TEST_F(UT_CPUSet, test_getUsageTotalDelta_02)
     qulonglong totalDelta = m_tester->getUsageTotalDelta();
     EXPECT_NE(totalDelta, 0);
 }
+
+static int g_overallInfoReads = 0;
+void stub_read_overall_info(void *obj)
+{
+    g_overallInfoReads++;
+    static_cast<CPUSet *>(obj)->d->m_topologyLoaded = true;
+}
+
+TEST_F(UT_CPUSet, test_update_topology_cached)
+{
+    Stub stub;
+    stub.set(ADDR(CPUSet, read_overall_info), stub_read_overall_info);
+    stub.set(ADDR(CPUSet, topology_changed), stub_contains);
+
+    g_overallInfoReads = 0;
+    m_tester->update();
+    m_tester->update();
+    m_tester->update();
+    EXPECT_EQ(g_overallInfoReads, 1);
+}
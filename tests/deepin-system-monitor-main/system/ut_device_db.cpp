@@ -12,6 +12,7 @@
 #include "system/diskio_info.h"
 #include "system/net_info.h"
 #include "system/gpu_info.h"
+#include "system/collector.h"
 
 //gtest
 #include "stub.h"
@@ -103,4 +104,17 @@ TEST_F(UT_DeviceDB, test_gpuInfoSet)
     EXPECT_GE(m_tester->gpuInfoSet()->gpuCount(), 0);
 }
 
-
+TEST_F(UT_DeviceDB, test_addCollectors)
+{
+    CollectorSet collectors(1000);
+    m_tester->addCollectors(collectors);
+
+    // counters are refreshed more often than block devices & gpus
+    const int counter = collectors.collector("cpu")->interval();
+    EXPECT_EQ(collectors.collector("memory")->interval(), counter);
+    EXPECT_EQ(collectors.collector("netifs")->interval(), counter);
+    EXPECT_EQ(collectors.collector("net_io")->interval(), counter);
+    EXPECT_LT(counter, collectors.collector("block_devices")->interval());
+    EXPECT_LT(counter, collectors.collector("disk_io")->interval());
+    EXPECT_LT(counter, collectors.collector("gpu")->interval());
+}
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/disk_stats.h"
+#include "system/block_device.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//qt
+#include <QFile>
+#include <QString>
+
+using namespace core::system;
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// diskstats content of n devices, rows in the 5.5+ kernel format
+static QByteArray makeDiskStats(int n)
+{
+    QByteArray content;
+    for (int i = 0; i < n; ++i) {
+        content += QString("%1 %2 nvme%3n1 %4 10 2000 50 200 20 4000 80 1 120 130 5 0 64 3 7 2\n")
+                   .arg(259, 4)
+                   .arg(i, 7)
+                   .arg(i)
+                   .arg(100 + i)
+                   .toLatin1();
+    }
+    return content;
+}
+
+TEST(UT_DiskStats, test_parse_001)
+{
+    // 4.18 (15 fields), pre 4.18 (11 fields), 5.5+ (17 fields) & a malformed line
+    const char content[] =
+        "   8       0 sda 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15\n"
+        "   8       1 sda1 1 2 3 4 5 6 7 8 9 10 11\n"
+        " 253       0 dm-0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17\n"
+        "   7       0 loop0 1 2\n";
+    QVector<DiskStats> rows;
+    DiskStatsReader::parse(content, sizeof(content) - 1, rows);
+
+    ASSERT_EQ(rows.size(), 3);
+    EXPECT_STREQ(rows[0].name, "sda");
+    EXPECT_EQ(rows[0].major, 8u);
+    EXPECT_EQ(rows[0].nfields, 15);
+    EXPECT_EQ(rows[0][DiskStats::kSectorsDiscarded], 14u);
+    EXPECT_EQ(rows[0][DiskStats::kFlushesCompleted], 0u);
+
+    EXPECT_STREQ(rows[1].name, "sda1");
+    EXPECT_EQ(rows[1].minor, 1u);
+    EXPECT_EQ(rows[1].nfields, 11);
+    EXPECT_EQ(rows[1][DiskStats::kWeightedIoTicks], 11u);
+    EXPECT_EQ(rows[1][DiskStats::kDiscardsCompleted], 0u);
+
+    EXPECT_STREQ(rows[2].name, "dm-0");
+    EXPECT_EQ(rows[2].nfields, 17);
+    EXPECT_EQ(rows[2][DiskStats::kInFlight], 9u);
+    EXPECT_EQ(rows[2][DiskStats::kFlushTicks], 17u);
+}
+
+TEST(UT_DiskStats, test_find_001)
+{
+    DiskStatsReader reader("/nonexistent/diskstats");
+    EXPECT_FALSE(reader.update());
+
+    QByteArray content = makeDiskStats(8);
+    DiskStatsReader::parse(content.constData(), size_t(content.size()), reader.m_rows);
+
+    int hint = -1;
+    const DiskStats *stats = reader.find("nvme5n1", hint);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(hint, 5);
+    EXPECT_EQ((*stats)[DiskStats::kReadsCompleted], 105u);
+
+    // stale hint
+    hint = 2;
+    EXPECT_EQ(reader.find("nvme5n1", hint), stats);
+    EXPECT_EQ(hint, 5);
+
+    EXPECT_EQ(reader.find("sdz", hint), nullptr);
+    EXPECT_EQ(hint, -1);
+}
+
+TEST(UT_DiskStats, test_update_001)
+{
+    DiskStatsReader reader;
+    if (!QFile::exists(PROC_PATH_DISK))
+        return;
+
+    EXPECT_TRUE(reader.update());
+    // re-read through the same descriptor
+    int rows = reader.rows().size();
+    EXPECT_TRUE(reader.update());
+    EXPECT_EQ(reader.rows().size(), rows);
+}
@@ -95,6 +95,39 @@ TEST_F(UT_NetifMonitor, test_handleNetData)
 //    m_tester->handleNetData();
 }
 
+TEST_F(UT_NetifMonitor, test_aggregatePackets)
+{
+    QVector<struct packet_payload_t> packets;
+    for (int i = 0; i < 100; ++i) {
+        struct packet_payload_t payload {};
+        payload.ino = ino_t(10 + i % 3);
+        payload.direction = (i % 2) ? kOutboundPacket : kInboundPacket;
+        payload.payload = 100;
+        packets << payload;
+    }
+
+    QVector<struct sock_io_stat_t> stats;
+    NetifMonitor::aggregatePackets(packets.constData(), packets.size(), stats);
+    ASSERT_EQ(stats.size(), 3);
+    qulonglong rx = 0, tx = 0, rxPackets = 0, txPackets = 0;
+    for (const struct sock_io_stat_t &stat : stats) {
+        rx += stat.rx_bytes;
+        tx += stat.tx_bytes;
+        rxPackets += stat.rx_packets;
+        txPackets += stat.tx_packets;
+    }
+    EXPECT_EQ(rx, 5000u);
+    EXPECT_EQ(tx, 5000u);
+    EXPECT_EQ(rxPackets + txPackets, 100u);
+
+    // one lock for the whole batch, stats are taken by inode
+    m_tester->mergeSockIOStats(stats);
+    SockIOStat stat;
+    EXPECT_TRUE(m_tester->getSockIOStatByInode(10, stat));
+    EXPECT_EQ(stat->rx_packets + stat->tx_packets, 34u);
+    EXPECT_FALSE(m_tester->getSockIOStatByInode(10, stat));
+}
+
 //TEST_F(UT_NetifMonitor, test_getSockIOStatByInode)
 //{
 //    Stub stub;
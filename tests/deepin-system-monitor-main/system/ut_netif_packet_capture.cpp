@@ -79,7 +79,7 @@ bool stub_hasDevIP_true()
 
 bool stub_parsePacket_false(const pcap_pkthdr *pkt_hdr,
                                     const u_char *packet,
-                                    PacketPayload &payload)
+                                    struct packet_payload_t &payload)
 {
     return false;
 }
@@ -94,14 +94,6 @@ pcap_t	*stub_pcap_create_false(const char *, char *)
     return nullptr;
 }
 
-int	stub_localPendingPackets_64()
-{
-    return 65;
-}
-int	stub_localPendingPackets_255()
-{
-    return 255;
-}
 
 /***************************************STUB end**********************************************/
 
@@ -300,27 +292,18 @@ TEST_F(UT_NetifPacketCapture, test_dispatchPackets_03)
 {
     m_tester->go = true;
     m_tester->m_devName = nullptr;
-    Stub stub;
-    stub.set(ADDR(PacketPayloadQueue, size), stub_localPendingPackets_64);
-    m_tester->dispatchPackets();
-}
-TEST_F(UT_NetifPacketCapture, test_dispatchPackets_04)
-{
-    m_tester->go = true;
-    Stub stub;
-    stub.set(ADDR(PacketPayloadQueue, size), stub_localPendingPackets_64);
     m_tester->dispatchPackets();
 }
 
-TEST_F(UT_NetifPacketCapture, test_dispatchPackets_05)
+TEST_F(UT_NetifPacketCapture, test_dispatchPackets_04)
 {
+    // no pcap handle, socket counters are polled instead
     m_tester->go = true;
-    Stub stub;
-    stub.set(ADDR(PacketPayloadQueue, size), stub_localPendingPackets_255);
+    m_tester->m_devName = "lo";
+    m_tester->m_handle = nullptr;
     m_tester->dispatchPackets();
 }
 
-
 TEST_F(UT_NetifPacketCapture, test_dispatchPackets_06)
 {
     m_tester->go = false;
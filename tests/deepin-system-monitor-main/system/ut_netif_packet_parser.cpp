@@ -60,7 +60,7 @@ TEST_F(UT_NetifPacketParser, test_parsePacket_01)
     pcap_pkthdr hdr;
     memset(&hdr,0,sizeof(pcap_pkthdr));
     const u_char packet[64] = {0};
-    PacketPayload payload = nullptr;
+    struct packet_payload_t payload {};
 
     Stub stub;
     stub.set(ntohs, stub_ntohs_IP);
@@ -72,7 +72,7 @@ TEST_F(UT_NetifPacketParser, test_parsePacket_02)
     pcap_pkthdr hdr;
     memset(&hdr,0,sizeof(pcap_pkthdr));
     const u_char packet[64] = {0};
-    PacketPayload payload = QSharedPointer<struct packet_payload_t>::create();
+    struct packet_payload_t payload {};
 
     Stub stub;
     stub.set(ntohs, stub_ntohs_IP);
@@ -85,7 +85,7 @@ TEST_F(UT_NetifPacketParser, test_parsePacket_03)
     memset(&hdr,0,sizeof(pcap_pkthdr));
     hdr.caplen = 15;
     const u_char packet[64] = {0};
-    PacketPayload payload = QSharedPointer<struct packet_payload_t>::create();
+    struct packet_payload_t payload {};
 
     Stub stub;
     stub.set(ntohs, stub_ntohs_IP);
@@ -97,7 +97,7 @@ TEST_F(UT_NetifPacketParser, test_parsePacket_04)
 //    pcap_pkthdr hdr;
 //    memset(&hdr,0,sizeof(hdr));
 //    const u_char packet[64] = {0};
-//    PacketPayload payload = QSharedPointer<struct packet_payload_t>::create();
+//    struct packet_payload_t payload {};
 
 //    Stub stub;
 //    stub.set(ntohs, stub_ntohs_IPV6);
@@ -118,7 +118,7 @@ TEST_F(UT_NetifPacketParser, test_parsePacket_05)
 //    memcpy(packet, &header, eth_hdr_len);
 //    memcpy(packet+eth_hdr_len, &ip6body, ip6_len);
 //    const u_char packet1[eth_hdr_len + ip6_len+1]= "00000000000000<<<<<<<<<<";
-//    PacketPayload payload = QSharedPointer<struct packet_payload_t>::create();
+//    struct packet_payload_t payload {};
 
 //    Stub stub;
 //    stub.set(ntohs, stub_ntohs_IPV6);
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/nvidia_smi_stream.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+
+using namespace core::system;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// streams two canned records, then stays alive like nvidia-smi in loop mode
+static const char kFakeNvidiaSmi[] =
+    "#!/bin/sh\n"
+    "echo \"0, Fake GPU A, 42, 10, 8192, 1024, 7168, 55, 1500, 00000000:01:00.0\"\n"
+    "echo \"1, Fake GPU B, 7, 1, 4096, 512, 3584, 40, 900, 00000000:02:00.0\"\n"
+    "exec sleep 60\n";
+
+static QString writeFakeTool(const QTemporaryDir &dir)
+{
+    const QString path = dir.filePath("nvidia-smi");
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return QString();
+    file.write(kFakeNvidiaSmi);
+    file.close();
+    file.setPermissions(file.permissions() | QFileDevice::ExeOwner);
+    return path;
+}
+
+TEST(UT_NvidiaSmiStream, test_parseRecord_001)
+{
+    gpu_info_t gpu;
+    EXPECT_TRUE(NvidiaSmiStream::parseRecord("0, Fake GPU A, 42, 10, 8192, 1024, 7168, 55, 1500, 00000000:01:00.0", gpu));
+    EXPECT_EQ(gpu.index, 0);
+    EXPECT_EQ(gpu.name, "Fake GPU A");
+    EXPECT_EQ(gpu.vendor, "NVIDIA");
+    EXPECT_FLOAT_EQ(gpu.gpuUtilization, 42);
+    EXPECT_EQ(gpu.totalMemory, 8192ull * 1024 * 1024);
+    EXPECT_EQ(gpu.usedMemory, 1024ull * 1024 * 1024);
+    EXPECT_EQ(gpu.clockSpeed, 1500u);
+    EXPECT_EQ(gpu.busInfo, "PCIe 00000000:01:00.0");
+    EXPECT_TRUE(gpu.isAvailable);
+}
+
+TEST(UT_NvidiaSmiStream, test_parseRecord_002)
+{
+    gpu_info_t gpu;
+    EXPECT_FALSE(NvidiaSmiStream::parseRecord("", gpu));
+    EXPECT_FALSE(NvidiaSmiStream::parseRecord("0, Fake GPU A, 42", gpu));
+    EXPECT_FALSE(NvidiaSmiStream::parseRecord("index, name, a, b, c, d, e, f, g, h", gpu));
+}
+
+TEST(UT_NvidiaSmiStream, test_parseOutput_001)
+{
+    NvidiaSmiStream stream("/nonexistent/nvidia-smi", 1000);
+    EXPECT_FALSE(stream.start());
+
+    // a record split across chunks is only taken once complete
+    const QByteArray head = "0, Fake GPU A, 42, 10, 8192, 1024";
+    const QByteArray tail = ", 7168, 55, 1500, 00000000:01:00.0\ngarbage\n";
+    stream.parseOutput(head.constData(), size_t(head.size()));
+    EXPECT_TRUE(stream.latest().isEmpty());
+    stream.parseOutput(tail.constData(), size_t(tail.size()));
+
+    const QList<GPUInfo> gpus = stream.latest();
+    ASSERT_EQ(gpus.size(), 1);
+    EXPECT_EQ(gpus[0]->name, "Fake GPU A");
+    EXPECT_EQ(stream.stats().records, 1u);
+    EXPECT_EQ(stream.stats().badRecords, 1u);
+
+    // a newer record of the same gpu replaces the previous one
+    const QByteArray next = "0, Fake GPU A, 99, 10, 8192, 1024, 7168, 55, 1500, 00000000:01:00.0\n";
+    stream.parseOutput(next.constData(), size_t(next.size()));
+    ASSERT_EQ(stream.latest().size(), 1);
+    EXPECT_FLOAT_EQ(stream.latest()[0]->gpuUtilization, 99);
+}
+
+TEST(UT_NvidiaSmiStream, test_start_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString tool = writeFakeTool(dir);
+    ASSERT_FALSE(tool.isEmpty());
+
+    NvidiaSmiStream stream(tool, 1000);
+    ASSERT_TRUE(stream.start());
+    EXPECT_TRUE(stream.isRunning());
+
+    QElapsedTimer timer;
+    timer.start();
+    while (stream.latest().size() < 2 && timer.elapsed() < 5000)
+        QThread::msleep(20);
+
+    const QList<GPUInfo> gpus = stream.latest();
+    ASSERT_EQ(gpus.size(), 2);
+    EXPECT_EQ(gpus[0]->index, 0);
+    EXPECT_FLOAT_EQ(gpus[0]->gpuUtilization, 42);
+    EXPECT_EQ(gpus[1]->index, 1);
+    EXPECT_EQ(gpus[1]->name, "Fake GPU B");
+    // the tool was started once, records streamed in without relaunching it
+    EXPECT_EQ(stream.stats().launches, 1u);
+
+    stream.stop();
+    EXPECT_FALSE(stream.isRunning());
+}
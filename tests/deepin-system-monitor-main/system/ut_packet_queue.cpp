@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/packet_queue.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace core::system;
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+static struct packet_payload_t makePayload(int i)
+{
+    struct packet_payload_t payload {};
+    payload.ino = ino_t(i);
+    payload.payload = 100;
+    return payload;
+}
+
+TEST(UT_PacketQueue, test_pushPop_001)
+{
+    PacketQueue queue(6);
+    EXPECT_EQ(queue.capacity(), 8);
+
+    struct packet_payload_t out[16];
+    EXPECT_EQ(queue.pop(out, 16), 0);
+
+    // wrap around the ring a few times
+    int next = 0, expected = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 5; ++i)
+            EXPECT_TRUE(queue.push(makePayload(next++)));
+        int n = queue.pop(out, 16);
+        ASSERT_EQ(n, 5);
+        for (int i = 0; i < n; ++i)
+            EXPECT_EQ(out[i].ino, ino_t(expected++));
+    }
+    EXPECT_EQ(queue.stats().pushed, 50u);
+    EXPECT_EQ(queue.stats().depth, 0);
+}
+
+TEST(UT_PacketQueue, test_drop_001)
+{
+    PacketQueue queue(8);
+    for (int i = 0; i < 10; ++i)
+        queue.push(makePayload(i));
+
+    packet_queue_stats_t stats = queue.stats();
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.depth, 8);
+    EXPECT_EQ(stats.maxDepth, 8);
+
+    // oldest packets are kept
+    struct packet_payload_t out[4];
+    ASSERT_EQ(queue.pop(out, 4), 4);
+    EXPECT_EQ(out[0].ino, ino_t(0));
+    EXPECT_EQ(queue.stats().depth, 4);
+
+    queue.recordBatch(10);
+    queue.recordBatch(5);
+    stats = queue.stats();
+    EXPECT_EQ(stats.batches, 2u);
+    EXPECT_EQ(stats.lastLatencyUs, 5);
+    EXPECT_EQ(stats.maxLatencyUs, 10);
+}
+
+TEST(UT_PacketQueue, test_wait_001)
+{
+    PacketQueue queue;
+    // nothing queued
+    EXPECT_FALSE(queue.wait(10));
+
+    queue.push(makePayload(1));
+    EXPECT_TRUE(queue.wait(10));
+
+    struct packet_payload_t out[1];
+    queue.pop(out, 1);
+    queue.wakeUp();
+    EXPECT_TRUE(queue.wait(10));
+}
+
+TEST(UT_PacketQueue, test_threads_001)
+{
+    const int npkts = 200000;
+    PacketQueue queue(256);
+    quint64 sum = 0;
+    int received = 0;
+
+    std::thread consumer([&]() {
+        struct packet_payload_t out[64];
+        while (received < npkts) {
+            int n = queue.pop(out, 64);
+            if (n == 0) {
+                queue.wait(100);
+                continue;
+            }
+            for (int i = 0; i < n; ++i)
+                sum += out[i].ino;
+            received += n;
+        }
+    });
+
+    // producer retries instead of dropping, so every packet must arrive in order & once
+    for (int i = 1; i <= npkts; ++i) {
+        while (!queue.push(makePayload(i)))
+            queue.notify();
+        if (i % 64 == 0)
+            queue.notify();
+    }
+    queue.notify();
+    consumer.join();
+
+    EXPECT_EQ(received, npkts);
+    EXPECT_EQ(sum, quint64(npkts) * (npkts + 1) / 2);
+}
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/sock_diag.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <linux/tcp.h>
+
+using namespace core::system;
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// inet_diag dump message of one ipv4 socket, with a tcp_info attribute if rx or tx is set
+static void appendDiagMsg(QByteArray &buf, const char *src, uint16_t sport, const char *dst, uint16_t dport,
+                          uint32_t ino, quint64 rx = 0, quint64 tx = 0)
+{
+    struct inet_diag_msg diag {};
+    diag.idiag_family = AF_INET;
+    diag.idiag_inode = ino;
+    diag.idiag_uid = 1000;
+    diag.id.idiag_sport = htons(sport);
+    diag.id.idiag_dport = htons(dport);
+    inet_pton(AF_INET, src, diag.id.idiag_src);
+    inet_pton(AF_INET, dst, diag.id.idiag_dst);
+
+    struct tcp_info tcpi {};
+    tcpi.tcpi_bytes_received = rx;
+    tcpi.tcpi_bytes_acked = tx;
+    const bool withInfo = rx || tx;
+
+    const size_t attrlen = withInfo ? RTA_SPACE(sizeof(tcpi)) : 0;
+    struct nlmsghdr nlh {};
+    nlh.nlmsg_len = uint32_t(NLMSG_LENGTH(sizeof(diag)) + attrlen);
+    nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+
+    QByteArray msg(int(NLMSG_ALIGN(nlh.nlmsg_len)), 0);
+    memcpy(msg.data(), &nlh, sizeof(nlh));
+    memcpy(msg.data() + NLMSG_HDRLEN, &diag, sizeof(diag));
+    if (withInfo) {
+        auto *attr = reinterpret_cast<struct rtattr *>(msg.data() + NLMSG_LENGTH(sizeof(diag)));
+        attr->rta_type = INET_DIAG_INFO;
+        attr->rta_len = uint16_t(RTA_LENGTH(sizeof(tcpi)));
+        memcpy(RTA_DATA(attr), &tcpi, sizeof(tcpi));
+    }
+    buf += msg;
+}
+
+static void appendDone(QByteArray &buf)
+{
+    struct nlmsghdr nlh {};
+    nlh.nlmsg_len = NLMSG_LENGTH(sizeof(int));
+    nlh.nlmsg_type = NLMSG_DONE;
+    QByteArray msg(int(NLMSG_ALIGN(nlh.nlmsg_len)), 0);
+    memcpy(msg.data(), &nlh, sizeof(nlh));
+    buf += msg;
+}
+
+static const sock_info_t *findConn(const SocketIndex &index, int proto, const char *src, uint16_t sport, const char *dst, uint16_t dport)
+{
+    in_addr s {}, d {};
+    inet_pton(AF_INET, src, &s);
+    inet_pton(AF_INET, dst, &d);
+    return index.find(makeSockTuple(AF_INET, proto, &s, sport, &d, dport));
+}
+
+TEST(UT_SockDiag, test_parseMessages_001)
+{
+    QByteArray buf;
+    appendDiagMsg(buf, "192.168.1.2", 50000, "1.2.3.4", 443, 100, 4096, 512);
+    appendDiagMsg(buf, "0.0.0.0", 22, "0.0.0.0", 0, 101);
+    // time wait socket without inode
+    appendDiagMsg(buf, "192.168.1.2", 50001, "1.2.3.4", 443, 0);
+
+    SocketIndex index;
+    bool done = false;
+    EXPECT_TRUE(SockDiag::parseMessages(buf.constData(), size_t(buf.size()), IPPROTO_TCP, index, nullptr, done));
+    EXPECT_FALSE(done);
+    EXPECT_EQ(index.size(), 2);
+
+    const sock_info_t *info = findConn(index, IPPROTO_TCP, "192.168.1.2", 50000, "1.2.3.4", 443);
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->ino, ino_t(100));
+    EXPECT_EQ(info->uid, uid_t(1000));
+    EXPECT_EQ(info->rxBytes, 4096u);
+    EXPECT_EQ(info->txBytes, 512u);
+
+    buf.clear();
+    appendDone(buf);
+    EXPECT_TRUE(SockDiag::parseMessages(buf.constData(), size_t(buf.size()), IPPROTO_TCP, index, nullptr, done));
+    EXPECT_TRUE(done);
+}
+
+TEST(UT_SockDiag, test_parseMessages_002)
+{
+    SocketIndex index;
+    QVector<sock_io_delta_t> deltas;
+    bool done = false;
+
+    QByteArray buf;
+    appendDiagMsg(buf, "192.168.1.2", 50000, "1.2.3.4", 443, 100, 4096, 512);
+    appendDiagMsg(buf, "192.168.1.2", 50002, "1.2.3.4", 443, 102, 10, 10);
+    appendDone(buf);
+    SockDiag::parseMessages(buf.constData(), size_t(buf.size()), IPPROTO_TCP, index, nullptr, done);
+
+    // second dump: one socket moved data, one tuple reused by a new socket, one socket is new
+    index.beginUpdate();
+    buf.clear();
+    appendDiagMsg(buf, "192.168.1.2", 50000, "1.2.3.4", 443, 100, 5000, 612);
+    appendDiagMsg(buf, "192.168.1.2", 50002, "1.2.3.4", 443, 103, 7, 3);
+    appendDiagMsg(buf, "192.168.1.2", 50003, "1.2.3.4", 443, 104);
+    appendDone(buf);
+    EXPECT_TRUE(SockDiag::parseMessages(buf.constData(), size_t(buf.size()), IPPROTO_TCP, index, &deltas, done));
+    EXPECT_EQ(index.removeStale(), 0);
+
+    ASSERT_EQ(deltas.size(), 2);
+    EXPECT_EQ(deltas[0].ino, ino_t(100));
+    EXPECT_EQ(deltas[0].rxBytes, 904u);
+    EXPECT_EQ(deltas[0].txBytes, 100u);
+    EXPECT_EQ(deltas[1].ino, ino_t(103));
+    EXPECT_EQ(deltas[1].rxBytes, 7u);
+    EXPECT_EQ(deltas[1].txBytes, 3u);
+}
+
+TEST(UT_SockDiag, test_dump_001)
+{
+    SockDiag diag;
+    if (!diag.isValid())
+        return;
+
+    // listening socket of our own, must show up in the dump
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(bind(fd, reinterpret_cast<struct sockaddr *>(&addr), len), 0);
+    ASSERT_EQ(listen(fd, 1), 0);
+    getsockname(fd, reinterpret_cast<struct sockaddr *>(&addr), &len);
+
+    SocketIndex index;
+    if (diag.dump(index)) {
+        const sock_info_t *info = findConn(index, IPPROTO_TCP, "127.0.0.1", ntohs(addr.sin_port), "0.0.0.0", 0);
+        EXPECT_NE(info, nullptr);
+    }
+    close(fd);
+}
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/socket_index.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+//Qt
+#include <QHash>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+using namespace core::system;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+static in_addr addr4(const char *str)
+{
+    in_addr addr {};
+    inet_pton(AF_INET, str, &addr);
+    return addr;
+}
+
+static in6_addr addr6(const char *str)
+{
+    in6_addr addr {};
+    inet_pton(AF_INET6, str, &addr);
+    return addr;
+}
+
+// tcp connection i of a host, 10.0.x.y:port -> 93.184.x.y:443
+static sock_tuple_t connTuple(int i, in_addr &local, uint16_t &lport, in_addr &remote)
+{
+    local.s_addr = htonl(0x0a000000u | uint32_t(i >> 14));
+    remote.s_addr = htonl(0x5db80000u | uint32_t(i & 0xffff));
+    lport = uint16_t(32768 + (i & 0x3fff));
+    return makeSockTuple(AF_INET, IPPROTO_TCP, &local, lport, &remote, 443);
+}
+
+TEST(UT_SocketIndex, test_insert_001)
+{
+    SocketIndex index;
+    for (int i = 0; i < 5000; ++i) {
+        in_addr local {}, remote {};
+        uint16_t lport {};
+        index.insert(connTuple(i, local, lport, remote), {ino_t(1000 + i), uid_t(i)});
+    }
+    EXPECT_EQ(index.size(), 5000);
+
+    in_addr local {}, remote {};
+    uint16_t lport {};
+    const sock_tuple_t key = connTuple(1234, local, lport, remote);
+    const sock_info_t *info = index.find(key);
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->ino, ino_t(2234));
+
+    // same tuple replaces the socket
+    index.insert(key, {ino_t(1), uid_t(0)});
+    EXPECT_EQ(index.size(), 5000);
+    EXPECT_EQ(index.find(key)->ino, ino_t(1));
+
+    // reverse direction is another key
+    EXPECT_EQ(index.find(makeSockTuple(AF_INET, IPPROTO_TCP, &remote, 443, &local, lport)), nullptr);
+    // so is the other protocol
+    EXPECT_EQ(index.find(makeSockTuple(AF_INET, IPPROTO_UDP, &local, lport, &remote, 443)), nullptr);
+
+    index.clear();
+    EXPECT_TRUE(index.isEmpty());
+    EXPECT_EQ(index.find(key), nullptr);
+}
+
+TEST(UT_SocketIndex, test_remove_001)
+{
+    SocketIndex index;
+    QHash<int, ino_t> ref;
+    for (int i = 0; i < 20000; ++i) {
+        int conn = (i * 7919) % 4096;
+        in_addr local {}, remote {};
+        uint16_t lport {};
+        const sock_tuple_t key = connTuple(conn, local, lport, remote);
+        if (i % 3 == 0) {
+            EXPECT_EQ(index.remove(key), ref.remove(conn) > 0);
+        } else {
+            index.insert(key, {ino_t(i), 0});
+            ref.insert(conn, ino_t(i));
+        }
+    }
+
+    EXPECT_EQ(index.size(), ref.size());
+    for (auto it = ref.cbegin(); it != ref.cend(); ++it) {
+        in_addr local {}, remote {};
+        uint16_t lport {};
+        const sock_info_t *info = index.find(connTuple(it.key(), local, lport, remote));
+        ASSERT_NE(info, nullptr);
+        EXPECT_EQ(info->ino, it.value());
+    }
+    for (int i = 0; i < index.size(); ++i)
+        EXPECT_EQ(index.find(index.keys().at(i)), &index.infoAt(i));
+}
+
+TEST(UT_SocketIndex, test_removeStale_001)
+{
+    SocketIndex index;
+    for (int i = 0; i < 1000; ++i) {
+        in_addr local {}, remote {};
+        uint16_t lport {};
+        index.insert(connTuple(i, local, lport, remote), {ino_t(i + 1), 0});
+    }
+
+    // next refresh lists the even connections only
+    index.beginUpdate();
+    for (int i = 0; i < 1000; i += 2) {
+        in_addr local {}, remote {};
+        uint16_t lport {};
+        index.insert(connTuple(i, local, lport, remote), {ino_t(i + 1), 0});
+    }
+    EXPECT_EQ(index.removeStale(), 500);
+    EXPECT_EQ(index.size(), 500);
+
+    for (int i = 0; i < 1000; ++i) {
+        in_addr local {}, remote {};
+        uint16_t lport {};
+        const sock_info_t *info = index.find(connTuple(i, local, lport, remote));
+        if (i % 2 == 0) {
+            ASSERT_NE(info, nullptr);
+            EXPECT_EQ(info->ino, ino_t(i + 1));
+        } else {
+            EXPECT_EQ(info, nullptr);
+        }
+    }
+}
+
+TEST(UT_SocketIndex, test_lookup_001)
+{
+    SocketIndex index;
+    const in_addr any4 {}, lan = addr4("192.168.1.2"), peer = addr4("8.8.8.8");
+    const in6_addr any6 {}, lan6 = addr6("fd00::2"), peer6 = addr6("2001:db8::1");
+
+    // connected udp socket, udp server bound to lan address, udp server bound to 0.0.0.0
+    index.insert(makeSockTuple(AF_INET, IPPROTO_UDP, &lan, 5000, &peer, 53), {1, 0});
+    index.insert(makeSockTuple(AF_INET, IPPROTO_UDP, &lan, 5353, &any4, 0), {2, 0});
+    index.insert(makeSockTuple(AF_INET, IPPROTO_UDP, &any4, 67, &any4, 0), {3, 0});
+    // tcp server bound to [::] (dual stack), ipv6 udp server bound to lan address
+    index.insert(makeSockTuple(AF_INET6, IPPROTO_TCP, &any6, 22, &any6, 0), {4, 0});
+    index.insert(makeSockTuple(AF_INET6, IPPROTO_UDP, &lan6, 443, &any6, 0), {5, 0});
+
+    auto lookup4 = [&](int proto, uint16_t lport, uint16_t rport) {
+        const sock_info_t *info = index.lookup(makeSockTuple(AF_INET, proto, &lan, lport, &peer, rport));
+        return info ? info->ino : ino_t(0);
+    };
+    EXPECT_EQ(lookup4(IPPROTO_UDP, 5000, 53), ino_t(1));
+    EXPECT_EQ(lookup4(IPPROTO_UDP, 5353, 40000), ino_t(2));
+    EXPECT_EQ(lookup4(IPPROTO_UDP, 67, 68), ino_t(3));
+    EXPECT_EQ(lookup4(IPPROTO_TCP, 22, 50000), ino_t(4));
+    EXPECT_EQ(lookup4(IPPROTO_UDP, 5000, 54), ino_t(0));
+    EXPECT_EQ(lookup4(IPPROTO_TCP, 5353, 40000), ino_t(0));
+
+    const sock_info_t *info = index.lookup(makeSockTuple(AF_INET6, IPPROTO_UDP, &lan6, 443, &peer6, 60000));
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->ino, ino_t(5));
+    EXPECT_EQ(index.lookup(makeSockTuple(AF_INET6, IPPROTO_TCP, &lan6, 443, &peer6, 60000)), nullptr);
+}
+
+TEST(UT_SocketIndex, test_v4mapped_001)
+{
+    const in_addr local = addr4("10.0.0.1"), remote = addr4("10.0.0.2");
+    const in6_addr local6 = addr6("::ffff:10.0.0.1"), remote6 = addr6("::ffff:10.0.0.2"), any6 {};
+
+    // dual stack socket as listed in /proc/net/tcp6, against an ipv4 packet
+    const sock_tuple_t mapped = makeSockTuple(AF_INET6, IPPROTO_TCP, &local6, 80, &remote6, 1234);
+    const sock_tuple_t plain = makeSockTuple(AF_INET, IPPROTO_TCP, &local, 80, &remote, 1234);
+    EXPECT_EQ(memcmp(&mapped, &plain, sizeof(plain)), 0);
+
+    // bound to a mapped address, not connected
+    const sock_tuple_t bound = makeSockTuple(AF_INET6, IPPROTO_UDP, &local6, 53, &any6, 0);
+    EXPECT_EQ(bound.family, AF_INET);
+
+    EXPECT_TRUE(makeSockAddr(AF_INET6, &local6) == makeSockAddr(AF_INET, &local));
+    EXPECT_FALSE(makeSockAddr(AF_INET, &remote) == makeSockAddr(AF_INET, &local));
+}
@@ -6,11 +6,14 @@
 //self
 #include "system/sys_info.h"
 #include "system/packet.h"
+#include "system/socket_index.h"
 
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 
+#include <arpa/inet.h>
+
 using namespace core::system;
 
 class UT_SysInfo: public ::testing::Test
@@ -53,9 +56,56 @@ TEST_F(UT_SysInfo, test_instance)
 
 TEST_F(UT_SysInfo, test_readSockStat)
 {
-    SockStatMap m_sockStats {};
-    m_tester->readSockStat(m_sockStats);
-//    EXPECT_TRUE(m_tester->readSockStat(m_sockStats) != true);
+    SocketIndex index;
+    m_tester->readSockStat(index);
+//    EXPECT_TRUE(m_tester->readSockStat(index) != true);
+}
+
+TEST_F(UT_SysInfo, test_parseSockLine_001)
+{
+    SocketIndex index;
+    const char header[] = "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n";
+    EXPECT_FALSE(SysInfo::parseSockLine(header, AF_INET, IPPROTO_TCP, index));
+
+    // 127.0.0.1:631 listening, 192.168.1.2:50000 -> 1.2.3.4:443, waiting socket without inode
+    const char listen[] = "   0: 0100007F:0277 00000000:0000 0A 00000000:00000000 00:00000000 00000000     0        0 12345 1 0000000000000000 100 0 0 10 0\n";
+    const char conn[] = "   1: 0201A8C0:C350 04030201:01BB 01 00000000:00000000 02:000A7D3F 00000000  1000        0 23456 2 0000000000000000 20 4 30 10 -1\n";
+    const char wait[] = "   2: 0201A8C0:C351 04030201:01BB 06 00000000:00000000 03:00001234 00000000     0        0 0 3 0000000000000000\n";
+    EXPECT_TRUE(SysInfo::parseSockLine(listen, AF_INET, IPPROTO_TCP, index));
+    EXPECT_TRUE(SysInfo::parseSockLine(conn, AF_INET, IPPROTO_TCP, index));
+    EXPECT_FALSE(SysInfo::parseSockLine(wait, AF_INET, IPPROTO_TCP, index));
+    ASSERT_EQ(index.size(), 2);
+
+    in_addr local {}, remote {};
+    inet_pton(AF_INET, "192.168.1.2", &local);
+    inet_pton(AF_INET, "1.2.3.4", &remote);
+    const sock_info_t *info = index.find(makeSockTuple(AF_INET, IPPROTO_TCP, &local, 50000, &remote, 443));
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->ino, ino_t(23456));
+    EXPECT_EQ(info->uid, uid_t(1000));
+
+    // a packet to the listening socket from any peer
+    inet_pton(AF_INET, "127.0.0.1", &local);
+    info = index.lookup(makeSockTuple(AF_INET, IPPROTO_TCP, &local, 631, &remote, 40000));
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->ino, ino_t(12345));
+}
+
+TEST_F(UT_SysInfo, test_parseSockLine_002)
+{
+    SocketIndex index;
+    // dual stack socket, [::ffff:10.0.0.1]:53 -> [::ffff:10.0.0.2]:4000
+    const char mapped[] = "   0: 0000000000000000FFFF00000100000A:0035 0000000000000000FFFF00000200000A:0FA0 07 00000000:00000000 00:00000000 00000000   101        0 777 2 0000000000000000 0\n";
+    EXPECT_TRUE(SysInfo::parseSockLine(mapped, AF_INET6, IPPROTO_UDP, index));
+    ASSERT_EQ(index.size(), 1);
+    EXPECT_EQ(index.keys().at(0).family, AF_INET);
+
+    in_addr local {}, remote {};
+    inet_pton(AF_INET, "10.0.0.1", &local);
+    inet_pton(AF_INET, "10.0.0.2", &remote);
+    const sock_info_t *info = index.find(makeSockTuple(AF_INET, IPPROTO_UDP, &local, 53, &remote, 4000));
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->ino, ino_t(777));
 }
 
 TEST_F(UT_SysInfo, test_readSysInfo)
@@ -121,3 +171,29 @@ TEST_F(UT_SysInfo, test_read_loadavg)
 {
     m_tester->read_loadavg(m_tester->d->loadAvg);
 }
+
+TEST_F(UT_SysInfo, test_read_loadavg_threads)
+{
+    m_tester->read_loadavg(m_tester->d->loadAvg);
+    EXPECT_NE(m_tester->nthreads(), 0u);
+    EXPECT_GE(m_tester->d->loadAvg->lavg_1m, 0.f);
+}
+
+TEST_F(UT_SysInfo, test_read_processes)
+{
+    EXPECT_NE(m_tester->read_processes(), 0u);
+}
+
+TEST_F(UT_SysInfo, test_readSysInfo_counts)
+{
+    m_tester->readSysInfo();
+    EXPECT_NE(m_tester->nprocesses(), 0u);
+    EXPECT_NE(m_tester->nthreads(), 0u);
+    EXPECT_NE(m_tester->nfds(), 0u);
+    EXPECT_LT(m_tester->uptime().tv_usec, 1000000);
+
+    // process count of the scan is kept
+    m_tester->set_nprocesses(42);
+    m_tester->readSysInfo();
+    EXPECT_EQ(m_tester->nprocesses(), 42u);
+}
@@ -73,3 +73,18 @@ TEST_F(UT_SystemMonitor, test_timerEvent)
     QTimerEvent event(1);
     m_tester->timerEvent(&event);
 }
+
+TEST_F(UT_SystemMonitor, test_publishSnapshot)
+{
+    EXPECT_TRUE(m_tester->snapshot() == nullptr);
+    m_tester->publishSnapshot();
+    SystemSnapshotPtr first = m_tester->snapshot();
+    ASSERT_TRUE(first != nullptr);
+
+    // readers keep the snapshot they hold, the next tick publishes a new one
+    m_tester->publishSnapshot();
+    SystemSnapshotPtr second = m_tester->snapshot();
+    ASSERT_TRUE(second != nullptr);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(second->seq(), first->seq() + 1);
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/system_snapshot.h"
+#include "process/process.h"
+#include "process/process_set.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+using namespace core::process;
+using namespace core::system;
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+TEST(UT_SystemSnapshot, test_addProcess_001)
+{
+    SystemSnapshot snapshot;
+    snapshot.addProcess(Process(10));
+    snapshot.addProcess(Process(20));
+
+    ASSERT_EQ(snapshot.processCount(), 2);
+    EXPECT_EQ(snapshot.indexOf(20), 1);
+    EXPECT_EQ(snapshot.process(snapshot.indexOf(10)).pid, 10);
+    EXPECT_EQ(snapshot.indexOf(30), -1);
+}
+
+TEST(UT_SystemSnapshot, test_addProcess_002)
+{
+    // the icon data is shared with the process, its QIcon is only built on the GUI thread
+    Process proc(10);
+    proc.refreashProcessIcon();
+    SystemSnapshot snapshot;
+    snapshot.addProcess(proc);
+
+    ASSERT_TRUE(proc.iconData() != nullptr);
+    EXPECT_EQ(snapshot.processText(0).icon, proc.iconData());
+}
+
+TEST(UT_SystemSnapshot, test_capture_001)
+{
+    // sources not given are left empty
+    std::shared_ptr<SystemSnapshot> snapshot = SystemSnapshot::capture(7, nullptr, nullptr, nullptr);
+    ASSERT_TRUE(snapshot != nullptr);
+    EXPECT_EQ(snapshot->seq(), 7u);
+    EXPECT_GT(snapshot->capturedNs(), 0u);
+    EXPECT_EQ(snapshot->processCount(), 0);
+    EXPECT_TRUE(snapshot->cpuUsages().isEmpty());
+}
+
+TEST(UT_SystemSnapshot, test_capture_002)
+{
+    ProcessSet processSet;
+    SystemSnapshot previous;
+    previous.addProcess(Process(10));
+    previous.m_processDelta.seq = processSet.lastDelta().seq;
+    previous.m_processCapturedNs = 5;
+
+    // no scan since previous, its processes are shared
+    std::shared_ptr<SystemSnapshot> snapshot = SystemSnapshot::capture(8, nullptr, nullptr, &processSet, &previous);
+    ASSERT_EQ(snapshot->processCount(), 1);
+    EXPECT_EQ(snapshot->indexOf(10), 0);
+    // read when previous read them
+    EXPECT_EQ(snapshot->processCapturedNs(), 5u);
+    EXPECT_GT(snapshot->capturedNs(), 5u);
+
+    // a scan ran, processes are read from the set again
+    previous.m_processDelta.seq = processSet.lastDelta().seq + 1;
+    snapshot = SystemSnapshot::capture(9, nullptr, nullptr, &processSet, &previous);
+    EXPECT_EQ(snapshot->processCount(), 0);
+    EXPECT_EQ(snapshot->processCapturedNs(), snapshot->capturedNs());
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "dkapture_shm_writer.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+// reopen fd through /proc as a client could do with the descriptor it received
+static int reopen(int fd, int flags)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    return open(path, flags | O_CLOEXEC);
+}
+
+TEST(UT_DKaptureShmWriter, test_seals_001)
+{
+    DKaptureShmWriter writer(2, 4);
+    if (!writer.isValid()) {
+        // F_SEAL_FUTURE_WRITE needs Linux 5.1
+        return;
+    }
+
+    int fd = writer.readOnlyFd();
+    ASSERT_GE(fd, 0);
+    int seals = fcntl(fd, F_GET_SEALS);
+    EXPECT_TRUE(dkShmSealed(seals));
+    EXPECT_TRUE(seals & F_SEAL_SEAL);
+
+    struct stat st {};
+    ASSERT_EQ(fstat(fd, &st), 0);
+    EXPECT_EQ(size_t(st.st_size), dkShmSize(2, 4));
+    EXPECT_EQ(st.st_mode & 0777, mode_t(S_IRUSR | S_IRGRP | S_IROTH));
+
+    // read only mapping of a client
+    void *view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ASSERT_NE(view, MAP_FAILED);
+    EXPECT_NE(dkShmHeader(view, size_t(st.st_size)), nullptr);
+
+    // the server still writes through the mapping it made before sealing
+    dk_proc_record_t *records = writer.beginBatch();
+    ASSERT_NE(records, nullptr);
+    records[0].pid = 42;
+    quint64 seq = writer.commit(1, 0);
+    dk_shm_batch_t batch = dkShmBatch(view, size_t(st.st_size), seq);
+    ASSERT_TRUE(batch.isValid());
+    EXPECT_EQ(batch.records[0].pid, 42);
+
+    EXPECT_EQ(mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0), MAP_FAILED);
+    munmap(view, size_t(st.st_size));
+}
+
+TEST(UT_DKaptureShmWriter, test_reopen_001)
+{
+    DKaptureShmWriter writer(2, 4);
+    if (!writer.isValid())
+        return;
+
+    int rw = reopen(writer.readOnlyFd(), O_RDWR);
+    if (rw < 0) {
+        // segment is read only for everyone, the owner included
+        EXPECT_EQ(errno, EACCES);
+        return;
+    }
+
+    // root ignores the mode, the seals still refuse writes, writable mappings & resizing
+    const size_t size = dkShmSize(2, 4);
+    EXPECT_LT(pwrite(rw, "x", 1, 0), 0);
+    EXPECT_EQ(errno, EPERM);
+    EXPECT_EQ(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, rw, 0), MAP_FAILED);
+    EXPECT_LT(ftruncate(rw, 0), 0);
+    EXPECT_LT(fcntl(rw, F_ADD_SEALS, 0), 0);
+    close(rw);
+}